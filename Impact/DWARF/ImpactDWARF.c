@@ -20,7 +20,7 @@ ImpactResult ImpactDWARFRunCFIInstructions(const ImpactDWARFCFIInstructions* ins
 
     ImpactResult result = ImpactDataCursorInitialize(&cursor, (uintptr_t)instructions->data, instructions->length, 0);
     if (result != ImpactResultSuccess) {
-        ImpactDebugLog("[Log:WARN] %s failed to initialize data cursor %d\n", __func__, result);
+        ImpactDebugLogWarn("[Log:WARN] %s failed to initialize data cursor %d\n", __func__, result);
         return result;
     }
 
@@ -30,7 +30,7 @@ ImpactResult ImpactDWARFRunCFIInstructions(const ImpactDWARFCFIInstructions* ins
     // functions, regardless of our relative position within the function
     const bool considerLocation = &cie->instructions != instructions;
 
-    ImpactDebugLog("[Log:INFO] running CFI instructions with offset 0x%lx\n", pcOffset);
+    ImpactDebugLogInfo("[Log:INFO] running CFI instructions with offset 0x%lx\n", pcOffset);
 
     while (!ImpactDataCursorAtEnd(&cursor)) {
         if (considerLocation && (location >= pcOffset)) {
@@ -42,7 +42,7 @@ ImpactResult ImpactDWARFRunCFIInstructions(const ImpactDWARFCFIInstructions* ins
 
         result = ImpactDataCursorReadUint8(&cursor, &opcode);
         if (result != ImpactResultSuccess) {
-            ImpactDebugLog("[Log:WARN] failed to read CFI opcode %d\n", result);
+            ImpactDebugLogWarn("[Log:WARN] failed to read CFI opcode %d\n", result);
             return result;
         }
 
@@ -51,7 +51,7 @@ ImpactResult ImpactDWARFRunCFIInstructions(const ImpactDWARFCFIInstructions* ins
 
         switch (opcode) {
         case DW_CFA_nop:
-            ImpactDebugLog("[Log:INFO] DW_CFA_nop\n");
+            ImpactDebugLogInfo("[Log:INFO] DW_CFA_nop\n");
             result = ImpactResultSuccess;
             break;
         case DW_CFA_def_cfa:
@@ -69,7 +69,7 @@ ImpactResult ImpactDWARFRunCFIInstructions(const ImpactDWARFCFIInstructions* ins
                     result = ImpactDWARFRun_DW_CFA_advance_loc(&cursor, operand, cie, state, &location);
                     break;
                 default:
-                    ImpactDebugLog("[Log:WARN] %s unhandled opcode %x\n", __func__, opcode);
+                    ImpactDebugLogWarn("[Log:WARN] %s unhandled opcode %x\n", __func__, opcode);
                     return ImpactResultFailure;
             }
                 break;
@@ -110,7 +110,7 @@ ImpactResult ImpactDWARFRunInstructions(const ImpactDWARFCFIData* data, ImpactDW
         return result;
     }
 
-    ImpactDebugLog("[Log:INFO] pc=%lx target=%llx\n", target.pc, targetAddress);
+    ImpactDebugLogInfo("[Log:INFO] pc=%lx target=%llx\n", target.pc, targetAddress);
 
     const uintptr_t pcOffset = target.pc - targetAddress;
 
@@ -127,13 +127,13 @@ ImpactResult ImpactDWARFReadData(ImpactMachODataRegion cfiRegion, ImpactDWARFEnv
 
     ImpactResult result = ImpactDataCursorInitialize(&cursor, cfiRegion.address, cfiRegion.length, offset);
     if (result != ImpactResultSuccess) {
-        ImpactDebugLog("[Log:WARN] %s failed to initialize data cursor %d\n", __func__, result);
+        ImpactDebugLogWarn("[Log:WARN] %s failed to initialize data cursor %d\n", __func__, result);
         return result;
     }
 
     result = ImpactDWARFReadCFI(&cursor, env, data);
     if (result != ImpactResultSuccess) {
-        ImpactDebugLog("[Log:WARN] %s parsing CFI failed %d\n", __func__, result);
+        ImpactDebugLogWarn("[Log:WARN] %s parsing CFI failed %d\n", __func__, result);
         return result;
     }
 
@@ -178,14 +178,14 @@ ImpactResult ImpactDWARFGetCFAValue(const ImpactDWARFCFIState* state, const Impa
 
     }
 
-    ImpactDebugLog("[Log:WARN] unsupported CFA definition %d \n", state->cfaDefinition.rule);
+    ImpactDebugLogWarn("[Log:WARN] unsupported CFA definition %d \n", state->cfaDefinition.rule);
 
     return ImpactResultUnimplemented;
 }
 
 ImpactResult ImpactDWARFGetRegisterValue(const ImpactDWARFCFIState* state, uintptr_t cfa, ImpactDWARFRegister dwarfRegister, uintptr_t* value) {
     if (ImpactInvalidPtr(state) || ImpactInvalidPtr(value)) {
-        ImpactDebugLog("[Log:WARN] %s pointer argument invalid\n", __func__);
+        ImpactDebugLogWarn("[Log:WARN] %s pointer argument invalid\n", __func__);
         return ImpactResultPointerInvalid;
     }
 
@@ -196,7 +196,7 @@ ImpactResult ImpactDWARFGetRegisterValue(const ImpactDWARFCFIState* state, uintp
             return ImpactReadMemory(addr, sizeof(void*), value);
         }
         default:
-            ImpactDebugLog("[Log:WARN] unsupported DWARF register rule %d\n", dwarfRegister.rule);
+            ImpactDebugLogWarn("[Log:WARN] unsupported DWARF register rule %d\n", dwarfRegister.rule);
             break;
     }
 
@@ -219,21 +219,21 @@ ImpactResult ImpactDWARFStepRegisters(const ImpactDWARFCFIData* cfiData, ImpactD
 
     result = ImpactDWARFGetCFAValue(&state, registers, &cfaValue);
     if (result != ImpactResultSuccess) {
-        ImpactDebugLog("[Log:WARN] %s failed to get CFA %d\n", __func__, result);
+        ImpactDebugLogWarn("[Log:WARN] %s failed to get CFA %d\n", __func__, result);
         return result;
     }
 
-    ImpactDebugLog("[Log:INFO] CFA=%lx, RA=%lld\n", cfaValue, cfiData->cie.return_address_register);
+    ImpactDebugLogInfo("[Log:INFO] CFA=%lx, RA=%lld\n", cfaValue, cfiData->cie.return_address_register);
     
     if (ImpactInvalidPtr((void*)cfaValue)) {
-        ImpactDebugLog("[Log:WARN] CFA invalid\n");
+        ImpactDebugLogWarn("[Log:WARN] CFA invalid\n");
         return ImpactResultFailure;
     }
 
     ImpactCPURegisters updatedRegisters = *registers;
 
     if (cfiData->cie.augmentationData.signedWithBKey) {
-        ImpactDebugLog("[Log:WARN] addresses are signed\n");
+        ImpactDebugLogWarn("[Log:WARN] addresses are signed\n");
     }
 
     for (uint32_t i = 0; i < ImpactCPUDWARFRegisterCount; ++i) {
@@ -249,7 +249,7 @@ ImpactResult ImpactDWARFStepRegisters(const ImpactDWARFCFIData* cfiData, ImpactD
             return result;
         }
 
-        ImpactDebugLog("[Log:INFO] restoring register %d with 0x%lx\n", i, regValue);
+        ImpactDebugLogInfo("[Log:INFO] restoring register %d with 0x%lx\n", i, regValue);
 
         if (i == cfiData->cie.return_address_register) {
             result = ImpactCPUSetRegister(&updatedRegisters, ImpactCPURegisterInstructionPointer, regValue);
@@ -35,7 +35,7 @@ ImpactResult ImpactDWARFRun_DW_CFA_def_cfa(ImpactDataCursor* cursor, ImpactDWARF
 
     state->cfaDefinition.value = value;
 
-    ImpactDebugLog("[Log:INFO] DW_CFA_def_cfa reg %d offset %lld\n", state->cfaDefinition.registerNum, state->cfaDefinition.value);
+    ImpactDebugLogInfo("[Log:INFO] DW_CFA_def_cfa reg %d offset %lld\n", state->cfaDefinition.registerNum, state->cfaDefinition.value);
 
     return ImpactResultSuccess;
 }
@@ -46,7 +46,7 @@ ImpactResult ImpactDWARFRun_DW_CFA_offset(ImpactDataCursor* cursor, uint8_t oper
     }
 
     if (operand >= ImpactCPUDWARFRegisterCount) {
-        ImpactDebugLog("[Log:WARN] DW_CFA_offset register out of range %d\n", operand);
+        ImpactDebugLogWarn("[Log:WARN] DW_CFA_offset register out of range %d\n", operand);
         return ImpactResultInconsistentData;
     }
 
@@ -54,7 +54,7 @@ ImpactResult ImpactDWARFRun_DW_CFA_offset(ImpactDataCursor* cursor, uint8_t oper
 
     ImpactResult result = ImpactDataCursorReadULEB128(cursor, &value);
     if (result != ImpactResultSuccess) {
-        ImpactDebugLog("[Log:WARN] DW_CFA_offset failed to read uleb128 %d\n", result);
+        ImpactDebugLogWarn("[Log:WARN] DW_CFA_offset failed to read uleb128 %d\n", result);
         return result;
     }
 
@@ -63,7 +63,7 @@ ImpactResult ImpactDWARFRun_DW_CFA_offset(ImpactDataCursor* cursor, uint8_t oper
     state->registerRules[operand].rule = ImpactDWARFCFIRegisterRuleOffsetFromCFA;
     state->registerRules[operand].value = offset;
 
-    ImpactDebugLog("[Log:INFO] DW_CFA_offset reg=%d offset=%lld\n", operand, offset);
+    ImpactDebugLogInfo("[Log:INFO] DW_CFA_offset reg=%d offset=%lld\n", operand, offset);
 
     return ImpactResultSuccess;
 }
@@ -76,7 +76,7 @@ ImpactResult ImpactDWARFRun_DW_CFA_advance_loc(ImpactDataCursor* cursor, uint8_t
     // should be a little more careful about checking bounds here
     const int32_t delta = operand * (int32_t)cie->code_alignment_factor;
 
-    ImpactDebugLog("[Log:INFO] DW_CFA_advance_loc delta=%d\n", delta);
+    ImpactDebugLogInfo("[Log:INFO] DW_CFA_advance_loc delta=%d\n", delta);
 
     *location += delta;
 
@@ -96,11 +96,11 @@ ImpactResult ImpactDWARFRun_DW_CFA_def_cfa_offset(ImpactDataCursor* cursor, Impa
 
     // per spec, only defined for register/offset rules
     if (state->cfaDefinition.rule != ImpactDWARFCFIRegisterRuleOffsetFromCFA) {
-        ImpactDebugLog("[Log:WARN] invalid for current CFA rule %d\n", state->cfaDefinition.rule);
+        ImpactDebugLogWarn("[Log:WARN] invalid for current CFA rule %d\n", state->cfaDefinition.rule);
         return ImpactResultInconsistentData;
     }
 
-    ImpactDebugLog("[Log:INFO] DW_CFA_def_cfa_offset offset=%llu\n", value);
+    ImpactDebugLogInfo("[Log:INFO] DW_CFA_def_cfa_offset offset=%llu\n", value);
 
     state->cfaDefinition.value = value;
 
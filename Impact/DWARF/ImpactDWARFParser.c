@@ -57,7 +57,7 @@ ImpactResult ImpactDWARFReadEncodedPointer(ImpactDataCursor* cursor, ImpactDWARF
     }
 
     if (result != ImpactResultSuccess) {
-        ImpactDebugLog("[Log:WARN] %s unknown pointer encoding %x\n", __func__, encoding);
+        ImpactDebugLogWarn("[Log:WARN] %s unknown pointer encoding %x\n", __func__, encoding);
 
         return result;
     }
@@ -73,7 +73,7 @@ ImpactResult ImpactDWARFReadEncodedPointer(ImpactDataCursor* cursor, ImpactDWARF
         value += currentAddress;
         break;
     default:
-        ImpactDebugLog("[Log:WARN] %s unknown pointer encoding %x\n", __func__, encoding);
+        ImpactDebugLogWarn("[Log:WARN] %s unknown pointer encoding %x\n", __func__, encoding);
 
         return ImpactResultInconsistentData;
     }
@@ -10,6 +10,8 @@
 #include "ImpactCPU.h"
 #include "ImpactUtility.h"
 #include "ImpactLog.h"
+#include "ImpactCompactUnwind.h"
+#include "ImpactBinaryImageCatalog.h"
 
 #include <mach-o/dyld.h>
 #include <mach-o/getsect.h>
@@ -19,12 +21,11 @@
 #include <TargetConditionals.h>
 
 #include <string.h>
+#include <limits.h>
 
 //static void ImpactBinaryImageAdded(const struct mach_header* mh, intptr_t vmaddr_slide);
 //static void ImpactBinaryImageRemoved(const struct mach_header* mh, intptr_t vmaddr_slide);
 
-static uint32_t ImpactBinaryImageNotFoundFlag = ~0;
-
 static ImpactResult ImpactBinaryImageFindDyldInfo(struct task_dyld_info* info);
 
 ImpactResult ImpactBinaryImageInitialize(ImpactState* state) {
@@ -33,6 +34,10 @@ ImpactResult ImpactBinaryImageInitialize(ImpactState* state) {
 
     state->mutableState.images.lastFoundIndex = ImpactBinaryImageNotFoundFlag;
     state->mutableState.images.writtenIndex = ImpactBinaryImageNotFoundFlag;
+    state->mutableState.images.deferLogging = false;
+
+    memset(state->mutableState.images.referenced, 0, sizeof(state->mutableState.images.referenced));
+    state->mutableState.images.overflowCount = 0;
 
     return ImpactBinaryImageFindDyldInfo(&state->mutableState.images.dyldInfo);
 }
@@ -77,6 +82,7 @@ ImpactResult ImpactBinaryImageGetData(const ImpactMachOHeader* header, const cha
 
     data->loadAddress = (uintptr_t)header;
     data->path = path;
+    data->index = ImpactBinaryImageNotFoundFlag;
 
     for (uint32_t i = 0; i < header->ncmds; ++i) {
         const struct load_command* const lcmd = (struct load_command*)ptr;
@@ -109,7 +115,7 @@ ImpactResult ImpactBinaryImageGetData(const ImpactMachOHeader* header, const cha
     return ImpactResultSuccess;
 }
 
-static ImpactResult ImpactBinaryImageLogPath(ImpactLogger* log, const char* path, bool last) {
+ImpactResult ImpactBinaryImageLogPath(ImpactLogger* log, const char* path, bool last) {
 #if TARGET_OS_OSX
     // This strips out the username, should it be present in the path
     if (strncmp(path, "/Users/", 7) == 0) {
@@ -117,10 +123,13 @@ static ImpactResult ImpactBinaryImageLogPath(ImpactLogger* log, const char* path
 
         sanitizedPath = strchr(sanitizedPath, '/');
         if (sanitizedPath != NULL) {
-            ImpactLogWriteString(log, "path: /Users/USER");
-            ImpactLogWriteString(log, sanitizedPath);
+            // built up front, so the value can be written as a single field in any encoding
+            char buffer[PATH_MAX];
 
-            return ImpactLogWriteString(log, last ? "\n" : ", ");
+            strlcpy(buffer, "/Users/USER", sizeof(buffer));
+            strlcat(buffer, sanitizedPath, sizeof(buffer));
+
+            return ImpactLogWriteKeyString(log, "path", buffer, last);
         }
     }
 #endif
@@ -128,12 +137,24 @@ static ImpactResult ImpactBinaryImageLogPath(ImpactLogger* log, const char* path
     return ImpactLogWriteKeyString(log, "path", path, last);
 }
 
-static ImpactResult ImpactBinaryImageLog(ImpactLogger* log, const ImpactMachOData* imageData) {
-    if (ImpactInvalidPtr(log) || ImpactInvalidPtr(imageData)) {
+static ImpactResult ImpactBinaryImageLog(ImpactState* state, const ImpactMachOData* imageData) {
+    if (ImpactInvalidPtr(state) || ImpactInvalidPtr(imageData)) {
         return ImpactResultPointerInvalid;
     }
 
-    ImpactLogWriteString(log, "[Binary:Found] ");
+    ImpactLogger* log = ImpactStateGetLog(state);
+    const uint32_t catalogId = ImpactBinaryImageCatalogLookup(state->constantState.imageCatalog, imageData->uuid);
+
+    ImpactLogBeginRecord(log, "Binary:Found");
+
+    ImpactLogWriteKeyInteger(log, "index", imageData->index, false);
+
+    // the catalog already has everything but the load address
+    if (catalogId != 0) {
+        ImpactLogWriteKeyInteger(log, "catalog", catalogId, false);
+
+        return ImpactLogWriteKeyInteger(log, "address", imageData->loadAddress, true);
+    }
 
     ImpactBinaryImageLogPath(log, imageData->path, false);
     ImpactLogWriteKeyInteger(log, "address", imageData->loadAddress, false);
@@ -143,12 +164,43 @@ static ImpactResult ImpactBinaryImageLog(ImpactLogger* log, const ImpactMachODat
     return ImpactResultSuccess;
 }
 
+static bool ImpactBinaryImageLogsAll(const ImpactState* state) {
+    return state->constantState.imageLogging == ImpactBinaryImageLoggingAll;
+}
+
+static void ImpactBinaryImageMarkReferenced(ImpactState* state, const ImpactMachOData* imageData) {
+    ImpactBinaryImages* images = &state->mutableState.images;
+    const uint32_t index = imageData->index;
+
+    if (index < ImpactBinaryImageReferenceLimit) {
+        images->referenced[index / 64] |= 1ull << (index % 64);
+        return;
+    }
+
+    for (uint32_t i = 0; i < images->overflowCount; ++i) {
+        if (images->overflowIndexes[i] == index) {
+            return;
+        }
+    }
+
+    if (images->overflowCount < ImpactBinaryImageOverflowLimit) {
+        images->overflowIndexes[images->overflowCount++] = index;
+        return;
+    }
+
+    // Too many images to track, so write this one now. That can produce duplicates, but
+    // never leaves a referenced image out.
+    if (!ImpactBinaryImageLogsAll(state) && !images->deferLogging) {
+        ImpactBinaryImageLog(state, imageData);
+    }
+}
+
 static ImpactResult ImpactBinaryImageFindDyldInfo(struct task_dyld_info* info) {
     mach_msg_type_number_t count = TASK_DYLD_INFO_COUNT;
 
     const kern_return_t result = task_info(mach_task_self(), TASK_DYLD_INFO, (task_info_t)info, &count);
     if (result != KERN_SUCCESS) {
-        ImpactDebugLog("[Log:ERROR:%s] unable to lookup task dyld info %d\n", __func__, result);
+        ImpactDebugLogError("[Log:ERROR:%s] unable to lookup task dyld info %d\n", __func__, result);
         return ImpactResultCallFailed;
     }
 
@@ -164,7 +216,11 @@ ImpactResult ImpactBinaryImageGetDyldImageData(const struct dyld_all_image_infos
     const ImpactMachOHeader* const header = (ImpactMachOHeader*)imageInfo->imageLoadAddress;
     const char* path = imageInfo->imageFilePath;
 
-    return ImpactBinaryImageGetData(header, path, data);
+    const ImpactResult result = ImpactBinaryImageGetData(header, path, data);
+
+    data->index = index;
+
+    return result;
 }
 
 static bool ImpactMachODataContainsAddress(const ImpactMachOData* data, uintptr_t address) {
@@ -186,12 +242,15 @@ ImpactResult ImpactBinaryImageFind(ImpactState* state, uintptr_t address, Impact
         return ImpactResultArgumentInvalid;
     }
 
-    ImpactLogger* logger = ImpactStateGetLog(state);
-
     ImpactBinaryImages* images = &state->mutableState.images;
     const struct dyld_all_image_infos* imagesInfo = (void *)images->dyldInfo.all_image_info_addr;
     const size_t imageCount = imagesInfo->infoArrayCount;
 
+    ImpactCrashMetrics* metrics = &state->mutableState.metrics;
+    const bool logsAll = ImpactBinaryImageLogsAll(state);
+
+    metrics->imageLookups += 1;
+
     // first, check the last match, as it's likely these repeat
     ImpactMachOData imageData = {0};
 
@@ -203,6 +262,7 @@ ImpactResult ImpactBinaryImageFind(ImpactState* state, uintptr_t address, Impact
 
         if (ImpactMachODataContainsAddress(&imageData, address)) {
             *data = imageData;
+            metrics->imageCacheHits += 1;
             return ImpactResultSuccess;
         }
     }
@@ -213,10 +273,10 @@ ImpactResult ImpactBinaryImageFind(ImpactState* state, uintptr_t address, Impact
             return result;
         }
 
-        if (i > images->writtenIndex || images->writtenIndex == ImpactBinaryImageNotFoundFlag) {
+        if (logsAll && !images->deferLogging && (i > images->writtenIndex || images->writtenIndex == ImpactBinaryImageNotFoundFlag)) {
             // There isn't an obvious action to take on error here, so we can just ignore
             // for now.
-            ImpactBinaryImageLog(logger, &imageData);
+            ImpactBinaryImageLog(state, &imageData);
 
             images->writtenIndex = i;
         }
@@ -224,20 +284,352 @@ ImpactResult ImpactBinaryImageFind(ImpactState* state, uintptr_t address, Impact
         if (ImpactMachODataContainsAddress(&imageData, address)) {
             *data = imageData;
             images->lastFoundIndex = i;
+
+            ImpactBinaryImageMarkReferenced(state, &imageData);
+
             return ImpactResultSuccess;
         }
     }
 
+    metrics->imageLookupMisses += 1;
+
     return ImpactResultFailure;
 }
 
-ImpactResult ImpactBinaryImageLogRemainingImages(ImpactState* state) {
+static ImpactResult ImpactBinaryImageLogThroughIndex(ImpactState* state, const struct dyld_all_image_infos* imagesInfo, uint32_t index) {
+    ImpactBinaryImages* images = &state->mutableState.images;
+
+    ImpactMachOData imageData = {0};
+
+    const uint32_t start = images->writtenIndex + 1;
+
+    for (uint32_t i = start; i <= index && i < imagesInfo->infoArrayCount; ++i) {
+        const ImpactResult result = ImpactBinaryImageGetDyldImageData(imagesInfo, i, &imageData);
+        if (result != ImpactResultSuccess) {
+            return result;
+        }
+
+        ImpactBinaryImageLog(state, &imageData);
+
+        images->writtenIndex = i;
+    }
+
+    return ImpactResultSuccess;
+}
+
+static void ImpactBinaryImageAddressSiftDown(ImpactBinaryImageAddress* addresses, uint32_t root, uint32_t count) {
+    while (true) {
+        uint32_t child = root * 2 + 1;
+        if (child >= count) {
+            return;
+        }
+
+        if (child + 1 < count && addresses[child + 1].address > addresses[child].address) {
+            child += 1;
+        }
+
+        if (addresses[root].address >= addresses[child].address) {
+            return;
+        }
+
+        const ImpactBinaryImageAddress tmp = addresses[root];
+        addresses[root] = addresses[child];
+        addresses[child] = tmp;
+
+        root = child;
+    }
+}
+
+// A heap sort is used here because it needs no extra memory and does not recurse, both of which
+// matter when called from a crash handler.
+static void ImpactBinaryImageAddressSort(ImpactBinaryImageAddress* addresses, uint32_t count) {
+    bool sorted = true;
+
+    for (uint32_t i = 1; i < count; ++i) {
+        if (addresses[i - 1].address > addresses[i].address) {
+            sorted = false;
+            break;
+        }
+    }
+
+    if (sorted) {
+        return;
+    }
+
+    for (uint32_t i = count / 2; i > 0; --i) {
+        ImpactBinaryImageAddressSiftDown(addresses, i - 1, count);
+    }
+
+    for (uint32_t end = count - 1; end > 0; --end) {
+        const ImpactBinaryImageAddress tmp = addresses[0];
+        addresses[0] = addresses[end];
+        addresses[end] = tmp;
+
+        ImpactBinaryImageAddressSiftDown(addresses, 0, end);
+    }
+}
+
+// returns the index of the first entry with an address >= the target
+static uint32_t ImpactBinaryImageAddressLowerBound(const ImpactBinaryImageAddress* addresses, uint32_t count, uintptr_t target) {
+    uint32_t low = 0;
+    uint32_t high = count;
+
+    while (low < high) {
+        const uint32_t mid = low + (high - low) / 2;
+
+        if (addresses[mid].address < target) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+static void ImpactBinaryImageResolveImageRange(const ImpactMachOData* imageData, uint32_t imageIndex, ImpactBinaryImageAddress* addresses, uint32_t count) {
+#if IMPACT_COMPACT_UNWIND_SUPPORTED
+    const struct unwind_info_section_header* header = (const void*)imageData->unwindInfoRegion.address;
+    const bool hasUnwindInfo = !ImpactInvalidPtr(header);
+#endif
+
+    for (uint32_t i = 0; i < count; ++i) {
+        ImpactBinaryImageAddress* entry = &addresses[i];
+
+        entry->imageIndex = imageIndex;
+        entry->imageOffset = entry->address - imageData->loadAddress;
+
+#if IMPACT_COMPACT_UNWIND_SUPPORTED
+        if (!hasUnwindInfo) {
+            continue;
+        }
+
+        const ImpactCompactUnwindTarget target = {
+            .address = entry->address,
+            .imageLoadAddress = imageData->loadAddress,
+            .header = header
+        };
+
+        // failure here just leaves the encoding at zero, which means "no unwind info"
+        ImpactCompactUnwindLookupEncoding(target, &entry->unwindEncoding);
+#endif
+    }
+}
+
+ImpactResult ImpactBinaryImageResolveAddresses(ImpactState* state, ImpactBinaryImageAddress* addresses, uint32_t count, ImpactBinaryImageResolveOptions options) {
+    if (ImpactInvalidPtr(state) || ImpactInvalidPtr(addresses)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    if (count == 0) {
+        return ImpactResultSuccess;
+    }
+
+    if ((options & ImpactBinaryImageResolveOptionPresorted) == 0) {
+        ImpactBinaryImageAddressSort(addresses, count);
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        addresses[i].imageIndex = ImpactBinaryImageNotFoundFlag;
+        addresses[i].imageOffset = 0;
+        addresses[i].unwindEncoding = 0;
+    }
+
+    ImpactBinaryImages* images = &state->mutableState.images;
+    const struct dyld_all_image_infos* imagesInfo = (void *)images->dyldInfo.all_image_info_addr;
+    const uint32_t imageCount = imagesInfo->infoArrayCount;
+
+    const uintptr_t lowestAddress = addresses[0].address;
+    const uintptr_t highestAddress = addresses[count - 1].address;
+
+    uint32_t remaining = count;
+    uint32_t highestFoundIndex = ImpactBinaryImageNotFoundFlag;
+
+    // Each image claims the contiguous run of sorted addresses that fall within its text range. This
+    // makes the total cost one pass over the images, plus a binary search per image, instead of a
+    // pass over the images for every address.
+    for (uint32_t i = 0; i < imageCount && remaining > 0; ++i) {
+        // fields an image lacks, like its unwind info, must not carry over from the previous one
+        ImpactMachOData imageData = {0};
+
+        const ImpactResult result = ImpactBinaryImageGetDyldImageData(imagesInfo, i, &imageData);
+        if (result != ImpactResultSuccess) {
+            return result;
+        }
+
+        const uintptr_t upperAddress = imageData.loadAddress + imageData.textSize;
+
+        if (upperAddress <= lowestAddress || imageData.loadAddress > highestAddress) {
+            continue;
+        }
+
+        const uint32_t first = ImpactBinaryImageAddressLowerBound(addresses, count, imageData.loadAddress);
+        uint32_t last = first;
+
+        while (last < count && addresses[last].address < upperAddress) {
+            last += 1;
+        }
+
+        if (last == first) {
+            continue;
+        }
+
+        ImpactBinaryImageResolveImageRange(&imageData, i, addresses + first, last - first);
+        ImpactBinaryImageMarkReferenced(state, &imageData);
+
+        remaining -= last - first;
+        highestFoundIndex = i;
+    }
+
+    if (highestFoundIndex == ImpactBinaryImageNotFoundFlag) {
+        return ImpactResultSuccess;
+    }
+
+    images->lastFoundIndex = highestFoundIndex;
+
+    if (!ImpactBinaryImageLogsAll(state)) {
+        return ImpactResultSuccess;
+    }
+
+    // match the side-effect of ImpactBinaryImageFind, so every referenced image makes it into the log
+    return ImpactBinaryImageLogThroughIndex(state, imagesInfo, highestFoundIndex);
+}
+
+ImpactResult ImpactBinaryImageNoteAddress(ImpactState* state, uintptr_t address) {
+    ImpactMachOData data = {0};
+
+    return ImpactBinaryImageFind(state, address, &data);
+}
+
+ImpactResult ImpactBinaryImageNoteIndex(ImpactState* state, uint32_t index) {
+    if (ImpactInvalidPtr(state)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    const ImpactBinaryImages* images = &state->mutableState.images;
+
+    // otherwise, the image was marked as referenced when it was found
+    if (!ImpactBinaryImageLogsAll(state) || images->deferLogging) {
+        return ImpactResultSuccess;
+    }
+
+    if (images->writtenIndex != ImpactBinaryImageNotFoundFlag && index <= images->writtenIndex) {
+        return ImpactResultSuccess;
+    }
+
+    return ImpactBinaryImageLogThroughIndex(state, (void *)images->dyldInfo.all_image_info_addr, index);
+}
+
+ImpactResult ImpactBinaryImageLogReferencedImages(ImpactState* state) {
+    if (ImpactInvalidPtr(state)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    const ImpactBinaryImages* images = &state->mutableState.images;
+    const struct dyld_all_image_infos* imagesInfo = (void *)images->dyldInfo.all_image_info_addr;
+    const uint32_t imageCount = imagesInfo->infoArrayCount;
+
+    ImpactMachOData imageData = {0};
+
+    for (uint32_t word = 0; word < ImpactBinaryImageReferenceLimit / 64 && word * 64 < imageCount; ++word) {
+        uint64_t bits = images->referenced[word];
+
+        while (bits != 0) {
+            const uint32_t index = word * 64 + __builtin_ctzll(bits);
+
+            bits &= bits - 1;
+
+            if (index >= imageCount) {
+                break;
+            }
+
+            ImpactResult result = ImpactBinaryImageGetDyldImageData(imagesInfo, index, &imageData);
+            if (result != ImpactResultSuccess) {
+                return result;
+            }
+
+            result = ImpactBinaryImageLog(state, &imageData);
+            if (result != ImpactResultSuccess) {
+                return result;
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < images->overflowCount; ++i) {
+        const uint32_t index = images->overflowIndexes[i];
+
+        if (index >= imageCount) {
+            continue;
+        }
+
+        ImpactResult result = ImpactBinaryImageGetDyldImageData(imagesInfo, index, &imageData);
+        if (result != ImpactResultSuccess) {
+            return result;
+        }
+
+        result = ImpactBinaryImageLog(state, &imageData);
+        if (result != ImpactResultSuccess) {
+            return result;
+        }
+    }
+
+    return ImpactResultSuccess;
+}
+
+// Stands in for the images that were left out, so a reader can still tell whether two reports came from
+// the same environment. Only the paths are hashed, because reading every image's UUID means walking its
+// load commands, which is the cost this mode exists to avoid.
+ImpactResult ImpactBinaryImageLogSummary(ImpactState* state) {
     if (ImpactInvalidPtr(state)) {
         return ImpactResultPointerInvalid;
     }
 
     ImpactLogger* logger = ImpactStateGetLog(state);
 
+    const ImpactBinaryImages* images = &state->mutableState.images;
+    const struct dyld_all_image_infos* imagesInfo = (void *)images->dyldInfo.all_image_info_addr;
+    const uint32_t imageCount = imagesInfo->infoArrayCount;
+
+    // 64-bit FNV-1a, with a zero byte between paths
+    uint64_t hash = 0xcbf29ce484222325;
+
+    for (uint32_t i = 0; i < imageCount; ++i) {
+        const char* path = imagesInfo->infoArray[i].imageFilePath;
+
+        for (const char* c = path; !ImpactInvalidPtr(c) && *c != 0; ++c) {
+            hash = (hash ^ (uint8_t)*c) * 0x100000001b3;
+        }
+
+        hash *= 0x100000001b3;
+    }
+
+    uint32_t referencedCount = images->overflowCount;
+
+    for (uint32_t word = 0; word < ImpactBinaryImageReferenceLimit / 64; ++word) {
+        referencedCount += __builtin_popcountll(images->referenced[word]);
+    }
+
+    ImpactLogBeginRecord(logger, "Binary:Summary");
+    ImpactLogWriteKeyInteger(logger, "count", imageCount, false);
+    ImpactLogWriteKeyInteger(logger, "referenced", referencedCount, false);
+
+    return ImpactLogWriteKeyInteger(logger, "hash", hash, true);
+}
+
+ImpactResult ImpactBinaryImageLogRemainingImages(ImpactState* state) {
+    if (ImpactInvalidPtr(state)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    if (!ImpactBinaryImageLogsAll(state)) {
+        const ImpactResult result = ImpactBinaryImageLogReferencedImages(state);
+        if (result != ImpactResultSuccess) {
+            return result;
+        }
+
+        return ImpactBinaryImageLogSummary(state);
+    }
+
     ImpactBinaryImages* images = &state->mutableState.images;
     const struct dyld_all_image_infos* imagesInfo = (void *)images->dyldInfo.all_image_info_addr;
     const size_t imageCount = imagesInfo->infoArrayCount;
@@ -250,7 +642,7 @@ ImpactResult ImpactBinaryImageLogRemainingImages(ImpactState* state) {
             return result;
         }
 
-        result = ImpactBinaryImageLog(logger, &imageData);
+        result = ImpactBinaryImageLog(state, &imageData);
         if (result != ImpactResultSuccess) {
             return result;
         }
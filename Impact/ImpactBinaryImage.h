@@ -12,8 +12,12 @@
 #include "ImpactState.h"
 #include "ImpactResult.h"
 
+#include <mach-o/compact_unwind_encoding.h>
+
 __BEGIN_DECLS
 
+static const uint32_t ImpactBinaryImageNotFoundFlag = ~0;
+
 typedef struct {
     uintptr_t address;
     intptr_t loadAddress;
@@ -28,6 +32,8 @@ typedef struct {
     uintptr_t loadAddress;
     uintptr_t textSize;
     const char* path;
+    // position in the dyld image list, which is also the image's index within a report
+    uint32_t index;
 } ImpactMachOData;
 
 #if __LP64__
@@ -46,12 +52,43 @@ typedef struct section ImpactSection;
 #define Impact_LC_SEGMENT LC_SEGMENT
 #endif
 
+typedef struct {
+    uintptr_t address;
+
+    // results, filled in by ImpactBinaryImageResolveAddresses
+    uint32_t imageIndex;
+    uintptr_t imageOffset;
+    compact_unwind_encoding_t unwindEncoding;
+} ImpactBinaryImageAddress;
+
+typedef enum {
+    ImpactBinaryImageResolveOptionNone = 0,
+    ImpactBinaryImageResolveOptionPresorted = 1 << 0
+} ImpactBinaryImageResolveOptions;
+
 ImpactResult ImpactBinaryImageInitialize(ImpactState* state);
 
 ImpactResult ImpactBinaryImageGetData(const ImpactMachOHeader* header, const char* path, ImpactMachOData* data);
 
+// Writes a "path" field, with any user name removed.
+ImpactResult ImpactBinaryImageLogPath(ImpactLogger* log, const char* path, bool last);
+
 ImpactResult ImpactBinaryImageFind(ImpactState* state, uintptr_t address, ImpactMachOData* data);
 
+// Resolves many addresses with a single pass over the image list. The addresses array
+// is sorted in place, unless the caller indicates it is already in ascending order.
+ImpactResult ImpactBinaryImageResolveAddresses(ImpactState* state, ImpactBinaryImageAddress* addresses, uint32_t count, ImpactBinaryImageResolveOptions options);
+
+// Ensures the image containing the address, if there is one, makes it into the report.
+ImpactResult ImpactBinaryImageNoteAddress(ImpactState* state, uintptr_t address);
+
+// The same, for an image that was already found. Does nothing once the image has been written.
+ImpactResult ImpactBinaryImageNoteIndex(ImpactState* state, uint32_t index);
+
+ImpactResult ImpactBinaryImageLogReferencedImages(ImpactState* state);
+
+// Counts and hashes every loaded image, for reports that only write the referenced ones.
+ImpactResult ImpactBinaryImageLogSummary(ImpactState* state);
 ImpactResult ImpactBinaryImageLogRemainingImages(ImpactState* state);
 
 __END_DECLS
@@ -0,0 +1,363 @@
+//
+//  ImpactBinaryImageCatalog.c
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#include "ImpactBinaryImageCatalog.h"
+#include "ImpactUtility.h"
+#include "ImpactLog.h"
+#include "ImpactLogSink.h"
+
+#include <mach-o/dyld.h>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// The table is never allowed to fill past this, which keeps probe sequences short.
+static const uint32_t ImpactBinaryImageCatalogMaxCount = ImpactBinaryImageCatalogCapacity / 2;
+
+static uint32_t ImpactBinaryImageCatalogSlot(const uint8_t* uuid) {
+    // UUIDs are already well-distributed, so there's no need to hash them
+    uint32_t value = 0;
+
+    memcpy(&value, uuid, sizeof(uint32_t));
+
+    return value & (ImpactBinaryImageCatalogCapacity - 1);
+}
+
+uint32_t ImpactBinaryImageCatalogLookup(const ImpactBinaryImageCatalog* catalog, const uint8_t* uuid) {
+    if (ImpactInvalidPtr(catalog) || ImpactInvalidPtr(uuid)) {
+        return 0;
+    }
+
+    const uint32_t slot = ImpactBinaryImageCatalogSlot(uuid);
+
+    for (uint32_t probe = 0; probe < ImpactBinaryImageCatalogCapacity; ++probe) {
+        const ImpactBinaryImageCatalogEntry* entry = &catalog->entries[(slot + probe) & (ImpactBinaryImageCatalogCapacity - 1)];
+        const uint32_t id = atomic_load_explicit(&entry->id, memory_order_acquire);
+
+        if (id == 0) {
+            return 0;
+        }
+
+        if (memcmp(entry->uuid, uuid, sizeof(entry->uuid)) == 0) {
+            return id;
+        }
+    }
+
+    return 0;
+}
+
+static ImpactResult ImpactBinaryImageCatalogInsert(ImpactBinaryImageCatalog* catalog, const uint8_t* uuid, uint32_t id) {
+    if (catalog->count >= ImpactBinaryImageCatalogMaxCount) {
+        return ImpactResultFailure;
+    }
+
+    const uint32_t slot = ImpactBinaryImageCatalogSlot(uuid);
+
+    for (uint32_t probe = 0; probe < ImpactBinaryImageCatalogCapacity; ++probe) {
+        ImpactBinaryImageCatalogEntry* entry = &catalog->entries[(slot + probe) & (ImpactBinaryImageCatalogCapacity - 1)];
+        const uint32_t existingId = atomic_load_explicit(&entry->id, memory_order_relaxed);
+
+        if (existingId != 0) {
+            if (memcmp(entry->uuid, uuid, sizeof(entry->uuid)) == 0) {
+                return ImpactResultSuccess;
+            }
+
+            continue;
+        }
+
+        // the UUID must be visible before the id publishes the entry to lock-free readers
+        memcpy(entry->uuid, uuid, sizeof(entry->uuid));
+        atomic_store_explicit(&entry->id, id, memory_order_release);
+
+        catalog->count += 1;
+
+        if (id >= catalog->nextId) {
+            catalog->nextId = id + 1;
+        }
+
+        return ImpactResultSuccess;
+    }
+
+    return ImpactResultFailure;
+}
+
+static const char* ImpactBinaryImageCatalogFindValue(const char* line, const char* end, const char* key) {
+    const size_t length = strlen(key);
+
+    for (const char* ptr = line; ptr + length <= end; ++ptr) {
+        if (memcmp(ptr, key, length) == 0) {
+            return ptr + length;
+        }
+    }
+
+    return NULL;
+}
+
+static int ImpactBinaryImageCatalogHexValue(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+
+    return -1;
+}
+
+static uint64_t ImpactBinaryImageCatalogParseInteger(const char* ptr, const char* end) {
+    uint64_t value = 0;
+
+    if (ptr == NULL || ptr + 2 > end || ptr[0] != '0' || ptr[1] != 'x') {
+        return 0;
+    }
+
+    for (ptr += 2; ptr < end; ++ptr) {
+        const int digit = ImpactBinaryImageCatalogHexValue(*ptr);
+        if (digit < 0) {
+            break;
+        }
+
+        value = (value << 4) | (uint64_t)digit;
+    }
+
+    return value;
+}
+
+static bool ImpactBinaryImageCatalogParseUUID(const char* ptr, const char* end, uint8_t* uuid) {
+    if (ptr == NULL || ptr + 32 > end) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < 16; ++i) {
+        const int high = ImpactBinaryImageCatalogHexValue(ptr[i * 2]);
+        const int low = ImpactBinaryImageCatalogHexValue(ptr[i * 2 + 1]);
+
+        if (high < 0 || low < 0) {
+            return false;
+        }
+
+        uuid[i] = (uint8_t)(high << 4 | low);
+    }
+
+    return true;
+}
+
+static void ImpactBinaryImageCatalogParse(ImpactBinaryImageCatalog* catalog, const char* contents, size_t size) {
+    const char* const end = contents + size;
+    const char* line = contents;
+
+    while (line < end) {
+        // a line without a terminator was torn by an earlier process, and is ignored
+        const char* lineEnd = memchr(line, '\n', end - line);
+        if (lineEnd == NULL) {
+            return;
+        }
+
+        if (strncmp(line, "[Catalog] ", 10) == 0) {
+            catalog->identifier = ImpactBinaryImageCatalogParseInteger(ImpactBinaryImageCatalogFindValue(line, lineEnd, "] id: "), lineEnd);
+        } else if (strncmp(line, "[Catalog:Image] ", 16) == 0) {
+            const uint64_t id = ImpactBinaryImageCatalogParseInteger(ImpactBinaryImageCatalogFindValue(line, lineEnd, "] id: "), lineEnd);
+            uint8_t uuid[16];
+
+            if (id > 0 && id <= UINT32_MAX && ImpactBinaryImageCatalogParseUUID(ImpactBinaryImageCatalogFindValue(line, lineEnd, ", uuid: "), lineEnd, uuid)) {
+                ImpactBinaryImageCatalogInsert(catalog, uuid, (uint32_t)id);
+            }
+        }
+
+        line = lineEnd + 1;
+    }
+}
+
+ImpactResult ImpactBinaryImageCatalogOpen(ImpactBinaryImageCatalog* catalog, const char* path) {
+    if (ImpactInvalidPtr(catalog) || ImpactInvalidPtr(path)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    memset(catalog, 0, sizeof(ImpactBinaryImageCatalog));
+
+    pthread_mutex_init(&catalog->lock, NULL);
+    catalog->nextId = 1;
+
+    const int fd = open(path, O_RDWR | O_APPEND | O_CREAT, 0666);
+    if (fd == -1) {
+        return ImpactResultFailure;
+    }
+
+    ImpactResult result = ImpactLogSinkOpenDescriptor(&catalog->log, fd);
+    if (result != ImpactResultSuccess) {
+        close(fd);
+        return result;
+    }
+
+    result = ImpactLogStart(&catalog->log, ImpactLogEncodingText);
+    if (result != ImpactResultSuccess) {
+        close(fd);
+        return result;
+    }
+
+    struct stat info = {0};
+
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return ImpactResultFailure;
+    }
+
+    bool tornLine = false;
+
+    if (info.st_size > 0) {
+        const char* contents = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (contents == MAP_FAILED) {
+            close(fd);
+            return ImpactResultFailure;
+        }
+
+        ImpactBinaryImageCatalogParse(catalog, contents, info.st_size);
+
+        tornLine = contents[info.st_size - 1] != '\n';
+
+        munmap((void*)contents, info.st_size);
+    }
+
+    if (catalog->identifier != 0) {
+        if (tornLine) {
+            ImpactLogWriteString(&catalog->log, "\n");
+        }
+
+        return ImpactLogFlush(&catalog->log);
+    }
+
+    // No usable header, so any ids in here can't be trusted. Start over.
+    if (info.st_size > 0) {
+        memset(catalog->entries, 0, sizeof(catalog->entries));
+        catalog->count = 0;
+        catalog->nextId = 1;
+
+        if (ftruncate(fd, 0) != 0) {
+            close(fd);
+            return ImpactResultFailure;
+        }
+    }
+
+    while (catalog->identifier == 0) {
+        arc4random_buf(&catalog->identifier, sizeof(catalog->identifier));
+    }
+
+    ImpactLogBeginRecord(&catalog->log, "Catalog");
+    ImpactLogWriteKeyInteger(&catalog->log, "id", (uintptr_t)catalog->identifier, false);
+
+    return ImpactLogWriteKeyInteger(&catalog->log, "version", ImpactBinaryImageCatalogVersion, true);
+}
+
+ImpactResult ImpactBinaryImageCatalogAdd(ImpactBinaryImageCatalog* catalog, const ImpactMachOData* data) {
+    if (ImpactInvalidPtr(catalog) || ImpactInvalidPtr(data)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    if (ImpactInvalidPtr(data->uuid)) {
+        return ImpactResultArgumentInvalid;
+    }
+
+    if (ImpactBinaryImageCatalogLookup(catalog, data->uuid) != 0) {
+        return ImpactResultSuccess;
+    }
+
+    pthread_mutex_lock(&catalog->lock);
+
+    ImpactResult result = ImpactResultSuccess;
+
+    if (ImpactBinaryImageCatalogLookup(catalog, data->uuid) == 0) {
+        if (catalog->count >= ImpactBinaryImageCatalogMaxCount) {
+            result = ImpactResultFailure;
+        } else {
+            const uint32_t id = catalog->nextId;
+            ImpactLogger* log = &catalog->log;
+
+            // written before inserting, so a report can never refer to an id the file doesn't have
+            ImpactLogBeginRecord(log, "Catalog:Image");
+            ImpactLogWriteKeyInteger(log, "id", id, false);
+            ImpactLogWriteKeyHexData(log, "uuid", data->uuid, 16, false);
+            ImpactLogWriteKeyInteger(log, "size", data->textSize, false);
+
+            result = ImpactBinaryImageLogPath(log, data->path ? data->path : "", true);
+            if (result == ImpactResultSuccess) {
+                result = ImpactBinaryImageCatalogInsert(catalog, data->uuid, id);
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&catalog->lock);
+
+    return result;
+}
+
+static void ImpactBinaryImageCatalogImageAdded(const struct mach_header* mh, intptr_t vmaddr_slide) {
+    ImpactState* state = GlobalImpactState;
+    if (ImpactInvalidPtr(state)) {
+        return;
+    }
+
+    ImpactBinaryImageCatalog* catalog = state->constantState.imageCatalog;
+    if (ImpactInvalidPtr(catalog)) {
+        return;
+    }
+
+    ImpactMachOData data = {0};
+
+    if (ImpactBinaryImageGetData((const ImpactMachOHeader*)mh, NULL, &data) != ImpactResultSuccess) {
+        return;
+    }
+
+    if (ImpactInvalidPtr(data.uuid) || ImpactBinaryImageCatalogLookup(catalog, data.uuid) != 0) {
+        return;
+    }
+
+    // Only new images need a path. dladdr is relatively expensive, and most images are already known.
+    Dl_info info = {0};
+
+    if (dladdr(mh, &info) != 0) {
+        data.path = info.dli_fname;
+    }
+
+    const ImpactResult result = ImpactBinaryImageCatalogAdd(catalog, &data);
+    if (result != ImpactResultSuccess) {
+        ImpactDebugLogWarn("[Log:WARN] failed to add image to catalog %d\n", result);
+    }
+}
+
+ImpactResult ImpactBinaryImageCatalogRegisterForImages(void) {
+    // this also invokes the callback for every image that is already loaded
+    _dyld_register_func_for_add_image(ImpactBinaryImageCatalogImageAdded);
+
+    return ImpactResultSuccess;
+}
+
+ImpactResult ImpactBinaryImageCatalogLog(ImpactState* state) {
+    if (ImpactInvalidPtr(state)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    const ImpactBinaryImageCatalog* catalog = state->constantState.imageCatalog;
+    if (ImpactInvalidPtr(catalog)) {
+        return ImpactResultArgumentInvalid;
+    }
+
+    ImpactLogger* log = ImpactStateGetLog(state);
+
+    ImpactLogBeginRecord(log, "Binary:Catalog");
+    ImpactLogWriteKeyInteger(log, "id", (uintptr_t)catalog->identifier, false);
+
+    return ImpactLogWriteKeyInteger(log, "version", ImpactBinaryImageCatalogVersion, true);
+}
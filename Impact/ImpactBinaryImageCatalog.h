@@ -0,0 +1,43 @@
+//
+//  ImpactBinaryImageCatalog.h
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#ifndef ImpactBinaryImageCatalog_h
+#define ImpactBinaryImageCatalog_h
+
+#include "ImpactState.h"
+#include "ImpactResult.h"
+#include "ImpactBinaryImage.h"
+
+// The catalog is a text file in the same record format as reports:
+//
+// [Catalog] id: 0x<random>, version: 0x1
+// [Catalog:Image] id: 0x1, uuid: <hex>, size: 0x<text size>, path: <path>
+//
+// It is only ever appended to, so a report that refers to a catalog id can be resolved with
+// any later copy of the same catalog.
+
+__BEGIN_DECLS
+
+enum { ImpactBinaryImageCatalogVersion = 1 };
+
+// Reads any existing entries, creating the file if needed. Not async-signal-safe.
+ImpactResult ImpactBinaryImageCatalogOpen(ImpactBinaryImageCatalog* catalog, const char* path);
+
+// Adds an image that isn't already present. Not async-signal-safe.
+ImpactResult ImpactBinaryImageCatalogAdd(ImpactBinaryImageCatalog* catalog, const ImpactMachOData* data);
+
+// Async-signal-safe. Returns zero when the image is not in the catalog.
+uint32_t ImpactBinaryImageCatalogLookup(const ImpactBinaryImageCatalog* catalog, const uint8_t* uuid);
+
+// Adds every loaded image, and any loaded afterwards, to the state's catalog.
+ImpactResult ImpactBinaryImageCatalogRegisterForImages(void);
+
+ImpactResult ImpactBinaryImageCatalogLog(ImpactState* state);
+
+__END_DECLS
+
+#endif /* ImpactBinaryImageCatalog_h */
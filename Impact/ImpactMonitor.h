@@ -11,6 +11,62 @@
 NS_ASSUME_NONNULL_BEGIN
 
 FOUNDATION_EXTERN const char* ImpactPlatformName;
+FOUNDATION_EXTERN NSErrorDomain const ImpactErrorDomain;
+
+typedef NS_ENUM(NSInteger, ImpactReportEncoding) {
+    ImpactReportEncodingText = 0,
+    ImpactReportEncodingBinary
+};
+
+typedef NS_OPTIONS(NSUInteger, ImpactCrashPathWarmUp) {
+    ImpactCrashPathWarmUpNone = 0,
+    /// Touches the crash handler's code and data, so they are resident when a crash happens.
+    ImpactCrashPathWarmUpTouch = 1 << 0,
+    /// Also locks them in memory. Subject to RLIMIT_MEMLOCK.
+    ImpactCrashPathWarmUpLock = 1 << 1,
+    /// Also reads ahead the unwind information of the main executable and common system libraries.
+    ImpactCrashPathWarmUpUnwindSections = 1 << 2
+};
+
+typedef NS_OPTIONS(NSUInteger, ImpactUnwindStrategies) {
+    ImpactUnwindStrategiesCompactUnwind = 1 << 0,
+    ImpactUnwindStrategiesDWARF = 1 << 1,
+    ImpactUnwindStrategiesFramePointer = 1 << 2,
+
+    ImpactUnwindStrategiesAll = ImpactUnwindStrategiesCompactUnwind | ImpactUnwindStrategiesDWARF | ImpactUnwindStrategiesFramePointer
+};
+
+@interface ImpactThreadPolicy : NSObject <NSCopying>
+
+@property (class, nonatomic, readonly) ImpactThreadPolicy *defaultPolicy;
+
+@property (nonatomic) BOOL logRegisters;
+@property (nonatomic) ImpactUnwindStrategies strategies;
+@property (nonatomic) NSUInteger frameLimit;
+
+@end
+
+/// What a report directory's index records about one report, so a pending crash can be found without
+/// reading any reports.
+@interface ImpactReportSummary : NSObject
+
+@property (nonatomic, readonly) NSUUID *identifier;
+@property (nonatomic, readonly) NSURL *reportURL;
+@property (nonatomic, readonly) NSUInteger slot;
+@property (nonatomic, readonly) NSDate *launchDate;
+
+@property (nonatomic, readonly) BOOL crashed;
+/// The crash handler finished writing the report.
+@property (nonatomic, readonly) BOOL complete;
+@property (nonatomic, readonly, nullable) NSDate *crashDate;
+/// Zero if no signal was received.
+@property (nonatomic, readonly) int signal;
+/// Zero if no mach exception was received.
+@property (nonatomic, readonly) int exceptionType;
+/// Identifies the top frames of the crashed thread by image and offset, and is stable across launches.
+@property (nonatomic, readonly) uint64_t stackHash;
+
+@end
 
 @interface ImpactMonitor : NSObject
 
@@ -21,8 +77,139 @@ FOUNDATION_EXTERN const char* ImpactPlatformName;
 
 - (void)startWithURL:(NSURL *)url identifier:(NSUUID *)uuid;
 
+/// Writes the report to a slot in a report directory, which keeps up to reportSlotCount reports along
+/// with a small index of them. Crashed reports are kept in preference to ones that ended normally.
+- (void)startWithReportDirectoryURL:(NSURL *)url identifier:(NSUUID *)uuid;
+
+/// Reads the index of a report directory, including the report for the current launch if there is one.
++ (nullable NSArray<ImpactReportSummary *> *)reportSummariesInDirectoryURL:(NSURL *)url error:(NSError **)error;
+
+/// Frees up a report's slot, deleting the report.
++ (BOOL)removeReport:(ImpactReportSummary *)summary inDirectoryURL:(NSURL *)url error:(NSError **)error;
+
+/// Reads a report, leaving out the header and unused space of a preallocated report, and decompressing
+/// a compressed one. A compressed report cut short by a torn write is read up to the damage.
++ (nullable NSData *)reportDataAtURL:(NSURL *)url error:(NSError **)error;
+
+/// Converts a report written with ImpactReportEncodingBinary to the text encoding. A report cut short by
+/// a torn write is converted up to the damage, and an error is still returned.
++ (BOOL)convertBinaryReportAtURL:(NSURL *)url toTextReportAtURL:(NSURL *)outputURL error:(NSError **)error;
+
+/// Where the image catalog for reports written to this location lives.
++ (NSURL *)imageCatalogURLForReportURL:(NSURL *)url;
+
 @property (nonatomic) BOOL suppressReportCrash;
 
+/// Defaults to ImpactReportEncodingText.
+@property (nonatomic) ImpactReportEncoding reportEncoding;
+
+/// Write only the images that captured addresses fall within, plus a count and hash of the full image
+/// list, instead of every loaded image. Defaults to NO.
+@property (nonatomic) BOOL logsReferencedImagesOnly;
+
+/// Keep a catalog of loaded images that persists across launches, so reports can refer to images by a
+/// catalog id instead of writing out paths and UUIDs. The catalog is append-only, and must be sent along
+/// with any report that has a [Binary:Catalog] record. Defaults to NO.
+@property (nonatomic) BOOL usesImageCatalog;
+
+/// When non-zero, the report file is preallocated to this many bytes and written through a shared
+/// mapping, so recording a crash needs no system calls. These files have a small header and trailing
+/// unused space, so they must be read with reportDataAtURL:error:. Defaults to zero.
+@property (nonatomic) NSUInteger preallocatedReportSize;
+
+/// Compress reports as they are written. Compressed reports must be read with reportDataAtURL:error:.
+/// This takes precedence over preallocatedReportSize. Defaults to NO.
+@property (nonatomic) BOOL compressesReports;
+
+/// The number of reports kept by startWithReportDirectoryURL:identifier:. Defaults to 8, and cannot be more than 64.
+@property (nonatomic) NSUInteger reportSlotCount;
+
+/// Memory reserved at startup for the crash handler to work in, so it never needs to allocate. Defaults to
+/// 256KB. Reports include how much was used, which can help with sizing. Zero disables the arena.
+@property (nonatomic) NSUInteger crashArenaSize;
+
+/// Pre-faults what the crash handler uses at startup, so a crash under memory pressure doesn't stall on
+/// page-ins. Defaults to none.
+@property (nonatomic) ImpactCrashPathWarmUp crashPathWarmUp;
+
+/// Records a backtrace every time a C++ exception is thrown, so a crash from one that was never caught
+/// includes where it was thrown, and not just std::terminate. Depends on Impact being loaded as a dynamic
+/// framework at launch. Defaults to NO.
+@property (nonatomic) BOOL capturesCxxThrowSites;
+
+/// Upper bound on the time spent writing a crash report. Zero, the default, means no limit.
+@property (nonatomic) NSTimeInterval crashHandlerTimeLimit;
+
+/// Where reports written by captureLiveReportWithError: go. Live reports cover every thread's stack and the
+/// loaded images, without the process crashing. Nil, the default, disables them.
+@property (nonatomic, nullable, copy) NSURL *liveReportDirectoryURL;
+
+/// A signal that triggers a live report, so one can be requested from outside the process with kill.
+/// Signals used to detect crashes are not allowed. Zero, the default, disables this.
+@property (nonatomic) int liveReportSignal;
+
+/// Captures closer together than this are skipped. Defaults to 10 seconds.
+@property (nonatomic) NSTimeInterval liveReportMinimumInterval;
+
+/// Briefly suspends every other thread to unwind it, and writes the result to a new file in
+/// liveReportDirectoryURL. Must be called after monitoring has started.
+- (nullable NSURL *)captureLiveReportWithError:(NSError **)error;
+
+/// Where hang reports go. A hang report has a call tree of the hung thread's stack, sampled for as
+/// long as the hang lasted. The main thread is always watched. Nil, the default, disables hang detection.
+@property (nonatomic, nullable, copy) NSURL *hangReportDirectoryURL;
+
+/// How long the main thread can stay busy before it is considered hung. Defaults to 1 second.
+@property (nonatomic) NSTimeInterval hangTimeout;
+
+/// How often a hung thread's stack is sampled. Each sample briefly suspends the thread. Defaults to 50ms.
+@property (nonatomic) NSTimeInterval hangSampleInterval;
+
+/// Hangs that last this long are reported right away, instead of when they end. Defaults to 10 seconds.
+@property (nonatomic) NSTimeInterval hangReportThreshold;
+
+/// Watches the calling thread for hangs as well. While busy, it must call beatHangWatch at least once per
+/// timeout, and it should call idleHangWatch before waiting on anything that is not a hang. Must be called
+/// after monitoring has started.
+- (BOOL)watchCurrentThreadForHangsWithTimeout:(NSTimeInterval)timeout;
+- (void)stopWatchingCurrentThreadForHangs;
+- (void)beatHangWatch;
+- (void)idleHangWatch;
+
+/// Samples the stacks of every thread at a frequency between 100 and 1000 Hz, until profiling is stopped.
+/// Profiling does not depend on monitoring having started.
+- (BOOL)startProfilingWithFrequency:(NSUInteger)frequency error:(NSError **)error;
+
+/// Writes each distinct stack seen while profiling on its own line, outermost frame first, followed by
+/// the number of times it was seen. This is the folded format that flame graph tools take.
+- (BOOL)stopProfilingAndWriteFoldedStacksToURL:(NSURL *)url error:(NSError **)error;
+
+/// Samples allocations, on average once per this many bytes allocated, and keeps track of the stacks the
+/// sampled ones came from until they are freed. Crash reports then include an estimate of the live bytes
+/// held by each stack. Only frame pointers are used, to keep malloc fast. Zero, the default, disables this.
+@property (nonatomic) NSUInteger allocationSamplingInterval;
+
+/// Writes the stacks of every sampled allocation that is still live, without stopping sampling.
+- (BOOL)writeAllocationSnapshotToURL:(NSURL *)url error:(NSError **)error;
+
+/// The number of threads that can record breadcrumbs, each of which keeps its most recent events in a ring
+/// that is set aside when monitoring starts. Crash reports include the latest events across all of them,
+/// in the order they happened. Zero, the default, disables breadcrumbs.
+@property (nonatomic) NSUInteger breadcrumbThreadLimit;
+
+/// Cheap enough to call from hot paths. Up to four arguments are kept, and messages are truncated to 31
+/// bytes. Does nothing before monitoring has started.
+- (void)recordBreadcrumbWithCategory:(uint32_t)category arguments:(nullable const uintptr_t *)arguments count:(NSUInteger)count message:(nullable const char *)message;
+
+/// Keeps the crash state, breadcrumbs and report buffers in shared memory, and forks a small watchdog
+/// process that maps them too. If this process crashes, the watchdog finishes the report once it is gone,
+/// even if the crash handler itself never got to the end. macOS only. Defaults to NO.
+@property (nonatomic) BOOL usesWatchdogProcess;
+
+@property (nonatomic, copy) ImpactThreadPolicy *crashedThreadPolicy;
+@property (nonatomic, copy) ImpactThreadPolicy *mainThreadPolicy;
+@property (nonatomic, copy) ImpactThreadPolicy *otherThreadPolicy;
+
 @property (nonatomic, nullable) NSString *applicationIdentifier;
 @property (nonatomic, nullable) NSString *organizationIdentifier;
 @property (nonatomic, nullable) NSString *installIdentifier;
@@ -9,18 +9,33 @@
 #import "ImpactMonitor.h"
 #include "ImpactState.h"
 #include "ImpactLog.h"
+#include "ImpactLogBinary.h"
+#include "ImpactLogCompression.h"
 #include "ImpactSignal.h"
 #include "ImpactMachException.h"
 #include "ImpactBinaryImage.h"
+#include "ImpactBinaryImageCatalog.h"
+#include "ImpactReportStore.h"
+#include "ImpactArena.h"
+#include "ImpactWarmUp.h"
 #include "ImpactUtility.h"
 #include "ImpactCPU.h"
 #include "ImpactRuntimeException.h"
+#include "ImpactLiveReport.h"
+#include "ImpactHang.h"
+#include "ImpactProfiler.h"
+#include "ImpactAllocation.h"
+#include "ImpactCxxException.h"
+#include "ImpactBreadcrumb.h"
+#include "ImpactWatchdog.h"
 
 #include <sys/sysctl.h>
 #import <sys/utsname.h>
 
 ImpactState* GlobalImpactState = NULL;
 
+NSErrorDomain const ImpactErrorDomain = @"io.chimehq.Impact";
+
 #if TARGET_OS_OSX
 const char* ImpactPlatformName = "macOS";
 #elif TARGET_OS_IOS
@@ -33,6 +48,102 @@ const char* ImpactPlatformName = "watchOS";
 #error("Unsupported platform")
 #endif
 
+_Static_assert((NSInteger)ImpactReportEncodingBinary == (NSInteger)ImpactLogEncodingBinary, "Public and internal encodings must match");
+_Static_assert((NSUInteger)ImpactUnwindStrategiesAll == (NSUInteger)ImpactUnwindStrategyAll, "Public and internal unwind strategies must match");
+
+@interface ImpactThreadPolicy ()
+
+- (ImpactThreadUnwindPolicy)unwindPolicy;
+
+@end
+
+@implementation ImpactThreadPolicy
+
++ (ImpactThreadPolicy *)defaultPolicy {
+    return [[ImpactThreadPolicy alloc] init];
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _logRegisters = ImpactThreadUnwindPolicyDefault.logRegisters;
+        _strategies = ImpactThreadUnwindPolicyDefault.strategies;
+        _frameLimit = ImpactThreadUnwindPolicyDefault.frameLimit;
+    }
+
+    return self;
+}
+
+- (id)copyWithZone:(NSZone *)zone {
+    ImpactThreadPolicy *policy = [[ImpactThreadPolicy allocWithZone:zone] init];
+
+    policy.logRegisters = self.logRegisters;
+    policy.strategies = self.strategies;
+    policy.frameLimit = self.frameLimit;
+
+    return policy;
+}
+
+- (ImpactThreadUnwindPolicy)unwindPolicy {
+    const ImpactThreadUnwindPolicy policy = {
+        .logRegisters = self.logRegisters == YES,
+        .strategies = (uint32_t)(self.strategies & ImpactUnwindStrategiesAll),
+        .frameLimit = (uint32_t)MIN(self.frameLimit, UINT32_MAX)
+    };
+
+    return policy;
+}
+
+@end
+
+@interface ImpactReportSummary ()
+
+- (instancetype)initWithEntry:(const ImpactReportIndexEntry *)entry slot:(NSUInteger)slot directoryURL:(NSURL *)url;
+
+@end
+
+@implementation ImpactReportSummary
+
+static NSDate *ImpactReportSummaryDate(uint64_t milliseconds) {
+    return [NSDate dateWithTimeIntervalSince1970:(NSTimeInterval)milliseconds / 1000.0];
+}
+
+- (instancetype)initWithEntry:(const ImpactReportIndexEntry *)entry slot:(NSUInteger)slot directoryURL:(NSURL *)url {
+    self = [super init];
+    if (self) {
+        char path[PATH_MAX];
+
+        ImpactReportStoreGetReportPath(url.fileSystemRepresentation, (uint32_t)slot, path, sizeof(path));
+
+        _identifier = [[NSUUID alloc] initWithUUIDBytes:entry->reportId];
+        _reportURL = [NSURL fileURLWithFileSystemRepresentation:path isDirectory:NO relativeToURL:nil];
+        _slot = slot;
+        _launchDate = ImpactReportSummaryDate(entry->launchTime);
+        _crashed = (entry->flags & ImpactReportIndexFlagCrashed) != 0;
+        _complete = (entry->flags & ImpactReportIndexFlagComplete) != 0;
+        _crashDate = _crashed ? ImpactReportSummaryDate(entry->crashTime) : nil;
+        _signal = entry->signal;
+        _exceptionType = entry->exceptionType;
+        _stackHash = entry->stackHash;
+    }
+
+    return self;
+}
+
+@end
+
+@interface ImpactMonitor ()
+
+@property (nonatomic) ImpactLiveReporter *liveReporter;
+@property (nonatomic) dispatch_source_t liveReportSource;
+@property (nonatomic) ImpactHangMonitor *hangMonitor;
+@property (nonatomic) ImpactProfiler *profiler;
+@property (nonatomic) ImpactAllocationSampler *allocationSampler;
+@property (nonatomic) ImpactBreadcrumbPool *breadcrumbPool;
+@property (nonatomic) ImpactWatchdogRegion *watchdogRegion;
+
+@end
+
 @implementation ImpactMonitor
 
 + (ImpactMonitor *)shared {
@@ -56,28 +167,130 @@ const char* ImpactPlatformName = "watchOS";
     self = [super init];
     if (self) {
         _suppressReportCrash = NO;
+        _reportEncoding = ImpactReportEncodingText;
+        _logsReferencedImagesOnly = NO;
+        _usesImageCatalog = NO;
+        _preallocatedReportSize = 0;
+        _compressesReports = NO;
+        _reportSlotCount = 8;
+        _crashArenaSize = 256 * 1024;
+        _crashPathWarmUp = ImpactCrashPathWarmUpNone;
+        _capturesCxxThrowSites = NO;
+        _liveReportSignal = 0;
+        _liveReportMinimumInterval = 10.0;
+        _hangTimeout = 1.0;
+        _hangSampleInterval = 0.05;
+        _hangReportThreshold = 10.0;
+        _allocationSamplingInterval = 0;
+        _breadcrumbThreadLimit = 0;
+        _usesWatchdogProcess = NO;
+        _crashedThreadPolicy = [ImpactThreadPolicy defaultPolicy];
+        _mainThreadPolicy = [ImpactThreadPolicy defaultPolicy];
+        _otherThreadPolicy = [ImpactThreadPolicy defaultPolicy];
     }
 
     return self;
 }
 
 - (void)startWithURL:(NSURL *)url identifier:(NSUUID *)uuid {
+    [self startWithURL:url identifier:uuid reportIndex:NULL];
+}
+
+- (void)startWithReportDirectoryURL:(NSURL *)url identifier:(NSUUID *)uuid {
     if (ImpactDebuggerAttached()) {
         NSLog(@"[Impact] Debugger attached, monitoring disabled");
         return;
     }
 
-    GlobalImpactState = malloc(sizeof(ImpactState));
+    uuid_t reportId;
+    char path[PATH_MAX];
+    ImpactReportIndex index = {0};
 
-    GlobalImpactState->constantState.suppressReportCrash = self.suppressReportCrash == YES;
+    [uuid getUUIDBytes:reportId];
 
-    atomic_store(&GlobalImpactState->mutableState.crashState, ImpactCrashStateUninitialized);
+    const uint32_t slotCount = (uint32_t)MIN(self.reportSlotCount, ImpactReportStoreMaxSlots);
+    const ImpactResult result = ImpactReportStoreOpen(&index, url.fileSystemRepresentation, slotCount, reportId, path, sizeof(path));
+    if (result != ImpactResultSuccess) {
+        NSLog(@"[Impact] Unable to open report directory %d", result);
+        return;
+    }
+
+    NSURL *reportURL = [NSURL fileURLWithFileSystemRepresentation:path isDirectory:NO relativeToURL:nil];
+
+    [self startWithURL:reportURL identifier:uuid reportIndex:&index];
+}
+
+- (void)startWithURL:(NSURL *)url identifier:(NSUUID *)uuid reportIndex:(const ImpactReportIndex *)reportIndex {
+    if (ImpactDebuggerAttached()) {
+        NSLog(@"[Impact] Debugger attached, monitoring disabled");
+        return;
+    }
+
+    if (self.usesWatchdogProcess) {
+        self.watchdogRegion = ImpactWatchdogRegionCreate();
+        if (self.watchdogRegion == NULL) {
+            NSLog(@"[Impact] Unable to create watchdog region");
+        }
+    }
+
+    ImpactWatchdogRegion* region = self.watchdogRegion;
+
+    GlobalImpactState = region ? &region->state : malloc(sizeof(ImpactState));
 
     ImpactResult result;
 
+    GlobalImpactState->constantState.suppressReportCrash = self.suppressReportCrash == YES;
+    GlobalImpactState->constantState.crashHandlerTimeLimit = (uint64_t)(MAX(self.crashHandlerTimeLimit, 0.0) * NSEC_PER_SEC);
+    GlobalImpactState->constantState.imageLogging = self.logsReferencedImagesOnly ? ImpactBinaryImageLoggingReferenced : ImpactBinaryImageLoggingAll;
+    GlobalImpactState->constantState.imageCatalog = NULL;
+    GlobalImpactState->constantState.allocationSampler = NULL;
+    GlobalImpactState->constantState.breadcrumbs = NULL;
+    GlobalImpactState->constantState.watchdogProcess = 0;
+    GlobalImpactState->constantState.watchdogPipe = -1;
+    atomic_store(&GlobalImpactState->mutableState.crashHandlerComplete, false);
+    atomic_store(&GlobalImpactState->mutableState.crashHandlerThread, MACH_PORT_NULL);
+    GlobalImpactState->mutableState.crashDeadline = 0;
+    memset(&GlobalImpactState->mutableState.metrics, 0, sizeof(ImpactCrashMetrics));
+
+    if (reportIndex) {
+        GlobalImpactState->mutableState.reportIndex = *reportIndex;
+    } else {
+        memset(&GlobalImpactState->mutableState.reportIndex, 0, sizeof(ImpactReportIndex));
+        GlobalImpactState->mutableState.reportIndex.fd = -1;
+    }
+
+    if (self.crashArenaSize > 0) {
+        result = ImpactArenaInitialize(&GlobalImpactState->mutableState.arena, self.crashArenaSize);
+        if (result != ImpactResultSuccess) {
+            NSLog(@"[Impact] Unable to initialize crash arena %d", result);
+        }
+    } else {
+        memset(&GlobalImpactState->mutableState.arena, 0, sizeof(ImpactArena));
+    }
+
+    ImpactThreadUnwindPolicies* policies = &GlobalImpactState->constantState.threadPolicies;
+
+    policies->crashedThread = [self.crashedThreadPolicy unwindPolicy];
+    policies->mainThread = [self.mainThreadPolicy unwindPolicy];
+    policies->otherThreads = [self.otherThreadPolicy unwindPolicy];
+
+    atomic_store(&GlobalImpactState->mutableState.crashState, ImpactCrashStateUninitialized);
+
     NSLog(@"[Impact] trying to start with: %s", url.fileSystemRepresentation);
     
-    result = ImpactLogInitialize(GlobalImpactState, url.fileSystemRepresentation);
+    const ImpactLogEncoding encoding = (ImpactLogEncoding)self.reportEncoding;
+
+    if (self.compressesReports) {
+        // this is far too large to put on the stack, and must outlive this call
+        ImpactLogCompressor* compressor = region ? &region->compressor : malloc(sizeof(ImpactLogCompressor));
+
+        result = ImpactLogInitializeCompressed(GlobalImpactState, url.fileSystemRepresentation, encoding, compressor);
+    } else if (self.preallocatedReportSize > 0) {
+        result = ImpactLogInitializeMapped(GlobalImpactState, url.fileSystemRepresentation, encoding, self.preallocatedReportSize);
+    } else {
+        result = ImpactLogInitializeWithEncoding(GlobalImpactState, url.fileSystemRepresentation, encoding);
+    }
+
     if (result != ImpactResultSuccess) {
         NSLog(@"[Impact] Unable to initialize log %d", result);
         return;
@@ -86,6 +299,14 @@ const char* ImpactPlatformName = "watchOS";
     [self logExecutableData:GlobalImpactState];
     [self logEnvironmentDataWithId:uuid state:GlobalImpactState];
 
+    if (self.usesImageCatalog) {
+        [self openImageCatalogForReportURL:url state:GlobalImpactState];
+    }
+
+    if (self.crashPathWarmUp != ImpactCrashPathWarmUpNone) {
+        [self warmUpCrashPath:GlobalImpactState];
+    }
+
     result = ImpactSignalInitialize(GlobalImpactState);
     if (result != ImpactResultSuccess) {
         NSLog(@"[Impact] Unable to initialize signal %d", result);
@@ -102,6 +323,13 @@ const char* ImpactPlatformName = "watchOS";
         NSLog(@"[Impact] Unable to initialize run time exceptions %d", result);
     }
 
+    if (self.capturesCxxThrowSites) {
+        result = ImpactCxxExceptionInitialize();
+        if (result != ImpactResultSuccess) {
+            NSLog(@"[Impact] Unable to initialize C++ throw sites %d", result);
+        }
+    }
+
 #if IMPACT_MACH_EXCEPTION_SUPPORTED
     result = ImpactMachExceptionInitialize(GlobalImpactState);
     if (result != ImpactResultSuccess) {
@@ -111,7 +339,519 @@ const char* ImpactPlatformName = "watchOS";
     
     atomic_store(&GlobalImpactState->mutableState.crashState, ImpactCrashStateInitialized);
 
-    ImpactDebugLog("[Log:INFO] finished initialization\n");
+    if (self.liveReportDirectoryURL) {
+        [self startLiveReports:GlobalImpactState];
+    }
+
+    if (self.hangReportDirectoryURL) {
+        [self startHangMonitor:GlobalImpactState];
+    }
+
+    if (self.allocationSamplingInterval > 0) {
+        [self startAllocationSampler:GlobalImpactState];
+    }
+
+    if (self.breadcrumbThreadLimit > 0) {
+        [self startBreadcrumbs:GlobalImpactState];
+    }
+
+    // last, so that everything the watchdog could need is already in the region
+    if (region) {
+        result = ImpactWatchdogStart(region);
+        if (result != ImpactResultSuccess) {
+            NSLog(@"[Impact] Unable to start watchdog process %d", result);
+        }
+    }
+
+    ImpactDebugLogInfo("[Log:INFO] finished initialization\n");
+}
+
++ (NSData *)reportDataAtURL:(NSURL *)url error:(NSError **)error {
+    NSData *data = [NSData dataWithContentsOfURL:url options:NSDataReadingMappedIfSafe error:error];
+    if (data == nil) {
+        return nil;
+    }
+
+    const uint8_t* contents = NULL;
+    size_t length = 0;
+
+    const ImpactResult result = ImpactLogGetReportContents(data.bytes, data.length, &contents, &length);
+    if (result != ImpactResultSuccess) {
+        if (error) {
+            *error = [NSError errorWithDomain:ImpactErrorDomain code:result userInfo:nil];
+        }
+
+        return nil;
+    }
+
+    if (ImpactLogCompressionIsCompressed(contents, length)) {
+        return [self decompressReportData:contents length:length error:error];
+    }
+
+    return [data subdataWithRange:NSMakeRange(contents - (const uint8_t *)data.bytes, length)];
+}
+
++ (NSData *)decompressReportData:(const uint8_t *)contents length:(size_t)length error:(NSError **)error {
+    size_t decodedLength = 0;
+
+    // a torn final block is expected when the process was killed while writing
+    ImpactResult result = ImpactLogCompressionGetDecodedLength(contents, length, &decodedLength);
+    if (result != ImpactResultSuccess && result != ImpactResultEndOfData) {
+        if (error) {
+            *error = [NSError errorWithDomain:ImpactErrorDomain code:result userInfo:nil];
+        }
+
+        return nil;
+    }
+
+    NSMutableData *decoded = [NSMutableData dataWithLength:decodedLength];
+
+    result = ImpactLogCompressionDecode(contents, length, decoded.mutableBytes, decoded.length, &decodedLength);
+    if (result != ImpactResultSuccess && result != ImpactResultEndOfData) {
+        if (error) {
+            *error = [NSError errorWithDomain:ImpactErrorDomain code:result userInfo:nil];
+        }
+
+        return nil;
+    }
+
+    decoded.length = decodedLength;
+
+    return decoded;
+}
+
++ (BOOL)convertBinaryReportAtURL:(NSURL *)url toTextReportAtURL:(NSURL *)outputURL error:(NSError **)error {
+    NSData *data = [self reportDataAtURL:url error:error];
+    if (data == nil) {
+        return NO;
+    }
+
+    // this is far too large to put on the stack
+    ImpactState* state = calloc(1, sizeof(ImpactState));
+
+    state->mutableState.reportIndex.fd = -1;
+
+    ImpactResult result = ImpactLogInitialize(state, outputURL.fileSystemRepresentation);
+    if (result == ImpactResultSuccess) {
+        ImpactLogger* log = ImpactStateGetLog(state);
+
+        result = ImpactLogBinaryDecode(data.bytes, data.length, log);
+
+        ImpactLogDeinitialize(log);
+    }
+
+    free(state);
+
+    if (result != ImpactResultSuccess) {
+        if (error) {
+            *error = [NSError errorWithDomain:ImpactErrorDomain code:result userInfo:nil];
+        }
+
+        return NO;
+    }
+
+    return YES;
+}
+
+- (void)startLiveReports:(ImpactState *)state {
+    ImpactLiveReporter* reporter = malloc(sizeof(ImpactLiveReporter));
+    const size_t arenaSize = self.crashArenaSize > 0 ? self.crashArenaSize : 256 * 1024;
+    const uint64_t interval = (uint64_t)(MAX(self.liveReportMinimumInterval, 0.0) * NSEC_PER_SEC);
+
+    ImpactResult result = ImpactLiveReporterInitialize(reporter, state, arenaSize, interval);
+    if (result != ImpactResultSuccess) {
+        NSLog(@"[Impact] Unable to initialize live reports %d", result);
+        free(reporter);
+        return;
+    }
+
+    self.liveReporter = reporter;
+
+    const int liveSignal = self.liveReportSignal;
+
+    if (liveSignal == 0) {
+        return;
+    }
+
+    if (ImpactSignalIsHandled(liveSignal) || liveSignal == SIGKILL || liveSignal == SIGSTOP || liveSignal < 0 || liveSignal >= NSIG) {
+        NSLog(@"[Impact] Live report signal %d is not allowed", liveSignal);
+        return;
+    }
+
+    // The signal is only ever delivered through the dispatch source, so captures happen on a regular
+    // queue and not in a signal handler.
+    dispatch_queue_t queue = dispatch_queue_create("io.chimehq.Impact.LiveReport", DISPATCH_QUEUE_SERIAL);
+    dispatch_source_t source = dispatch_source_create(DISPATCH_SOURCE_TYPE_SIGNAL, liveSignal, 0, queue);
+
+    __weak typeof(self) weakSelf = self;
+
+    dispatch_source_set_event_handler(source, ^{
+        NSError *error = nil;
+
+        if ([weakSelf captureLiveReportWithError:&error] == nil) {
+            NSLog(@"[Impact] Unable to capture live report %@", error);
+        }
+    });
+
+    signal(liveSignal, SIG_IGN);
+    dispatch_resume(source);
+
+    self.liveReportSource = source;
+}
+
+// Captures can land within the same millisecond, so names also carry a count for this process.
+static _Atomic uint32_t ImpactLiveReportSequence = 0;
+
+- (NSURL *)captureLiveReportWithError:(NSError **)error {
+    ImpactLiveReporter* reporter = self.liveReporter;
+    NSURL *directoryURL = self.liveReportDirectoryURL;
+
+    if (reporter == NULL || directoryURL == nil) {
+        if (error) {
+            *error = [NSError errorWithDomain:ImpactErrorDomain code:ImpactResultStateInvalid userInfo:nil];
+        }
+
+        return nil;
+    }
+
+    [NSFileManager.defaultManager createDirectoryAtURL:directoryURL withIntermediateDirectories:YES attributes:nil error:nil];
+
+    const uint64_t milliseconds = ImpactTimeGetEpochMilliseconds();
+    const uint32_t sequence = atomic_fetch_add(&ImpactLiveReportSequence, 1);
+    NSString *name = [NSString stringWithFormat:@"Live-%llu-%u.log", milliseconds, sequence];
+    NSURL *url = [directoryURL URLByAppendingPathComponent:name];
+
+    const ImpactResult result = ImpactLiveReportCapture(reporter, url.fileSystemRepresentation, (ImpactLogEncoding)self.reportEncoding);
+    if (result != ImpactResultSuccess) {
+        if (error) {
+            *error = [NSError errorWithDomain:ImpactErrorDomain code:result userInfo:nil];
+        }
+
+        return nil;
+    }
+
+    return url;
+}
+
+static __thread ImpactHangWatch* ImpactCurrentHangWatch = NULL;
+
+static void ImpactMainRunLoopObserver(CFRunLoopObserverRef observer, CFRunLoopActivity activity, void *info) {
+    ImpactHangWatch* watch = info;
+
+    // the main thread is only hung if it is doing something other than waiting for events
+    if (activity == kCFRunLoopBeforeWaiting || activity == kCFRunLoopExit) {
+        ImpactHangWatchIdle(watch);
+    } else {
+        ImpactHangWatchBeat(watch);
+    }
+}
+
+static uint64_t ImpactNanoseconds(NSTimeInterval interval) {
+    return (uint64_t)(MAX(interval, 0.0) * NSEC_PER_SEC);
+}
+
+- (void)startHangMonitor:(ImpactState *)state {
+    NSURL *directoryURL = self.hangReportDirectoryURL;
+
+    [NSFileManager.defaultManager createDirectoryAtURL:directoryURL withIntermediateDirectories:YES attributes:nil error:nil];
+
+    // this is far too large to put anywhere else, and must outlive the watchdog thread
+    ImpactHangMonitor* monitor = malloc(sizeof(ImpactHangMonitor));
+
+    const uint64_t sampleInterval = MAX(ImpactNanoseconds(self.hangSampleInterval), NSEC_PER_MSEC);
+    const ImpactLogEncoding encoding = (ImpactLogEncoding)self.reportEncoding;
+
+    ImpactResult result = ImpactHangMonitorInitialize(monitor, state, directoryURL.fileSystemRepresentation, encoding, sampleInterval, ImpactNanoseconds(self.hangReportThreshold));
+    if (result != ImpactResultSuccess) {
+        NSLog(@"[Impact] Unable to initialize hang monitor %d", result);
+        free(monitor);
+        return;
+    }
+
+    const thread_act_t mainThread = pthread_mach_thread_np(pthread_main_thread_np());
+    ImpactHangWatch* watch = ImpactHangMonitorRegisterThread(monitor, mainThread, MAX(ImpactNanoseconds(self.hangTimeout), sampleInterval));
+    if (watch == NULL) {
+        NSLog(@"[Impact] Unable to watch the main thread for hangs");
+        ImpactHangMonitorDeinitialize(monitor);
+        free(monitor);
+        return;
+    }
+
+    // Started before the observer exists, so a failure leaves nothing behind that points at the watch.
+    result = ImpactHangMonitorStart(monitor);
+    if (result != ImpactResultSuccess) {
+        NSLog(@"[Impact] Unable to start hang monitor %d", result);
+        ImpactHangMonitorUnregisterThread(monitor, watch);
+        ImpactHangMonitorDeinitialize(monitor);
+        free(monitor);
+        return;
+    }
+
+    CFRunLoopObserverContext context = { .info = watch };
+    CFRunLoopObserverRef observer = CFRunLoopObserverCreate(kCFAllocatorDefault, kCFRunLoopAllActivities, true, 0, ImpactMainRunLoopObserver, &context);
+
+    CFRunLoopAddObserver(CFRunLoopGetMain(), observer, kCFRunLoopCommonModes);
+    CFRelease(observer);
+
+    self.hangMonitor = monitor;
+}
+
+- (BOOL)watchCurrentThreadForHangsWithTimeout:(NSTimeInterval)timeout {
+    ImpactHangMonitor* monitor = self.hangMonitor;
+
+    if (monitor == NULL || ImpactCurrentHangWatch != NULL) {
+        return NO;
+    }
+
+    const thread_act_t thread = pthread_mach_thread_np(pthread_self());
+
+    ImpactCurrentHangWatch = ImpactHangMonitorRegisterThread(monitor, thread, MAX(ImpactNanoseconds(timeout), monitor->sampleInterval));
+
+    return ImpactCurrentHangWatch != NULL;
+}
+
+- (void)stopWatchingCurrentThreadForHangs {
+    if (self.hangMonitor == NULL || ImpactCurrentHangWatch == NULL) {
+        return;
+    }
+
+    ImpactHangMonitorUnregisterThread(self.hangMonitor, ImpactCurrentHangWatch);
+    ImpactCurrentHangWatch = NULL;
+}
+
+- (void)beatHangWatch {
+    if (ImpactCurrentHangWatch) {
+        ImpactHangWatchBeat(ImpactCurrentHangWatch);
+    }
+}
+
+- (void)idleHangWatch {
+    if (ImpactCurrentHangWatch) {
+        ImpactHangWatchIdle(ImpactCurrentHangWatch);
+    }
+}
+
+- (BOOL)startProfilingWithFrequency:(NSUInteger)frequency error:(NSError **)error {
+    if (self.profiler) {
+        if (error) {
+            *error = [NSError errorWithDomain:ImpactErrorDomain code:ImpactResultStateInvalid userInfo:nil];
+        }
+
+        return NO;
+    }
+
+    // this is far too large to put on the stack
+    ImpactProfiler* profiler = malloc(sizeof(ImpactProfiler));
+    const uint64_t interval = NSEC_PER_SEC / MAX(frequency, 1);
+
+    ImpactResult result = ImpactProfilerInitialize(profiler, GlobalImpactState, interval);
+    if (result == ImpactResultSuccess) {
+        result = ImpactProfilerStart(profiler);
+    }
+
+    if (result != ImpactResultSuccess) {
+        ImpactProfilerDeinitialize(profiler);
+        free(profiler);
+
+        if (error) {
+            *error = [NSError errorWithDomain:ImpactErrorDomain code:result userInfo:nil];
+        }
+
+        return NO;
+    }
+
+    self.profiler = profiler;
+
+    return YES;
+}
+
+- (BOOL)stopProfilingAndWriteFoldedStacksToURL:(NSURL *)url error:(NSError **)error {
+    ImpactProfiler* profiler = self.profiler;
+
+    if (profiler == NULL) {
+        if (error) {
+            *error = [NSError errorWithDomain:ImpactErrorDomain code:ImpactResultStateInvalid userInfo:nil];
+        }
+
+        return NO;
+    }
+
+    self.profiler = NULL;
+
+    ImpactProfilerStop(profiler);
+
+    const ImpactResult result = ImpactProfilerWriteFoldedStacks(profiler, url.fileSystemRepresentation);
+
+    ImpactProfilerDeinitialize(profiler);
+    free(profiler);
+
+    if (result != ImpactResultSuccess) {
+        if (error) {
+            *error = [NSError errorWithDomain:ImpactErrorDomain code:result userInfo:nil];
+        }
+
+        return NO;
+    }
+
+    return YES;
+}
+
+- (void)startAllocationSampler:(ImpactState *)state {
+    // must outlive every thread that could be inside malloc, so it is never freed
+    ImpactAllocationSampler* sampler = malloc(sizeof(ImpactAllocationSampler));
+
+    ImpactResult result = ImpactAllocationSamplerInitialize(sampler, state, self.allocationSamplingInterval, ImpactUnwindStrategyFramePointer);
+    if (result != ImpactResultSuccess) {
+        NSLog(@"[Impact] Unable to initialize allocation sampling %d", result);
+        free(sampler);
+        return;
+    }
+
+    result = ImpactAllocationSamplerInstall(sampler);
+    if (result != ImpactResultSuccess) {
+        NSLog(@"[Impact] Unable to install allocation sampling %d", result);
+        ImpactAllocationSamplerDeinitialize(sampler);
+        free(sampler);
+        return;
+    }
+
+    state->constantState.allocationSampler = sampler;
+    self.allocationSampler = sampler;
+}
+
+- (BOOL)writeAllocationSnapshotToURL:(NSURL *)url error:(NSError **)error {
+    ImpactAllocationSampler* sampler = self.allocationSampler;
+
+    if (sampler == NULL) {
+        if (error) {
+            *error = [NSError errorWithDomain:ImpactErrorDomain code:ImpactResultStateInvalid userInfo:nil];
+        }
+
+        return NO;
+    }
+
+    const ImpactResult result = ImpactAllocationSamplerWriteSnapshot(sampler, url.fileSystemRepresentation, (ImpactLogEncoding)self.reportEncoding);
+    if (result != ImpactResultSuccess) {
+        if (error) {
+            *error = [NSError errorWithDomain:ImpactErrorDomain code:result userInfo:nil];
+        }
+
+        return NO;
+    }
+
+    return YES;
+}
+
+- (void)startBreadcrumbs:(ImpactState *)state {
+    // threads may be holding on to their rings, so the pool is never freed
+    ImpactWatchdogRegion* region = self.watchdogRegion;
+    ImpactBreadcrumbPool* pool = region ? &region->breadcrumbs : malloc(sizeof(ImpactBreadcrumbPool));
+
+    const ImpactResult result = ImpactBreadcrumbPoolInitialize(pool, (uint32_t)MIN(self.breadcrumbThreadLimit, UINT32_MAX));
+    if (result != ImpactResultSuccess) {
+        NSLog(@"[Impact] Unable to initialize breadcrumbs %d", result);
+
+        if (region == NULL) {
+            free(pool);
+        }
+
+        return;
+    }
+
+    state->constantState.breadcrumbs = pool;
+    self.breadcrumbPool = pool;
+}
+
+- (void)recordBreadcrumbWithCategory:(uint32_t)category arguments:(const uintptr_t *)arguments count:(NSUInteger)count message:(const char *)message {
+    ImpactBreadcrumbPool* pool = _breadcrumbPool;
+
+    if (pool) {
+        ImpactBreadcrumbRecord(pool, category, arguments, (uint32_t)MIN(count, ImpactBreadcrumbArgumentLimit), message);
+    }
+}
+
+- (void)warmUpCrashPath:(ImpactState *)state {
+    const ImpactCrashPathWarmUp warmUp = self.crashPathWarmUp;
+    ImpactWarmUpOptions options = ImpactWarmUpOptionNone;
+
+    if (warmUp & ImpactCrashPathWarmUpLock) {
+        options |= ImpactWarmUpOptionLock;
+    }
+
+    if (warmUp & ImpactCrashPathWarmUpUnwindSections) {
+        options |= ImpactWarmUpOptionUnwindSections;
+    }
+
+    ImpactWarmUpStatistics statistics = {0};
+
+    ImpactWarmUp(state, options, &statistics);
+    ImpactWarmUpLogStatistics(state, &statistics);
+}
+
++ (NSArray<ImpactReportSummary *> *)reportSummariesInDirectoryURL:(NSURL *)url error:(NSError **)error {
+    ImpactReportIndexEntry entries[ImpactReportStoreMaxSlots];
+    uint32_t count = 0;
+
+    const ImpactResult result = ImpactReportStoreReadIndex(url.fileSystemRepresentation, entries, ImpactReportStoreMaxSlots, &count);
+    if (result != ImpactResultSuccess) {
+        if (error) {
+            *error = [NSError errorWithDomain:ImpactErrorDomain code:result userInfo:nil];
+        }
+
+        return nil;
+    }
+
+    NSMutableArray<ImpactReportSummary *> *summaries = [NSMutableArray array];
+
+    for (uint32_t i = 0; i < count; ++i) {
+        if (entries[i].launchTime == 0) {
+            continue;
+        }
+
+        [summaries addObject:[[ImpactReportSummary alloc] initWithEntry:&entries[i] slot:i directoryURL:url]];
+    }
+
+    [summaries sortUsingComparator:^NSComparisonResult(ImpactReportSummary *a, ImpactReportSummary *b) {
+        return [a.launchDate compare:b.launchDate];
+    }];
+
+    return summaries;
+}
+
++ (BOOL)removeReport:(ImpactReportSummary *)summary inDirectoryURL:(NSURL *)url error:(NSError **)error {
+    const ImpactResult result = ImpactReportStoreRemove(url.fileSystemRepresentation, (uint32_t)summary.slot);
+    if (result != ImpactResultSuccess) {
+        if (error) {
+            *error = [NSError errorWithDomain:ImpactErrorDomain code:result userInfo:nil];
+        }
+
+        return NO;
+    }
+
+    return YES;
+}
+
++ (NSURL *)imageCatalogURLForReportURL:(NSURL *)url {
+    return [url.URLByDeletingLastPathComponent URLByAppendingPathComponent:@"ImpactImageCatalog.log"];
+}
+
+- (void)openImageCatalogForReportURL:(NSURL *)url state:(ImpactState *)state {
+    NSURL *catalogURL = [ImpactMonitor imageCatalogURLForReportURL:url];
+
+    // this lives for the rest of the process, as the dyld callback cannot be removed
+    ImpactBinaryImageCatalog* catalog = calloc(1, sizeof(ImpactBinaryImageCatalog));
+
+    ImpactResult result = ImpactBinaryImageCatalogOpen(catalog, catalogURL.fileSystemRepresentation);
+    if (result != ImpactResultSuccess) {
+        NSLog(@"[Impact] Unable to open image catalog %d", result);
+        free(catalog);
+        return;
+    }
+
+    state->constantState.imageCatalog = catalog;
+
+    ImpactBinaryImageCatalogLog(state);
+    ImpactBinaryImageCatalogRegisterForImages();
 }
 
 - (NSString *)OSVersionString {
@@ -156,7 +896,7 @@ const char* ImpactPlatformName = "watchOS";
             return "false";
         }
 
-        ImpactDebugLog("[Log:WARN] failed to determine if process is being translated\n");
+        ImpactDebugLogWarn("[Log:WARN] failed to determine if process is being translated\n");
 
         return "<unknown>";
     }
@@ -169,7 +909,7 @@ const char* ImpactPlatformName = "watchOS";
 
     NSBundle *mainBundle = [NSBundle mainBundle];
 
-    ImpactLogWriteString(log, "[Application] ");
+    ImpactLogBeginRecord(log, "Application");
 
     if (self.applicationIdentifier.length != 0) {
         ImpactLogWriteKeyStringObject(log, "id", self.applicationIdentifier, false);
@@ -186,7 +926,7 @@ const char* ImpactPlatformName = "watchOS";
 - (void)logEnvironmentDataWithId:(NSUUID *)identifier state:(ImpactState *)state {
     ImpactLogger* log = ImpactStateGetLog(state);
 
-    ImpactLogWriteString(log, "[Environment] ");
+    ImpactLogBeginRecord(log, "Environment");
 
     ImpactLogWriteKeyString(log, "platform", ImpactPlatformName, false);
 
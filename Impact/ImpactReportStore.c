@@ -0,0 +1,323 @@
+//
+//  ImpactReportStore.c
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#include "ImpactReportStore.h"
+#include "ImpactUtility.h"
+#include "ImpactTime.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const char ImpactReportStoreIndexName[] = "ImpactReportIndex";
+
+static const char ImpactReportStoreMagic[4] = { 'I', 'M', 'P', 'X' };
+
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t entrySize;
+} ImpactReportStoreHeader;
+
+_Static_assert(sizeof(ImpactReportStoreHeader) == ImpactReportStoreHeaderSize, "Header size is part of the file format");
+
+static off_t ImpactReportStoreEntryOffset(uint32_t slot) {
+    return ImpactReportStoreHeaderSize + (off_t)slot * sizeof(ImpactReportIndexEntry);
+}
+
+static int ImpactReportStoreOpenIndex(const char* directory, int flags) {
+    char path[PATH_MAX];
+
+    if (snprintf(path, sizeof(path), "%s/%s", directory, ImpactReportStoreIndexName) >= (int)sizeof(path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+
+    return open(path, flags, 0666);
+}
+
+// Returns the number of slots, or zero if the index is missing or unusable.
+static uint32_t ImpactReportStoreReadEntries(int fd, ImpactReportIndexEntry* entries, uint32_t capacity) {
+    uint8_t buffer[ImpactReportStoreHeaderSize + ImpactReportStoreMaxSlots * sizeof(ImpactReportIndexEntry)];
+
+    const ssize_t length = pread(fd, buffer, sizeof(buffer), 0);
+    if (length < ImpactReportStoreHeaderSize) {
+        return 0;
+    }
+
+    ImpactReportStoreHeader header;
+
+    memcpy(&header, buffer, sizeof(header));
+
+    if (memcmp(header.magic, ImpactReportStoreMagic, sizeof(header.magic)) != 0 || header.version != ImpactReportStoreVersion) {
+        return 0;
+    }
+
+    if (header.entrySize != sizeof(ImpactReportIndexEntry) || header.slotCount > ImpactReportStoreMaxSlots) {
+        return 0;
+    }
+
+    // slots past the end of a short file were never written, and are empty
+    const uint32_t count = header.slotCount < capacity ? header.slotCount : capacity;
+    const size_t available = (size_t)length - ImpactReportStoreHeaderSize;
+
+    memset(entries, 0, count * sizeof(ImpactReportIndexEntry));
+    memcpy(entries, buffer + ImpactReportStoreHeaderSize, available < count * sizeof(ImpactReportIndexEntry) ? available : count * sizeof(ImpactReportIndexEntry));
+
+    return count;
+}
+
+static uint32_t ImpactReportStoreChooseSlot(const ImpactReportIndexEntry* entries, uint32_t count) {
+    uint32_t oldest = 0;
+    uint32_t oldestCrash = 0;
+    bool foundNonCrash = false;
+
+    for (uint32_t i = 0; i < count; ++i) {
+        const ImpactReportIndexEntry* entry = &entries[i];
+
+        if (entry->launchTime == 0) {
+            return i;
+        }
+
+        // crashes are kept over launches that ended normally, for as long as possible
+        if ((entry->flags & ImpactReportIndexFlagCrashed) == 0) {
+            if (!foundNonCrash || entry->launchTime < entries[oldest].launchTime) {
+                oldest = i;
+                foundNonCrash = true;
+            }
+        } else if (entry->launchTime < entries[oldestCrash].launchTime) {
+            oldestCrash = i;
+        }
+    }
+
+    return foundNonCrash ? oldest : oldestCrash;
+}
+
+ImpactResult ImpactReportStoreGetReportPath(const char* directory, uint32_t slot, char* path, size_t pathSize) {
+    if (ImpactInvalidPtr(directory) || ImpactInvalidPtr(path)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    if (snprintf(path, pathSize, "%s/Report-%u.log", directory, slot) >= (int)pathSize) {
+        return ImpactResultArgumentInvalid;
+    }
+
+    return ImpactResultSuccess;
+}
+
+ImpactResult ImpactReportStoreOpen(ImpactReportIndex* index, const char* directory, uint32_t slotCount, const uint8_t* reportId, char* path, size_t pathSize) {
+    if (ImpactInvalidPtr(index) || ImpactInvalidPtr(directory) || ImpactInvalidPtr(reportId) || ImpactInvalidPtr(path)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    index->fd = -1;
+
+    if (slotCount == 0 || slotCount > ImpactReportStoreMaxSlots) {
+        return ImpactResultArgumentInvalid;
+    }
+
+    if (mkdir(directory, 0755) != 0 && errno != EEXIST) {
+        return ImpactResultCallFailed;
+    }
+
+    const int fd = ImpactReportStoreOpenIndex(directory, O_RDWR | O_CREAT);
+    if (fd == -1) {
+        return ImpactResultCallFailed;
+    }
+
+    ImpactReportIndexEntry entries[ImpactReportStoreMaxSlots] = {0};
+    const uint32_t existingCount = ImpactReportStoreReadEntries(fd, entries, slotCount);
+
+    // A new or changed slot count rewrites the whole index, keeping whatever entries still fit.
+    if (existingCount != slotCount) {
+        ImpactReportStoreHeader header = {
+            .version = ImpactReportStoreVersion,
+            .slotCount = slotCount,
+            .entrySize = sizeof(ImpactReportIndexEntry)
+        };
+
+        memcpy(header.magic, ImpactReportStoreMagic, sizeof(header.magic));
+
+        const size_t entriesSize = slotCount * sizeof(ImpactReportIndexEntry);
+
+        if (ftruncate(fd, 0) != 0 ||
+            pwrite(fd, &header, sizeof(header), 0) != sizeof(header) ||
+            pwrite(fd, entries, entriesSize, ImpactReportStoreHeaderSize) != (ssize_t)entriesSize) {
+            close(fd);
+            return ImpactResultCallFailed;
+        }
+    }
+
+    const uint32_t slot = ImpactReportStoreChooseSlot(entries, slotCount);
+
+    ImpactResult result = ImpactReportStoreGetReportPath(directory, slot, path, pathSize);
+    if (result != ImpactResultSuccess) {
+        close(fd);
+        return result;
+    }
+
+    ImpactReportIndexEntry* entry = &index->entry;
+
+    memset(entry, 0, sizeof(ImpactReportIndexEntry));
+    memcpy(entry->reportId, reportId, sizeof(entry->reportId));
+    entry->launchTime = ImpactTimeGetEpochMilliseconds();
+
+    if (pwrite(fd, entry, sizeof(ImpactReportIndexEntry), ImpactReportStoreEntryOffset(slot)) != sizeof(ImpactReportIndexEntry)) {
+        close(fd);
+        return ImpactResultCallFailed;
+    }
+
+    index->fd = fd;
+    index->slot = slot;
+
+    return ImpactResultSuccess;
+}
+
+ImpactResult ImpactReportStoreReadIndex(const char* directory, ImpactReportIndexEntry* entries, uint32_t capacity, uint32_t* count) {
+    if (ImpactInvalidPtr(directory) || ImpactInvalidPtr(entries) || ImpactInvalidPtr(count)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    *count = 0;
+
+    const int fd = ImpactReportStoreOpenIndex(directory, O_RDONLY);
+    if (fd == -1) {
+        return errno == ENOENT ? ImpactResultSuccess : ImpactResultCallFailed;
+    }
+
+    *count = ImpactReportStoreReadEntries(fd, entries, capacity);
+
+    close(fd);
+
+    return ImpactResultSuccess;
+}
+
+ImpactResult ImpactReportStoreRemove(const char* directory, uint32_t slot) {
+    if (ImpactInvalidPtr(directory)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    if (slot >= ImpactReportStoreMaxSlots) {
+        return ImpactResultArgumentInvalid;
+    }
+
+    char path[PATH_MAX];
+
+    ImpactResult result = ImpactReportStoreGetReportPath(directory, slot, path, sizeof(path));
+    if (result != ImpactResultSuccess) {
+        return result;
+    }
+
+    const int fd = ImpactReportStoreOpenIndex(directory, O_RDWR);
+    if (fd == -1) {
+        return ImpactResultCallFailed;
+    }
+
+    const ImpactReportIndexEntry entry = {0};
+
+    result = pwrite(fd, &entry, sizeof(entry), ImpactReportStoreEntryOffset(slot)) == sizeof(entry) ? ImpactResultSuccess : ImpactResultCallFailed;
+
+    close(fd);
+
+    if (unlink(path) != 0 && errno != ENOENT) {
+        return ImpactResultCallFailed;
+    }
+
+    return result;
+}
+
+#pragma mark - Updates
+
+// Entries are small enough that the whole thing goes out in one pwrite each time.
+static ImpactResult ImpactReportStoreWriteEntry(ImpactState* state) {
+    if (ImpactInvalidPtr(state)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    const ImpactReportIndex* index = &state->mutableState.reportIndex;
+
+    if (index->fd < 0) {
+        return ImpactResultSuccess;
+    }
+
+    const ssize_t count = pwrite(index->fd, &index->entry, sizeof(ImpactReportIndexEntry), ImpactReportStoreEntryOffset(index->slot));
+
+    return count == sizeof(ImpactReportIndexEntry) ? ImpactResultSuccess : ImpactResultCallFailed;
+}
+
+static void ImpactReportStoreMarkCrashed(ImpactReportIndexEntry* entry) {
+    if ((entry->flags & ImpactReportIndexFlagCrashed) == 0) {
+        entry->flags |= ImpactReportIndexFlagCrashed;
+        entry->crashTime = ImpactTimeGetEpochMilliseconds();
+    }
+}
+
+ImpactResult ImpactReportStoreRecordSignal(ImpactState* state, int signal) {
+    if (ImpactInvalidPtr(state)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    ImpactReportIndexEntry* entry = &state->mutableState.reportIndex.entry;
+
+    ImpactReportStoreMarkCrashed(entry);
+    entry->signal = signal;
+
+    return ImpactReportStoreWriteEntry(state);
+}
+
+ImpactResult ImpactReportStoreRecordException(ImpactState* state, int exceptionType) {
+    if (ImpactInvalidPtr(state)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    ImpactReportIndexEntry* entry = &state->mutableState.reportIndex.entry;
+
+    ImpactReportStoreMarkCrashed(entry);
+    entry->exceptionType = exceptionType;
+
+    return ImpactReportStoreWriteEntry(state);
+}
+
+ImpactResult ImpactReportStoreRecordStackHash(ImpactState* state, uint64_t hash) {
+    if (ImpactInvalidPtr(state)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    state->mutableState.reportIndex.entry.stackHash = hash;
+
+    return ImpactReportStoreWriteEntry(state);
+}
+
+ImpactResult ImpactReportStoreRecordComplete(ImpactState* state) {
+    if (ImpactInvalidPtr(state)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    state->mutableState.reportIndex.entry.flags |= ImpactReportIndexFlagComplete;
+
+    return ImpactReportStoreWriteEntry(state);
+}
+
+// 64-bit FNV-1a. Frames are hashed by image and offset, so the same crash hashes the same in every launch.
+uint64_t ImpactReportStoreStackHashAdd(uint64_t hash, const uint8_t* imageUUID, uintptr_t offset) {
+    if (!ImpactInvalidPtr(imageUUID)) {
+        for (uint32_t i = 0; i < 16; ++i) {
+            hash = (hash ^ imageUUID[i]) * 0x100000001b3;
+        }
+    }
+
+    for (uint32_t i = 0; i < sizeof(uintptr_t); ++i) {
+        hash = (hash ^ ((offset >> (i * 8)) & 0xFF)) * 0x100000001b3;
+    }
+
+    return hash;
+}
@@ -0,0 +1,61 @@
+//
+//  ImpactReportStore.h
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#ifndef ImpactReportStore_h
+#define ImpactReportStore_h
+
+#include "ImpactState.h"
+#include "ImpactResult.h"
+
+// A store is a directory with a fixed number of report slots, plus an index file:
+//
+// header: magic, version, slot count, entry size (4 bytes each)
+// entries: one ImpactReportIndexEntry per slot
+//
+// The index is small enough to read in one go, so finding out whether the last launch crashed never
+// requires parsing a report.
+
+__BEGIN_DECLS
+
+enum {
+    ImpactReportStoreVersion = 1,
+    ImpactReportStoreHeaderSize = 16
+};
+
+extern const char ImpactReportStoreIndexName[];
+
+// Picks a slot for a new report, preferring empty slots and then the oldest report that did not crash.
+// The report path for the slot is written to path. Not async-signal-safe.
+ImpactResult ImpactReportStoreOpen(ImpactReportIndex* index, const char* directory, uint32_t slotCount, const uint8_t* reportId, char* path, size_t pathSize);
+
+ImpactResult ImpactReportStoreGetReportPath(const char* directory, uint32_t slot, char* path, size_t pathSize);
+
+// Reads every slot, including empty ones. Not async-signal-safe.
+ImpactResult ImpactReportStoreReadIndex(const char* directory, ImpactReportIndexEntry* entries, uint32_t capacity, uint32_t* count);
+
+// Empties a slot and deletes its report, once the report has been dealt with. Not async-signal-safe.
+ImpactResult ImpactReportStoreRemove(const char* directory, uint32_t slot);
+
+// These update this launch's entry in place, and are async-signal-safe.
+ImpactResult ImpactReportStoreRecordSignal(ImpactState* state, int signal);
+ImpactResult ImpactReportStoreRecordException(ImpactState* state, int exceptionType);
+ImpactResult ImpactReportStoreRecordStackHash(ImpactState* state, uint64_t hash);
+ImpactResult ImpactReportStoreRecordComplete(ImpactState* state);
+
+// Folds a frame into a running stack hash. Start with ImpactReportStoreStackHashSeed.
+uint64_t ImpactReportStoreStackHashAdd(uint64_t hash, const uint8_t* _Nullable imageUUID, uintptr_t offset);
+
+static const uint64_t ImpactReportStoreStackHashSeed = 0xcbf29ce484222325;
+
+enum {
+    // deep enough to tell crashes apart, shallow enough to ignore differences in how they were reached
+    ImpactReportStoreStackHashFrames = 8
+};
+
+__END_DECLS
+
+#endif /* ImpactReportStore_h */
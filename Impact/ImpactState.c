@@ -9,21 +9,56 @@
 #include "ImpactState.h"
 #include "ImpactDebug.h"
 
+#include <pthread.h>
+#include <string.h>
 #include <unistd.h>
 
+void ImpactStateInitializeDerived(ImpactState* derived, const ImpactState* source, ImpactStateDerivedOptions options) {
+    memset(derived, 0, sizeof(ImpactState));
+
+    if (source) {
+        derived->constantState = source->constantState;
+    }
+
+    // only crash reports carry the [Binary:Catalog] record that catalog ids refer to
+    derived->constantState.imageCatalog = NULL;
+
+    if (options & ImpactStateDerivedOptionNoTimeLimit) {
+        derived->constantState.crashHandlerTimeLimit = 0;
+    }
+
+    if (options & ImpactStateDerivedOptionReferencedImages) {
+        derived->constantState.imageLogging = ImpactBinaryImageLoggingReferenced;
+    }
+
+    derived->mutableState.reportIndex.fd = -1;
+    derived->mutableState.log.fd = -1;
+}
+
+void ImpactStateClaimDiagnostics(ImpactState* state) {
+    thread_act_t unclaimed = MACH_PORT_NULL;
+
+    atomic_compare_exchange_strong(&state->mutableState.crashHandlerThread, &unclaimed, pthread_mach_thread_np(pthread_self()));
+}
+
 void ImpactStateTransitionCtx(ImpactState* state, const char* logContext, ImpactCrashState expectedState, ImpactCrashState newState) {
+    // the thread that starts handling a crash is the one that goes on to run the crash handler
+    if (expectedState == ImpactCrashStateInitialized) {
+        ImpactStateClaimDiagnostics(state);
+    }
+
     if (atomic_compare_exchange_strong(&state->mutableState.crashState, &expectedState, newState)) {
-        ImpactDebugLog("[Log:INFO:%s] transition %d -> %d\n", logContext, expectedState, newState);
+        ImpactDebugLogInfo("[Log:INFO:%s] transition %d -> %d\n", logContext, expectedState, newState);
         return;
     }
 
-    ImpactDebugLog("[Log:ERROR:%s] state transition failed %d -> %d\n", logContext, expectedState, newState);
+    ImpactDebugLogError("[Log:ERROR:%s] state transition failed %d -> %d\n", logContext, expectedState, newState);
 
     _exit(1);
 }
 
 _Noreturn void ImpactStateInvalidCtx(const char* logContext, ImpactCrashState invalidState) {
-    ImpactDebugLog("[Log:ERROR:%s] state invalid %d\n", logContext, invalidState);
+    ImpactDebugLogError("[Log:ERROR:%s] state invalid %d\n", logContext, invalidState);
 
     _exit(1);
 }
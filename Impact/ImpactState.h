@@ -2,20 +2,80 @@
 #define ImpactState_h
 
 #include "ImpactDebug.h"
+#include "ImpactResult.h"
+#include "ImpactTime.h"
 
 #include <signal.h>
 #include <stdatomic.h>
 #include <mach/exc.h>
 #include <mach-o/dyld_images.h>
 #include <stdbool.h>
+#include <pthread.h>
 
-enum { ImpactLogBufferSize = 256 };
+enum {
+    ImpactLogBufferSize = 256,
+    ImpactLogRecordBufferSize = 2048
+};
+
+typedef enum {
+    ImpactLogEncodingText = 0,
+    ImpactLogEncodingBinary
+} ImpactLogEncoding;
+
+typedef struct ImpactLogger ImpactLogger;
+typedef struct ImpactLogCompressor ImpactLogCompressor;
+typedef struct ImpactAllocationSampler ImpactAllocationSampler;
+typedef struct ImpactBreadcrumbPool ImpactBreadcrumbPool;
+
+// Where a logger's bytes end up. Writers ask for space with reserve, fill in some or all of it, and then
+// commit what they used. Sinks decide what flush means. These tables are constant, so a logger only
+// ever holds a pointer to one of the built-in implementations.
+typedef struct {
+    // Returns contiguous space for up to *length bytes, updating *length with the actual amount. Returns
+    // NULL when nothing is available until the sink is flushed.
+    char* (*reserve)(ImpactLogger* log, size_t* length);
+    ImpactResult (*commit)(ImpactLogger* log, size_t length);
+    ImpactResult (*flush)(ImpactLogger* log);
+    // Writes a complete message ahead of anything committed but not yet flushed, so a partial
+    // record is never split. Optional.
+    ImpactResult (*writeAhead)(ImpactLogger* log, const char* data, size_t length);
+    void (*close)(ImpactLogger* log);
+} ImpactLogSink;
+
+typedef struct {
+    uint8_t* base;
+    size_t size;
+    size_t pending; // written into the mapping, but not yet committed to the header
+} ImpactLogMapping;
 
 typedef struct {
+    uint8_t* base;
+    size_t size;
+    uint64_t written; // total ever written, so the next write goes at written % size
+} ImpactLogRing;
+
+struct ImpactLogger {
+    const ImpactLogSink* sink;
+
     int fd;
     uint32_t bufferCount;
     char buffer[ImpactLogBufferSize];
-} ImpactLogger;
+
+    ImpactLogMapping mapping;
+    ImpactLogRing ring;
+    ImpactLogCompressor* compressor;
+
+    uint64_t flushDuration; // nanoseconds
+    uint32_t flushCount;
+
+    ImpactLogEncoding encoding;
+    bool recordSeparatorPending;
+
+    // binary records must be staged, as they are length-prefixed and checksummed
+    bool recordContinuation;
+    uint32_t recordCount;
+    uint8_t record[ImpactLogRecordBufferSize];
+};
 
 enum { ImpactSignalCount = 5 };
 
@@ -46,12 +106,153 @@ typedef enum {
     ImpactCrashStateSecondSignalHandled
 } ImpactCrashState;
 
+enum {
+    ImpactBinaryImageReferenceLimit = 4096,
+    // referenced images past the bitmap, kept as a list
+    ImpactBinaryImageOverflowLimit = 64
+};
+
+typedef enum {
+    ImpactBinaryImageLoggingAll = 0,
+    ImpactBinaryImageLoggingReferenced
+} ImpactBinaryImageLogging;
+
 typedef struct {
     struct task_dyld_info dyldInfo;
     uint32_t writtenIndex;
     uint32_t lastFoundIndex;
+    bool deferLogging; // set while capturing, when images must only be looked up
+
+    // one bit per dyld image index, set when a captured address falls within that image
+    uint64_t referenced[ImpactBinaryImageReferenceLimit / 64];
+    uint32_t overflowIndexes[ImpactBinaryImageOverflowLimit];
+    uint32_t overflowCount;
 } ImpactBinaryImages;
 
+enum {
+    ImpactBinaryImageCatalogCapacity = 8192
+};
+
+typedef struct {
+    uint8_t uuid[16];
+    _Atomic uint32_t id; // zero marks an empty slot
+} ImpactBinaryImageCatalogEntry;
+
+// Maps image UUIDs to ids that stay the same across launches. Entries are only ever added outside of the
+// crash path, so lookups can read the table without taking the lock.
+typedef struct {
+    ImpactLogger log;
+    pthread_mutex_t lock;
+    uint64_t identifier;
+    uint32_t nextId;
+    uint32_t count;
+    ImpactBinaryImageCatalogEntry entries[ImpactBinaryImageCatalogCapacity];
+} ImpactBinaryImageCatalog;
+
+enum {
+    ImpactReportStoreMaxSlots = 64
+};
+
+typedef enum {
+    ImpactReportIndexFlagCrashed = 1 << 0,  // a crash handler started on this report
+    ImpactReportIndexFlagComplete = 1 << 1  // and got all the way through it
+} ImpactReportIndexFlag;
+
+// One fixed-size record per slot of a report store. The layout is part of the index file format.
+typedef struct {
+    uint8_t reportId[16];
+    uint64_t launchTime; // epoch milliseconds, zero for an empty slot
+    uint64_t crashTime;
+    uint64_t stackHash; // of the crashed thread's top frames
+    uint32_t flags;
+    int32_t signal;
+    int32_t exceptionType;
+    uint32_t reserved;
+} ImpactReportIndexEntry;
+
+// The slot this launch is writing to. The entry is written back in place whenever it changes.
+typedef struct {
+    int fd; // -1 when there is no store
+    uint32_t slot;
+    ImpactReportIndexEntry entry;
+} ImpactReportIndex;
+
+typedef enum {
+    ImpactUnwindStrategyCompactUnwind = 1 << 0,
+    ImpactUnwindStrategyDWARF = 1 << 1,
+    ImpactUnwindStrategyFramePointer = 1 << 2,
+
+    ImpactUnwindStrategyAll = ImpactUnwindStrategyCompactUnwind | ImpactUnwindStrategyDWARF | ImpactUnwindStrategyFramePointer
+} ImpactUnwindStrategy;
+
+// Describes how a frame's registers were recovered. These are written per-frame, so values must remain stable.
+typedef enum {
+    ImpactUnwindOutcomeThreadState = 0,
+    ImpactUnwindOutcomeCompactUnwind = 1,
+    ImpactUnwindOutcomeDWARF = 2,
+    ImpactUnwindOutcomeFramePointer = 3,
+    ImpactUnwindOutcomeFramePointerFallback = 4,
+
+    ImpactUnwindOutcomeCount
+} ImpactUnwindOutcome;
+
+typedef struct {
+    bool logRegisters;
+    uint32_t strategies;
+    uint32_t frameLimit;
+} ImpactThreadUnwindPolicy;
+
+static const ImpactThreadUnwindPolicy ImpactThreadUnwindPolicyDefault = {
+    .logRegisters = true,
+    .strategies = ImpactUnwindStrategyAll,
+    .frameLimit = 512
+};
+
+typedef struct {
+    ImpactThreadUnwindPolicy crashedThread;
+    ImpactThreadUnwindPolicy mainThread;
+    ImpactThreadUnwindPolicy otherThreads;
+} ImpactThreadUnwindPolicies;
+
+typedef enum {
+    ImpactCrashPhaseStateTransition = 0,
+    ImpactCrashPhaseUninstallHandlers,
+    ImpactCrashPhaseThreadEnumeration,
+    ImpactCrashPhaseSuspend,
+    ImpactCrashPhaseUnwind,
+    ImpactCrashPhaseFormat,
+    ImpactCrashPhaseImages,
+    ImpactCrashPhaseResume,
+
+    ImpactCrashPhaseCount
+} ImpactCrashPhase;
+
+typedef struct {
+    uint64_t phaseDurations[ImpactCrashPhaseCount]; // nanoseconds
+    uint64_t slowestThreadDuration;
+    uint64_t suspendedAt;
+    uint64_t suspendedDuration; // from suspending threads until they are resumed
+
+    uint32_t threadCount;
+    uint32_t unwindOutcomes[ImpactUnwindOutcomeCount];
+    uint32_t unwindFallbacks[ImpactResultCount]; // table failures the frame pointer recovered from
+    uint32_t unwindFailures[ImpactResultCount]; // failures that ended a stack
+
+    uint32_t imageLookups;
+    uint32_t imageLookupMisses;
+    uint32_t imageCacheHits;
+} ImpactCrashMetrics;
+
+// Memory for the crash path, reserved and faulted in at startup. Allocation is a lock-free bump, and
+// everything is released at once when the arena is reset at the start of a crash.
+typedef struct {
+    uint8_t* base;
+    size_t size;
+    _Atomic size_t used;
+    _Atomic size_t highWater;
+    _Atomic uint32_t failures;
+} ImpactArena;
+
 typedef struct {
     // signals
     struct sigaction preexistingActions[ImpactSignalCount];
@@ -62,6 +263,14 @@ typedef struct {
 
     // general configuration
     bool suppressReportCrash;
+    ImpactThreadUnwindPolicies threadPolicies;
+    uint64_t crashHandlerTimeLimit; // nanoseconds, zero means unlimited
+    ImpactBinaryImageLogging imageLogging;
+    ImpactBinaryImageCatalog* imageCatalog;
+    ImpactAllocationSampler* allocationSampler;
+    ImpactBreadcrumbPool* breadcrumbs;
+    pid_t watchdogProcess; // zero when there is none
+    int watchdogPipe; // read end of a pipe only the watchdog can write to, valid with watchdogProcess
 
     void* preexistingNSExceptionHandler;
 } ImpactConstantState;
@@ -72,6 +281,13 @@ typedef struct {
 
     _Atomic ImpactCrashState crashState;
     _Atomic uint32_t exceptionCount;
+    _Atomic bool crashHandlerComplete;
+    _Atomic thread_act_t crashHandlerThread; // the only thread diagnostics are written from during a crash
+
+    uint64_t crashDeadline;
+    ImpactCrashMetrics metrics;
+    ImpactReportIndex reportIndex;
+    ImpactArena arena;
 } ImpactMutableState;
 
 typedef struct {
@@ -85,8 +301,37 @@ static inline ImpactLogger* ImpactStateGetLog(ImpactState* state) {
     return &state->mutableState.log;
 }
 
+static inline bool ImpactStateDeadlineExceeded(const ImpactState* state) {
+    const uint64_t deadline = state->mutableState.crashDeadline;
+
+    return deadline != 0 && ImpactTimeGetMonotonicNanoseconds() >= deadline;
+}
+
+// returns the time elapsed since start, so callers can keep their own aggregates as well
+static inline uint64_t ImpactStateRecordPhase(ImpactState* state, ImpactCrashPhase phase, uint64_t start) {
+    const uint64_t duration = ImpactTimeGetMonotonicNanoseconds() - start;
+
+    state->mutableState.metrics.phaseDurations[phase] += duration;
+
+    return duration;
+}
+
 #include <unistd.h>
 
+typedef enum {
+    ImpactStateDerivedOptionNone = 0,
+    ImpactStateDerivedOptionNoTimeLimit = 1 << 0, // for reports written while the process keeps running
+    ImpactStateDerivedOptionReferencedImages = 1 << 1 // only log the images that frames fall within
+} ImpactStateDerivedOptions;
+
+// Sets up a state for writing reports of its own, configured like source but sharing none of its
+// files. Without a source, the configuration is left zeroed. Not async-signal-safe.
+void ImpactStateInitializeDerived(ImpactState* derived, const ImpactState* source, ImpactStateDerivedOptions options);
+
+// Makes the calling thread the only one diagnostics are written from once a crash is being handled.
+// Only the first call has any effect. Async-signal-safe.
+void ImpactStateClaimDiagnostics(ImpactState* state);
+
 void ImpactStateTransitionCtx(ImpactState* state, const char* logContext, ImpactCrashState expectedState, ImpactCrashState newState);
 _Noreturn void ImpactStateInvalidCtx(const char* logContext, ImpactCrashState invalidState);
 
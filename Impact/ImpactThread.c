@@ -11,11 +11,16 @@
 #include "ImpactLog.h"
 #include "ImpactCPU.h"
 #include "ImpactUnwind.h"
+#include "ImpactBinaryImage.h"
+#include "ImpactReportStore.h"
+#include "ImpactArena.h"
 
 #include <mach/mach_init.h>
 #include <mach/mach_port.h>
 #include <mach/vm_map.h>
 #include <mach/thread_act.h>
+#include <pthread.h>
+#include <string.h>
 
 ImpactResult ImpactThreadListInitialize(ImpactThreadList* list, thread_act_t crashedThread, const ImpactCPURegisters* crashedThreadRegisters) {
     if (ImpactInvalidPtr(list)) {
@@ -24,20 +29,23 @@ ImpactResult ImpactThreadListInitialize(ImpactThreadList* list, thread_act_t cra
 
     const kern_return_t kr = task_threads(mach_task_self(), &list->threads, &list->count);
     if (kr != KERN_SUCCESS) {
-        ImpactDebugLog("[Log:ERROR] unable to get threads %d\n", kr);
+        ImpactDebugLogError("[Log:ERROR] unable to get threads %d\n", kr);
         return ImpactResultFailure;
     }
 
     list->threadSelf = mach_thread_self();
 
+    // this does not produce a new port right, so it does not need to be deallocated
+    list->mainThread = pthread_mach_thread_np(pthread_main_thread_np());
+
     if (crashedThread == ImpactThreadAssumeSelfCrashed) {
         list->crashedThread = list->threadSelf;
     } else {
         list->crashedThread = crashedThread;
     }
 
-    if (!MACH_PORT_VALID(list->crashedThread)) {
-        ImpactDebugLog("[Log:WARN] crashed thread is invalid\n");
+    if (!MACH_PORT_VALID(list->crashedThread) && list->crashedThread != ImpactThreadNoneCrashed) {
+        ImpactDebugLogWarn("[Log:WARN] crashed thread is invalid\n");
     }
 
     list->crashedThreadRegisters = crashedThreadRegisters;
@@ -51,7 +59,7 @@ ImpactResult ImpactThreadListDeinitialize(ImpactThreadList* list) {
     for (mach_msg_type_number_t i = 0; i < list->count; ++i) {
         const kern_return_t kr = mach_port_deallocate(task, list->threads[i]);
         if (kr != KERN_SUCCESS) {
-            ImpactDebugLog("[Log:%s] unable to dealloc thread port %d\n", __func__, kr);
+            ImpactDebugLogWarn("[Log:%s] unable to dealloc thread port %d\n", __func__, kr);
         }
 
         list->threads[i] = MACH_PORT_NULL;
@@ -61,12 +69,12 @@ ImpactResult ImpactThreadListDeinitialize(ImpactThreadList* list) {
 
     kern_return_t kr = vm_deallocate(task, (vm_address_t)list->threads, size);
     if (kr != KERN_SUCCESS) {
-        ImpactDebugLog("[Log:%s] unable to dealloc thread storage %d\n", __func__, kr);
+        ImpactDebugLogWarn("[Log:%s] unable to dealloc thread storage %d\n", __func__, kr);
     }
 
     kr = mach_port_deallocate(task, list->threadSelf);
     if (kr != KERN_SUCCESS) {
-        ImpactDebugLog("[Log:%s] unable to dealloc self thread port %d\n", __func__, kr);
+        ImpactDebugLogWarn("[Log:%s] unable to dealloc self thread port %d\n", __func__, kr);
     }
 
     return ImpactResultSuccess;
@@ -88,7 +96,7 @@ ImpactResult ImpactThreadGetState(const ImpactThreadList* list, thread_act_t thr
 
     const kern_return_t kr = thread_get_state(thread, ImpactCPUThreadStateFlavor, state, &count);
     if (kr != KERN_SUCCESS) {
-        ImpactDebugLog("[Log:%s] unable to read thread state %d\n", __func__, kr);
+        ImpactDebugLogWarn("[Log:%s] unable to read thread state %d\n", __func__, kr);
         return ImpactResultFailure;
     }
 
@@ -113,7 +121,7 @@ static ImpactResult ImpactThreadListSuspendAllExceptForCurrent(const ImpactThrea
 
         const kern_return_t kr = thread_suspend(thread);
         if (kr != KERN_SUCCESS) {
-            ImpactDebugLog("[Log:%s] failed to suspend thread %d\n", __func__, kr);
+            ImpactDebugLogWarn("[Log:%s] failed to suspend thread %d\n", __func__, kr);
         }
     }
 
@@ -134,7 +142,7 @@ static ImpactResult ImpactThreadListResumeAllExceptForCurrent(const ImpactThread
 
         const kern_return_t kr = thread_resume(thread);
         if (kr != KERN_SUCCESS) {
-            ImpactDebugLog("[Log:%s] failed to suspend thread %d\n", __func__, kr);
+            ImpactDebugLogWarn("[Log:%s] failed to suspend thread %d\n", __func__, kr);
         }
     }
 
@@ -142,125 +150,713 @@ static ImpactResult ImpactThreadListResumeAllExceptForCurrent(const ImpactThread
 }
 #endif
 
-static ImpactResult ImpactThreadLogFrame(ImpactState* state, const ImpactCPURegisters* registers) {
-    if (ImpactInvalidPtr(state) || ImpactInvalidPtr(registers)) {
+static ImpactResult ImpactThreadGetFrame(const ImpactCPURegisters* registers, ImpactUnwindOutcome outcome, ImpactThreadFrame* frame) {
+    if (ImpactInvalidPtr(registers) || ImpactInvalidPtr(frame)) {
         return ImpactResultArgumentInvalid;
     }
 
-    ImpactLogger* log = ImpactStateGetLog(state);
-
-    ImpactLogWriteString(log, "[Thread:Frame] ");
-
-    uintptr_t value = 0;
-    ImpactResult result;
-
-    result = ImpactCPUGetRegister(registers, ImpactCPURegisterInstructionPointer, &value);
+    ImpactResult result = ImpactCPUGetRegister(registers, ImpactCPURegisterInstructionPointer, &frame->ip);
     if (result != ImpactResultSuccess) {
         return result;
     }
 
-    ImpactLogWriteKeyInteger(log, "ip", value, false);
-
-    result = ImpactCPUGetRegister(registers, ImpactCPURegisterStackPointer, &value);
+    result = ImpactCPUGetRegister(registers, ImpactCPURegisterStackPointer, &frame->sp);
     if (result != ImpactResultSuccess) {
         return result;
     }
 
-    ImpactLogWriteKeyInteger(log, "sp", value, false);
-
-    result = ImpactCPUGetRegister(registers, ImpactCPURegisterFramePointer, &value);
+    result = ImpactCPUGetRegister(registers, ImpactCPURegisterFramePointer, &frame->fp);
     if (result != ImpactResultSuccess) {
         return result;
     }
 
-    ImpactLogWriteKeyInteger(log, "fp", value, true);
+    frame->outcome = outcome;
 
     return ImpactResultSuccess;
 }
 
-static ImpactResult ImpactThreadLogStacktrace(ImpactState* state, const ImpactCPURegisters* registers) {
-    if (ImpactInvalidPtr(state) || ImpactInvalidPtr(registers)) {
+// While threads are being captured, this only looks the image up. Otherwise, it can also log it.
+static void ImpactThreadFindFrameImage(ImpactState* state, ImpactThreadFrame* frame) {
+    ImpactMachOData imageData = {0};
+
+    if (ImpactBinaryImageFind(state, frame->ip, &imageData) != ImpactResultSuccess) {
+        frame->imageUUID = NULL;
+        frame->imageIndex = ImpactBinaryImageNotFoundFlag;
+        frame->imageOffset = 0;
+
+        return;
+    }
+
+    frame->imageUUID = imageData.uuid;
+    frame->imageIndex = imageData.index;
+    frame->imageOffset = frame->ip - imageData.loadAddress;
+}
+
+// Frames are written relative to the image that contains them, which lets a reader symbolicate without
+// searching the image list. The stack pointer is written in full for the first frame of a thread, and as
+// a delta from the previous frame after that. The frame's image must already have been found.
+static ImpactResult ImpactThreadLogFrame(ImpactState* state, const ImpactThreadFrame* frame, uintptr_t* previousStackPointer, uint64_t* stackHash) {
+    if (ImpactInvalidPtr(state) || ImpactInvalidPtr(frame) || ImpactInvalidPtr(previousStackPointer)) {
+        return ImpactResultArgumentInvalid;
+    }
+
+    ImpactLogger* log = ImpactStateGetLog(state);
+    const uintptr_t ip = frame->ip;
+    const bool found = frame->imageIndex != ImpactBinaryImageNotFoundFlag;
+
+    // This has to happen before the record begins, because it can log the image.
+    if (found) {
+        ImpactBinaryImageNoteIndex(state, frame->imageIndex);
+    }
+
+    if (stackHash) {
+        *stackHash = found ? ImpactReportStoreStackHashAdd(*stackHash, frame->imageUUID, frame->imageOffset) : ImpactReportStoreStackHashAdd(*stackHash, NULL, ip);
+    }
+
+    ImpactLogBeginRecord(log, "Thread:Frame");
+
+    if (found) {
+        ImpactLogWriteKeyInteger(log, "image", frame->imageIndex, false);
+        ImpactLogWriteKeyInteger(log, "offset", frame->imageOffset, false);
+    } else {
+        ImpactLogWriteKeyInteger(log, "ip", ip, false);
+    }
+
+    if (*previousStackPointer == 0) {
+        ImpactLogWriteKeyInteger(log, "sp", frame->sp, false);
+    } else {
+        ImpactLogWriteKeySignedInteger(log, "sp_delta", (intptr_t)(frame->sp - *previousStackPointer), false);
+    }
+
+    *previousStackPointer = frame->sp;
+
+    ImpactLogWriteKeyInteger(log, "fp", frame->fp, false);
+    ImpactLogWriteKeyInteger(log, "unwind", (uint8_t)frame->outcome, true);
+
+    return ImpactResultSuccess;
+}
+
+static ImpactResult ImpactThreadLogTruncation(ImpactState* state, const char* section, uint32_t remaining) {
+    ImpactLogger* log = ImpactStateGetLog(state);
+
+    ImpactLogBeginRecord(log, "Truncated");
+    ImpactLogWriteKeyString(log, "section", section, false);
+    ImpactLogWriteKeyInteger(log, "reason", ImpactResultDeadlineExceeded, false);
+
+    return ImpactLogWriteKeyInteger(log, "remaining", remaining, true);
+}
+
+static ImpactResult ImpactThreadLogStacktrace(ImpactState* state, const ImpactThreadUnwindPolicy* policy, const ImpactCPURegisters* registers, uint64_t* stackHash) {
+    if (ImpactInvalidPtr(state) || ImpactInvalidPtr(policy) || ImpactInvalidPtr(registers)) {
         return ImpactResultArgumentInvalid;
     }
 
+    ImpactCrashMetrics* metrics = &state->mutableState.metrics;
     ImpactCPURegisters unwindRegisters = *registers;
 
-    // for now, impose a limit on how many frames we write out
-    for (uint32_t i = 0; i < 512; ++i) {
-        ImpactResult result = ImpactThreadLogFrame(state, &unwindRegisters);
+    // the first frame's registers come directly from the thread state
+    ImpactUnwindOutcome outcome = ImpactUnwindOutcomeThreadState;
+    uintptr_t previousStackPointer = 0;
+
+    for (uint32_t i = 0; i < policy->frameLimit; ++i) {
+        // always get at least the first frame out
+        if (i > 0 && ImpactStateDeadlineExceeded(state)) {
+            ImpactThreadLogTruncation(state, "frames", 0);
+
+            return ImpactResultDeadlineExceeded;
+        }
+
+        uint64_t* frameHash = i < ImpactReportStoreStackHashFrames ? stackHash : NULL;
+        ImpactThreadFrame frame = {0};
+
+        ImpactResult result = ImpactThreadGetFrame(&unwindRegisters, outcome, &frame);
+        if (result == ImpactResultSuccess) {
+            ImpactThreadFindFrameImage(state, &frame);
+
+            result = ImpactThreadLogFrame(state, &frame, &previousStackPointer, frameHash);
+        }
+
         if (result != ImpactResultSuccess) {
-            ImpactDebugLog("[Log:%s] failed to write frame %x\n", __func__, result);
+            ImpactDebugLogWarn("[Log:%s] failed to write frame %x\n", __func__, result);
         }
 
-        result = ImpactUnwindStepRegisters(state, &unwindRegisters);
+        metrics->unwindOutcomes[outcome] += 1;
+
+        result = ImpactUnwindStepRegisters(state, policy->strategies, &unwindRegisters, &outcome);
         switch (result) {
             case ImpactResultEndOfStack:
                 return ImpactResultSuccess;
             case ImpactResultSuccess:
                 break;
             default:
-                ImpactDebugLog("[Log:WARN] failed to step registers %x\n", result);
+                ImpactDebugLogWarn("[Log:WARN] failed to step registers %x\n", result);
+
+                if (result < ImpactResultCount) {
+                    metrics->unwindFailures[result] += 1;
+                }
+
                 return result;
         }
     }
 
-    ImpactDebugLog("[Log:%s] exceeded maximum number of frames\n", __func__);
+    ImpactDebugLogWarn("[Log:%s] exceeded maximum number of frames\n", __func__);
 
     return ImpactResultFailure;
 }
 
-ImpactResult ImpactThreadLog(ImpactState* state, const ImpactThreadList* list, thread_act_t thread) {
+static const ImpactThreadUnwindPolicy* ImpactThreadGetUnwindPolicy(const ImpactState* state, const ImpactThreadList* list, thread_act_t thread) {
+    const ImpactThreadUnwindPolicies* policies = &state->constantState.threadPolicies;
+
+    if (thread == list->crashedThread && MACH_PORT_VALID(thread)) {
+        return &policies->crashedThread;
+    }
+
+    if (thread == list->mainThread && MACH_PORT_VALID(thread)) {
+        return &policies->mainThread;
+    }
+
+    return &policies->otherThreads;
+}
+
+static ImpactResult ImpactThreadLog(ImpactState* state, const ImpactThreadList* list, thread_act_t thread) {
     if (ImpactInvalidPtr(state) || ImpactInvalidPtr(list)) {
         return ImpactResultArgumentInvalid;
     }
 
+    const ImpactThreadUnwindPolicy* policy = ImpactThreadGetUnwindPolicy(state, list, thread);
     ImpactCPURegisters registers = {0};
 
     ImpactResult result = ImpactThreadGetState(list, thread, &registers);
     if (result != ImpactResultSuccess) {
-        ImpactDebugLog("[Log:%s] failed to get thread state %d\n", __func__, result);
+        ImpactDebugLogWarn("[Log:%s] failed to get thread state %d\n", __func__, result);
         return result;
     }
 
-    result = ImpactCPURegistersLog(state, &registers);
-    if (result != ImpactResultSuccess) {
-        ImpactDebugLog("[Log:%s] failed to log thread state %d\n", __func__, result);
+    if (policy->logRegisters) {
+        result = ImpactCPURegistersLog(state, &registers);
+        if (result != ImpactResultSuccess) {
+            ImpactDebugLogWarn("[Log:%s] failed to log thread state %d\n", __func__, result);
+        }
+    } else {
+        // Keep a record per thread, so thread boundaries are still visible in the log.
+        ImpactLogger* log = ImpactStateGetLog(state);
+
+        ImpactLogBeginRecord(log, "Thread:State");
+        ImpactLogEndRecord(log);
     }
 
-    if (thread == list->crashedThread && MACH_PORT_VALID(thread)) {
+    const bool crashed = thread == list->crashedThread && MACH_PORT_VALID(thread);
+    uint64_t stackHash = ImpactReportStoreStackHashSeed;
+
+    if (crashed) {
         ImpactLogger* log = ImpactStateGetLog(state);
 
-        ImpactLogWriteString(log, "[Thread:Crashed]\n");
-        ImpactLogFlush(log);
+        ImpactLogBeginRecord(log, "Thread:Crashed");
+        ImpactLogEndRecord(log);
+    }
+
+    result = ImpactThreadLogStacktrace(state, policy, &registers, crashed ? &stackHash : NULL);
+
+    if (crashed) {
+        ImpactReportStoreRecordStackHash(state, stackHash);
+    }
+
+    if (result == ImpactResultDeadlineExceeded) {
+        return result;
     }
 
-    result = ImpactThreadLogStacktrace(state, &registers);
     if (result != ImpactResultSuccess) {
-        ImpactDebugLog("[Log:%s] failed to log thread stack trace %d\n", __func__, result);
+        ImpactDebugLogWarn("[Log:%s] failed to log thread stack trace %d\n", __func__, result);
     }
 
     return ImpactResultSuccess;
 }
 
-ImpactResult ImpactThreadListLog(ImpactState* state, const ImpactThreadList* list) {
+static ImpactResult ImpactThreadLogTimed(ImpactState* state, const ImpactThreadList* list, thread_act_t thread) {
+    ImpactCrashMetrics* metrics = &state->mutableState.metrics;
+    const uint64_t start = ImpactTimeGetMonotonicNanoseconds();
+
+    const ImpactResult result = ImpactThreadLog(state, list, thread);
+
+    const uint64_t duration = ImpactStateRecordPhase(state, ImpactCrashPhaseUnwind, start);
+
+    if (duration > metrics->slowestThreadDuration) {
+        metrics->slowestThreadDuration = duration;
+    }
+
+    return result;
+}
+
+static bool ImpactThreadListContains(const ImpactThreadList* list, thread_act_t thread) {
+    if (!MACH_PORT_VALID(thread)) {
+        return false;
+    }
+
+    for (mach_msg_type_number_t i = 0; i < list->count; ++i) {
+        if (list->threads[i] == thread) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool ImpactThreadListIsPrioritized(const ImpactThreadList* list, thread_act_t thread) {
+    if (!MACH_PORT_VALID(thread)) {
+        return false;
+    }
+
+    return thread == list->crashedThread || thread == list->mainThread;
+}
+
+static ImpactResult ImpactThreadListLogSuspended(ImpactState* state, const ImpactThreadList* list) {
     ImpactResult result = ImpactResultFailure;
 
+    uint64_t start = ImpactTimeGetMonotonicNanoseconds();
+
 #if IMPACT_THREADS_SUPPORTED
     result = ImpactThreadListSuspendAllExceptForCurrent(list);
 #endif
 
-    for (mach_msg_type_number_t i = 0; i < list->count; ++i) {
+    ImpactStateRecordPhase(state, ImpactCrashPhaseSuspend, start);
+    state->mutableState.metrics.suspendedAt = start;
+
+    state->mutableState.metrics.threadCount = list->count;
+
+    // Threads are written in priority order: crashed, main, and then everything else. If we run out of
+    // time, or get killed part-way through, the most important data is already on disk.
+    const thread_act_t prioritizedThreads[2] = {
+        list->crashedThread,
+        list->crashedThread == list->mainThread ? MACH_PORT_NULL : list->mainThread
+    };
+
+    uint32_t loggedCount = 0;
+    bool deadlineExceeded = false;
+
+    for (uint32_t i = 0; i < 2 && deadlineExceeded == false; ++i) {
+        const thread_act_t thread = prioritizedThreads[i];
+
+        if (ImpactThreadListContains(list, thread) == false) {
+            continue;
+        }
+
+        // the crashed thread always gets a chance, regardless of the deadline
+        if (i > 0 && ImpactStateDeadlineExceeded(state)) {
+            deadlineExceeded = true;
+            break;
+        }
+
+        result = ImpactThreadLogTimed(state, list, thread);
+        if (result == ImpactResultDeadlineExceeded) {
+            deadlineExceeded = true;
+        } else if (result != ImpactResultSuccess) {
+            ImpactDebugLogWarn("[Log:%s] failed to log prioritized thread %d %d\n", __func__, i, result);
+        }
+
+        loggedCount += 1;
+    }
+
+    for (mach_msg_type_number_t i = 0; i < list->count && deadlineExceeded == false; ++i) {
         const thread_act_t thread = list->threads[i];
 
-        result = ImpactThreadLog(state, list, thread);
-        if (result != ImpactResultSuccess) {
-            ImpactDebugLog("[Log:%s] failed to log thread %d %d\n", __func__, i, result);
+        if (ImpactThreadListIsPrioritized(list, thread)) {
+            continue;
+        }
+
+        if (ImpactStateDeadlineExceeded(state)) {
+            deadlineExceeded = true;
+            break;
+        }
+
+        result = ImpactThreadLogTimed(state, list, thread);
+        if (result == ImpactResultDeadlineExceeded) {
+            deadlineExceeded = true;
+        } else if (result != ImpactResultSuccess) {
+            ImpactDebugLogWarn("[Log:%s] failed to log thread %d %d\n", __func__, i, result);
         }
+
+        loggedCount += 1;
+    }
+
+    if (deadlineExceeded) {
+        ImpactThreadLogTruncation(state, "threads", list->count - loggedCount);
     }
 
+    ImpactThreadListResume(state, list);
+
+    return deadlineExceeded ? ImpactResultDeadlineExceeded : ImpactResultSuccess;
+}
+
+ImpactResult ImpactThreadListResume(ImpactState* state, const ImpactThreadList* list) {
+    if (ImpactInvalidPtr(state) || ImpactInvalidPtr(list)) {
+        return ImpactResultArgumentInvalid;
+    }
+
+    const uint64_t start = ImpactTimeGetMonotonicNanoseconds();
+    ImpactResult result = ImpactResultFailure;
+
 #if IMPACT_THREADS_SUPPORTED
     result = ImpactThreadListResumeAllExceptForCurrent(list);
 #endif
 
+    ImpactStateRecordPhase(state, ImpactCrashPhaseResume, start);
+
+    ImpactCrashMetrics* metrics = &state->mutableState.metrics;
+
+    metrics->suspendedDuration += ImpactTimeGetMonotonicNanoseconds() - metrics->suspendedAt;
+
+    return result;
+}
+
+#pragma mark - Sampling
+
+ImpactResult ImpactThreadSample(ImpactState* state, thread_act_t thread, uint32_t strategies, uintptr_t* ips, uint32_t limit, uint32_t* count) {
+    if (ImpactInvalidPtr(state) || ImpactInvalidPtr(ips) || ImpactInvalidPtr(count)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    *count = 0;
+
+#if IMPACT_THREADS_SUPPORTED
+    if (thread_suspend(thread) != KERN_SUCCESS) {
+        return ImpactResultCallFailed;
+    }
+
+    // nothing in here may allocate or take a lock, as the suspended thread could be holding it
+    const ImpactThreadList list = { .crashedThread = ImpactThreadNoneCrashed };
+    ImpactCPURegisters registers = {0};
+    ImpactUnwindOutcome outcome = ImpactUnwindOutcomeThreadState;
+
+    ImpactResult result = ImpactThreadGetState(&list, thread, &registers);
+
+    while (result == ImpactResultSuccess && *count < limit) {
+        result = ImpactCPUGetRegister(&registers, ImpactCPURegisterInstructionPointer, &ips[*count]);
+        if (result != ImpactResultSuccess) {
+            break;
+        }
+
+        *count += 1;
+
+        result = ImpactUnwindStepRegisters(state, strategies, &registers, &outcome);
+    }
+
+    thread_resume(thread);
+
+    return result;
+#else
+    return ImpactResultFailure;
+#endif
+}
+
+#pragma mark - Capture
+
+// Copies from the stack pointer up, stopping early at the end of the page if the full range isn't readable.
+static void ImpactThreadCaptureStack(ImpactState* state, ImpactThreadSnapshot* snapshot, uintptr_t sp) {
+    uint8_t* buffer = ImpactArenaAllocate(&state->mutableState.arena, ImpactThreadSnapshotStackSize, 16);
+    if (buffer == NULL) {
+        return;
+    }
+
+    vm_size_t length = ImpactThreadSnapshotStackSize;
+    vm_size_t copied = 0;
+
+    kern_return_t kr = vm_read_overwrite(mach_task_self(), sp, length, (vm_address_t)buffer, &copied);
+    if (kr != KERN_SUCCESS) {
+        const vm_size_t toPageEnd = vm_page_size - (sp % vm_page_size);
+
+        length = toPageEnd < length ? toPageEnd : length;
+        kr = vm_read_overwrite(mach_task_self(), sp, length, (vm_address_t)buffer, &copied);
+    }
+
+    if (kr != KERN_SUCCESS) {
+        ImpactArenaTrim(&state->mutableState.arena, buffer, ImpactThreadSnapshotStackSize, 0);
+        return;
+    }
+
+    ImpactArenaTrim(&state->mutableState.arena, buffer, ImpactThreadSnapshotStackSize, copied);
+
+    snapshot->stackAddress = sp;
+    snapshot->stack = buffer;
+    snapshot->stackLength = (uint32_t)copied;
+}
+
+// Frames are reserved for the policy's limit, or whatever the arena has left, and trimmed afterwards.
+static ImpactResult ImpactThreadCaptureFrames(ImpactState* state, const ImpactThreadUnwindPolicy* policy, const ImpactCPURegisters* registers, ImpactThreadSnapshot* snapshot) {
+    ImpactArena* arena = &state->mutableState.arena;
+    ImpactCrashMetrics* metrics = &state->mutableState.metrics;
+
+    const size_t available = ImpactArenaGetAvailable(arena) / sizeof(ImpactThreadFrame);
+    const uint32_t capacity = policy->frameLimit < available ? policy->frameLimit : (uint32_t)available;
+
+    ImpactThreadFrame* frames = capacity > 0 ? ImpactArenaAllocate(arena, capacity * sizeof(ImpactThreadFrame), _Alignof(ImpactThreadFrame)) : NULL;
+    if (frames == NULL) {
+        return ImpactResultFailure;
+    }
+
+    ImpactCPURegisters unwindRegisters = *registers;
+    ImpactUnwindOutcome outcome = ImpactUnwindOutcomeThreadState;
+    ImpactResult result = ImpactResultFailure;
+    uint32_t count = 0;
+
+    while (count < capacity) {
+        if (count > 0 && ImpactStateDeadlineExceeded(state)) {
+            result = ImpactResultDeadlineExceeded;
+            break;
+        }
+
+        result = ImpactThreadGetFrame(&unwindRegisters, outcome, &frames[count]);
+        if (result != ImpactResultSuccess) {
+            break;
+        }
+
+        // the unwinder looks up the same address next, so this mostly hits the cache
+        ImpactThreadFindFrameImage(state, &frames[count]);
+
+        count += 1;
+        metrics->unwindOutcomes[outcome] += 1;
+
+        result = ImpactUnwindStepRegisters(state, policy->strategies, &unwindRegisters, &outcome);
+        if (result == ImpactResultEndOfStack) {
+            result = ImpactResultSuccess;
+            break;
+        }
+
+        if (result != ImpactResultSuccess) {
+            if (result < ImpactResultCount) {
+                metrics->unwindFailures[result] += 1;
+            }
+
+            break;
+        }
+
+        // running out of room without reaching the end of the stack
+        result = ImpactResultFailure;
+    }
+
+    ImpactArenaTrim(arena, frames, capacity * sizeof(ImpactThreadFrame), count * sizeof(ImpactThreadFrame));
+
+    snapshot->frames = count > 0 ? frames : NULL;
+    snapshot->frameCount = count;
+
+    return result;
+}
+
+static void ImpactThreadCapture(ImpactState* state, const ImpactThreadList* list, thread_act_t thread, ImpactThreadSnapshot* snapshot) {
+    ImpactCrashMetrics* metrics = &state->mutableState.metrics;
+    const uint64_t start = ImpactTimeGetMonotonicNanoseconds();
+
+    const ImpactThreadUnwindPolicy* policy = ImpactThreadGetUnwindPolicy(state, list, thread);
+    ImpactCPURegisters registers = {0};
+
+    snapshot->thread = thread;
+    snapshot->unwindResult = ImpactResultFailure;
+    snapshot->stateResult = ImpactThreadGetState(list, thread, &registers);
+
+    if (snapshot->stateResult == ImpactResultSuccess) {
+        if (policy->logRegisters) {
+            snapshot->registers = ImpactArenaAllocate(&state->mutableState.arena, sizeof(ImpactCPURegisters), _Alignof(ImpactCPURegisters));
+
+            if (snapshot->registers) {
+                *snapshot->registers = registers;
+            }
+        }
+
+        uintptr_t sp = 0;
+
+        if (thread == list->crashedThread && ImpactCPUGetRegister(&registers, ImpactCPURegisterStackPointer, &sp) == ImpactResultSuccess) {
+            ImpactThreadCaptureStack(state, snapshot, sp);
+        }
+
+        snapshot->unwindResult = ImpactThreadCaptureFrames(state, policy, &registers, snapshot);
+    }
+
+    const uint64_t duration = ImpactStateRecordPhase(state, ImpactCrashPhaseUnwind, start);
+
+    if (duration > metrics->slowestThreadDuration) {
+        metrics->slowestThreadDuration = duration;
+    }
+}
+
+ImpactResult ImpactThreadListCapture(ImpactState* state, const ImpactThreadList* list, ImpactThreadListSnapshot* snapshot) {
+    if (ImpactInvalidPtr(state) || ImpactInvalidPtr(list) || ImpactInvalidPtr(snapshot)) {
+        return ImpactResultArgumentInvalid;
+    }
+
+    ImpactArena* arena = &state->mutableState.arena;
+
+    // Checked before anything is suspended, so the caller can fall back to writing threads directly.
+    snapshot->threads = ImpactArenaAllocate(arena, list->count * sizeof(ImpactThreadSnapshot), _Alignof(ImpactThreadSnapshot));
+    snapshot->count = 0;
+    snapshot->remaining = 0;
+
+    if (snapshot->threads == NULL) {
+        return ImpactResultFailure;
+    }
+
+    memset(snapshot->threads, 0, list->count * sizeof(ImpactThreadSnapshot));
+
+    // While capturing, images are only looked up. They are written later, along with the frames.
+    state->mutableState.images.deferLogging = true;
+
+    const uint64_t start = ImpactTimeGetMonotonicNanoseconds();
+
+#if IMPACT_THREADS_SUPPORTED
+    ImpactThreadListSuspendAllExceptForCurrent(list);
+#endif
+
+    ImpactStateRecordPhase(state, ImpactCrashPhaseSuspend, start);
+    state->mutableState.metrics.suspendedAt = start;
+    state->mutableState.metrics.threadCount = list->count;
+
+    const thread_act_t prioritizedThreads[2] = {
+        list->crashedThread,
+        list->crashedThread == list->mainThread ? MACH_PORT_NULL : list->mainThread
+    };
+
+    bool deadlineExceeded = false;
+
+    for (uint32_t i = 0; i < 2 && deadlineExceeded == false; ++i) {
+        const thread_act_t thread = prioritizedThreads[i];
+
+        if (ImpactThreadListContains(list, thread) == false) {
+            continue;
+        }
+
+        // the crashed thread always gets a chance, regardless of the deadline
+        if (i > 0 && ImpactStateDeadlineExceeded(state)) {
+            deadlineExceeded = true;
+            break;
+        }
+
+        ImpactThreadCapture(state, list, thread, &snapshot->threads[snapshot->count]);
+        snapshot->count += 1;
+    }
+
+    for (mach_msg_type_number_t i = 0; i < list->count && deadlineExceeded == false; ++i) {
+        const thread_act_t thread = list->threads[i];
+
+        if (ImpactThreadListIsPrioritized(list, thread)) {
+            continue;
+        }
+
+        if (ImpactStateDeadlineExceeded(state)) {
+            deadlineExceeded = true;
+            break;
+        }
+
+        ImpactThreadCapture(state, list, thread, &snapshot->threads[snapshot->count]);
+        snapshot->count += 1;
+    }
+
+    // The lookup cache could now point past the last image written, which would let a frame be written
+    // before its image.
+    state->mutableState.images.deferLogging = false;
+    state->mutableState.images.lastFoundIndex = ImpactBinaryImageNotFoundFlag;
+
+    if (deadlineExceeded) {
+        snapshot->remaining = list->count - snapshot->count;
+
+        return ImpactResultDeadlineExceeded;
+    }
+
     return ImpactResultSuccess;
 }
+
+static ImpactResult ImpactThreadSnapshotLogThread(ImpactState* state, const ImpactThreadList* list, const ImpactThreadSnapshot* snapshot) {
+    ImpactLogger* log = ImpactStateGetLog(state);
+    const thread_act_t thread = snapshot->thread;
+
+    if (snapshot->stateResult != ImpactResultSuccess) {
+        ImpactDebugLogWarn("[Log:%s] failed to get thread state %d\n", __func__, snapshot->stateResult);
+        return snapshot->stateResult;
+    }
+
+    if (snapshot->registers) {
+        ImpactCPURegistersLog(state, snapshot->registers);
+    } else {
+        ImpactLogBeginRecord(log, "Thread:State");
+        ImpactLogEndRecord(log);
+    }
+
+    const bool crashed = thread == list->crashedThread && MACH_PORT_VALID(thread);
+    uint64_t stackHash = ImpactReportStoreStackHashSeed;
+
+    if (crashed) {
+        ImpactLogBeginRecord(log, "Thread:Crashed");
+        ImpactLogEndRecord(log);
+    }
+
+    if (snapshot->stack) {
+        ImpactLogBeginRecord(log, "Thread:Stack");
+        ImpactLogWriteKeyInteger(log, "address", snapshot->stackAddress, false);
+        ImpactLogWriteKeyHexData(log, "bytes", snapshot->stack, snapshot->stackLength, true);
+    }
+
+    uintptr_t previousStackPointer = 0;
+
+    for (uint32_t i = 0; i < snapshot->frameCount; ++i) {
+        uint64_t* frameHash = crashed && i < ImpactReportStoreStackHashFrames ? &stackHash : NULL;
+
+        ImpactThreadLogFrame(state, &snapshot->frames[i], &previousStackPointer, frameHash);
+    }
+
+    if (crashed) {
+        ImpactReportStoreRecordStackHash(state, stackHash);
+    }
+
+    if (snapshot->unwindResult == ImpactResultDeadlineExceeded) {
+        ImpactThreadLogTruncation(state, "frames", 0);
+    }
+
+    return snapshot->unwindResult;
+}
+
+ImpactResult ImpactThreadListSnapshotLog(ImpactState* state, const ImpactThreadList* list, const ImpactThreadListSnapshot* snapshot) {
+    if (ImpactInvalidPtr(state) || ImpactInvalidPtr(list) || ImpactInvalidPtr(snapshot)) {
+        return ImpactResultArgumentInvalid;
+    }
+
+    const uint64_t start = ImpactTimeGetMonotonicNanoseconds();
+    uint32_t remaining = snapshot->remaining;
+
+    for (uint32_t i = 0; i < snapshot->count; ++i) {
+        // everything here was captured in time, but writing it has its own cost
+        if (i > 0 && ImpactStateDeadlineExceeded(state)) {
+            remaining += snapshot->count - i;
+            break;
+        }
+
+        const ImpactResult result = ImpactThreadSnapshotLogThread(state, list, &snapshot->threads[i]);
+        if (result != ImpactResultSuccess && result != ImpactResultDeadlineExceeded) {
+            ImpactDebugLogWarn("[Log:%s] failed to log thread %d %d\n", __func__, i, result);
+        }
+    }
+
+    if (remaining > 0) {
+        ImpactThreadLogTruncation(state, "threads", remaining);
+    }
+
+    ImpactStateRecordPhase(state, ImpactCrashPhaseFormat, start);
+
+    return remaining > 0 ? ImpactResultDeadlineExceeded : ImpactResultSuccess;
+}
+
+ImpactResult ImpactThreadListLog(ImpactState* state, const ImpactThreadList* list) {
+    if (ImpactInvalidPtr(state) || ImpactInvalidPtr(list)) {
+        return ImpactResultArgumentInvalid;
+    }
+
+    ImpactThreadListSnapshot snapshot = {0};
+
+    ImpactResult result = ImpactThreadListCapture(state, list, &snapshot);
+    if (result != ImpactResultSuccess && result != ImpactResultDeadlineExceeded) {
+        // no room in the arena, so write threads as they are unwound instead
+        return ImpactThreadListLogSuspended(state, list);
+    }
+
+    result = ImpactThreadListSnapshotLog(state, list, &snapshot);
+
+    ImpactThreadListResume(state, list);
+
+    return result;
+}
@@ -24,14 +24,76 @@ typedef struct {
     mach_msg_type_number_t count;
 
     thread_act_t threadSelf;
+    thread_act_t mainThread;
     thread_act_t crashedThread;
     const ImpactCPURegisters* crashedThreadRegisters;
 } ImpactThreadList;
 
 static const thread_act_t ImpactThreadAssumeSelfCrashed = MACH_PORT_NULL;
+// for capturing threads when nothing has crashed
+static const thread_act_t ImpactThreadNoneCrashed = MACH_PORT_DEAD;
+
+enum {
+    // bytes copied from the crashed thread's stack, starting at its stack pointer
+    ImpactThreadSnapshotStackSize = 1024
+};
+
+typedef struct {
+    uintptr_t ip;
+    uintptr_t sp;
+    uintptr_t fp;
+    ImpactUnwindOutcome outcome;
+
+    // found along with the frame, so writing it never has to search the images again
+    const uint8_t* imageUUID;
+    uint32_t imageIndex; // ImpactBinaryImageNotFoundFlag when no image contains ip
+    uintptr_t imageOffset;
+} ImpactThreadFrame;
+
+// Everything needed to write a thread, copied while threads are suspended. Only the registers of
+// threads whose policy logs them are kept.
+typedef struct {
+    thread_act_t thread;
+    ImpactResult stateResult;
+    ImpactResult unwindResult;
+    ImpactCPURegisters* registers;
+
+    ImpactThreadFrame* frames;
+    uint32_t frameCount;
+
+    uintptr_t stackAddress;
+    const uint8_t* stack;
+    uint32_t stackLength;
+} ImpactThreadSnapshot;
+
+// Threads are in priority order: crashed, main, and then everything else.
+typedef struct {
+    ImpactThreadSnapshot* threads;
+    uint32_t count;
+    uint32_t remaining; // not captured, because the deadline passed
+} ImpactThreadListSnapshot;
 
 ImpactResult ImpactThreadListInitialize(ImpactThreadList* list, thread_act_t crashedThread, const ImpactCPURegisters* crashedThreadRegisters);
 ImpactResult ImpactThreadListDeinitialize(ImpactThreadList* list);
+
+// Uses the crashed thread's registers, when the list has them, and asks the kernel otherwise. The thread
+// should be suspended.
+ImpactResult ImpactThreadGetState(const ImpactThreadList* list, thread_act_t thread, ImpactCPURegisters* registers);
+
+// Suspends a running thread just long enough to unwind it, writing up to limit instruction pointers,
+// innermost first. Returns ImpactResultSuccess if the stack went deeper than the limit, and
+// ImpactResultEndOfStack if it was unwound completely. Not for use while a crash is being handled.
+ImpactResult ImpactThreadSample(ImpactState* state, thread_act_t thread, uint32_t strategies, uintptr_t* ips, uint32_t limit, uint32_t* count);
+
+// Writes every thread. With an arena, threads are captured into it while suspended and then written,
+// and otherwise they are written while suspended. Threads stay suspended until everything is written,
+// so nothing can interfere with a crash.
 ImpactResult ImpactThreadListLog(ImpactState* state, const ImpactThreadList* list);
 
+// The two halves of ImpactThreadListLog. Capturing suspends threads and leaves them that way, so
+// non-fatal callers should resume before writing.
+ImpactResult ImpactThreadListCapture(ImpactState* state, const ImpactThreadList* list, ImpactThreadListSnapshot* snapshot);
+ImpactResult ImpactThreadListResume(ImpactState* state, const ImpactThreadList* list);
+ImpactResult ImpactThreadListSnapshotLog(ImpactState* state, const ImpactThreadList* list, const ImpactThreadListSnapshot* snapshot);
+
 #endif /* ImpactThread_h */
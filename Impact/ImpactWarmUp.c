@@ -0,0 +1,175 @@
+//
+//  ImpactWarmUp.c
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#include "ImpactWarmUp.h"
+#include "ImpactUtility.h"
+#include "ImpactBinaryImage.h"
+#include "ImpactCrashHandler.h"
+#include "ImpactLog.h"
+
+#include <dlfcn.h>
+#include <mach-o/dyld.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Images that nearly every crashed stack passes through.
+static const char* const ImpactWarmUpUnwindImages[] = {
+    "libsystem_kernel.dylib",
+    "libsystem_pthread.dylib",
+    "libsystem_platform.dylib",
+    "libsystem_c.dylib",
+    "libdyld.dylib",
+    "libobjc.A.dylib",
+    "libdispatch.dylib",
+    "libswiftCore.dylib",
+    "CoreFoundation",
+    "Foundation",
+    "UIKitCore",
+    "AppKit"
+};
+
+ImpactResult ImpactWarmUpRange(const void* address, size_t length, bool lock, ImpactWarmUpStatistics* statistics) {
+    if (ImpactInvalidPtr(address) || ImpactInvalidPtr(statistics)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    if (length == 0) {
+        return ImpactResultSuccess;
+    }
+
+    const uintptr_t pageSize = (uintptr_t)getpagesize();
+    const uintptr_t start = (uintptr_t)address & ~(pageSize - 1);
+    const uintptr_t end = ((uintptr_t)address + length + pageSize - 1) & ~(pageSize - 1);
+
+    // a hint, so the reads below don't each wait on their own I/O
+    madvise((void*)start, end - start, MADV_WILLNEED);
+
+    for (uintptr_t page = start; page < end; page += pageSize) {
+        (void)*(volatile const uint8_t*)page;
+    }
+
+    statistics->ranges += 1;
+    statistics->touchedBytes += end - start;
+
+    if (!lock || end - start > ImpactWarmUpLockLimit) {
+        return ImpactResultSuccess;
+    }
+
+    if (mlock((const void*)start, end - start) != 0) {
+        statistics->lockFailures += 1;
+
+        return ImpactResultCallFailed;
+    }
+
+    statistics->lockedBytes += end - start;
+
+    return ImpactResultSuccess;
+}
+
+static bool ImpactWarmUpIsUnwindImage(const char* path) {
+    if (ImpactInvalidPtr(path)) {
+        return false;
+    }
+
+    const char* name = strrchr(path, '/');
+
+    name = name ? name + 1 : path;
+
+    for (size_t i = 0; i < sizeof(ImpactWarmUpUnwindImages) / sizeof(ImpactWarmUpUnwindImages[0]); ++i) {
+        if (strcmp(name, ImpactWarmUpUnwindImages[i]) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void ImpactWarmUpUnwindSections(bool lock, ImpactWarmUpStatistics* statistics) {
+    const uint32_t count = _dyld_image_count();
+
+    for (uint32_t i = 0; i < count; ++i) {
+        const char* path = _dyld_get_image_name(i);
+
+        // the main executable is always the first image
+        if (i > 0 && !ImpactWarmUpIsUnwindImage(path)) {
+            continue;
+        }
+
+        const ImpactMachOHeader* header = (const ImpactMachOHeader*)_dyld_get_image_header(i);
+        ImpactMachOData data = {0};
+
+        if (ImpactInvalidPtr(header) || ImpactBinaryImageGetData(header, path, &data) != ImpactResultSuccess) {
+            continue;
+        }
+
+        if (data.unwindInfoRegion.address != 0) {
+            ImpactWarmUpRange((const void*)data.unwindInfoRegion.address, data.unwindInfoRegion.length, lock, statistics);
+        }
+
+        if (data.ehFrameRegion.address != 0) {
+            ImpactWarmUpRange((const void*)data.ehFrameRegion.address, data.ehFrameRegion.length, lock, statistics);
+        }
+    }
+}
+
+ImpactResult ImpactWarmUp(ImpactState* state, ImpactWarmUpOptions options, ImpactWarmUpStatistics* statistics) {
+    if (ImpactInvalidPtr(state) || ImpactInvalidPtr(statistics)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    memset(statistics, 0, sizeof(ImpactWarmUpStatistics));
+
+    const bool lock = (options & ImpactWarmUpOptionLock) != 0;
+
+    // Failures to lock are counted rather than returned. The usual cause is RLIMIT_MEMLOCK, and touching
+    // the pages is still worthwhile without it.
+    Dl_info info = {0};
+
+    if (dladdr((const void*)ImpactCrashHandler, &info) != 0 && info.dli_fbase != NULL) {
+        ImpactMachOData data = {0};
+
+        if (ImpactBinaryImageGetData(info.dli_fbase, info.dli_fname, &data) == ImpactResultSuccess) {
+            ImpactWarmUpRange(info.dli_fbase, data.textSize, lock, statistics);
+        }
+    }
+
+    ImpactWarmUpRange(state, sizeof(ImpactState), lock, statistics);
+
+    const ImpactArena* arena = &state->mutableState.arena;
+
+    if (arena->base) {
+        ImpactWarmUpRange(arena->base, arena->size, lock, statistics);
+    }
+
+    const ImpactLogMapping* mapping = &state->mutableState.log.mapping;
+
+    if (mapping->base) {
+        ImpactWarmUpRange(mapping->base, mapping->size, lock, statistics);
+    }
+
+    if (options & ImpactWarmUpOptionUnwindSections) {
+        ImpactWarmUpUnwindSections(lock, statistics);
+    }
+
+    return ImpactResultSuccess;
+}
+
+ImpactResult ImpactWarmUpLogStatistics(ImpactState* state, const ImpactWarmUpStatistics* statistics) {
+    if (ImpactInvalidPtr(state) || ImpactInvalidPtr(statistics)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    ImpactLogger* log = ImpactStateGetLog(state);
+
+    ImpactLogBeginRecord(log, "WarmUp");
+    ImpactLogWriteKeyInteger(log, "ranges", statistics->ranges, false);
+    ImpactLogWriteKeyInteger(log, "touched", statistics->touchedBytes, false);
+    ImpactLogWriteKeyInteger(log, "locked", statistics->lockedBytes, false);
+
+    return ImpactLogWriteKeyInteger(log, "lock_failures", statistics->lockFailures, true);
+}
@@ -0,0 +1,50 @@
+//
+//  ImpactWarmUp.h
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#ifndef ImpactWarmUp_h
+#define ImpactWarmUp_h
+
+#include "ImpactState.h"
+#include "ImpactResult.h"
+
+#include <stdbool.h>
+
+__BEGIN_DECLS
+
+typedef enum {
+    ImpactWarmUpOptionNone = 0,
+    // wire pages as well as touching them, so they cannot be paged out again
+    ImpactWarmUpOptionLock = 1 << 0,
+    // read ahead the unwind sections of the main executable and the system libraries most stacks go through
+    ImpactWarmUpOptionUnwindSections = 1 << 1
+} ImpactWarmUpOptions;
+
+enum {
+    // Larger ranges are still touched, but not locked. This mostly matters when Impact is linked
+    // statically, because the code range is then the whole executable.
+    ImpactWarmUpLockLimit = 16 * 1024 * 1024
+};
+
+typedef struct {
+    uint32_t ranges;
+    size_t touchedBytes;
+    size_t lockedBytes;
+    uint32_t lockFailures;
+} ImpactWarmUpStatistics;
+
+// Touches every page in a range, and optionally locks it. Not async-signal-safe.
+ImpactResult ImpactWarmUpRange(const void* address, size_t length, bool lock, ImpactWarmUpStatistics* statistics);
+
+// Warms up what the crash handler needs: Impact's code, the state, the arena and the report mapping.
+// Not async-signal-safe.
+ImpactResult ImpactWarmUp(ImpactState* state, ImpactWarmUpOptions options, ImpactWarmUpStatistics* statistics);
+
+ImpactResult ImpactWarmUpLogStatistics(ImpactState* state, const ImpactWarmUpStatistics* statistics);
+
+__END_DECLS
+
+#endif /* ImpactWarmUp_h */
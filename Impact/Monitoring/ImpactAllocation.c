@@ -0,0 +1,551 @@
+//
+//  ImpactAllocation.c
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#include "ImpactAllocation.h"
+#include "ImpactUtility.h"
+#include "ImpactUnwind.h"
+#include "ImpactBinaryImage.h"
+#include "ImpactLog.h"
+#include "ImpactTime.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// libmalloc calls this, when set, for every allocation and deallocation in every zone. It is how the
+// system's own memory tools work, and unlike a custom zone it also sees the default zone.
+typedef void (ImpactMallocLogger)(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t hotFramesToSkip);
+
+extern ImpactMallocLogger* malloc_logger;
+
+enum {
+    ImpactMallocLogTypeAllocate = 2,
+    ImpactMallocLogTypeDeallocate = 4,
+    ImpactMallocLogTypeHasZone = 8,
+    ImpactMallocLogTypeVMAllocate = 16,
+    ImpactMallocLogTypeVMDeallocate = 32,
+    ImpactMallocLogTypeCleared = 64
+};
+
+static ImpactAllocationSampler* _Atomic ImpactAllocationInstalledSampler = NULL;
+static ImpactMallocLogger* ImpactAllocationPreviousLogger = NULL;
+static pthread_once_t ImpactAllocationLoggerOnce = PTHREAD_ONCE_INIT;
+
+static const size_t ImpactAllocationStacksSize = sizeof(ImpactAllocationStack) * ImpactAllocationStackCapacity;
+static const size_t ImpactAllocationLiveSize = sizeof(ImpactAllocationLive) * ImpactAllocationLiveCapacity;
+static const size_t ImpactAllocationSnapshotOffset = ImpactAllocationStacksSize + ImpactAllocationLiveSize + ImpactAllocationFilterSize;
+static const size_t ImpactAllocationTablesSize = ImpactAllocationSnapshotOffset + sizeof(ImpactState);
+
+ImpactResult ImpactAllocationSamplerInitialize(ImpactAllocationSampler* sampler, const ImpactState* source, uint64_t interval, uint32_t strategies) {
+    if (ImpactInvalidPtr(sampler)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    if (interval == 0 || (strategies & ImpactUnwindStrategyAll) == 0) {
+        return ImpactResultArgumentInvalid;
+    }
+
+    memset(sampler, 0, sizeof(ImpactAllocationSampler));
+
+    ImpactState* state = &sampler->state;
+
+    ImpactStateInitializeDerived(state, source, ImpactStateDerivedOptionNone);
+
+    sampler->interval = interval;
+    sampler->strategies = strategies & ImpactUnwindStrategyAll;
+    sampler->unwindLock = OS_UNFAIR_LOCK_INIT;
+    sampler->snapshotLock = OS_UNFAIR_LOCK_INIT;
+
+    atomic_store(&sampler->seed, ImpactTimeGetMonotonicNanoseconds() ^ (uint64_t)(uintptr_t)sampler);
+
+    if (pthread_key_create(&sampler->countdownKey, NULL) != 0) {
+        return ImpactResultCallFailed;
+    }
+
+    uint8_t* tables = mmap(NULL, ImpactAllocationTablesSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (tables == MAP_FAILED) {
+        pthread_key_delete(sampler->countdownKey);
+        return ImpactResultCallFailed;
+    }
+
+    sampler->stacks = (ImpactAllocationStack*)tables;
+    sampler->live = (ImpactAllocationLive*)(tables + ImpactAllocationStacksSize);
+    sampler->filter = (_Atomic uint8_t*)(tables + ImpactAllocationStacksSize + ImpactAllocationLiveSize);
+    sampler->snapshotState = (ImpactState*)(tables + ImpactAllocationSnapshotOffset);
+
+    // unwinding with tables looks up images, but must never log them from inside malloc
+    ImpactResult result = ImpactBinaryImageInitialize(state);
+    if (result != ImpactResultSuccess) {
+        munmap(tables, ImpactAllocationTablesSize);
+        pthread_key_delete(sampler->countdownKey);
+        return result;
+    }
+
+    state->mutableState.images.deferLogging = true;
+
+    atomic_store(&sampler->enabled, true);
+
+    return ImpactResultSuccess;
+}
+
+ImpactResult ImpactAllocationSamplerDeinitialize(ImpactAllocationSampler* sampler) {
+    if (ImpactInvalidPtr(sampler)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    if (sampler->installed) {
+        return ImpactResultStateInvalid;
+    }
+
+    atomic_store(&sampler->enabled, false);
+
+    if (sampler->stacks && munmap(sampler->stacks, ImpactAllocationTablesSize) != 0) {
+        return ImpactResultCallFailed;
+    }
+
+    pthread_key_delete(sampler->countdownKey);
+
+    sampler->stacks = NULL;
+    sampler->live = NULL;
+    sampler->filter = NULL;
+    sampler->snapshotState = NULL;
+
+    return ImpactResultSuccess;
+}
+
+#pragma mark - Sampling
+
+static uint64_t ImpactAllocationHashAddress(uintptr_t address) {
+    uint64_t hash = (uint64_t)address;
+
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+
+    return hash;
+}
+
+// Exponentially-distributed gaps between samples make every byte equally likely to be sampled, no matter
+// the pattern of allocation sizes.
+static uintptr_t ImpactAllocationDrawCountdown(ImpactAllocationSampler* sampler) {
+    uint64_t x = atomic_fetch_add_explicit(&sampler->seed, 0x9e3779b97f4a7c15ULL, memory_order_relaxed) + 0x9e3779b97f4a7c15ULL;
+
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    x = x ^ (x >> 31);
+
+    // uniform over (0, 1]
+    const double uniform = (double)((x >> 11) + 1) * 0x1.0p-53;
+    const double countdown = -log(uniform) * (double)sampler->interval;
+
+    return countdown < 1.0 ? 1 : (uintptr_t)countdown;
+}
+
+// The chance of an allocation being sampled grows with its size, so its estimated share of the total is
+// its size over that chance.
+static int64_t ImpactAllocationWeight(const ImpactAllocationSampler* sampler, size_t size) {
+    const double probability = -expm1(-(double)size / (double)sampler->interval);
+
+    return (int64_t)((double)size / probability);
+}
+
+static void ImpactAllocationFilterAdjust(ImpactAllocationSampler* sampler, uintptr_t address, int delta) {
+    _Atomic uint8_t* counter = &sampler->filter[ImpactAllocationHashAddress(address) % ImpactAllocationFilterSize];
+    uint8_t value = atomic_load_explicit(counter, memory_order_relaxed);
+
+    // a saturated counter sticks, which only costs frees in that bucket a table lookup
+    while (value != UINT8_MAX) {
+        if (atomic_compare_exchange_weak_explicit(counter, &value, (uint8_t)(value + delta), memory_order_release, memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
+static bool ImpactAllocationLiveInsert(ImpactAllocationSampler* sampler, uintptr_t address, uint32_t stack, int64_t weight) {
+    const uint64_t hash = ImpactAllocationHashAddress(address) >> 32;
+
+    for (uint32_t probe = 0; probe < ImpactAllocationProbeLimit; ++probe) {
+        ImpactAllocationLive* live = &sampler->live[(hash + probe) % ImpactAllocationLiveCapacity];
+        uintptr_t existing = atomic_load_explicit(&live->address, memory_order_relaxed);
+
+        if (existing != ImpactAllocationLiveEmpty && existing != ImpactAllocationLiveRemoved) {
+            continue;
+        }
+
+        if (atomic_compare_exchange_strong(&live->address, &existing, ImpactAllocationLiveReserved) == false) {
+            continue;
+        }
+
+        live->stack = stack;
+        live->weight = weight;
+
+        ImpactAllocationFilterAdjust(sampler, address, 1);
+
+        atomic_store_explicit(&live->address, address, memory_order_release);
+
+        return true;
+    }
+
+    return false;
+}
+
+static bool ImpactAllocationLiveRemove(ImpactAllocationSampler* sampler, uintptr_t address, uint32_t* stack, int64_t* weight) {
+    const uint64_t hash = ImpactAllocationHashAddress(address) >> 32;
+
+    for (uint32_t probe = 0; probe < ImpactAllocationProbeLimit; ++probe) {
+        ImpactAllocationLive* live = &sampler->live[(hash + probe) % ImpactAllocationLiveCapacity];
+        uintptr_t existing = atomic_load_explicit(&live->address, memory_order_acquire);
+
+        if (existing == ImpactAllocationLiveEmpty) {
+            return false;
+        }
+
+        if (existing != address) {
+            continue;
+        }
+
+        *stack = live->stack;
+        *weight = live->weight;
+
+        if (atomic_compare_exchange_strong(&live->address, &existing, ImpactAllocationLiveRemoved) == false) {
+            return false;
+        }
+
+        ImpactAllocationFilterAdjust(sampler, address, -1);
+
+        return true;
+    }
+
+    return false;
+}
+
+static uint64_t ImpactAllocationHashFrames(const uintptr_t* frames, uint32_t count) {
+    uint64_t hash = 14695981039346656037ULL;
+
+    for (uint32_t i = 0; i < count; ++i) {
+        hash = (hash ^ frames[i]) * 1099511628211ULL;
+    }
+
+    return hash == 0 ? 1 : hash;
+}
+
+static bool ImpactAllocationFindStack(ImpactAllocationSampler* sampler, const uintptr_t* frames, uint32_t count, uint32_t* index) {
+    const uint64_t hash = ImpactAllocationHashFrames(frames, count);
+
+    for (uint32_t probe = 0; probe < ImpactAllocationProbeLimit; ++probe) {
+        const uint32_t candidate = (uint32_t)((hash + probe) % ImpactAllocationStackCapacity);
+        ImpactAllocationStack* stack = &sampler->stacks[candidate];
+        uint64_t existing = atomic_load_explicit(&stack->hash, memory_order_acquire);
+
+        if (existing == 0 && atomic_compare_exchange_strong(&stack->hash, &existing, hash)) {
+            memcpy(stack->frames, frames, count * sizeof(uintptr_t));
+            stack->frameCount = count;
+
+            atomic_store_explicit(&stack->ready, true, memory_order_release);
+            atomic_fetch_add_explicit(&sampler->stackCount, 1, memory_order_relaxed);
+
+            *index = candidate;
+
+            return true;
+        }
+
+        if (existing != hash) {
+            continue;
+        }
+
+        // another thread is still filling it in, and waiting here isn't an option
+        if (atomic_load_explicit(&stack->ready, memory_order_acquire) == false) {
+            return false;
+        }
+
+        if (stack->frameCount == count && memcmp(stack->frames, frames, count * sizeof(uintptr_t)) == 0) {
+            *index = candidate;
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// The first two frames are this function and the one that recorded the allocation.
+__attribute__((noinline, disable_tail_calls))
+static uint32_t ImpactAllocationCaptureFrames(ImpactAllocationSampler* sampler, uintptr_t* frames, uint32_t skip) {
+    const bool tables = (sampler->strategies & ~ImpactUnwindStrategyFramePointer) != 0;
+
+    if (tables) {
+        os_unfair_lock_lock(&sampler->unwindLock);
+    }
+
+    const uint32_t count = ImpactUnwindCaptureStack(&sampler->state, sampler->strategies, frames, ImpactAllocationFrameLimit, skip + 2);
+
+    if (tables) {
+        os_unfair_lock_unlock(&sampler->unwindLock);
+    }
+
+    return count;
+}
+
+__attribute__((noinline, disable_tail_calls))
+void ImpactAllocationSamplerRecordAllocation(ImpactAllocationSampler* sampler, uintptr_t address, size_t size, uint32_t skip) {
+    if (atomic_load_explicit(&sampler->enabled, memory_order_relaxed) == false) {
+        return;
+    }
+
+    // Thread-specific data, rather than a thread-local, because the first touch of a thread-local can
+    // allocate. Zero means this thread hasn't drawn yet.
+    uintptr_t countdown = (uintptr_t)pthread_getspecific(sampler->countdownKey);
+
+    if (countdown == 0) {
+        countdown = ImpactAllocationDrawCountdown(sampler);
+    }
+
+    if (size < countdown) {
+        pthread_setspecific(sampler->countdownKey, (void*)(countdown - size));
+        return;
+    }
+
+    pthread_setspecific(sampler->countdownKey, (void*)ImpactAllocationDrawCountdown(sampler));
+
+    uintptr_t frames[ImpactAllocationFrameLimit];
+    const uint32_t count = ImpactAllocationCaptureFrames(sampler, frames, skip);
+    const int64_t weight = ImpactAllocationWeight(sampler, size);
+    uint32_t index = 0;
+
+    if (ImpactAllocationFindStack(sampler, frames, count, &index) == false ||
+        ImpactAllocationLiveInsert(sampler, address, index, weight) == false) {
+        atomic_fetch_add_explicit(&sampler->dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    ImpactAllocationStack* stack = &sampler->stacks[index];
+
+    atomic_fetch_add_explicit(&stack->liveBytes, weight, memory_order_relaxed);
+    atomic_fetch_add_explicit(&stack->liveCount, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&stack->totalBytes, (uint64_t)weight, memory_order_relaxed);
+    atomic_fetch_add_explicit(&sampler->sampled, 1, memory_order_relaxed);
+}
+
+void ImpactAllocationSamplerRecordFree(ImpactAllocationSampler* sampler, uintptr_t address) {
+    // frees of sampled allocations still count after sampling is disabled
+    const uint8_t filter = atomic_load_explicit(&sampler->filter[ImpactAllocationHashAddress(address) % ImpactAllocationFilterSize], memory_order_acquire);
+
+    if (filter == 0) {
+        return;
+    }
+
+    uint32_t index = 0;
+    int64_t weight = 0;
+
+    if (ImpactAllocationLiveRemove(sampler, address, &index, &weight) == false) {
+        return;
+    }
+
+    ImpactAllocationStack* stack = &sampler->stacks[index];
+
+    atomic_fetch_sub_explicit(&stack->liveBytes, weight, memory_order_relaxed);
+    atomic_fetch_sub_explicit(&stack->liveCount, 1, memory_order_relaxed);
+}
+
+int64_t ImpactAllocationSamplerGetLiveBytes(const ImpactAllocationSampler* sampler) {
+    if (ImpactInvalidPtr(sampler) || sampler->stacks == NULL) {
+        return 0;
+    }
+
+    int64_t total = 0;
+
+    for (uint32_t i = 0; i < ImpactAllocationStackCapacity; ++i) {
+        const ImpactAllocationStack* stack = &sampler->stacks[i];
+
+        if (atomic_load_explicit(&stack->ready, memory_order_acquire)) {
+            total += atomic_load_explicit(&stack->liveBytes, memory_order_relaxed);
+        }
+    }
+
+    return total;
+}
+
+#pragma mark - Malloc Logger
+
+static void ImpactAllocationMallocLogger(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t hotFramesToSkip) {
+    ImpactAllocationSampler* sampler = atomic_load_explicit(&ImpactAllocationInstalledSampler, memory_order_acquire);
+    const uint32_t vm = ImpactMallocLogTypeVMAllocate | ImpactMallocLogTypeVMDeallocate;
+
+    if (sampler && (type & vm) == 0) {
+        const bool allocated = (type & ImpactMallocLogTypeAllocate) != 0;
+        const bool deallocated = (type & ImpactMallocLogTypeDeallocate) != 0;
+
+        // for realloc, arg2 is the old pointer and arg3 the new size, and a failure leaves the old one
+        if (deallocated && (allocated == false || result != 0)) {
+            ImpactAllocationSamplerRecordFree(sampler, arg2);
+        }
+
+        if (allocated && result != 0) {
+            ImpactAllocationSamplerRecordAllocation(sampler, result, deallocated ? arg3 : arg2, hotFramesToSkip + 1);
+        }
+    }
+
+    ImpactMallocLogger* previous = ImpactAllocationPreviousLogger;
+
+    if (previous) {
+        previous(type, arg1, arg2, arg3, result, hotFramesToSkip);
+    }
+}
+
+// Anything installed after the logger may chain to it, so once in place it stays, and only forwards
+// while no sampler is installed.
+static void ImpactAllocationInstallLogger(void) {
+    ImpactAllocationPreviousLogger = malloc_logger;
+    malloc_logger = ImpactAllocationMallocLogger;
+}
+
+ImpactResult ImpactAllocationSamplerInstall(ImpactAllocationSampler* sampler) {
+    if (ImpactInvalidPtr(sampler)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    ImpactAllocationSampler* expected = NULL;
+
+    if (atomic_compare_exchange_strong(&ImpactAllocationInstalledSampler, &expected, sampler) == false) {
+        return ImpactResultStateInvalid;
+    }
+
+    sampler->installed = true;
+
+    pthread_once(&ImpactAllocationLoggerOnce, ImpactAllocationInstallLogger);
+
+    return ImpactResultSuccess;
+}
+
+ImpactResult ImpactAllocationSamplerUninstall(ImpactAllocationSampler* sampler) {
+    if (ImpactInvalidPtr(sampler)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    ImpactAllocationSampler* expected = sampler;
+
+    if (atomic_compare_exchange_strong(&ImpactAllocationInstalledSampler, &expected, NULL) == false) {
+        return ImpactResultStateInvalid;
+    }
+
+    return ImpactResultSuccess;
+}
+
+#pragma mark - Reports
+
+static void ImpactAllocationLogFrame(ImpactState* state, uint32_t index, uintptr_t ip) {
+    ImpactLogger* log = ImpactStateGetLog(state);
+
+    // must happen before the record begins, as finding an image can log it
+    ImpactMachOData imageData = {0};
+    const bool found = ImpactBinaryImageFind(state, ip, &imageData) == ImpactResultSuccess;
+
+    ImpactLogBeginRecord(log, "Allocation:Frame");
+    ImpactLogWriteKeyInteger(log, "stack", index, false);
+
+    if (found) {
+        ImpactLogWriteKeyInteger(log, "image", imageData.index, false);
+        ImpactLogWriteKeyInteger(log, "offset", ip - imageData.loadAddress, true);
+    } else {
+        ImpactLogWriteKeyInteger(log, "ip", ip, true);
+    }
+}
+
+ImpactResult ImpactAllocationSamplerLog(ImpactState* state, const ImpactAllocationSampler* sampler) {
+    if (ImpactInvalidPtr(state) || ImpactInvalidPtr(sampler) || sampler->stacks == NULL) {
+        return ImpactResultPointerInvalid;
+    }
+
+    ImpactLogger* log = ImpactStateGetLog(state);
+    const int64_t liveBytes = ImpactAllocationSamplerGetLiveBytes(sampler);
+
+    ImpactLogBeginRecord(log, "Allocation");
+    ImpactLogWriteKeyInteger(log, "interval", sampler->interval, false);
+    ImpactLogWriteKeyInteger(log, "sampled", atomic_load(&sampler->sampled), false);
+    ImpactLogWriteKeyInteger(log, "dropped", atomic_load(&sampler->dropped), false);
+    ImpactLogWriteKeyInteger(log, "stacks", atomic_load(&sampler->stackCount), false);
+    ImpactLogWriteKeyInteger(log, "live_bytes", liveBytes > 0 ? (uintptr_t)liveBytes : 0, true);
+
+    for (uint32_t i = 0; i < ImpactAllocationStackCapacity; ++i) {
+        const ImpactAllocationStack* stack = &sampler->stacks[i];
+
+        if (atomic_load_explicit(&stack->ready, memory_order_acquire) == false) {
+            continue;
+        }
+
+        const int64_t bytes = atomic_load(&stack->liveBytes);
+
+        if (bytes <= 0) {
+            continue;
+        }
+
+        if (ImpactStateDeadlineExceeded(state)) {
+            return ImpactResultDeadlineExceeded;
+        }
+
+        ImpactLogBeginRecord(log, "Allocation:Stack");
+        ImpactLogWriteKeyInteger(log, "id", i, false);
+        ImpactLogWriteKeyInteger(log, "bytes", (uintptr_t)bytes, false);
+        ImpactLogWriteKeyInteger(log, "count", (uintptr_t)atomic_load(&stack->liveCount), false);
+        ImpactLogWriteKeyInteger(log, "total", atomic_load(&stack->totalBytes), false);
+        ImpactLogWriteKeyInteger(log, "frames", stack->frameCount, true);
+
+        for (uint32_t j = 0; j < stack->frameCount; ++j) {
+            ImpactAllocationLogFrame(state, i, stack->frames[j]);
+        }
+    }
+
+    return ImpactResultSuccess;
+}
+
+ImpactResult ImpactAllocationSamplerWriteSnapshot(ImpactAllocationSampler* sampler, const char* path, ImpactLogEncoding encoding) {
+    if (ImpactInvalidPtr(sampler) || ImpactInvalidPtr(path)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    if (sampler->snapshotState == NULL) {
+        return ImpactResultStateInvalid;
+    }
+
+    if (os_unfair_lock_trylock(&sampler->snapshotLock) == false) {
+        return ImpactResultStateInvalid;
+    }
+
+    ImpactState* state = sampler->snapshotState;
+
+    ImpactStateInitializeDerived(state, &sampler->state, ImpactStateDerivedOptionReferencedImages);
+
+    ImpactResult result = ImpactLogInitializeWithEncoding(state, path, encoding);
+    if (result != ImpactResultSuccess) {
+        os_unfair_lock_unlock(&sampler->snapshotLock);
+        return result;
+    }
+
+    ImpactLogger* log = ImpactStateGetLog(state);
+
+    ImpactLogBeginRecord(log, "Live");
+    ImpactLogWriteKeyInteger(log, "pid", getpid(), false);
+    ImpactLogWriteTime(log, "time", true);
+
+    result = ImpactBinaryImageInitialize(state);
+    if (result == ImpactResultSuccess) {
+        result = ImpactAllocationSamplerLog(state, sampler);
+    }
+
+    if (result == ImpactResultSuccess) {
+        result = ImpactBinaryImageLogReferencedImages(state);
+    }
+
+    ImpactLogDeinitialize(log);
+
+    os_unfair_lock_unlock(&sampler->snapshotLock);
+
+    return result;
+}
@@ -0,0 +1,106 @@
+//
+//  ImpactAllocation.h
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#ifndef ImpactAllocation_h
+#define ImpactAllocation_h
+
+#include "ImpactState.h"
+#include "ImpactResult.h"
+
+#include <os/lock.h>
+
+_Pragma("clang assume_nonnull begin")
+__BEGIN_DECLS
+
+enum {
+    ImpactAllocationFrameLimit = 32,
+    ImpactAllocationStackCapacity = 4096,
+    ImpactAllocationLiveCapacity = 65536,
+    ImpactAllocationFilterSize = 16384,
+    // probes into either table before giving up on a sample
+    ImpactAllocationProbeLimit = 64
+};
+
+// Every distinct stack that a sampled allocation came from. Slots are claimed by hash, and only read
+// once ready.
+typedef struct {
+    _Atomic uint64_t hash; // zero when empty
+    _Atomic bool ready;
+    uint32_t frameCount;
+    uintptr_t frames[ImpactAllocationFrameLimit];
+    _Atomic int64_t liveBytes; // estimated from the samples
+    _Atomic int64_t liveCount; // sampled allocations not yet freed
+    _Atomic uint64_t totalBytes;
+} ImpactAllocationStack;
+
+// A sampled allocation that has not been freed.
+typedef struct {
+    _Atomic uintptr_t address; // ImpactAllocationLiveEmpty or ImpactAllocationLiveRemoved when unused
+    uint32_t stack;
+    int64_t weight;
+} ImpactAllocationLive;
+
+enum {
+    ImpactAllocationLiveEmpty = 0,
+    ImpactAllocationLiveRemoved = 1,
+    ImpactAllocationLiveReserved = 2 // claimed, but not yet filled in
+};
+
+struct ImpactAllocationSampler {
+    uint64_t interval; // mean bytes between samples
+    uint32_t strategies;
+    ImpactState state; // only used for unwinding with tables
+    os_unfair_lock unwindLock; // image lookups are not safe from more than one thread
+
+    _Atomic bool enabled;
+    bool installed; // stays set, as other threads may still be inside the sampler
+    _Atomic uint64_t seed;
+    pthread_key_t countdownKey;
+
+    _Atomic uint64_t sampled;
+    _Atomic uint64_t dropped; // a table was too full
+    _Atomic uint32_t stackCount;
+
+    ImpactAllocationStack* stacks;
+    ImpactAllocationLive* live;
+    _Atomic uint8_t* filter; // counts of live addresses per bucket, so most frees never touch the table
+
+    // mapped along with the tables, as allocating one while sampling could reenter the sampler
+    ImpactState* snapshotState;
+    os_unfair_lock snapshotLock;
+};
+
+// The tables are mapped up front, so nothing here calls malloc. Unwinding with frame pointers alone is
+// the cheapest, and the only strategy that never looks up images, so it is what to use unless compact
+// unwind is really needed. Not async-signal-safe.
+ImpactResult ImpactAllocationSamplerInitialize(ImpactAllocationSampler* sampler, const ImpactState* _Nullable source, uint64_t interval, uint32_t strategies);
+
+// Samples every allocation in the process, via libmalloc's logger hook, chaining to any logger that was
+// already there. Only one sampler can be installed at a time. Once installed, a sampler can never be
+// deinitialized, because there is no way to know that every thread has left it.
+ImpactResult ImpactAllocationSamplerInstall(ImpactAllocationSampler* sampler);
+ImpactResult ImpactAllocationSamplerUninstall(ImpactAllocationSampler* sampler);
+ImpactResult ImpactAllocationSamplerDeinitialize(ImpactAllocationSampler* sampler);
+
+// What the malloc logger calls. Skip is the number of frames above the caller to leave out.
+void ImpactAllocationSamplerRecordAllocation(ImpactAllocationSampler* sampler, uintptr_t address, size_t size, uint32_t skip);
+void ImpactAllocationSamplerRecordFree(ImpactAllocationSampler* sampler, uintptr_t address);
+
+// The estimated total of every sampled stack that is still live.
+int64_t ImpactAllocationSamplerGetLiveBytes(const ImpactAllocationSampler* sampler);
+
+// Writes an Allocation record, then each stack with live bytes and its frames. Async-signal-safe.
+ImpactResult ImpactAllocationSamplerLog(ImpactState* state, const ImpactAllocationSampler* sampler);
+
+// Writes the same thing to a separate report, while sampling continues. Nothing is allocated. Returns
+// ImpactResultStateInvalid if another snapshot is being written. Not async-signal-safe.
+ImpactResult ImpactAllocationSamplerWriteSnapshot(ImpactAllocationSampler* sampler, const char* path, ImpactLogEncoding encoding);
+
+__END_DECLS
+_Pragma("clang assume_nonnull end")
+
+#endif /* ImpactAllocation_h */
@@ -0,0 +1,273 @@
+//
+//  ImpactBreadcrumb.c
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#include "ImpactBreadcrumb.h"
+#include "ImpactUtility.h"
+#include "ImpactLog.h"
+#include "ImpactTime.h"
+
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// what a thread holds when there was no ring left for it, so it doesn't search again on every event
+static ImpactBreadcrumbRing ImpactBreadcrumbNoRing;
+
+static const uint64_t ImpactBreadcrumbRingMask = ImpactBreadcrumbRingCapacity - 1;
+
+static size_t ImpactBreadcrumbPoolSize(uint32_t ringCount) {
+    const size_t pageSize = (size_t)getpagesize();
+    const size_t size = ringCount * (sizeof(ImpactBreadcrumbRing) + sizeof(ImpactBreadcrumbCursor));
+
+    return (size + pageSize - 1) / pageSize * pageSize;
+}
+
+static void ImpactBreadcrumbReleaseRing(void* value) {
+    ImpactBreadcrumbRing* ring = value;
+
+    if (ring != &ImpactBreadcrumbNoRing) {
+        atomic_store(&ring->claimed, false);
+    }
+}
+
+ImpactResult ImpactBreadcrumbPoolInitialize(ImpactBreadcrumbPool* pool, uint32_t ringCount) {
+    if (ImpactInvalidPtr(pool)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    memset(pool, 0, sizeof(ImpactBreadcrumbPool));
+
+    if (ringCount == 0) {
+        return ImpactResultArgumentInvalid;
+    }
+
+    const size_t size = ImpactBreadcrumbPoolSize(ringCount);
+    const size_t pageSize = (size_t)getpagesize();
+
+    // shared, so that a watchdog process forked afterwards sees new events as well
+    uint8_t* base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANON, -1, 0);
+    if (base == MAP_FAILED) {
+        return ImpactResultCallFailed;
+    }
+
+    // so that recording never takes a zero-fill fault
+    for (size_t offset = 0; offset < size; offset += pageSize) {
+        ((volatile uint8_t*)base)[offset] = 0;
+    }
+
+    if (pthread_key_create(&pool->key, ImpactBreadcrumbReleaseRing) != 0) {
+        munmap(base, size);
+        return ImpactResultCallFailed;
+    }
+
+    pool->ringCount = ringCount;
+    pool->rings = (ImpactBreadcrumbRing*)base;
+    pool->cursors = (ImpactBreadcrumbCursor*)(base + ringCount * sizeof(ImpactBreadcrumbRing));
+
+    return ImpactResultSuccess;
+}
+
+ImpactResult ImpactBreadcrumbPoolDeinitialize(ImpactBreadcrumbPool* pool) {
+    if (ImpactInvalidPtr(pool)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    if (pool->rings == NULL) {
+        return ImpactResultSuccess;
+    }
+
+    // a value left behind could otherwise show up under a future key
+    pthread_setspecific(pool->key, NULL);
+    pthread_key_delete(pool->key);
+
+    if (munmap(pool->rings, ImpactBreadcrumbPoolSize(pool->ringCount)) != 0) {
+        return ImpactResultCallFailed;
+    }
+
+    memset(pool, 0, sizeof(ImpactBreadcrumbPool));
+
+    return ImpactResultSuccess;
+}
+
+static ImpactBreadcrumbRing* ImpactBreadcrumbClaimRing(ImpactBreadcrumbPool* pool) {
+    const thread_act_t thread = pthread_mach_thread_np(pthread_self());
+
+    for (uint32_t i = 0; i < pool->ringCount; ++i) {
+        ImpactBreadcrumbRing* ring = &pool->rings[i];
+        bool expected = false;
+
+        if (atomic_compare_exchange_strong(&ring->claimed, &expected, true)) {
+            // the previous owner's events would otherwise be attributed to this thread
+            atomic_store(&ring->head, 0);
+            atomic_store(&ring->thread, thread);
+
+            pthread_setspecific(pool->key, ring);
+
+            return ring;
+        }
+    }
+
+    pthread_setspecific(pool->key, &ImpactBreadcrumbNoRing);
+
+    return &ImpactBreadcrumbNoRing;
+}
+
+void ImpactBreadcrumbRecord(ImpactBreadcrumbPool* pool, uint32_t category, const uintptr_t* arguments, uint32_t count, const char* message) {
+    ImpactBreadcrumbRing* ring = pthread_getspecific(pool->key);
+
+    if (ring == NULL) {
+        ring = ImpactBreadcrumbClaimRing(pool);
+    }
+
+    if (ring == &ImpactBreadcrumbNoRing) {
+        atomic_fetch_add_explicit(&pool->dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    // no other thread ever writes head, so this load can't race
+    const uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    ImpactBreadcrumb* event = &ring->events[head & ImpactBreadcrumbRingMask];
+
+    if (arguments == NULL || count > ImpactBreadcrumbArgumentLimit) {
+        count = arguments ? ImpactBreadcrumbArgumentLimit : 0;
+    }
+
+    event->time = ImpactTimeGetMonotonicNanoseconds();
+    event->category = category;
+    event->argumentCount = count;
+
+    for (uint32_t i = 0; i < count; ++i) {
+        event->arguments[i] = arguments[i];
+    }
+
+    uint32_t length = 0;
+
+    if (message) {
+        for (; length < ImpactBreadcrumbMessageSize - 1 && message[length] != 0; ++length) {
+            event->message[length] = message[length];
+        }
+    }
+
+    event->message[length] = 0;
+
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+ImpactBreadcrumbRing* ImpactBreadcrumbPoolGetRing(ImpactBreadcrumbPool* pool, thread_act_t thread) {
+    if (ImpactInvalidPtr(pool) || !MACH_PORT_VALID(thread)) {
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < pool->ringCount; ++i) {
+        if (atomic_load(&pool->rings[i].thread) == thread) {
+            return &pool->rings[i];
+        }
+    }
+
+    return NULL;
+}
+
+static void ImpactBreadcrumbLogEvent(ImpactLogger* log, const ImpactBreadcrumbRing* ring, uint64_t index, uint64_t now) {
+    // Copy first, and then check that the owner didn't lap the slot while it was being read. The slot is
+    // only in use for index + capacity once head has reached it.
+    const ImpactBreadcrumb event = ring->events[index & ImpactBreadcrumbRingMask];
+
+    atomic_thread_fence(memory_order_acquire);
+
+    if (atomic_load_explicit(&ring->head, memory_order_relaxed) >= index + ImpactBreadcrumbRingCapacity) {
+        return;
+    }
+
+    const uint32_t count = event.argumentCount < ImpactBreadcrumbArgumentLimit ? event.argumentCount : ImpactBreadcrumbArgumentLimit;
+    static const char* const argumentKeys[ImpactBreadcrumbArgumentLimit] = { "arg0", "arg1", "arg2", "arg3" };
+
+    ImpactLogBeginRecord(log, "Breadcrumb");
+    ImpactLogWriteKeyInteger(log, "thread", atomic_load(&ring->thread), false);
+    ImpactLogWriteKeyInteger(log, "age", now > event.time ? now - event.time : 0, false);
+    ImpactLogWriteKeyInteger(log, "category", event.category, false);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        ImpactLogWriteKeyInteger(log, argumentKeys[i], event.arguments[i], false);
+    }
+
+    ImpactLogWriteKeyString(log, "message", event.message, true);
+}
+
+ImpactResult ImpactBreadcrumbPoolLog(ImpactState* state, ImpactBreadcrumbPool* pool) {
+    if (ImpactInvalidPtr(state) || ImpactInvalidPtr(pool) || pool->rings == NULL) {
+        return ImpactResultPointerInvalid;
+    }
+
+    ImpactLogger* log = ImpactStateGetLog(state);
+    const uint64_t now = ImpactTimeGetMonotonicNanoseconds();
+
+    uint32_t threads = 0;
+    uint64_t recorded = 0;
+
+    for (uint32_t i = 0; i < pool->ringCount; ++i) {
+        const uint64_t head = atomic_load_explicit(&pool->rings[i].head, memory_order_acquire);
+
+        pool->cursors[i].next = head;
+        pool->cursors[i].floor = head > ImpactBreadcrumbRingCapacity ? head - ImpactBreadcrumbRingCapacity : 0;
+
+        threads += head > 0 ? 1 : 0;
+        recorded += head;
+    }
+
+    ImpactLogBeginRecord(log, "Breadcrumbs");
+    ImpactLogWriteKeyInteger(log, "threads", threads, false);
+    ImpactLogWriteKeyInteger(log, "recorded", recorded, false);
+    ImpactLogWriteKeyInteger(log, "dropped", atomic_load(&pool->dropped), true);
+
+    // Walk backwards from the newest event in every ring, always taking the newest of them, until the
+    // limit is reached. Only the ring each pick came from needs to be remembered.
+    uint32_t picks[ImpactBreadcrumbLogLimit];
+    uint32_t pickCount = 0;
+
+    while (pickCount < ImpactBreadcrumbLogLimit) {
+        uint32_t best = UINT32_MAX;
+        uint64_t bestTime = 0;
+
+        for (uint32_t i = 0; i < pool->ringCount; ++i) {
+            const ImpactBreadcrumbCursor* cursor = &pool->cursors[i];
+
+            if (cursor->next <= cursor->floor) {
+                continue;
+            }
+
+            const uint64_t time = pool->rings[i].events[(cursor->next - 1) & ImpactBreadcrumbRingMask].time;
+
+            if (best == UINT32_MAX || time > bestTime) {
+                best = i;
+                bestTime = time;
+            }
+        }
+
+        if (best == UINT32_MAX) {
+            break;
+        }
+
+        pool->cursors[best].next -= 1;
+        picks[pickCount++] = best;
+    }
+
+    if (ImpactStateDeadlineExceeded(state)) {
+        return ImpactResultDeadlineExceeded;
+    }
+
+    // Every cursor now rests on its ring's oldest pick, so going through the picks in reverse hands out
+    // each ring's events oldest first.
+    for (uint32_t i = pickCount; i > 0; --i) {
+        ImpactBreadcrumbCursor* cursor = &pool->cursors[picks[i - 1]];
+
+        ImpactBreadcrumbLogEvent(log, &pool->rings[picks[i - 1]], cursor->next, now);
+
+        cursor->next += 1;
+    }
+
+    return ImpactResultSuccess;
+}
@@ -0,0 +1,78 @@
+//
+//  ImpactBreadcrumb.h
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#ifndef ImpactBreadcrumb_h
+#define ImpactBreadcrumb_h
+
+#include "ImpactState.h"
+#include "ImpactResult.h"
+
+#include <mach/mach.h>
+#include <pthread.h>
+
+_Pragma("clang assume_nonnull begin")
+__BEGIN_DECLS
+
+enum {
+    ImpactBreadcrumbArgumentLimit = 4,
+    ImpactBreadcrumbMessageSize = 32, // including the terminator
+    ImpactBreadcrumbRingCapacity = 64, // must be a power of two
+    ImpactBreadcrumbLogLimit = 128
+};
+
+typedef struct {
+    uint64_t time; // monotonic nanoseconds
+    uint32_t category;
+    uint32_t argumentCount;
+    uintptr_t arguments[ImpactBreadcrumbArgumentLimit];
+    char message[ImpactBreadcrumbMessageSize];
+} ImpactBreadcrumb;
+
+// Only the owning thread writes events. It fills in the slot, and then publishes it by storing the new
+// head, so that is the only atomic operation per event. A ring keeps its events after its thread exits,
+// until another thread claims it.
+typedef struct {
+    _Atomic bool claimed;
+    _Atomic thread_act_t thread;
+    _Atomic uint64_t head; // the number of events ever recorded
+    ImpactBreadcrumb events[ImpactBreadcrumbRingCapacity];
+} ImpactBreadcrumbRing;
+
+typedef struct {
+    uint64_t next;
+    uint64_t floor;
+} ImpactBreadcrumbCursor;
+
+struct ImpactBreadcrumbPool {
+    pthread_key_t key;
+    uint32_t ringCount;
+    _Atomic uint32_t dropped; // events from threads that found every ring claimed
+    ImpactBreadcrumbRing* rings;
+    ImpactBreadcrumbCursor* cursors; // scratch for logging
+};
+
+// Every ring is mapped and faulted in up front. A thread claims one on its first event, and holds it
+// until it exits. Threads beyond ringCount record nothing.
+ImpactResult ImpactBreadcrumbPoolInitialize(ImpactBreadcrumbPool* pool, uint32_t ringCount);
+
+// Only safe once every thread that recorded into the pool, other than the calling one, has exited.
+ImpactResult ImpactBreadcrumbPoolDeinitialize(ImpactBreadcrumbPool* pool);
+
+// Takes no locks and makes no syscalls after the calling thread's first event. Arguments beyond
+// ImpactBreadcrumbArgumentLimit are dropped, and the message is truncated.
+void ImpactBreadcrumbRecord(ImpactBreadcrumbPool* pool, uint32_t category, const uintptr_t* _Nullable arguments, uint32_t count, const char* _Nullable message);
+
+ImpactBreadcrumbRing* _Nullable ImpactBreadcrumbPoolGetRing(ImpactBreadcrumbPool* pool, thread_act_t thread);
+
+// Writes a Breadcrumbs record, followed by the most recent events across all threads, oldest first.
+// Async-signal-safe, but only one log may be written from a pool at a time.
+ImpactResult ImpactBreadcrumbPoolLog(ImpactState* state, ImpactBreadcrumbPool* pool);
+
+__END_DECLS
+_Pragma("clang assume_nonnull end")
+
+#endif /* ImpactBreadcrumb_h */
@@ -10,43 +10,216 @@
 #include "ImpactUtility.h"
 #include "ImpactThread.h"
 #include "ImpactBinaryImage.h"
+#include "ImpactLog.h"
+#include "ImpactTime.h"
+#include "ImpactReportStore.h"
+#include "ImpactArena.h"
+#include "ImpactAllocation.h"
+#include "ImpactCxxException.h"
+#include "ImpactBreadcrumb.h"
+#include "ImpactWatchdog.h"
 
+#include <string.h>
 #include <unistd.h>
 
-ImpactResult ImpactCrashHandler(ImpactState* state, thread_act_t crashedThread, const ImpactCPURegisters* registers) {
-    if (ImpactInvalidPtr(state)) {
-        return ImpactResultArgumentInvalid;
+static ImpactResult ImpactCrashHandlerLogTiming(ImpactState* state, uint64_t handlerStart) {
+    ImpactLogger* log = ImpactStateGetLog(state);
+    const ImpactCrashMetrics* metrics = &state->mutableState.metrics;
+    const uint64_t* durations = metrics->phaseDurations;
+
+    // captured before writing, as this record's own flush cannot be included
+    const uint64_t flushDuration = log->flushDuration;
+    const uint32_t flushCount = log->flushCount;
+
+    ImpactLogBeginRecord(log, "Timing");
+    ImpactLogWriteKeyInteger(log, "transition", durations[ImpactCrashPhaseStateTransition], false);
+    ImpactLogWriteKeyInteger(log, "uninstall", durations[ImpactCrashPhaseUninstallHandlers], false);
+    ImpactLogWriteKeyInteger(log, "enumerate", durations[ImpactCrashPhaseThreadEnumeration], false);
+    ImpactLogWriteKeyInteger(log, "suspend", durations[ImpactCrashPhaseSuspend], false);
+    ImpactLogWriteKeyInteger(log, "unwind", durations[ImpactCrashPhaseUnwind], false);
+    ImpactLogWriteKeyInteger(log, "unwind_max", metrics->slowestThreadDuration, false);
+    ImpactLogWriteKeyInteger(log, "format", durations[ImpactCrashPhaseFormat], false);
+    ImpactLogWriteKeyInteger(log, "images", durations[ImpactCrashPhaseImages], false);
+    ImpactLogWriteKeyInteger(log, "resume", durations[ImpactCrashPhaseResume], false);
+    ImpactLogWriteKeyInteger(log, "suspended", metrics->suspendedDuration, false);
+    ImpactLogWriteKeyInteger(log, "flush", flushDuration, false);
+    ImpactLogWriteKeyInteger(log, "flushes", flushCount, false);
+    ImpactLogWriteKeyInteger(log, "total", ImpactTimeGetMonotonicNanoseconds() - handlerStart, false);
+    ImpactLogWriteKeyInteger(log, "threads", metrics->threadCount, false);
+    ImpactLogWriteKeyInteger(log, "lookups", metrics->imageLookups, false);
+    ImpactLogWriteKeyInteger(log, "lookup_misses", metrics->imageLookupMisses, false);
+
+    return ImpactLogWriteKeyInteger(log, "cache_hits", metrics->imageCacheHits, true);
+}
+
+// The prefix must end in two digits, which are replaced with each ImpactResult value.
+static void ImpactCrashHandlerLogUnwindResults(ImpactLogger* log, const char* prefix, const uint32_t* counts) {
+    char key[16] = {0};
+    const size_t length = strnlen(prefix, sizeof(key) - 1);
+
+    memcpy(key, prefix, length);
+
+    for (uint32_t i = ImpactResultFailure; i < ImpactResultCount; ++i) {
+        if (counts[i] == 0) {
+            continue;
+        }
+
+        key[length - 2] = '0' + (i / 10) % 10;
+        key[length - 1] = '0' + i % 10;
+
+        ImpactLogWriteKeyInteger(log, key, counts[i], false);
     }
+}
+
+static ImpactResult ImpactCrashHandlerLogUnwindQuality(ImpactState* state) {
+    ImpactLogger* log = ImpactStateGetLog(state);
+    const ImpactCrashMetrics* metrics = &state->mutableState.metrics;
+    const uint32_t* outcomes = metrics->unwindOutcomes;
+
+    ImpactLogBeginRecord(log, "Unwind");
+    ImpactLogWriteKeyInteger(log, "thread_state", outcomes[ImpactUnwindOutcomeThreadState], false);
+    ImpactLogWriteKeyInteger(log, "compact_unwind", outcomes[ImpactUnwindOutcomeCompactUnwind], false);
+    ImpactLogWriteKeyInteger(log, "dwarf", outcomes[ImpactUnwindOutcomeDWARF], false);
+    ImpactLogWriteKeyInteger(log, "frame_pointer", outcomes[ImpactUnwindOutcomeFramePointer], false);
+    ImpactLogWriteKeyInteger(log, "frame_pointer_fallback", outcomes[ImpactUnwindOutcomeFramePointerFallback], false);
+
+    // Both are keyed by ImpactResult value. Only the non-zero ones are written, so the
+    // record stays small in the common case.
+    ImpactCrashHandlerLogUnwindResults(log, "fallback_00", metrics->unwindFallbacks);
+    ImpactCrashHandlerLogUnwindResults(log, "failure_00", metrics->unwindFailures);
 
-    ImpactDebugLog("[Log:INFO] entering the crash handler\n");
+    uint32_t frames = 0;
 
+    for (uint32_t i = 0; i < ImpactUnwindOutcomeCount; ++i) {
+        frames += outcomes[i];
+    }
+
+    return ImpactLogWriteKeyInteger(log, "frames", frames, true);
+}
+
+// Everything but the closing records, which are written even if this fails.
+static ImpactResult ImpactCrashHandlerLogReport(ImpactState* state, thread_act_t crashedThread, const ImpactCPURegisters* registers, uint64_t handlerStart) {
     ImpactThreadList list = {0};
 
     ImpactResult result = ImpactThreadListInitialize(&list, crashedThread, registers);
+
+    ImpactStateRecordPhase(state, ImpactCrashPhaseThreadEnumeration, handlerStart);
+
     if (result != ImpactResultSuccess) {
-        ImpactDebugLog("[Log:ERROR:%s] unable to initialize thread list %d\n", __func__, result);
+        ImpactDebugLogError("[Log:ERROR:%s] unable to initialize thread list %d\n", __func__, result);
         return result;
     }
 
+    // running out of time isn't an error, but it does mean we have to stop collecting data
     result = ImpactThreadListLog(state, &list);
-    if (result != ImpactResultSuccess) {
-        ImpactDebugLog("[Log:ERROR:%s] unable to log thread list %d\n", __func__, result);
+    if (result != ImpactResultSuccess && result != ImpactResultDeadlineExceeded) {
+        ImpactDebugLogError("[Log:ERROR:%s] unable to log thread list %d\n", __func__, result);
         return result;
     }
 
-    result = ImpactBinaryImageLogRemainingImages(state);
+    // an uncaught C++ exception aborts from std::terminate, long after the stack it was thrown from is gone
+    if (ImpactStateDeadlineExceeded(state) == false) {
+        ImpactCxxExceptionLogPending(state, list.crashedThread);
+    }
+
+    ImpactAllocationSampler* sampler = state->constantState.allocationSampler;
+
+    if (sampler && ImpactStateDeadlineExceeded(state) == false) {
+        result = ImpactAllocationSamplerLog(state, sampler);
+        if (result != ImpactResultSuccess && result != ImpactResultDeadlineExceeded) {
+            ImpactDebugLogError("[Log:ERROR:%s] unable to log allocations %d\n", __func__, result);
+        }
+    }
+
+    ImpactBreadcrumbPool* breadcrumbs = state->constantState.breadcrumbs;
+
+    // a watchdog that is still around can merge them once this process is gone
+    const bool deferBreadcrumbs = ImpactWatchdogIsRunning(state);
+
+    if (breadcrumbs && deferBreadcrumbs == false && ImpactStateDeadlineExceeded(state) == false) {
+        result = ImpactBreadcrumbPoolLog(state, breadcrumbs);
+        if (result != ImpactResultSuccess && result != ImpactResultDeadlineExceeded) {
+            ImpactDebugLogError("[Log:ERROR:%s] unable to log breadcrumbs %d\n", __func__, result);
+        }
+    }
+
+    if (ImpactStateDeadlineExceeded(state)) {
+        ImpactDebugLogWarn("[Log:WARN:%s] deadline exceeded, skipping remaining images\n", __func__);
+
+        // Even out of time, the images that frames point into are cheap and too important to drop.
+        if (state->constantState.imageLogging == ImpactBinaryImageLoggingReferenced) {
+            ImpactBinaryImageLogReferencedImages(state);
+        }
+
+        // images were left out either way
+        ImpactBinaryImageLogSummary(state);
+
+        ImpactLogger* log = ImpactStateGetLog(state);
+
+        ImpactLogBeginRecord(log, "Truncated");
+        ImpactLogWriteKeyString(log, "section", "images", false);
+        ImpactLogWriteKeyInteger(log, "reason", ImpactResultDeadlineExceeded, true);
+    } else {
+        const uint64_t start = ImpactTimeGetMonotonicNanoseconds();
+
+        result = ImpactBinaryImageLogRemainingImages(state);
+
+        ImpactStateRecordPhase(state, ImpactCrashPhaseImages, start);
+
+        if (result != ImpactResultSuccess) {
+            ImpactDebugLogError("[Log:ERROR] unable to log remaining images %d\n", result);
+            return result;
+        }
+    }
+
+    return ImpactResultSuccess;
+}
+
+ImpactResult ImpactCrashHandler(ImpactState* state, thread_act_t crashedThread, const ImpactCPURegisters* registers) {
+    if (ImpactInvalidPtr(state)) {
+        return ImpactResultArgumentInvalid;
+    }
+
+    ImpactStateClaimDiagnostics(state);
+
+    ImpactDebugLogInfo("[Log:INFO] entering the crash handler\n");
+
+    const uint64_t handlerStart = ImpactTimeGetMonotonicNanoseconds();
+    const uint64_t limit = state->constantState.crashHandlerTimeLimit;
+
+    state->mutableState.crashDeadline = limit > 0 ? handlerStart + limit : 0;
+
+    ImpactAllocationSampler* sampler = state->constantState.allocationSampler;
+
+    // keeps the tables still while they are logged
+    if (sampler) {
+        atomic_store(&sampler->enabled, false);
+    }
+
+    ImpactArenaReset(&state->mutableState.arena);
+
+    const ImpactResult result = ImpactCrashHandlerLogReport(state, crashedThread, registers, handlerStart);
+
+    // written whether or not the report is complete, since a failed report is when timing matters most
+    ImpactCrashHandlerLogUnwindQuality(state);
+    ImpactArenaLogStatistics(state);
+    ImpactCrashHandlerLogTiming(state, handlerStart);
+
     if (result != ImpactResultSuccess) {
-        ImpactDebugLog("[Log:ERROR] unable to log remaining images %d\n", result);
         return result;
     }
 
-    ImpactDebugLog("[Log:INFO] exiting the crash handler\n");
+    ImpactReportStoreRecordComplete(state);
+
+    atomic_store(&state->mutableState.crashHandlerComplete, true);
+
+    ImpactDebugLogInfo("[Log:INFO] exiting the crash handler\n");
 
     if (state->constantState.suppressReportCrash) {
         // There are lots of exit functions. Only _exit is listed
         // as safe to call from a signal handler.
 
-        ImpactDebugLog("[Log:WARN:%s] suppressing ReportCrash\n", __func__);
+        ImpactDebugLogWarn("[Log:WARN:%s] suppressing ReportCrash\n", __func__);
 
         _exit(0);
         return ImpactResultSuccess;
@@ -0,0 +1,273 @@
+//
+//  ImpactCxxException.cpp
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#include "ImpactCxxException.h"
+#include "ImpactUtility.h"
+#include "ImpactUnwind.h"
+#include "ImpactBinaryImage.h"
+#include "ImpactLog.h"
+
+#include <pthread.h>
+#include <typeinfo>
+
+extern "C" {
+void __cxa_throw(void* thrown, std::type_info* type, void (*destructor)(void*)) __attribute__((noreturn));
+void __cxa_rethrow(void) __attribute__((noreturn));
+void* __cxa_begin_catch(void* exception) noexcept;
+void __cxa_end_catch(void);
+}
+
+static _Atomic bool ImpactCxxExceptionEnabled = false;
+static bool ImpactCxxExceptionKeyCreated = false;
+static pthread_key_t ImpactCxxExceptionKey;
+static pthread_once_t ImpactCxxExceptionOnce = PTHREAD_ONCE_INIT;
+static ImpactCxxExceptionThrowSite ImpactCxxExceptionThrowSites[ImpactCxxExceptionThreadLimit];
+
+static void ImpactCxxExceptionReleaseThrowSite(void* value) {
+    ImpactCxxExceptionThrowSite* site = static_cast<ImpactCxxExceptionThrowSite*>(value);
+
+    atomic_store(&site->pending, false);
+    atomic_store(&site->thread, MACH_PORT_NULL);
+}
+
+static void ImpactCxxExceptionCreateKey(void) {
+    ImpactCxxExceptionKeyCreated = pthread_key_create(&ImpactCxxExceptionKey, ImpactCxxExceptionReleaseThrowSite) == 0;
+}
+
+ImpactResult ImpactCxxExceptionInitialize(void) {
+    pthread_once(&ImpactCxxExceptionOnce, ImpactCxxExceptionCreateKey);
+
+    if (ImpactCxxExceptionKeyCreated == false) {
+        return ImpactResultCallFailed;
+    }
+
+    atomic_store(&ImpactCxxExceptionEnabled, true);
+
+    return ImpactResultSuccess;
+}
+
+void ImpactCxxExceptionDeinitialize(void) {
+    atomic_store(&ImpactCxxExceptionEnabled, false);
+}
+
+// Until the key exists, it is zero, which names a slot the system already uses for something else.
+static bool ImpactCxxExceptionIsEnabled(void) {
+    return atomic_load_explicit(&ImpactCxxExceptionEnabled, memory_order_relaxed);
+}
+
+// A thread claims a site on its first throw, and gives it back when it exits.
+static ImpactCxxExceptionThrowSite* ImpactCxxExceptionCurrentThrowSite(bool claim) {
+    ImpactCxxExceptionThrowSite* site = static_cast<ImpactCxxExceptionThrowSite*>(pthread_getspecific(ImpactCxxExceptionKey));
+
+    if (site || claim == false) {
+        return site;
+    }
+
+    const thread_act_t thread = pthread_mach_thread_np(pthread_self());
+
+    for (uint32_t i = 0; i < ImpactCxxExceptionThreadLimit; ++i) {
+        thread_act_t expected = MACH_PORT_NULL;
+
+        if (atomic_compare_exchange_strong(&ImpactCxxExceptionThrowSites[i].thread, &expected, thread)) {
+            site = &ImpactCxxExceptionThrowSites[i];
+            site->throwCount = 0;
+            site->catchDepth = 0;
+            site->caughtDepth = 0;
+
+            pthread_setspecific(ImpactCxxExceptionKey, site);
+
+            return site;
+        }
+    }
+
+    return NULL;
+}
+
+__attribute__((noinline, disable_tail_calls))
+void ImpactCxxExceptionRecordThrow(const void* type, uint32_t skip) {
+    if (ImpactCxxExceptionIsEnabled() == false) {
+        return;
+    }
+
+    ImpactCxxExceptionThrowSite* site = ImpactCxxExceptionCurrentThrowSite(true);
+
+    if (site == NULL) {
+        return;
+    }
+
+    // a crash handler on another thread only reads the site while it is pending
+    atomic_store_explicit(&site->pending, false, memory_order_relaxed);
+
+    // Frame pointers alone never look anything up, and are what keeps this cheap. The first frame is
+    // this function.
+    site->frameCount = ImpactUnwindCaptureStack(NULL, ImpactUnwindStrategyFramePointer, site->frames, ImpactCxxExceptionFrameLimit, skip + 1);
+    site->type = type;
+    site->throwCount += 1;
+    site->caughtDepth = 0;
+
+    atomic_store_explicit(&site->pending, true, memory_order_release);
+}
+
+void ImpactCxxExceptionRecordRethrow(void) {
+    if (ImpactCxxExceptionIsEnabled() == false) {
+        return;
+    }
+
+    ImpactCxxExceptionThrowSite* site = ImpactCxxExceptionCurrentThrowSite(false);
+
+    // the original throw site is still the interesting one
+    if (site) {
+        site->caughtDepth = 0;
+        atomic_store_explicit(&site->pending, true, memory_order_release);
+    }
+}
+
+// Beginning a catch is not enough to clear the exception. Throwing out of a noexcept function begins a
+// catch on the way to std::terminate, and that crash is the one that needs the throw site. The first
+// catch to begin after a throw is the one handling it, as nothing else can run in between but cleanups,
+// and any of those that throw replace the record.
+void ImpactCxxExceptionRecordBeginCatch(void) {
+    if (ImpactCxxExceptionIsEnabled() == false) {
+        return;
+    }
+
+    ImpactCxxExceptionThrowSite* site = ImpactCxxExceptionCurrentThrowSite(false);
+
+    if (site == NULL) {
+        return;
+    }
+
+    site->catchDepth += 1;
+
+    if (site->caughtDepth == 0 && atomic_load_explicit(&site->pending, memory_order_relaxed)) {
+        site->caughtDepth = site->catchDepth;
+    }
+}
+
+// Ending any other catch block, like one left by a throw from within it, leaves the exception pending.
+void ImpactCxxExceptionRecordEndCatch(void) {
+    if (ImpactCxxExceptionIsEnabled() == false) {
+        return;
+    }
+
+    ImpactCxxExceptionThrowSite* site = ImpactCxxExceptionCurrentThrowSite(false);
+
+    if (site == NULL || site->catchDepth == 0) {
+        return;
+    }
+
+    if (site->caughtDepth == site->catchDepth) {
+        site->caughtDepth = 0;
+        atomic_store_explicit(&site->pending, false, memory_order_relaxed);
+    }
+
+    site->catchDepth -= 1;
+}
+
+ImpactCxxExceptionThrowSite* ImpactCxxExceptionGetThrowSite(thread_act_t thread) {
+    if (!MACH_PORT_VALID(thread)) {
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < ImpactCxxExceptionThreadLimit; ++i) {
+        if (atomic_load(&ImpactCxxExceptionThrowSites[i].thread) == thread) {
+            return &ImpactCxxExceptionThrowSites[i];
+        }
+    }
+
+    return NULL;
+}
+
+ImpactResult ImpactCxxExceptionLogPending(ImpactState* state, thread_act_t thread) {
+    if (ImpactInvalidPtr(state)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    const ImpactCxxExceptionThrowSite* site = ImpactCxxExceptionGetThrowSite(thread);
+
+    if (site == NULL || atomic_load_explicit(&site->pending, memory_order_acquire) == false) {
+        return ImpactResultSuccess;
+    }
+
+    const std::type_info* type = static_cast<const std::type_info*>(site->type);
+    ImpactLogger* log = ImpactStateGetLog(state);
+
+    // The name is the mangled one, as demangling allocates. Calling what() would mean running the
+    // exception's own code, which is too much to trust here.
+    ImpactLogBeginRecord(log, "Exception");
+    ImpactLogWriteKeyString(log, "type", "c++", false);
+    ImpactLogWriteKeyString(log, "name", type ? type->name() : NULL, false);
+    ImpactLogWriteKeyInteger(log, "frames", site->frameCount, true);
+
+    // written like thread frames, relative to their image when it can be found
+    for (uint32_t i = 0; i < site->frameCount; ++i) {
+        const uintptr_t ip = site->frames[i];
+
+        // these are all return addresses, which can be just past the end of the calling function's image
+        ImpactMachOData imageData = {0};
+        const bool found = ImpactBinaryImageFind(state, ip - 1, &imageData) == ImpactResultSuccess;
+
+        // This has to happen before the record begins, because it can log the image.
+        if (found) {
+            ImpactBinaryImageNoteIndex(state, imageData.index);
+        }
+
+        ImpactLogBeginRecord(log, "Exception:Frame");
+
+        if (found) {
+            ImpactLogWriteKeyInteger(log, "image", imageData.index, false);
+            ImpactLogWriteKeyInteger(log, "offset", ip - imageData.loadAddress, true);
+        } else {
+            ImpactLogWriteKeyInteger(log, "ip", ip, true);
+        }
+    }
+
+    return ImpactResultSuccess;
+}
+
+#pragma mark - Interposing
+
+__attribute__((noreturn, disable_tail_calls))
+static void ImpactCxxExceptionThrow(void* thrown, std::type_info* type, void (*destructor)(void*)) {
+    ImpactCxxExceptionRecordThrow(type, 1);
+
+    __cxa_throw(thrown, type, destructor);
+}
+
+__attribute__((noreturn))
+static void ImpactCxxExceptionRethrow(void) {
+    ImpactCxxExceptionRecordRethrow();
+
+    __cxa_rethrow();
+}
+
+static void* ImpactCxxExceptionBeginCatch(void* exception) noexcept {
+    ImpactCxxExceptionRecordBeginCatch();
+
+    return __cxa_begin_catch(exception);
+}
+
+static void ImpactCxxExceptionEndCatch(void) {
+    ImpactCxxExceptionRecordEndCatch();
+
+    __cxa_end_catch();
+}
+
+// Exceptions that are never caught are handed to std::terminate by libc++abi itself, through a call
+// that can't be interposed, so they stay pending.
+typedef struct {
+    const void* replacement;
+    const void* replacee;
+} ImpactCxxExceptionInterpose;
+
+__attribute__((used, section("__DATA,__interpose")))
+static const ImpactCxxExceptionInterpose ImpactCxxExceptionInterposes[] = {
+    { (const void*)ImpactCxxExceptionThrow, (const void*)__cxa_throw },
+    { (const void*)ImpactCxxExceptionRethrow, (const void*)__cxa_rethrow },
+    { (const void*)ImpactCxxExceptionBeginCatch, (const void*)__cxa_begin_catch },
+    { (const void*)ImpactCxxExceptionEndCatch, (const void*)__cxa_end_catch },
+};
@@ -0,0 +1,60 @@
+//
+//  ImpactCxxException.h
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#ifndef ImpactCxxException_h
+#define ImpactCxxException_h
+
+#include "ImpactState.h"
+#include "ImpactResult.h"
+
+#include <mach/mach.h>
+
+_Pragma("clang assume_nonnull begin")
+__BEGIN_DECLS
+
+enum {
+    ImpactCxxExceptionFrameLimit = 32,
+    ImpactCxxExceptionThreadLimit = 256
+};
+
+// The most recent throw on one thread. Only that thread writes to it.
+typedef struct {
+    _Atomic thread_act_t thread; // MACH_PORT_NULL when unused
+    _Atomic bool pending; // thrown, and not yet through a catch block
+    const void* _Nullable type; // the std::type_info of the exception
+    uint64_t throwCount;
+    uint32_t catchDepth; // catch blocks the thread is in
+    uint32_t caughtDepth; // the catch block handling this exception, or zero before it is caught
+    uint32_t frameCount;
+    uintptr_t frames[ImpactCxxExceptionFrameLimit];
+} ImpactCxxExceptionThrowSite;
+
+// Starts recording where C++ exceptions are thrown from. __cxa_throw, __cxa_rethrow, __cxa_begin_catch and
+// __cxa_end_catch are interposed with dyld, which only works when Impact is a dynamic library loaded at
+// launch. Until this is called, the interposed functions do nothing but forward.
+ImpactResult ImpactCxxExceptionInitialize(void);
+
+// Stops recording, so the interposed functions go back to only forwarding. Threads keep the sites they
+// already claimed.
+void ImpactCxxExceptionDeinitialize(void);
+
+// What the interposed functions call. Skip is the number of frames above the caller to leave out.
+void ImpactCxxExceptionRecordThrow(const void* _Nullable type, uint32_t skip);
+void ImpactCxxExceptionRecordRethrow(void);
+void ImpactCxxExceptionRecordBeginCatch(void);
+void ImpactCxxExceptionRecordEndCatch(void);
+
+ImpactCxxExceptionThrowSite* _Nullable ImpactCxxExceptionGetThrowSite(thread_act_t thread);
+
+// Writes an Exception record, and its frames, if the thread has an exception that was never caught.
+// Async-signal-safe.
+ImpactResult ImpactCxxExceptionLogPending(ImpactState* state, thread_act_t thread);
+
+__END_DECLS
+_Pragma("clang assume_nonnull end")
+
+#endif /* ImpactCxxException_h */
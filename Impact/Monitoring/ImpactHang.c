@@ -0,0 +1,440 @@
+//
+//  ImpactHang.c
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#include "ImpactHang.h"
+#include "ImpactUtility.h"
+#include "ImpactThread.h"
+#include "ImpactBinaryImage.h"
+#include "ImpactLog.h"
+#include "ImpactTime.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+ImpactResult ImpactHangMonitorInitialize(ImpactHangMonitor* monitor, const ImpactState* source, const char* directory, ImpactLogEncoding encoding, uint64_t sampleInterval, uint64_t reportThreshold) {
+    if (ImpactInvalidPtr(monitor) || ImpactInvalidPtr(source) || ImpactInvalidPtr(directory)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    if (sampleInterval == 0 || strlen(directory) >= sizeof(monitor->directory)) {
+        return ImpactResultArgumentInvalid;
+    }
+
+    memset(monitor, 0, sizeof(ImpactHangMonitor));
+
+    ImpactStateInitializeDerived(&monitor->state, source, ImpactStateDerivedOptionNoTimeLimit | ImpactStateDerivedOptionReferencedImages);
+
+    strcpy(monitor->directory, directory);
+    monitor->encoding = encoding;
+    monitor->sampleInterval = sampleInterval;
+    monitor->reportThreshold = reportThreshold;
+
+    if (pthread_mutex_init(&monitor->lock, NULL) != 0) {
+        return ImpactResultFailure;
+    }
+
+    if (pthread_cond_init(&monitor->condition, NULL) != 0) {
+        pthread_mutex_destroy(&monitor->lock);
+        return ImpactResultFailure;
+    }
+
+    if (pthread_cond_init(&monitor->sampled, NULL) != 0) {
+        pthread_cond_destroy(&monitor->condition);
+        pthread_mutex_destroy(&monitor->lock);
+        return ImpactResultFailure;
+    }
+
+    return ImpactResultSuccess;
+}
+
+ImpactResult ImpactHangMonitorDeinitialize(ImpactHangMonitor* monitor) {
+    if (ImpactInvalidPtr(monitor)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    pthread_cond_destroy(&monitor->sampled);
+    pthread_cond_destroy(&monitor->condition);
+    pthread_mutex_destroy(&monitor->lock);
+
+    return ImpactResultSuccess;
+}
+
+#pragma mark - Watches
+
+ImpactHangWatch* ImpactHangMonitorRegisterThread(ImpactHangMonitor* monitor, thread_act_t thread, uint64_t timeout) {
+    if (ImpactInvalidPtr(monitor) || !MACH_PORT_VALID(thread) || timeout == 0) {
+        return NULL;
+    }
+
+    ImpactHangWatch* watch = NULL;
+
+    pthread_mutex_lock(&monitor->lock);
+
+    for (uint32_t i = 0; i < ImpactHangWatchLimit; ++i) {
+        if (atomic_load(&monitor->watches[i].thread) == MACH_PORT_NULL) {
+            watch = &monitor->watches[i];
+            break;
+        }
+    }
+
+    if (watch) {
+        watch->timeout = timeout;
+        watch->main = thread == pthread_mach_thread_np(pthread_main_thread_np());
+        atomic_store(&watch->busy, false);
+        atomic_store(&watch->lastBeat, ImpactTimeGetMonotonicNanoseconds());
+        atomic_store(&watch->thread, thread);
+    }
+
+    pthread_mutex_unlock(&monitor->lock);
+
+    return watch;
+}
+
+void ImpactHangMonitorUnregisterThread(ImpactHangMonitor* monitor, ImpactHangWatch* watch) {
+    if (ImpactInvalidPtr(monitor) || ImpactInvalidPtr(watch)) {
+        return;
+    }
+
+    // Once this returns, the watchdog can no longer be holding the thread suspended.
+    pthread_mutex_lock(&monitor->lock);
+
+    while (monitor->sampling == watch) {
+        pthread_cond_wait(&monitor->sampled, &monitor->lock);
+    }
+
+    atomic_store(&watch->thread, MACH_PORT_NULL);
+    pthread_mutex_unlock(&monitor->lock);
+}
+
+void ImpactHangWatchBeat(ImpactHangWatch* watch) {
+    atomic_store_explicit(&watch->lastBeat, ImpactTimeGetMonotonicNanoseconds(), memory_order_relaxed);
+    atomic_store_explicit(&watch->busy, true, memory_order_relaxed);
+}
+
+void ImpactHangWatchIdle(ImpactHangWatch* watch) {
+    atomic_store_explicit(&watch->busy, false, memory_order_relaxed);
+}
+
+#pragma mark - Call Tree
+
+void ImpactHangRecordSample(ImpactHang* hang, const uintptr_t* ips, uint32_t count) {
+    if (ImpactInvalidPtr(hang) || ImpactInvalidPtr(ips) || count == 0) {
+        return;
+    }
+
+    if (ImpactCallTreeAddSample(&hang->tree, ips, count) == false) {
+        hang->truncatedSamples += 1;
+    }
+
+    hang->samples += 1;
+}
+
+#pragma mark - Sampling
+
+static void ImpactHangBegin(ImpactHangMonitor* monitor, ImpactHangWatch* watch, uint64_t beat) {
+    ImpactHang* hang = &monitor->hang;
+
+    hang->watch = watch;
+    hang->thread = atomic_load(&watch->thread);
+    hang->beat = beat;
+    hang->timeout = watch->timeout;
+    hang->main = watch->main;
+    hang->reported = false;
+
+    hang->samples = 0;
+    hang->failedSamples = 0;
+    hang->truncatedSamples = 0;
+    hang->samplingDuration = 0;
+    hang->slowestSample = 0;
+
+    ImpactCallTreeInitialize(&hang->tree, hang->nodes, ImpactHangNodeCapacity);
+
+    // images are only looked up while the thread is suspended, and written with the report
+    ImpactBinaryImageInitialize(&monitor->state);
+    monitor->state.mutableState.images.deferLogging = true;
+}
+
+static bool ImpactHangHasEnded(const ImpactHang* hang) {
+    const ImpactHangWatch* watch = hang->watch;
+
+    return atomic_load(&watch->thread) != hang->thread ||
+        atomic_load(&watch->lastBeat) != hang->beat ||
+        atomic_load(&watch->busy) == false;
+}
+
+// The time the thread spends suspended is bounded by the frame limit.
+static void ImpactHangSample(ImpactHangMonitor* monitor) {
+    ImpactHang* hang = &monitor->hang;
+    ImpactState* state = &monitor->state;
+
+    const ImpactThreadUnwindPolicies* policies = &state->constantState.threadPolicies;
+    const ImpactThreadUnwindPolicy* policy = hang->main ? &policies->mainThread : &policies->otherThreads;
+    const uint32_t limit = policy->frameLimit < ImpactHangFrameLimit ? policy->frameLimit : ImpactHangFrameLimit;
+
+    uintptr_t ips[ImpactHangFrameLimit];
+    uint32_t count = 0;
+
+    const uint64_t start = ImpactTimeGetMonotonicNanoseconds();
+    const ImpactResult result = ImpactThreadSample(state, hang->thread, policy->strategies, ips, limit, &count);
+    const uint64_t duration = ImpactTimeGetMonotonicNanoseconds() - start;
+
+    hang->samplingDuration += duration;
+
+    if (duration > hang->slowestSample) {
+        hang->slowestSample = duration;
+    }
+
+    if (count == 0) {
+        hang->failedSamples += 1;
+        return;
+    }
+
+    if (count == limit && result == ImpactResultSuccess) {
+        hang->truncatedSamples += 1;
+    }
+
+    ImpactHangRecordSample(hang, ips, count);
+}
+
+#pragma mark - Reports
+
+static void ImpactHangLogNode(ImpactState* state, const ImpactCallTreeNode* node) {
+    ImpactLogger* log = ImpactStateGetLog(state);
+
+    // must happen before the record begins, as finding an image can log it
+    ImpactMachOData imageData = {0};
+    const bool found = ImpactBinaryImageFind(state, node->ip, &imageData) == ImpactResultSuccess;
+
+    ImpactLogBeginRecord(log, "Hang:Node");
+
+    if (node->parent != ImpactCallTreeNodeNone) {
+        ImpactLogWriteKeyInteger(log, "parent", node->parent, false);
+    }
+
+    if (found) {
+        ImpactLogWriteKeyInteger(log, "image", imageData.index, false);
+        ImpactLogWriteKeyInteger(log, "offset", node->ip - imageData.loadAddress, false);
+    } else {
+        ImpactLogWriteKeyInteger(log, "ip", node->ip, false);
+    }
+
+    ImpactLogWriteKeyInteger(log, "count", node->count, false);
+    ImpactLogWriteKeyInteger(log, "leaf", node->leafCount, true);
+}
+
+static ImpactResult ImpactHangMonitorReport(ImpactHangMonitor* monitor, uint64_t now, bool ongoing) {
+    const ImpactHang* hang = &monitor->hang;
+    ImpactState* state = &monitor->state;
+    char path[PATH_MAX];
+
+    if (snprintf(path, sizeof(path), "%s/Hang-%llu.log", monitor->directory, (unsigned long long)ImpactTimeGetEpochMilliseconds()) >= (int)sizeof(path)) {
+        return ImpactResultArgumentInvalid;
+    }
+
+    ImpactResult result = ImpactLogInitializeWithEncoding(state, path, monitor->encoding);
+    if (result != ImpactResultSuccess) {
+        return result;
+    }
+
+    ImpactLogger* log = ImpactStateGetLog(state);
+
+    ImpactLogBeginRecord(log, "Hang");
+    ImpactLogWriteKeyInteger(log, "main", hang->main, false);
+    ImpactLogWriteKeyInteger(log, "duration", now - hang->beat, false);
+    ImpactLogWriteKeyInteger(log, "timeout", hang->timeout, false);
+    ImpactLogWriteKeyInteger(log, "ongoing", ongoing, false);
+    ImpactLogWriteKeyInteger(log, "samples", hang->samples, false);
+    ImpactLogWriteKeyInteger(log, "failed", hang->failedSamples, false);
+    ImpactLogWriteKeyInteger(log, "truncated", hang->truncatedSamples, false);
+    ImpactLogWriteKeyInteger(log, "interval", monitor->sampleInterval, false);
+    ImpactLogWriteKeyInteger(log, "sampling", hang->samplingDuration, false);
+    ImpactLogWriteKeyInteger(log, "sample_max", hang->slowestSample, false);
+    ImpactLogWriteKeyInteger(log, "nodes", hang->tree.nodeCount, false);
+    ImpactLogWriteKeyInteger(log, "pid", getpid(), false);
+    ImpactLogWriteTime(log, "time", true);
+
+    ImpactBinaryImageInitialize(state);
+
+    for (uint32_t i = 0; i < hang->tree.nodeCount; ++i) {
+        ImpactHangLogNode(state, &hang->nodes[i]);
+    }
+
+    ImpactBinaryImageLogReferencedImages(state);
+
+    monitor->reportCount += 1;
+
+    return ImpactLogDeinitialize(log);
+}
+
+#pragma mark - Watchdog
+
+// What the watchdog decided to do while holding the lock. Sampling and reporting happen after it is
+// released, so registering, unregistering and stopping never wait on file I/O.
+typedef struct {
+    uint64_t wait; // how long to wait before checking again
+    bool sample;
+    bool report;
+    bool ongoing;
+} ImpactHangStep;
+
+static ImpactHangStep ImpactHangMonitorCheck(ImpactHangMonitor* monitor, uint64_t now) {
+    ImpactHang* hang = &monitor->hang;
+    ImpactHangStep step = { .wait = monitor->sampleInterval };
+
+    if (hang->watch) {
+        if (ImpactHangHasEnded(hang)) {
+            step.report = hang->reported == false;
+
+            // the hang's data stays put until the next one begins, which can't happen before the report
+            hang->watch = NULL;
+
+            return step;
+        }
+
+        if (hang->reported) {
+            // nothing more to do but wait for it to end
+            step.wait = hang->timeout / 2;
+
+            return step;
+        }
+
+        step.sample = hang->samples + hang->failedSamples < ImpactHangSampleLimit;
+
+        if (monitor->reportThreshold > 0 && now - hang->beat >= monitor->reportThreshold) {
+            step.report = true;
+            step.ongoing = true;
+            hang->reported = true;
+        }
+
+        return step;
+    }
+
+    uint64_t wait = NSEC_PER_SEC;
+
+    for (uint32_t i = 0; i < ImpactHangWatchLimit; ++i) {
+        ImpactHangWatch* watch = &monitor->watches[i];
+
+        if (atomic_load(&watch->thread) == MACH_PORT_NULL) {
+            continue;
+        }
+
+        const uint64_t beat = atomic_load(&watch->lastBeat);
+
+        if (atomic_load(&watch->busy) && now > beat && now - beat >= watch->timeout) {
+            ImpactHangBegin(monitor, watch, beat);
+
+            step.sample = true;
+
+            return step;
+        }
+
+        if (watch->timeout / 2 < wait) {
+            wait = watch->timeout / 2;
+        }
+    }
+
+    step.wait = wait > monitor->sampleInterval ? wait : monitor->sampleInterval;
+
+    return step;
+}
+
+static void* ImpactHangMonitorRun(void* context) {
+    ImpactHangMonitor* monitor = context;
+
+    pthread_setname_np("io.chimehq.Impact.HangMonitor");
+
+    pthread_mutex_lock(&monitor->lock);
+
+    while (monitor->running) {
+        const uint64_t now = ImpactTimeGetMonotonicNanoseconds();
+        const ImpactHangStep step = ImpactHangMonitorCheck(monitor, now);
+
+        if (step.sample || step.report) {
+            // unregistering this watch now waits until the thread has been resumed
+            monitor->sampling = step.sample ? monitor->hang.watch : NULL;
+
+            pthread_mutex_unlock(&monitor->lock);
+
+            if (step.sample) {
+                ImpactHangSample(monitor);
+            }
+
+            if (step.report) {
+                ImpactHangMonitorReport(monitor, now, step.ongoing);
+            }
+
+            pthread_mutex_lock(&monitor->lock);
+
+            monitor->sampling = NULL;
+            pthread_cond_broadcast(&monitor->sampled);
+
+            if (monitor->running == false) {
+                break;
+            }
+        }
+
+        const struct timespec timeout = {
+            .tv_sec = (time_t)(step.wait / NSEC_PER_SEC),
+            .tv_nsec = (long)(step.wait % NSEC_PER_SEC)
+        };
+
+        pthread_cond_timedwait_relative_np(&monitor->condition, &monitor->lock, &timeout);
+    }
+
+    pthread_mutex_unlock(&monitor->lock);
+
+    return NULL;
+}
+
+ImpactResult ImpactHangMonitorStart(ImpactHangMonitor* monitor) {
+    if (ImpactInvalidPtr(monitor)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    pthread_mutex_lock(&monitor->lock);
+
+    if (monitor->running) {
+        pthread_mutex_unlock(&monitor->lock);
+        return ImpactResultStateInvalid;
+    }
+
+    monitor->running = true;
+    monitor->hang.watch = NULL;
+
+    const int result = pthread_create(&monitor->thread, NULL, ImpactHangMonitorRun, monitor);
+    if (result != 0) {
+        monitor->running = false;
+    }
+
+    pthread_mutex_unlock(&monitor->lock);
+
+    return result == 0 ? ImpactResultSuccess : ImpactResultCallFailed;
+}
+
+ImpactResult ImpactHangMonitorStop(ImpactHangMonitor* monitor) {
+    if (ImpactInvalidPtr(monitor)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    pthread_mutex_lock(&monitor->lock);
+
+    if (monitor->running == false) {
+        pthread_mutex_unlock(&monitor->lock);
+        return ImpactResultStateInvalid;
+    }
+
+    monitor->running = false;
+    pthread_cond_signal(&monitor->condition);
+
+    pthread_mutex_unlock(&monitor->lock);
+
+    pthread_join(monitor->thread, NULL);
+
+    return ImpactResultSuccess;
+}
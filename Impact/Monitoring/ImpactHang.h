@@ -0,0 +1,97 @@
+//
+//  ImpactHang.h
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#ifndef ImpactHang_h
+#define ImpactHang_h
+
+#include "ImpactState.h"
+#include "ImpactResult.h"
+#include "ImpactCallTree.h"
+
+#include <limits.h>
+#include <mach/mach.h>
+
+_Pragma("clang assume_nonnull begin")
+__BEGIN_DECLS
+
+enum {
+    ImpactHangWatchLimit = 8,
+    ImpactHangFrameLimit = 128,
+    ImpactHangNodeCapacity = 4096,
+    ImpactHangSampleLimit = 2000
+};
+
+// A thread that is expected to beat at least once per timeout while it is busy. Idle threads, like a
+// run loop waiting for events, are not watched until they beat again.
+typedef struct {
+    _Atomic thread_act_t thread; // MACH_PORT_NULL when unused
+    _Atomic uint64_t lastBeat;
+    _Atomic bool busy;
+    uint64_t timeout; // nanoseconds
+    bool main;
+} ImpactHangWatch;
+
+typedef struct {
+    ImpactHangWatch* _Nullable watch;
+    thread_act_t thread;
+    uint64_t beat; // the last beat before the hang
+    uint64_t timeout; // copied from the watch, which can be reused once the hang ends
+    bool main;
+    bool reported;
+
+    uint32_t samples;
+    uint32_t failedSamples;
+    uint32_t truncatedSamples; // ran out of frames or nodes
+    uint64_t samplingDuration; // nanoseconds, in total
+    uint64_t slowestSample; // the longest the thread was held suspended
+
+    ImpactCallTree tree;
+    ImpactCallTreeNode nodes[ImpactHangNodeCapacity];
+} ImpactHang;
+
+typedef struct {
+    ImpactState state;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t condition;
+    pthread_cond_t sampled; // signalled when the watchdog lets go of a thread
+    ImpactHangWatch* _Nullable sampling; // the watch whose thread is being sampled, outside the lock
+    bool running;
+
+    char directory[PATH_MAX];
+    ImpactLogEncoding encoding;
+    uint64_t sampleInterval; // nanoseconds
+    uint64_t reportThreshold; // hangs this long are reported without waiting for them to end
+    uint32_t reportCount;
+
+    ImpactHangWatch watches[ImpactHangWatchLimit];
+    ImpactHang hang;
+} ImpactHangMonitor;
+
+// Takes the unwind configuration of an existing state. Hang reports are written to the directory, which
+// must exist. Not async-signal-safe.
+ImpactResult ImpactHangMonitorInitialize(ImpactHangMonitor* monitor, const ImpactState* source, const char* directory, ImpactLogEncoding encoding, uint64_t sampleInterval, uint64_t reportThreshold);
+ImpactResult ImpactHangMonitorStart(ImpactHangMonitor* monitor);
+// Waits for the watchdog thread to exit. Unregister all watches before deinitializing.
+ImpactResult ImpactHangMonitorStop(ImpactHangMonitor* monitor);
+ImpactResult ImpactHangMonitorDeinitialize(ImpactHangMonitor* monitor);
+
+// Returns NULL when every watch is in use. The thread starts out idle.
+ImpactHangWatch* _Nullable ImpactHangMonitorRegisterThread(ImpactHangMonitor* monitor, thread_act_t thread, uint64_t timeout);
+void ImpactHangMonitorUnregisterThread(ImpactHangMonitor* monitor, ImpactHangWatch* watch);
+
+// Both are cheap enough to call from a run loop observer.
+void ImpactHangWatchBeat(ImpactHangWatch* watch);
+void ImpactHangWatchIdle(ImpactHangWatch* watch);
+
+// Adds one stack, innermost frame first, to the hang's call tree.
+void ImpactHangRecordSample(ImpactHang* hang, const uintptr_t* ips, uint32_t count);
+
+__END_DECLS
+_Pragma("clang assume_nonnull end")
+
+#endif /* ImpactHang_h */
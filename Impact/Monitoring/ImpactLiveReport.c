@@ -0,0 +1,175 @@
+//
+//  ImpactLiveReport.c
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#include "ImpactLiveReport.h"
+#include "ImpactUtility.h"
+#include "ImpactThread.h"
+#include "ImpactBinaryImage.h"
+#include "ImpactLog.h"
+#include "ImpactTime.h"
+#include "ImpactArena.h"
+
+#include <string.h>
+#include <unistd.h>
+
+ImpactResult ImpactLiveReporterInitialize(ImpactLiveReporter* reporter, const ImpactState* source, size_t arenaSize, uint64_t minimumInterval) {
+    if (ImpactInvalidPtr(reporter) || ImpactInvalidPtr(source)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    memset(reporter, 0, sizeof(ImpactLiveReporter));
+
+    ImpactState* state = &reporter->state;
+
+    // a live report is never a crash, so there is nothing to be gained by cutting it short
+    ImpactStateInitializeDerived(state, source, ImpactStateDerivedOptionNoTimeLimit);
+
+    if (pthread_mutex_init(&reporter->lock, NULL) != 0) {
+        return ImpactResultFailure;
+    }
+
+    reporter->minimumInterval = minimumInterval;
+
+    return ImpactArenaInitialize(&state->mutableState.arena, arenaSize);
+}
+
+ImpactResult ImpactLiveReporterDeinitialize(ImpactLiveReporter* reporter) {
+    if (ImpactInvalidPtr(reporter)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    pthread_mutex_destroy(&reporter->lock);
+
+    return ImpactArenaDeinitialize(&reporter->state.mutableState.arena);
+}
+
+static bool ImpactLiveReportCrashInProgress(void) {
+    if (GlobalImpactState == NULL) {
+        return false;
+    }
+
+    const ImpactCrashState crashState = atomic_load(&GlobalImpactState->mutableState.crashState);
+
+    return crashState != ImpactCrashStateUninitialized && crashState != ImpactCrashStateInitialized;
+}
+
+static ImpactResult ImpactLiveReportLogTiming(ImpactState* state, uint64_t start) {
+    ImpactLogger* log = ImpactStateGetLog(state);
+    const ImpactCrashMetrics* metrics = &state->mutableState.metrics;
+    const uint64_t* durations = metrics->phaseDurations;
+
+    ImpactLogBeginRecord(log, "Timing");
+    ImpactLogWriteKeyInteger(log, "enumerate", durations[ImpactCrashPhaseThreadEnumeration], false);
+    ImpactLogWriteKeyInteger(log, "suspend", durations[ImpactCrashPhaseSuspend], false);
+    ImpactLogWriteKeyInteger(log, "unwind", durations[ImpactCrashPhaseUnwind], false);
+    ImpactLogWriteKeyInteger(log, "format", durations[ImpactCrashPhaseFormat], false);
+    ImpactLogWriteKeyInteger(log, "images", durations[ImpactCrashPhaseImages], false);
+    ImpactLogWriteKeyInteger(log, "resume", durations[ImpactCrashPhaseResume], false);
+    ImpactLogWriteKeyInteger(log, "suspended", metrics->suspendedDuration, false);
+    ImpactLogWriteKeyInteger(log, "total", ImpactTimeGetMonotonicNanoseconds() - start, false);
+
+    return ImpactLogWriteKeyInteger(log, "threads", metrics->threadCount, true);
+}
+
+static ImpactResult ImpactLiveReportLogThreads(ImpactState* state) {
+    const uint64_t start = ImpactTimeGetMonotonicNanoseconds();
+
+    ImpactThreadList list = {0};
+
+    ImpactResult result = ImpactThreadListInitialize(&list, ImpactThreadNoneCrashed, NULL);
+
+    ImpactStateRecordPhase(state, ImpactCrashPhaseThreadEnumeration, start);
+
+    if (result != ImpactResultSuccess) {
+        return result;
+    }
+
+    ImpactThreadListSnapshot snapshot = {0};
+
+    result = ImpactThreadListCapture(state, &list, &snapshot);
+    if (result == ImpactResultSuccess) {
+        // Unlike a crash, the process has to keep going, so threads are resumed before any formatting.
+        ImpactThreadListResume(state, &list);
+
+        result = ImpactThreadListSnapshotLog(state, &list, &snapshot);
+    } else {
+        result = ImpactThreadListLog(state, &list);
+    }
+
+    ImpactThreadListDeinitialize(&list);
+
+    return result;
+}
+
+ImpactResult ImpactLiveReportCapture(ImpactLiveReporter* reporter, const char* path, ImpactLogEncoding encoding) {
+    if (ImpactInvalidPtr(reporter) || ImpactInvalidPtr(path)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    if (ImpactLiveReportCrashInProgress()) {
+        return ImpactResultStateInvalid;
+    }
+
+    // a trigger that arrives during a capture is dropped, rather than queued behind it
+    if (pthread_mutex_trylock(&reporter->lock) != 0) {
+        return ImpactResultStateInvalid;
+    }
+
+    const uint64_t start = ImpactTimeGetMonotonicNanoseconds();
+
+    if (reporter->captureCount > 0 && start - reporter->lastCapture < reporter->minimumInterval) {
+        reporter->rateLimitedCount += 1;
+        pthread_mutex_unlock(&reporter->lock);
+
+        return ImpactResultRateLimited;
+    }
+
+    ImpactState* state = &reporter->state;
+
+    ImpactResult result = ImpactLogInitializeWithEncoding(state, path, encoding);
+    if (result != ImpactResultSuccess) {
+        pthread_mutex_unlock(&reporter->lock);
+        return result;
+    }
+
+    reporter->lastCapture = start;
+    reporter->captureCount += 1;
+
+    ImpactLogger* log = ImpactStateGetLog(state);
+
+    ImpactLogBeginRecord(log, "Live");
+    ImpactLogWriteKeyInteger(log, "pid", getpid(), false);
+    ImpactLogWriteKeyInteger(log, "capture", reporter->captureCount, false);
+    ImpactLogWriteKeyInteger(log, "rate_limited", reporter->rateLimitedCount, false);
+    ImpactLogWriteTime(log, "time", true);
+
+    memset(&state->mutableState.metrics, 0, sizeof(ImpactCrashMetrics));
+    ImpactArenaReset(&state->mutableState.arena);
+    state->mutableState.crashDeadline = 0;
+
+    result = ImpactBinaryImageInitialize(state);
+    if (result == ImpactResultSuccess) {
+        result = ImpactLiveReportLogThreads(state);
+    }
+
+    if (result == ImpactResultSuccess) {
+        const uint64_t imagesStart = ImpactTimeGetMonotonicNanoseconds();
+
+        result = ImpactBinaryImageLogRemainingImages(state);
+
+        ImpactStateRecordPhase(state, ImpactCrashPhaseImages, imagesStart);
+    }
+
+    ImpactArenaLogStatistics(state);
+    ImpactLiveReportLogTiming(state, start);
+
+    ImpactLogDeinitialize(log);
+
+    pthread_mutex_unlock(&reporter->lock);
+
+    return result;
+}
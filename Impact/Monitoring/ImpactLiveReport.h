@@ -0,0 +1,42 @@
+//
+//  ImpactLiveReport.h
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#ifndef ImpactLiveReport_h
+#define ImpactLiveReport_h
+
+#include "ImpactState.h"
+#include "ImpactResult.h"
+
+#include <limits.h>
+
+_Pragma("clang assume_nonnull begin")
+__BEGIN_DECLS
+
+// Writes every thread's stack to a separate report while the process keeps running. Captures have their
+// own state and arena, so they never touch anything the crash handler depends on.
+typedef struct {
+    ImpactState state;
+    pthread_mutex_t lock;
+    uint64_t minimumInterval; // nanoseconds between captures
+    uint64_t lastCapture;
+    uint32_t captureCount;
+    uint32_t rateLimitedCount;
+} ImpactLiveReporter;
+
+// Takes the configuration of an existing state, so live reports are unwound the same way. Not async-signal-safe.
+ImpactResult ImpactLiveReporterInitialize(ImpactLiveReporter* reporter, const ImpactState* source, size_t arenaSize, uint64_t minimumInterval);
+ImpactResult ImpactLiveReporterDeinitialize(ImpactLiveReporter* reporter);
+
+// Threads are suspended only while they are being unwound, and resumed before anything is written.
+// Returns ImpactResultRateLimited within the minimum interval of the last capture, and ImpactResultStateInvalid
+// if a capture is already in progress or the process is crashing. Not async-signal-safe.
+ImpactResult ImpactLiveReportCapture(ImpactLiveReporter* reporter, const char* path, ImpactLogEncoding encoding);
+
+__END_DECLS
+_Pragma("clang assume_nonnull end")
+
+#endif /* ImpactLiveReport_h */
@@ -12,6 +12,8 @@
 #include "ImpactSignal.h"
 #include "ImpactState.h"
 #include "ImpactCrashHandler.h"
+#include "ImpactReportStore.h"
+#include "ImpactBinaryImage.h"
 
 #include <mach/task.h>
 #include <mach/mach_port.h>
@@ -109,7 +111,7 @@ static ImpactResult ImpactMachExceptionSetupThread(void* ctx) {
 
     result = pthread_create(&thread, &attrs, ImpactMachExceptionServer, ctx);
     if (result != 0) {
-        ImpactDebugLog("[Log:WARN] unable to create pthread %ld\n", result);
+        ImpactDebugLogWarn("[Log:WARN] unable to create pthread %ld\n", result);
         return ImpactResultFailure;
     }
 
@@ -154,7 +156,7 @@ ImpactResult ImpactMachExceptionLogPreexistingHandlers(const ImpactState* state)
 
         const ImpactResult result = ImpactMachExceptionGetHandler(state, i, &handler);
         if (result != ImpactResultSuccess) {
-            ImpactDebugLog("[Log:WARN] unable to read preexisting mach handler %d\n", result);
+            ImpactDebugLogWarn("[Log:WARN] unable to read preexisting mach handler %d\n", result);
             continue;
         }
 
@@ -162,7 +164,7 @@ ImpactResult ImpactMachExceptionLogPreexistingHandlers(const ImpactState* state)
             continue;
         }
 
-        ImpactDebugLog("[Log:INFO] preexisting mach exception handler %d - %x, %x\n", i, handler.mask, handler.behavior);
+        ImpactDebugLogInfo("[Log:INFO] preexisting mach exception handler %d - %x, %x\n", i, handler.mask, handler.behavior);
     }
 
     return ImpactResultSuccess;
@@ -176,19 +178,19 @@ ImpactResult ImpactMachExceptionInitialize(ImpactState* state) {
 
     kern_return_t kr = mach_port_allocate(task, MACH_PORT_RIGHT_RECEIVE, port);
     if (kr != KERN_SUCCESS) {
-        ImpactDebugLog("[Log:%s] unable to allocate port %d\n", __func__, kr);
+        ImpactDebugLogWarn("[Log:%s] unable to allocate port %d\n", __func__, kr);
         return ImpactResultFailure;
     }
 
     kr = mach_port_insert_right(task, *port, *port, MACH_MSG_TYPE_MAKE_SEND);
     if (kr != KERN_SUCCESS) {
-        ImpactDebugLog("[Log:%s] unable to insert port right %d\n", __func__, kr);
+        ImpactDebugLogWarn("[Log:%s] unable to insert port right %d\n", __func__, kr);
         return ImpactResultFailure;
     }
 
     ImpactResult result = ImpactMachExceptionSetupThread(state);
     if (result != ImpactResultSuccess) {
-        ImpactDebugLog("[Log:%s] unable to start thread %d\n", __func__, result);
+        ImpactDebugLogWarn("[Log:%s] unable to start thread %d\n", __func__, result);
         return ImpactResultFailure;
     }
 
@@ -211,7 +213,7 @@ ImpactResult ImpactMachExceptionInitialize(ImpactState* state) {
                                    prexistingHandlers->flavors);
 
     if (kr != KERN_SUCCESS) {
-        ImpactDebugLog("[Log:%s] unable to install handler %d\n", __func__, kr);
+        ImpactDebugLogWarn("[Log:%s] unable to install handler %d\n", __func__, kr);
         return ImpactResultFailure;
     }
 
@@ -247,16 +249,20 @@ ImpactResult ImpactMachExceptionRestorePreexisting(const ImpactState* state) {
 static ImpactResult ImpactMachExceptionLog(ImpactState* state, const ImpactMachExceptionRaiseRequest* request) {
     ImpactLogger* log = ImpactStateGetLog(state);
 
-    ImpactLogWriteString(log, "[MachException] ");
+    ImpactLogBeginRecord(log, "MachException");
     
     ImpactLogWriteKeyInteger(log, "number", request->exception, false);
     ImpactLogWriteKeyInteger(log, "code", request->code[0], false);
     ImpactLogWriteKeyInteger(log, "subcode", request->code[1], false);
     ImpactLogWriteTime(log, "time", true);
 
+    if (request->exception == EXC_BAD_ACCESS) {
+        ImpactBinaryImageNoteAddress(state, (uintptr_t)request->code[1]);
+    }
+
     thread_t thread = request->thread.name;
 
-    ImpactDebugLog("[Log:INFO] mach exc request %d, thread %x\n", request->Head.msgh_id, thread);
+    ImpactDebugLogInfo("[Log:INFO] mach exc request %d, thread %x\n", request->Head.msgh_id, thread);
     
     return ImpactResultSuccess;
 }
@@ -291,7 +297,7 @@ static ImpactResult ImpactMachExceptionForward(const ImpactState* state, const I
         handlerCount++;
 
         if ((forwardedMasks & handler.mask) != 0) {
-            ImpactDebugLog("[Log:WARN:%s] duplicate forwarding mask found %x\n", __func__, handler.mask);
+            ImpactDebugLogWarn("[Log:WARN:%s] duplicate forwarding mask found %x\n", __func__, handler.mask);
             continue;
         }
 
@@ -299,7 +305,7 @@ static ImpactResult ImpactMachExceptionForward(const ImpactState* state, const I
 
         result = ImpactMachExceptionSendToHandler(request, &handler);
         if (result != ImpactResultSuccess) {
-            ImpactDebugLog("[Log:WARN:%s] failed forwarding to %x %d\n", __func__, handler.mask, result);
+            ImpactDebugLogWarn("[Log:WARN:%s] failed forwarding to %x %d\n", __func__, handler.mask, result);
             failCount++;
         }
     }
@@ -322,7 +328,7 @@ static ImpactResult ImpactMachExceptionReply(const ImpactMachExceptionRaiseReque
     reply.NDR = request->NDR;
     reply.RetCode = code;
 
-    ImpactDebugLog("[Log:INFO:%s] sending reply message %d\n", __func__, reply.Head.msgh_id);
+    ImpactDebugLogInfo("[Log:INFO:%s] sending reply message %d\n", __func__, reply.Head.msgh_id);
 
     const mach_msg_return_t mr = mach_msg(&reply.Head,
                                           MACH_SEND_MSG,
@@ -332,7 +338,7 @@ static ImpactResult ImpactMachExceptionReply(const ImpactMachExceptionRaiseReque
                                           MACH_MSG_TIMEOUT_NONE,
                                           MACH_PORT_NULL);
     if (mr != MACH_MSG_SUCCESS) {
-        ImpactDebugLog("[Log:ERROR:%s] failed to reply to exception %x\n", __func__, mr);
+        ImpactDebugLogError("[Log:ERROR:%s] failed to reply to exception %x\n", __func__, mr);
         return ImpactResultFailure;
     }
 
@@ -344,7 +350,7 @@ static ImpactResult ImpactMachExceptionReadException(ImpactMachExceptionAllRaise
         return ImpactResultArgumentInvalid;
     }
 
-    ImpactDebugLog("[Log:INFO] waiting on mach exception %x\n", request->raise.Head.msgh_size);
+    ImpactDebugLogInfo("[Log:INFO] waiting on mach exception %x\n", request->raise.Head.msgh_size);
 
     if (ImpactMachExceptionInitSemaphore != NULL) {
         dispatch_semaphore_signal(ImpactMachExceptionInitSemaphore);
@@ -358,7 +364,7 @@ static ImpactResult ImpactMachExceptionReadException(ImpactMachExceptionAllRaise
                                           MACH_MSG_TIMEOUT_NONE,
                                           MACH_PORT_NULL);
     if (mr != MACH_MSG_SUCCESS) {
-        ImpactDebugLog("[Log:ERROR:%s] unable to read exception %x %x\n", __func__, mr, request->raise.Head.msgh_size);
+        ImpactDebugLogError("[Log:ERROR:%s] unable to read exception %x %x\n", __func__, mr, request->raise.Head.msgh_size);
         return ImpactResultFailure;
     }
 
@@ -368,20 +374,22 @@ static ImpactResult ImpactMachExceptionReadException(ImpactMachExceptionAllRaise
 static ImpactResult ImpactMachExceptionProcess(ImpactState* state, const ImpactMachExceptionRaiseRequest* request, bool* forwarded) {
     ImpactResult result = ImpactMachExceptionLog(state, request);
     if (result != ImpactResultSuccess) {
-        ImpactDebugLog("[Log:ERROR] unable to log mach exception %d\n", result);
+        ImpactDebugLogError("[Log:ERROR] unable to log mach exception %d\n", result);
         return result;
     }
 
+    ImpactReportStoreRecordException(state, request->exception);
+
     const thread_act_t thread = request->thread.name;
 
     result = ImpactCrashHandler(state, thread, NULL);
     if (result != ImpactResultSuccess) {
-        ImpactDebugLog("[Log:ERROR] crash handler failed %d\n", result);
+        ImpactDebugLogError("[Log:ERROR] crash handler failed %d\n", result);
     }
 
     result = ImpactMachExceptionForward(state, request, forwarded);
     if (result != ImpactResultSuccess) {
-        ImpactDebugLog("[Log:WARN] failed to forward exception %d\n", result);
+        ImpactDebugLogWarn("[Log:WARN] failed to forward exception %d\n", result);
     }
 
     return result;
@@ -452,27 +460,35 @@ static ImpactResult ImpactMachExceptionHandle(ImpactState* state) {
     }
 
     if (request.raise.task.name != mach_task_self()) {
-        ImpactDebugLog("[Log:INFO:%s] exception from non-self task, ignoring\n", __func__);
+        ImpactDebugLogInfo("[Log:INFO:%s] exception from non-self task, ignoring\n", __func__);
         return ImpactMachExceptionReply(&request.raise, KERN_FAILURE);
     }
 
+    uint64_t start = ImpactTimeGetMonotonicNanoseconds();
+
     ImpactCrashState currentState = ImpactCrashStateUninitialized;
     ImpactMachExceptionHandlerEntranceAdjustState(state, &currentState);
 
+    ImpactStateRecordPhase(state, ImpactCrashPhaseStateTransition, start);
+
+    start = ImpactTimeGetMonotonicNanoseconds();
+
     result = ImpactSignalUninstallHandlers(state);
     if (result != ImpactResultSuccess) {
-        ImpactDebugLog("[Log:ERROR:%s] failed to restore signal handlers %d\n", __func__, result);
+        ImpactDebugLogError("[Log:ERROR:%s] failed to restore signal handlers %d\n", __func__, result);
     }
 
+    ImpactStateRecordPhase(state, ImpactCrashPhaseUninstallHandlers, start);
+
     if (currentState == ImpactCrashStateInitialized) {
         bool forwarded = false;
         result = ImpactMachExceptionProcess(state, &request.raise, &forwarded);
         if (result != ImpactResultSuccess) {
-            ImpactDebugLog("[Log:WARN:%s] failed to process exception %d\n", __func__, result);
+            ImpactDebugLogWarn("[Log:WARN:%s] failed to process exception %d\n", __func__, result);
         }
 
         if (forwarded) {
-            ImpactDebugLog("[Log:INFO:%s] forwarded message to preexisting handler\n", __func__);
+            ImpactDebugLogInfo("[Log:INFO:%s] forwarded message to preexisting handler\n", __func__);
             return result;
         }
     }
@@ -484,11 +500,11 @@ static ImpactResult ImpactMachExceptionHandle(ImpactState* state) {
     // In all these cases, we tell the kernel that we were unable to handle this
     // exception, and it should continue the termination process.
 
-    ImpactDebugLog("[Log:INFO:%s] replying directly with KERN_FAILURE\n", __func__);
+    ImpactDebugLogInfo("[Log:INFO:%s] replying directly with KERN_FAILURE\n", __func__);
 
     result = ImpactMachExceptionReply(&request.raise, KERN_FAILURE);
     if (result != ImpactResultSuccess) {
-        ImpactDebugLog("[Log:ERROR:%s] direct reply failed %d\n", __func__, result);
+        ImpactDebugLogError("[Log:ERROR:%s] direct reply failed %d\n", __func__, result);
         return result;
     }
 
@@ -508,7 +524,7 @@ static void* ImpactMachExceptionServer(void* ctx) {
         }
     }
 
-    ImpactDebugLog("[Log:INFO:%s] exception handling thread exiting\n", __func__);
+    ImpactDebugLogInfo("[Log:INFO:%s] exception handling thread exiting\n", __func__);
 
     return NULL;
 }
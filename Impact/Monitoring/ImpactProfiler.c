@@ -0,0 +1,355 @@
+//
+//  ImpactProfiler.c
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#include "ImpactProfiler.h"
+#include "ImpactUtility.h"
+#include "ImpactThread.h"
+#include "ImpactBinaryImage.h"
+#include "ImpactTime.h"
+
+#include <dlfcn.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+ImpactResult ImpactProfilerInitialize(ImpactProfiler* profiler, const ImpactState* source, uint64_t interval) {
+    if (ImpactInvalidPtr(profiler)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    memset(profiler, 0, offsetof(ImpactProfiler, ring));
+
+    ImpactState* state = &profiler->state;
+
+    ImpactStateInitializeDerived(state, source, ImpactStateDerivedOptionReferencedImages);
+
+    // a profile is a blend of every thread, so only the strategies common to all of them apply
+    const ImpactThreadUnwindPolicies* policies = &state->constantState.threadPolicies;
+
+    profiler->strategies = source ? policies->mainThread.strategies & policies->otherThreads.strategies : ImpactUnwindStrategyAll;
+
+    if (interval < ImpactProfilerMinimumInterval) {
+        interval = ImpactProfilerMinimumInterval;
+    } else if (interval > ImpactProfilerMaximumInterval) {
+        interval = ImpactProfilerMaximumInterval;
+    }
+
+    profiler->interval = interval;
+
+    atomic_store(&profiler->ring.head, 0);
+    atomic_store(&profiler->ring.tail, 0);
+
+    ImpactCallTreeInitialize(&profiler->tree, profiler->nodes, ImpactProfilerNodeCapacity);
+
+    if (pthread_mutex_init(&profiler->lock, NULL) != 0) {
+        return ImpactResultFailure;
+    }
+
+    if (pthread_mutex_init(&profiler->treeLock, NULL) != 0) {
+        pthread_mutex_destroy(&profiler->lock);
+        return ImpactResultFailure;
+    }
+
+    if (pthread_cond_init(&profiler->condition, NULL) != 0) {
+        pthread_mutex_destroy(&profiler->treeLock);
+        pthread_mutex_destroy(&profiler->lock);
+        return ImpactResultFailure;
+    }
+
+    return ImpactBinaryImageInitialize(state);
+}
+
+ImpactResult ImpactProfilerDeinitialize(ImpactProfiler* profiler) {
+    if (ImpactInvalidPtr(profiler)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    pthread_cond_destroy(&profiler->condition);
+    pthread_mutex_destroy(&profiler->treeLock);
+    pthread_mutex_destroy(&profiler->lock);
+
+    return ImpactResultSuccess;
+}
+
+ImpactResult ImpactProfilerSetThreads(ImpactProfiler* profiler, const thread_act_t* threads, uint32_t count) {
+    if (ImpactInvalidPtr(profiler) || ImpactInvalidPtr(threads)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    if (count > ImpactProfilerThreadLimit) {
+        return ImpactResultArgumentInvalid;
+    }
+
+    pthread_mutex_lock(&profiler->lock);
+
+    if (profiler->running) {
+        pthread_mutex_unlock(&profiler->lock);
+        return ImpactResultStateInvalid;
+    }
+
+    memcpy(profiler->threads, threads, count * sizeof(thread_act_t));
+    profiler->threadCount = count;
+
+    pthread_mutex_unlock(&profiler->lock);
+
+    return ImpactResultSuccess;
+}
+
+#pragma mark - Sampling
+
+static void ImpactProfilerSampleThread(ImpactProfiler* profiler, thread_act_t thread, uint64_t time) {
+    ImpactProfilerRing* ring = &profiler->ring;
+    ImpactProfilerStatistics* statistics = &profiler->statistics;
+
+    const uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    const uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+    if (head - tail >= ImpactProfilerRingCapacity) {
+        statistics->dropped += 1;
+        return;
+    }
+
+    ImpactProfilerSample* sample = &ring->samples[head % ImpactProfilerRingCapacity];
+    uint32_t count = 0;
+
+    // the stack is unwound straight into the ring, so nothing is copied
+    ImpactThreadSample(&profiler->state, thread, profiler->strategies, sample->ips, ImpactProfilerFrameLimit, &count);
+
+    if (count == 0) {
+        statistics->failed += 1;
+        return;
+    }
+
+    sample->thread = thread;
+    sample->count = count;
+    sample->time = time;
+
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+
+    statistics->samples += 1;
+}
+
+static void ImpactProfilerTick(ImpactProfiler* profiler) {
+    const uint64_t start = ImpactTimeGetMonotonicNanoseconds();
+    const thread_act_t threadSelf = pthread_mach_thread_np(pthread_self());
+
+    if (profiler->threadCount > 0) {
+        for (uint32_t i = 0; i < profiler->threadCount; ++i) {
+            if (profiler->threads[i] != threadSelf) {
+                ImpactProfilerSampleThread(profiler, profiler->threads[i], start);
+            }
+        }
+    } else {
+        ImpactThreadList list = {0};
+
+        if (ImpactThreadListInitialize(&list, ImpactThreadNoneCrashed, NULL) != ImpactResultSuccess) {
+            profiler->statistics.failed += 1;
+            return;
+        }
+
+        for (mach_msg_type_number_t i = 0; i < list.count; ++i) {
+            if (list.threads[i] != list.threadSelf) {
+                ImpactProfilerSampleThread(profiler, list.threads[i], start);
+            }
+        }
+
+        ImpactThreadListDeinitialize(&list);
+    }
+
+    ImpactProfilerStatistics* statistics = &profiler->statistics;
+    const uint64_t duration = ImpactTimeGetMonotonicNanoseconds() - start;
+
+    statistics->ticks += 1;
+    statistics->samplingDuration += duration;
+
+    if (duration > statistics->slowestTick) {
+        statistics->slowestTick = duration;
+    }
+}
+
+static void* ImpactProfilerRun(void* context) {
+    ImpactProfiler* profiler = context;
+
+    pthread_setname_np("io.chimehq.Impact.Profiler");
+
+    const struct timespec timeout = {
+        .tv_sec = (time_t)(profiler->interval / 1000000000),
+        .tv_nsec = (long)(profiler->interval % 1000000000)
+    };
+
+    pthread_mutex_lock(&profiler->lock);
+
+    while (profiler->running) {
+        ImpactProfilerTick(profiler);
+
+        if (profiler->statistics.ticks % ImpactProfilerAggregateInterval == 0) {
+            ImpactProfilerAggregate(profiler);
+        }
+
+        pthread_cond_timedwait_relative_np(&profiler->condition, &profiler->lock, &timeout);
+    }
+
+    pthread_mutex_unlock(&profiler->lock);
+
+    return NULL;
+}
+
+ImpactResult ImpactProfilerStart(ImpactProfiler* profiler) {
+    if (ImpactInvalidPtr(profiler)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    pthread_mutex_lock(&profiler->lock);
+
+    if (profiler->running) {
+        pthread_mutex_unlock(&profiler->lock);
+        return ImpactResultStateInvalid;
+    }
+
+    profiler->running = true;
+
+    const int result = pthread_create(&profiler->thread, NULL, ImpactProfilerRun, profiler);
+    if (result != 0) {
+        profiler->running = false;
+    }
+
+    pthread_mutex_unlock(&profiler->lock);
+
+    return result == 0 ? ImpactResultSuccess : ImpactResultCallFailed;
+}
+
+ImpactResult ImpactProfilerStop(ImpactProfiler* profiler) {
+    if (ImpactInvalidPtr(profiler)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    pthread_mutex_lock(&profiler->lock);
+
+    if (profiler->running == false) {
+        pthread_mutex_unlock(&profiler->lock);
+        return ImpactResultStateInvalid;
+    }
+
+    profiler->running = false;
+    pthread_cond_signal(&profiler->condition);
+
+    pthread_mutex_unlock(&profiler->lock);
+
+    pthread_join(profiler->thread, NULL);
+
+    return ImpactProfilerAggregate(profiler);
+}
+
+#pragma mark - Aggregation
+
+ImpactResult ImpactProfilerAggregate(ImpactProfiler* profiler) {
+    if (ImpactInvalidPtr(profiler)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    ImpactProfilerRing* ring = &profiler->ring;
+
+    // the lock makes whoever is aggregating the only consumer
+    pthread_mutex_lock(&profiler->treeLock);
+
+    const uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+    for (; tail != head; ++tail) {
+        const ImpactProfilerSample* sample = &ring->samples[tail % ImpactProfilerRingCapacity];
+
+        if (ImpactCallTreeAddSample(&profiler->tree, sample->ips, sample->count) == false) {
+            profiler->statistics.truncated += 1;
+        }
+    }
+
+    atomic_store_explicit(&ring->tail, tail, memory_order_release);
+
+    pthread_mutex_unlock(&profiler->treeLock);
+
+    return ImpactResultSuccess;
+}
+
+ImpactResult ImpactProfilerGetStatistics(ImpactProfiler* profiler, ImpactProfilerStatistics* statistics) {
+    if (ImpactInvalidPtr(profiler) || ImpactInvalidPtr(statistics)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    pthread_mutex_lock(&profiler->lock);
+    pthread_mutex_lock(&profiler->treeLock);
+
+    *statistics = profiler->statistics;
+
+    pthread_mutex_unlock(&profiler->treeLock);
+    pthread_mutex_unlock(&profiler->lock);
+
+    return ImpactResultSuccess;
+}
+
+#pragma mark - Output
+
+static void ImpactProfilerWriteFrame(FILE* file, uintptr_t ip) {
+    Dl_info info = {0};
+
+    if (dladdr((const void*)ip, &info) == 0 || info.dli_fname == NULL) {
+        fprintf(file, "0x%lx", (unsigned long)ip);
+        return;
+    }
+
+    const char* slash = strrchr(info.dli_fname, '/');
+    const char* image = slash ? slash + 1 : info.dli_fname;
+
+    if (info.dli_sname) {
+        fprintf(file, "%s`%s", image, info.dli_sname);
+    } else {
+        fprintf(file, "%s`0x%lx", image, (unsigned long)(ip - (uintptr_t)info.dli_fbase));
+    }
+}
+
+ImpactResult ImpactProfilerWriteFoldedStacks(ImpactProfiler* profiler, const char* path) {
+    if (ImpactInvalidPtr(profiler) || ImpactInvalidPtr(path)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    ImpactProfilerAggregate(profiler);
+
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        return ImpactResultCallFailed;
+    }
+
+    pthread_mutex_lock(&profiler->treeLock);
+
+    const ImpactCallTree* tree = &profiler->tree;
+    uint32_t stack[ImpactProfilerFrameLimit];
+
+    for (uint32_t i = 0; i < tree->nodeCount; ++i) {
+        const ImpactCallTreeNode* node = &tree->nodes[i];
+
+        if (node->leafCount == 0) {
+            continue;
+        }
+
+        uint32_t depth = 0;
+
+        for (uint32_t index = i; index != ImpactCallTreeNodeNone && depth < ImpactProfilerFrameLimit; index = tree->nodes[index].parent) {
+            stack[depth++] = index;
+        }
+
+        for (uint32_t j = depth; j > 0; --j) {
+            ImpactProfilerWriteFrame(file, tree->nodes[stack[j - 1]].ip);
+            fputc(j > 1 ? ';' : ' ', file);
+        }
+
+        fprintf(file, "%u\n", node->leafCount);
+    }
+
+    pthread_mutex_unlock(&profiler->treeLock);
+
+    return fclose(file) == 0 ? ImpactResultSuccess : ImpactResultCallFailed;
+}
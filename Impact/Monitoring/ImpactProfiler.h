@@ -0,0 +1,104 @@
+//
+//  ImpactProfiler.h
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#ifndef ImpactProfiler_h
+#define ImpactProfiler_h
+
+#include "ImpactState.h"
+#include "ImpactResult.h"
+#include "ImpactCallTree.h"
+
+#include <mach/mach.h>
+
+_Pragma("clang assume_nonnull begin")
+__BEGIN_DECLS
+
+enum {
+    ImpactProfilerFrameLimit = 64,
+    ImpactProfilerRingCapacity = 1024,
+    ImpactProfilerNodeCapacity = 16384,
+    ImpactProfilerThreadLimit = 32,
+    // ticks between moving samples out of the ring and into the tree
+    ImpactProfilerAggregateInterval = 32
+};
+
+// 1kHz to 100Hz. The cost of a sample barely depends on the rate, so overhead scales with it, about
+// tenfold from one end to the other. ImpactProfilerTests' testOverheadAtEachRate measures both ends.
+static const uint64_t ImpactProfilerMinimumInterval = 1000000;
+static const uint64_t ImpactProfilerMaximumInterval = 10000000;
+
+typedef struct {
+    thread_act_t thread;
+    uint32_t count;
+    uint64_t time;
+    uintptr_t ips[ImpactProfilerFrameLimit];
+} ImpactProfilerSample;
+
+// Single producer, single consumer. The sampling thread only ever advances head, and aggregation only
+// ever advances tail.
+typedef struct {
+    _Atomic uint64_t head;
+    _Atomic uint64_t tail;
+    ImpactProfilerSample samples[ImpactProfilerRingCapacity];
+} ImpactProfilerRing;
+
+// The profiler's overhead is samplingDuration over the time spent profiling, and every thread sampled
+// is held suspended for roughly samplingDuration / samples.
+typedef struct {
+    uint64_t ticks;
+    uint64_t samples;
+    uint64_t dropped; // the ring was full
+    uint64_t failed;
+    uint64_t truncated; // ran out of tree nodes
+    uint64_t samplingDuration; // nanoseconds, in total
+    uint64_t slowestTick;
+} ImpactProfilerStatistics;
+
+typedef struct {
+    ImpactState state;
+    uint32_t strategies;
+    uint64_t interval; // nanoseconds
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t condition;
+    bool running;
+
+    thread_act_t threads[ImpactProfilerThreadLimit];
+    uint32_t threadCount; // zero samples every thread
+
+    ImpactProfilerStatistics statistics;
+    ImpactProfilerRing ring;
+
+    pthread_mutex_t treeLock;
+    ImpactCallTree tree;
+    ImpactCallTreeNode nodes[ImpactProfilerNodeCapacity];
+} ImpactProfiler;
+
+// Unwinds the way the source state is configured to, or with every strategy without one. The interval
+// is clamped to the supported range. Not async-signal-safe, like everything else here.
+ImpactResult ImpactProfilerInitialize(ImpactProfiler* profiler, const ImpactState* _Nullable source, uint64_t interval);
+ImpactResult ImpactProfilerDeinitialize(ImpactProfiler* profiler);
+
+// Limits sampling to these threads, which must stay alive while profiling. Must be called before starting.
+ImpactResult ImpactProfilerSetThreads(ImpactProfiler* profiler, const thread_act_t* threads, uint32_t count);
+
+ImpactResult ImpactProfilerStart(ImpactProfiler* profiler);
+ImpactResult ImpactProfilerStop(ImpactProfiler* profiler);
+
+// Moves everything sampled so far into the tree.
+ImpactResult ImpactProfilerAggregate(ImpactProfiler* profiler);
+ImpactResult ImpactProfilerGetStatistics(ImpactProfiler* profiler, ImpactProfilerStatistics* statistics);
+
+// One line per distinct stack, outermost frame first and separated by semicolons, followed by its
+// sample count. Frames are symbolicated with dladdr.
+ImpactResult ImpactProfilerWriteFoldedStacks(ImpactProfiler* profiler, const char* path);
+
+__END_DECLS
+_Pragma("clang assume_nonnull end")
+
+#endif /* ImpactProfiler_h */
@@ -6,8 +6,10 @@
 
 #import <Foundation/Foundation.h>
 
+enum { ImpactRuntimeExceptionMaxFrames = 128 };
+
 static void ImpactNSUncaughtExceptionExceptionHandler(NSException *exception) {
-    ImpactDebugLog("[Log:INFO] uncaught exception\n");
+    ImpactDebugLogInfo("[Log:INFO] uncaught exception\n");
     ImpactRuntimeExceptionLogNSException(exception);
 
     ImpactState* state = GlobalImpactState;
@@ -19,7 +21,7 @@ static void ImpactNSUncaughtExceptionExceptionHandler(NSException *exception) {
     NSUncaughtExceptionHandler* existing = (NSUncaughtExceptionHandler*)state->constantState.preexistingNSExceptionHandler;
 
     if (ImpactInvalidPtr((void*)existing)) {
-        ImpactDebugLog("[Log:WARN] invalid existing NSUncaughtExceptionHandler\n");
+        ImpactDebugLogWarn("[Log:WARN] invalid existing NSUncaughtExceptionHandler\n");
         return;
     }
 
@@ -44,7 +46,7 @@ void ImpactRuntimeExceptionLogNSException(NSException* exception) {
     }
 
     if (atomic_fetch_add(&state->mutableState.exceptionCount, 1) > 1) {
-        ImpactDebugLog("[Log:WARN] subsequent invocation of ImpactRuntimeExceptionLogNSException ignored\n");
+        ImpactDebugLogWarn("[Log:WARN] subsequent invocation of ImpactRuntimeExceptionLogNSException ignored\n");
         return;
     }
 
@@ -54,20 +56,31 @@ void ImpactRuntimeExceptionLogNSException(NSException* exception) {
         return;
     }
 
-    ImpactLogWriteString(log, "[Exception] ");
+    ImpactLogBeginRecord(log, "Exception");
     ImpactLogWriteKeyString(log, "type", "objc", false);
     ImpactLogWriteKeyStringObject(log, "name", exception.name, false);
     ImpactLogWriteKeyStringObject(log, "message", exception.reason, false);
     ImpactLogWriteTime(log, "time", true);
 
-    ImpactMachOData imageData = {0};
+    ImpactBinaryImageAddress addresses[ImpactRuntimeExceptionMaxFrames] = {0};
+    uint32_t count = 0;
 
     for (NSNumber *address in exception.callStackReturnAddresses) {
         const uintptr_t addr = address.unsignedIntegerValue;
 
-        ImpactLogWriteString(log, "[Exception:Frame] ");
+        ImpactLogBeginRecord(log, "Exception:Frame");
         ImpactLogWriteKeyInteger(log, "ip", addr, true);
 
-        ImpactBinaryImageFind(state, addr - 1, &imageData);
+        if (count < ImpactRuntimeExceptionMaxFrames) {
+            addresses[count].address = addr - 1;
+            count += 1;
+        }
+    }
+
+    // Resolving all of the frames at once is much cheaper than searching for each one. We're
+    // only after the side-effect of getting the referenced images logged.
+    const ImpactResult result = ImpactBinaryImageResolveAddresses(state, addresses, count, ImpactBinaryImageResolveOptionNone);
+    if (result != ImpactResultSuccess) {
+        ImpactDebugLogWarn("[Log:WARN] failed to resolve exception frames %d\n", result);
     }
 }
@@ -9,8 +9,10 @@
 #include "ImpactSignal.h"
 #include "ImpactLog.h"
 #include "ImpactCrashHandler.h"
+#include "ImpactReportStore.h"
 #include "ImpactUtility.h"
 #include "ImpactThread.h"
+#include "ImpactBinaryImage.h"
 
 #include <signal.h>
 #include <stdbool.h>
@@ -27,6 +29,16 @@ static const int ImpactHandledSignals[ImpactSignalCount] = {
 
 static void ImpactSignalHandler(int signal, siginfo_t* info, ucontext_t* uap);
 
+bool ImpactSignalIsHandled(int signal) {
+    for (uint32_t i = 0; i < ImpactSignalCount; ++i) {
+        if (ImpactHandledSignals[i] == signal) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 ImpactResult ImpactSignalInitialize(ImpactState* state) {
     sigset_t set = {0};
 
@@ -62,7 +74,7 @@ ImpactResult ImpactSignalInitialize(ImpactState* state) {
     return someFailed ? ImpactResultFailure : ImpactResultSuccess;
 }
 
-static ImpactResult ImpactSignalInstallDefaultHandlers(void) {
+ImpactResult ImpactSignalInstallDefaultHandlers(void) {
     bool someFailed = false;
 
     struct sigaction action = {0};
@@ -76,7 +88,7 @@ static ImpactResult ImpactSignalInstallDefaultHandlers(void) {
 
         int result = sigaction(signal, &action, NULL);
         if (result != 0) {
-            ImpactDebugLog("[Log:%s] unable to install default signal handler %d %d\n", __func__, signal, result);
+            ImpactDebugLogWarn("[Log:%s] unable to install default signal handler %d %d\n", __func__, signal, result);
             someFailed = true;
         }
     }
@@ -97,7 +109,7 @@ static ImpactResult ImpactSignalRestorePreexisting(const ImpactState* state) {
 
         int result = sigaction(signal, &action, NULL);
         if (result != 0) {
-            ImpactDebugLog("[Log:%s] unable to restore signal handler %d %d\n", __func__, signal, result);
+            ImpactDebugLogWarn("[Log:%s] unable to restore signal handler %d %d\n", __func__, signal, result);
             someFailed = true;
         }
     }
@@ -111,7 +123,7 @@ ImpactResult ImpactSignalUninstallHandlers(const ImpactState* state) {
         return result;
     }
 
-    ImpactDebugLog("[Log:%s] failed to restore preexisting handlers %d\n", __func__, result);
+    ImpactDebugLogWarn("[Log:%s] failed to restore preexisting handlers %d\n", __func__, result);
 
     // ok, fall back to removing all handlers
     return ImpactSignalInstallDefaultHandlers();
@@ -120,7 +132,7 @@ ImpactResult ImpactSignalUninstallHandlers(const ImpactState* state) {
 static ImpactResult ImpactSignalLog(ImpactState* state, int signal, siginfo_t* info) {
     ImpactLogger* log = ImpactStateGetLog(state);
 
-    ImpactLogWriteString(log, "[Signal] ");
+    ImpactLogBeginRecord(log, "Signal");
 
     if (ImpactInvalidPtr(info)) {
         ImpactLogWriteKeyInteger(log, "signal", signal, true);
@@ -130,6 +142,9 @@ static ImpactResult ImpactSignalLog(ImpactState* state, int signal, siginfo_t* i
         ImpactLogWriteKeyPointer(log, "address", info->si_addr, false);
         ImpactLogWriteTime(log, "time", false);
         ImpactLogWriteKeyInteger(log, "errno", info->si_errno, true);
+
+        // a fault address inside an image is worth keeping that image for
+        ImpactBinaryImageNoteAddress(state, (uintptr_t)info->si_addr);
     }
 
     return ImpactResultSuccess;
@@ -192,25 +207,34 @@ static void ImpactSignalHandler(int signal, siginfo_t* info, ucontext_t* uap) {
     // important to give previous handlers a chance to run, particularly if we fail
     // at some point. This is why we do this early.
 
+    uint64_t start = ImpactTimeGetMonotonicNanoseconds();
+
     ImpactResult result = ImpactSignalUninstallHandlers(state);
     if (result != ImpactResultSuccess) {
-        ImpactDebugLog("[Log:%s] failed to uninstall handlers %d\n", __func__, result);
+        ImpactDebugLogWarn("[Log:%s] failed to uninstall handlers %d\n", __func__, result);
     }
 
+    ImpactStateRecordPhase(state, ImpactCrashPhaseUninstallHandlers, start);
+
     // At this point, any signal, including the current, could be
     // reraised and our handler would not be invoked. This protects us
     // from a crash loop within the handler.
 
     // log signal first, before adjusting state. Helpful to have this in the log.
     ImpactSignalLog(state, signal, info);
+    ImpactReportStoreRecordSignal(state, signal);
+
+    start = ImpactTimeGetMonotonicNanoseconds();
 
     ImpactCrashState currentState = ImpactCrashStateUninitialized;
     ImpactSignalHandlerEntranceAdjustState(state, &currentState);
 
+    ImpactStateRecordPhase(state, ImpactCrashPhaseStateTransition, start);
+
     // we only trigger the crash handler on our first invocation
     if (currentState == ImpactCrashStateInitialized) {
         if (ImpactInvalidPtr(uap)) {
-            ImpactDebugLog("[Log:Error] %suap pointer invalid\n", __func__);
+            ImpactDebugLogError("[Log:Error] %suap pointer invalid\n", __func__);
         } else {
             ImpactCrashHandler(state, ImpactThreadAssumeSelfCrashed, uap->uc_mcontext);
         }
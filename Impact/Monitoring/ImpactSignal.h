@@ -14,5 +14,8 @@
 
 ImpactResult ImpactSignalInitialize(ImpactState* state);
 ImpactResult ImpactSignalUninstallHandlers(const ImpactState* state);
+ImpactResult ImpactSignalInstallDefaultHandlers(void);
+
+bool ImpactSignalIsHandled(int signal);
 
 #endif /* ImpactSignal_h */
@@ -0,0 +1,229 @@
+//
+//  ImpactWatchdog.c
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#include "ImpactWatchdog.h"
+#include "ImpactUtility.h"
+#include "ImpactSignal.h"
+#include "ImpactLog.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <mach/mach.h>
+#include <string.h>
+#include <sys/event.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+ImpactWatchdogRegion* ImpactWatchdogRegionCreate(void) {
+    const size_t pageSize = (size_t)getpagesize();
+    const size_t size = sizeof(ImpactWatchdogRegion);
+
+    void* base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANON, -1, 0);
+    if (base == MAP_FAILED) {
+        return NULL;
+    }
+
+    // the crash handler must never be the first to touch a page
+    for (size_t offset = 0; offset < size; offset += pageSize) {
+        ((volatile uint8_t*)base)[offset] = 0;
+    }
+
+    return base;
+}
+
+ImpactResult ImpactWatchdogRegionDestroy(ImpactWatchdogRegion* region) {
+    if (ImpactInvalidPtr(region)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    if (munmap(region, sizeof(ImpactWatchdogRegion)) != 0) {
+        return ImpactResultCallFailed;
+    }
+
+    return ImpactResultSuccess;
+}
+
+// Whether the last byte written so far ends a line. When it can't be read back, a terminator is assumed
+// to be missing, because an extra empty line is harmless.
+static bool ImpactWatchdogLogEndsLine(const ImpactLogger* log) {
+    if (log->encoding == ImpactLogEncodingBinary) {
+        return true;
+    }
+
+    if (log->bufferCount > 0) {
+        return log->buffer[log->bufferCount - 1] == '\n';
+    }
+
+    if (log->ring.base != NULL) {
+        return log->ring.written == 0 || log->ring.base[(log->ring.written - 1) % log->ring.size] == '\n';
+    }
+
+    if (log->compressor != NULL) {
+        return false;
+    }
+
+    off_t end = 0;
+
+    if (log->mapping.base != NULL) {
+        const ImpactLogMappedHeader* header = (const ImpactLogMappedHeader*)log->mapping.base;
+
+        end = (off_t)(sizeof(ImpactLogMappedHeader) + atomic_load(&header->committed) + log->mapping.pending);
+    } else {
+        struct stat info = {0};
+
+        if (fstat(log->fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+            return false;
+        }
+
+        end = info.st_size;
+    }
+
+    if (end == 0) {
+        return true;
+    }
+
+    char last = 0;
+
+    return pread(log->fd, &last, 1, end - 1) == 1 && last == '\n';
+}
+
+ImpactResult ImpactWatchdogFinishReport(ImpactState* state) {
+    if (ImpactInvalidPtr(state)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    const ImpactCrashState crashState = atomic_load(&state->mutableState.crashState);
+
+    // exiting normally leaves nothing to do
+    if (crashState == ImpactCrashStateUninitialized || crashState == ImpactCrashStateInitialized) {
+        return ImpactResultSuccess;
+    }
+
+    // whatever was left of the crash handler's deadline has long passed
+    state->mutableState.crashDeadline = 0;
+
+    ImpactLogger* log = ImpactStateGetLog(state);
+
+    // the crash handler may have died part way through a line
+    if (!ImpactWatchdogLogEndsLine(log)) {
+        ImpactLogWriteString(log, "\n");
+    }
+
+    ImpactLogBeginRecord(log, "Watchdog");
+    ImpactLogWriteKeyInteger(log, "crash_state", crashState, false);
+    ImpactLogWriteKeyInteger(log, "complete", atomic_load(&state->mutableState.crashHandlerComplete), true);
+
+    ImpactBreadcrumbPool* breadcrumbs = state->constantState.breadcrumbs;
+
+    if (breadcrumbs) {
+        const ImpactResult result = ImpactBreadcrumbPoolLog(state, breadcrumbs);
+        if (result != ImpactResultSuccess) {
+            return result;
+        }
+    }
+
+    return ImpactLogFlush(log);
+}
+
+#if IMPACT_WATCHDOG_SUPPORTED
+static void ImpactWatchdogWaitForExit(pid_t parent) {
+    const int queue = kqueue();
+
+    if (queue >= 0) {
+        struct kevent event;
+
+        EV_SET(&event, parent, EVFILT_PROC, EV_ADD | EV_ONESHOT, NOTE_EXIT, 0, NULL);
+
+        // a parent that is already gone is reported as an error
+        while (kevent(queue, &event, 1, &event, 1, NULL) < 0 && errno == EINTR) {
+        }
+
+        close(queue);
+    }
+
+    // Once the parent is gone, this process is reparented. That may happen a moment after the exit is
+    // delivered, and it is also the fallback for when kqueue fails.
+    while (getppid() == parent) {
+        sleep(1);
+    }
+}
+
+__attribute__((noreturn))
+static void ImpactWatchdogRun(ImpactWatchdogRegion* region, pid_t parent, const int pipeFds[2]) {
+    // Only async-signal-safe calls are allowed in the child of a multithreaded process. A crash here must
+    // not run the parent's handlers, which would write into the parent's report.
+    ImpactSignalInstallDefaultHandlers();
+    task_set_exception_ports(mach_task_self(), EXC_MASK_ALL, MACH_PORT_NULL, EXCEPTION_DEFAULT, THREAD_STATE_NONE);
+
+    // the write end is never written, it only has to stay open for as long as this process runs
+    close(pipeFds[0]);
+
+    ImpactWatchdogWaitForExit(parent);
+    ImpactWatchdogFinishReport(&region->state);
+
+    _exit(0);
+}
+#endif
+
+// Nothing reaps the watchdog, and a host could reap it without this knowing, so its pid says nothing
+// about whether it is running. Once it exits, its end of the pipe closes, and reading gives EOF.
+bool ImpactWatchdogIsRunning(const ImpactState* state) {
+    if (ImpactInvalidPtr(state) || state->constantState.watchdogProcess <= 0) {
+        return false;
+    }
+
+    char byte = 0;
+    const int savedErrno = errno;
+    const bool running = read(state->constantState.watchdogPipe, &byte, 1) < 0 && errno == EAGAIN;
+
+    errno = savedErrno;
+
+    return running;
+}
+
+ImpactResult ImpactWatchdogStart(ImpactWatchdogRegion* region) {
+    if (ImpactInvalidPtr(region)) {
+        return ImpactResultPointerInvalid;
+    }
+
+#if IMPACT_WATCHDOG_SUPPORTED
+    if (region->state.constantState.watchdogProcess > 0) {
+        return ImpactResultStateInvalid;
+    }
+
+    int pipeFds[2];
+
+    if (pipe(pipeFds) != 0) {
+        return ImpactResultCallFailed;
+    }
+
+    const pid_t parent = getpid();
+    const pid_t child = fork();
+
+    if (child < 0) {
+        close(pipeFds[0]);
+        close(pipeFds[1]);
+        return ImpactResultCallFailed;
+    }
+
+    if (child == 0) {
+        ImpactWatchdogRun(region, parent, pipeFds);
+    }
+
+    close(pipeFds[1]);
+    fcntl(pipeFds[0], F_SETFL, O_NONBLOCK);
+    fcntl(pipeFds[0], F_SETFD, FD_CLOEXEC);
+
+    region->state.constantState.watchdogPipe = pipeFds[0];
+    region->state.constantState.watchdogProcess = child;
+
+    return ImpactResultSuccess;
+#else
+    return ImpactResultUnimplemented;
+#endif
+}
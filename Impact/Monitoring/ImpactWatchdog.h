@@ -0,0 +1,50 @@
+//
+//  ImpactWatchdog.h
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#ifndef ImpactWatchdog_h
+#define ImpactWatchdog_h
+
+#include "ImpactState.h"
+#include "ImpactResult.h"
+#include "ImpactBreadcrumb.h"
+#include "ImpactLogCompression.h"
+
+#include <TargetConditionals.h>
+
+// fork is not permitted anywhere else
+#define IMPACT_WATCHDOG_SUPPORTED TARGET_OS_OSX
+
+_Pragma("clang assume_nonnull begin")
+__BEGIN_DECLS
+
+// Everything a watchdog needs to finish a report, in one shared anonymous mapping. A process forked once
+// it is set up sees the same memory at the same addresses, so the pointers within it stay valid there.
+typedef struct {
+    ImpactState state;
+    ImpactBreadcrumbPool breadcrumbs;
+    ImpactLogCompressor compressor;
+} ImpactWatchdogRegion;
+
+ImpactWatchdogRegion* _Nullable ImpactWatchdogRegionCreate(void);
+ImpactResult ImpactWatchdogRegionDestroy(ImpactWatchdogRegion* region);
+
+// Forks a process that waits for this one to exit. If it crashed, the watchdog then finishes the report
+// from the region. Everything in the region must be set up first. Not async-signal-safe.
+ImpactResult ImpactWatchdogStart(ImpactWatchdogRegion* region);
+
+// Whether the state's watchdog is still running. A watchdog that has exited is reported as gone even
+// while it is still a zombie. Async-signal-safe.
+bool ImpactWatchdogIsRunning(const ImpactState* state);
+
+// What the watchdog does once the process it watches is gone. Writes nothing unless a crash handler
+// started. Async-signal-safe.
+ImpactResult ImpactWatchdogFinishReport(ImpactState* state);
+
+__END_DECLS
+_Pragma("clang assume_nonnull end")
+
+#endif /* ImpactWatchdog_h */
@@ -64,14 +64,14 @@ ImpactResult ImpactCompactUnwindLookupSecondLevelCompressedEntry(ImpactCompactUn
 
     const CompactUnwindCompressedHeader* compressedHeader = ImpactPointerOffset(target.header, index->secondLevelPagesSectionOffset);
     if (compressedHeader->kind != UNWIND_SECOND_LEVEL_COMPRESSED) {
-        ImpactDebugLog("[Log:WARN:%s] compressed header kind invalid %d\n", __func__, compressedHeader->kind);
+        ImpactDebugLogWarn("[Log:WARN:%s] compressed header kind invalid %d\n", __func__, compressedHeader->kind);
         return ImpactResultInconsistentData;
     }
 
     const uintptr_t imageRelativeAddress = target.address - target.imageLoadAddress;
 
     if (imageRelativeAddress < index->functionOffset) {
-        ImpactDebugLog("[Log:WARN:%s] address not in range\n", __func__);
+        ImpactDebugLogWarn("[Log:WARN:%s] address not in range\n", __func__);
         return ImpactResultInconsistentData;
     }
 
@@ -89,7 +89,7 @@ ImpactResult ImpactCompactUnwindLookupSecondLevelCompressedEntry(ImpactCompactUn
 
         if (imageRelativeAddress >= nextIndex->functionOffset) {
             *encoding = NULL;
-            ImpactDebugLog("[Log:WARN:%s] address not in within found function\n", __func__);
+            ImpactDebugLogWarn("[Log:WARN:%s] address not in within found function\n", __func__);
             return ImpactResultFailure;
         }
     }
@@ -166,7 +166,7 @@ ImpactResult ImpactCompactUnwindLookupEncoding(ImpactCompactUnwindTarget target,
     }
 
     if (target.header->version != UNWIND_SECTION_VERSION) {
-        ImpactDebugLog("[Log:INFO:%s] compact unwind version invalid %d\n", __func__, target.header->version);
+        ImpactDebugLogInfo("[Log:INFO:%s] compact unwind version invalid %d\n", __func__, target.header->version);
 
         return ImpactResultInconsistentData;
     }
@@ -176,14 +176,14 @@ ImpactResult ImpactCompactUnwindLookupEncoding(ImpactCompactUnwindTarget target,
 
     result = ImpactCompactUnwindLookupFirstLevel(target, &firstLevelEntry);
     if (result != ImpactResultSuccess) {
-        ImpactDebugLog("[Log:INFO:%s] failed to lookup first level encoding %d\n", __func__, result);
+        ImpactDebugLogInfo("[Log:INFO:%s] failed to lookup first level encoding %d\n", __func__, result);
         return result;
     }
 
     const compact_unwind_encoding_t* encodingPtr = NULL;
     result = ImpactCompactUnwindLookupSecondLevel(target, firstLevelEntry, &encodingPtr);
     if (result != ImpactResultSuccess) {
-        ImpactDebugLog("[Log:INFO:%s] failed to lookup second level encoding %d\n", __func__, result);
+        ImpactDebugLogInfo("[Log:INFO:%s] failed to lookup second level encoding %d\n", __func__, result);
         return result;
     }
 
@@ -197,17 +197,17 @@ ImpactResult ImpactCompactUnwindStepRegisters(ImpactCompactUnwindTarget target,
 
     ImpactResult result = ImpactCompactUnwindLookupEncoding(target, &encoding);
     if (result != ImpactResultSuccess) {
-        ImpactDebugLog("[Log:WARN] failed to look up compact unwind encoding %d\n", result);
+        ImpactDebugLogWarn("[Log:WARN] failed to look up compact unwind encoding %d\n", result);
         return result;
     }
 
     if (encoding == 0) {
-        ImpactDebugLog("[Log:INFO] no unwind info available\n");
+        ImpactDebugLogInfo("[Log:INFO] no unwind info available\n");
 
         return ImpactResultMissingUnwindInfo;
     }
 
-    ImpactDebugLog("[Log:INFO] found compact unwind encoding 0x%x\n", encoding);
+    ImpactDebugLogInfo("[Log:INFO] found compact unwind encoding 0x%x\n", encoding);
 
     return ImpactCompactUnwindStepArchRegisters(target, registers, encoding, dwarfFDEOffset);
 }
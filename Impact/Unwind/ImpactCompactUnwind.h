@@ -31,6 +31,7 @@ ImpactResult ImpactCompactUnwindLookupEncoding(ImpactCompactUnwindTarget target,
 
 ImpactResult ImpactCompactUnwindStepRegisters(ImpactCompactUnwindTarget target, ImpactCPURegisters* registers, uint32_t* dwarfFDEOffset);
 ImpactResult ImpactCompactUnwindStepArchRegisters(ImpactCompactUnwindTarget target, ImpactCPURegisters* registers, compact_unwind_encoding_t encoding, uint32_t* dwarfFDEOffset);
+ImpactResult ImpactCompactUnwindGetArchDWARFOffset(compact_unwind_encoding_t encoding, uint32_t* dwarfFDEOffset);
 
 
 #endif /* ImpactCompactUnwind_h */
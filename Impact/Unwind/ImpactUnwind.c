@@ -37,7 +37,7 @@ ImpactResult ImpactUnwindStepRegistersWithFramePointer(ImpactCPURegisters* regis
     }
 
     if (ImpactInvalidPtr(frame)) {
-        ImpactDebugLog("[Log:ERROR] frame pointer invalid %p\n", frame);
+        ImpactDebugLogError("[Log:ERROR] frame pointer invalid %p\n", frame);
         return ImpactResultFailure;
     }
 
@@ -74,7 +74,7 @@ static ImpactResult ImpactUnwindDWARFCFIStepRegisters(ImpactMachODataRegion ehFr
 
     ImpactResult result = ImpactDWARFReadData(ehFrameRegion, env, fdeOffset, &cfiData);
     if (result != ImpactResultSuccess) {
-        ImpactDebugLog("[Log:WARN] %s failed to parse CFI data %d\n", __func__, result);
+        ImpactDebugLogWarn("[Log:WARN] %s failed to parse CFI data %d\n", __func__, result);
         return result;
     }
 
@@ -98,7 +98,56 @@ static ImpactResult ImpactUnwindCompactUnwindStepRegisters(ImpactMachOData* imag
     return ImpactCompactUnwindStepRegisters(target, registers, dwarfFDEOFfset);
 }
 
-ImpactResult ImpactUnwindStepRegisters(ImpactState* state, ImpactCPURegisters* registers) {
+static ImpactResult ImpactUnwindCompactUnwindGetDWARFOffset(ImpactMachOData* imageData, uintptr_t pc, uint32_t* dwarfFDEOFfset) {
+    const ImpactCompactUnwindTarget target = {
+        .address = pc,
+        .imageLoadAddress = imageData->loadAddress,
+        .header = (const struct unwind_info_section_header*)imageData->unwindInfoRegion.address
+    };
+
+    compact_unwind_encoding_t encoding = 0;
+
+    const ImpactResult result = ImpactCompactUnwindLookupEncoding(target, &encoding);
+    if (result != ImpactResultSuccess) {
+        return result;
+    }
+
+    return ImpactCompactUnwindGetArchDWARFOffset(encoding, dwarfFDEOFfset);
+}
+
+static void ImpactUnwindRecordFallback(ImpactState* state, ImpactResult failure) {
+    if (failure > ImpactResultSuccess && failure < ImpactResultCount) {
+        state->mutableState.metrics.unwindFallbacks[failure] += 1;
+    }
+}
+
+static ImpactResult ImpactUnwindFallBackToFramePointer(ImpactState* state, uint32_t strategies, ImpactResult failure, ImpactCPURegisters* registers, ImpactUnwindOutcome* outcome) {
+    if ((strategies & ImpactUnwindStrategyFramePointer) == 0) {
+        return failure;
+    }
+
+    ImpactUnwindRecordFallback(state, failure);
+
+    *outcome = ImpactUnwindOutcomeFramePointerFallback;
+
+    return ImpactUnwindStepRegistersWithFramePointer(registers);
+}
+
+ImpactResult ImpactUnwindStepRegisters(ImpactState* state, uint32_t strategies, ImpactCPURegisters* registers, ImpactUnwindOutcome* outcome) {
+    const uint32_t tableStrategies = ImpactUnwindStrategyCompactUnwind | ImpactUnwindStrategyDWARF;
+
+    // When only the frame pointer is allowed, there's no need to even find the image. This
+    // is the cheapest possible way to unwind.
+    if ((strategies & tableStrategies) == 0) {
+        if ((strategies & ImpactUnwindStrategyFramePointer) == 0) {
+            return ImpactResultArgumentInvalid;
+        }
+
+        *outcome = ImpactUnwindOutcomeFramePointer;
+
+        return ImpactUnwindStepRegistersWithFramePointer(registers);
+    }
+
     uintptr_t pc = 0;
 
     ImpactResult result = ImpactCPUGetRegister(registers, ImpactCPURegisterInstructionPointer, &pc);
@@ -110,53 +159,109 @@ ImpactResult ImpactUnwindStepRegisters(ImpactState* state, ImpactCPURegisters* r
 
     result = ImpactBinaryImageFind(state, pc, &imageData);
     if (result != ImpactResultSuccess) {
-        ImpactDebugLog("[Log:WARN] unable to find binary image %d\n", result);
+        ImpactDebugLogWarn("[Log:WARN] unable to find binary image %d\n", result);
 
         return result;
     }
 
-    ImpactDebugLog("[Log:INFO] found image at %p\n", (void*)imageData.loadAddress);
+    ImpactDebugLogInfo("[Log:INFO] found image at %p\n", (void*)imageData.loadAddress);
 
     if (pc <= imageData.loadAddress) {
-        ImpactDebugLog("[Log:WARN] pc not within image range\n");
+        ImpactDebugLogWarn("[Log:WARN] pc not within image range\n");
 
-        return ImpactUnwindStepRegistersWithFramePointer(registers);
+        return ImpactUnwindFallBackToFramePointer(state, strategies, ImpactResultInconsistentData, registers, outcome);
     }
 
     uint32_t dwarfFDEOFfset = 0;
-    result = ImpactUnwindCompactUnwindStepRegisters(&imageData, pc, registers, &dwarfFDEOFfset);
-    if (result == ImpactResultEndOfStack) {
-        return ImpactResultEndOfStack;
-    }
 
-    if (result == ImpactResultMissingUnwindInfo) {
-        // this is a weirdly common situation, because some apple libs are missing unwind_info section entries
-        return ImpactUnwindStepRegistersWithFramePointer(registers);
+    if (strategies & ImpactUnwindStrategyCompactUnwind) {
+        result = ImpactUnwindCompactUnwindStepRegisters(&imageData, pc, registers, &dwarfFDEOFfset);
+        if (result == ImpactResultEndOfStack) {
+            return ImpactResultEndOfStack;
+        }
+
+        if (result == ImpactResultMissingUnwindInfo) {
+            // this is a weirdly common situation, because some apple libs are missing unwind_info section entries
+            return ImpactUnwindFallBackToFramePointer(state, strategies, result, registers, outcome);
+        }
+
+        if (result != ImpactResultSuccess) {
+            ImpactDebugLogWarn("[Log:WARN] compact unwind failed %d\n", result);
+
+            // fall back to the frame pointer
+            return ImpactUnwindFallBackToFramePointer(state, strategies, result, registers, outcome);
+        }
+
+        if (dwarfFDEOFfset == 0) {
+            // compact unwind has done the step
+            *outcome = ImpactUnwindOutcomeCompactUnwind;
+
+            return ImpactResultSuccess;
+        }
+    } else {
+        // Even without compact unwind, its tables are how we locate the FDE.
+        result = ImpactUnwindCompactUnwindGetDWARFOffset(&imageData, pc, &dwarfFDEOFfset);
+        if (result != ImpactResultSuccess) {
+            return ImpactUnwindFallBackToFramePointer(state, strategies, result, registers, outcome);
+        }
     }
 
+#if IMPACT_DWARF_CFI_SUPPORTED
+    if (strategies & ImpactUnwindStrategyDWARF) {
+        ImpactDebugLogInfo("[Log:INFO] using DWARF CFI with FDE offset 0x%x\n", dwarfFDEOFfset);
 
-    if (result != ImpactResultSuccess) {
-        ImpactDebugLog("[Log:WARN] compact unwind failed %d\n", result);
+        *outcome = ImpactUnwindOutcomeDWARF;
 
-        // fall back to the frame pointer
-        return ImpactUnwindStepRegistersWithFramePointer(registers);
-    }
+        result = ImpactUnwindDWARFCFIStepRegisters(imageData.ehFrameRegion, pc, registers, dwarfFDEOFfset);
+        if (result == ImpactResultSuccess || result == ImpactResultEndOfStack) {
+            return result;
+        }
+
+        ImpactDebugLogWarn("[Log:WARN] DWARF CFI unwind failed %d\n", result);
 
-    if (dwarfFDEOFfset == 0) {
-        // compact unwind has done the step
-        return ImpactResultSuccess;
+        return ImpactUnwindFallBackToFramePointer(state, strategies, result, registers, outcome);
     }
+#endif
 
-#if IMPACT_DWARF_CFI_SUPPORTED
-    ImpactDebugLog("[Log:INFO] using DWARF CFI with FDE offset 0x%x\n", dwarfFDEOFfset);
+    return ImpactUnwindFallBackToFramePointer(state, strategies, ImpactResultUnimplemented, registers, outcome);
+}
 
-    result = ImpactUnwindDWARFCFIStepRegisters(imageData.ehFrameRegion, pc, registers, dwarfFDEOFfset);
-    if (result == ImpactResultSuccess || result == ImpactResultEndOfStack) {
-        return result;
+__attribute__((noinline, disable_tail_calls))
+uint32_t ImpactUnwindCaptureStack(ImpactState* state, uint32_t strategies, uintptr_t* frames, uint32_t limit, uint32_t skip) {
+    ImpactCPURegisters registers = {0};
+    const uintptr_t fp = (uintptr_t)__builtin_frame_address(0);
+
+    // this function's own frame, which the first step leaves
+    ImpactCPUSetRegister(&registers, ImpactCPURegisterFramePointer, fp);
+    ImpactCPUSetRegister(&registers, ImpactCPURegisterStackPointer, fp);
+    ImpactCPUSetRegister(&registers, ImpactCPURegisterInstructionPointer, (uintptr_t)ImpactUnwindCaptureStack);
+
+    ImpactUnwindOutcome outcome = ImpactUnwindOutcomeThreadState;
+    uintptr_t previousSP = fp;
+    uint32_t count = 0;
+
+    for (uint32_t step = 0; count < limit; ++step) {
+        if (ImpactUnwindStepRegisters(state, strategies, &registers, &outcome) != ImpactResultSuccess) {
+            break;
+        }
+
+        uintptr_t ip = 0;
+        uintptr_t sp = 0;
+
+        ImpactCPUGetRegister(&registers, ImpactCPURegisterInstructionPointer, &ip);
+        ImpactCPUGetRegister(&registers, ImpactCPURegisterStackPointer, &sp);
+
+        // the stack only ever gets shallower, anything else is a corrupt frame
+        if (ip == 0 || sp <= previousSP) {
+            break;
+        }
+
+        previousSP = sp;
+
+        if (step >= skip) {
+            frames[count++] = ip;
+        }
     }
 
-    ImpactDebugLog("[Log:WARN] DWARF CFI unwind failed %d\n", result);
-#endif
-    
-    return ImpactUnwindStepRegistersWithFramePointer(registers);
+    return count;
 }
@@ -13,7 +13,15 @@
 #include "ImpactCPU.h"
 #include "ImpactState.h"
 
+__BEGIN_DECLS
+
 ImpactResult ImpactUnwindStepRegistersWithFramePointer(ImpactCPURegisters* registers);
-ImpactResult ImpactUnwindStepRegisters(ImpactState* state, ImpactCPURegisters* registers);
+ImpactResult ImpactUnwindStepRegisters(ImpactState* state, uint32_t strategies, ImpactCPURegisters* registers, ImpactUnwindOutcome* outcome);
+
+// Unwinds the calling thread, starting with its caller's frame, after leaving out skip frames. With
+// frame pointers alone, the state is never touched, so that is safe from any thread at once.
+uint32_t ImpactUnwindCaptureStack(ImpactState* state, uint32_t strategies, uintptr_t* frames, uint32_t limit, uint32_t skip);
+
+__END_DECLS
 
 #endif /* ImpactUnwind_h */
@@ -177,5 +177,15 @@ ImpactResult ImpactCompactUnwindStepArchRegisters(ImpactCompactUnwindTarget targ
     return ImpactResultArgumentInvalid;
 }
 
+ImpactResult ImpactCompactUnwindGetArchDWARFOffset(compact_unwind_encoding_t encoding, uint32_t* dwarfFDEOffset) {
+    if ((encoding & UNWIND_ARM64_MODE_MASK) != UNWIND_ARM64_MODE_DWARF) {
+        return ImpactResultMissingUnwindInfo;
+    }
+
+    *dwarfFDEOffset = encoding & UNWIND_ARM64_DWARF_SECTION_OFFSET;
+
+    return ImpactResultSuccess;
+}
+
 #endif
 
@@ -19,4 +19,8 @@ ImpactResult ImpactCompactUnwindStepArchRegisters(ImpactCompactUnwindTarget targ
     return ImpactResultFailure;
 }
 
+ImpactResult ImpactCompactUnwindGetArchDWARFOffset(compact_unwind_encoding_t encoding, uint32_t* dwarfFDEOffset) {
+    return ImpactResultUnimplemented;
+}
+
 #endif
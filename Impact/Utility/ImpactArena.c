@@ -0,0 +1,141 @@
+//
+//  ImpactArena.c
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#include "ImpactArena.h"
+#include "ImpactUtility.h"
+#include "ImpactLog.h"
+
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+ImpactResult ImpactArenaInitialize(ImpactArena* arena, size_t size) {
+    if (ImpactInvalidPtr(arena)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    memset(arena, 0, sizeof(ImpactArena));
+
+    if (size == 0) {
+        return ImpactResultArgumentInvalid;
+    }
+
+    const size_t pageSize = (size_t)getpagesize();
+
+    size = (size + pageSize - 1) / pageSize * pageSize;
+
+    void* base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (base == MAP_FAILED) {
+        return ImpactResultCallFailed;
+    }
+
+    // Anonymous pages are only backed on first write. Doing that now means the crash path never takes a
+    // zero-fill fault, which would have to go through the VM system.
+    for (size_t offset = 0; offset < size; offset += pageSize) {
+        ((volatile uint8_t*)base)[offset] = 0;
+    }
+
+    arena->base = base;
+    arena->size = size;
+
+    return ImpactResultSuccess;
+}
+
+ImpactResult ImpactArenaDeinitialize(ImpactArena* arena) {
+    if (ImpactInvalidPtr(arena)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    if (arena->base && munmap(arena->base, arena->size) != 0) {
+        return ImpactResultCallFailed;
+    }
+
+    memset(arena, 0, sizeof(ImpactArena));
+
+    return ImpactResultSuccess;
+}
+
+void* ImpactArenaAllocate(ImpactArena* arena, size_t size, size_t alignment) {
+    if (ImpactInvalidPtr(arena) || arena->base == NULL) {
+        return NULL;
+    }
+
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        return NULL;
+    }
+
+    size_t used = atomic_load_explicit(&arena->used, memory_order_relaxed);
+    size_t start;
+    size_t end;
+
+    do {
+        start = (used + alignment - 1) & ~(alignment - 1);
+        end = start + size;
+
+        if (start < used || end < start || end > arena->size) {
+            atomic_fetch_add_explicit(&arena->failures, 1, memory_order_relaxed);
+            return NULL;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&arena->used, &used, end, memory_order_relaxed, memory_order_relaxed));
+
+    size_t highWater = atomic_load_explicit(&arena->highWater, memory_order_relaxed);
+
+    while (end > highWater && !atomic_compare_exchange_weak_explicit(&arena->highWater, &highWater, end, memory_order_relaxed, memory_order_relaxed)) {
+    }
+
+    return arena->base + start;
+}
+
+void ImpactArenaTrim(ImpactArena* arena, void* allocation, size_t size, size_t usedSize) {
+    if (ImpactInvalidPtr(arena) || ImpactInvalidPtr(allocation) || usedSize > size) {
+        return;
+    }
+
+    size_t end = (size_t)((uint8_t*)allocation - arena->base) + size;
+
+    atomic_compare_exchange_strong_explicit(&arena->used, &end, end - (size - usedSize), memory_order_relaxed, memory_order_relaxed);
+}
+
+void ImpactArenaReset(ImpactArena* arena) {
+    if (ImpactInvalidPtr(arena)) {
+        return;
+    }
+
+    atomic_store_explicit(&arena->used, 0, memory_order_relaxed);
+}
+
+size_t ImpactArenaGetUsed(const ImpactArena* arena) {
+    if (ImpactInvalidPtr(arena)) {
+        return 0;
+    }
+
+    return atomic_load_explicit(&arena->used, memory_order_relaxed);
+}
+
+size_t ImpactArenaGetAvailable(const ImpactArena* arena) {
+    if (ImpactInvalidPtr(arena)) {
+        return 0;
+    }
+
+    return arena->size - atomic_load_explicit(&arena->used, memory_order_relaxed);
+}
+
+ImpactResult ImpactArenaLogStatistics(ImpactState* state) {
+    if (ImpactInvalidPtr(state)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    ImpactLogger* log = ImpactStateGetLog(state);
+    const ImpactArena* arena = &state->mutableState.arena;
+
+    ImpactLogBeginRecord(log, "Arena");
+    ImpactLogWriteKeyInteger(log, "size", arena->size, false);
+    ImpactLogWriteKeyInteger(log, "used", atomic_load_explicit(&arena->used, memory_order_relaxed), false);
+    ImpactLogWriteKeyInteger(log, "high_water", atomic_load_explicit(&arena->highWater, memory_order_relaxed), false);
+
+    return ImpactLogWriteKeyInteger(log, "failures", atomic_load_explicit(&arena->failures, memory_order_relaxed), true);
+}
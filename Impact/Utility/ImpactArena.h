@@ -0,0 +1,41 @@
+//
+//  ImpactArena.h
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#ifndef ImpactArena_h
+#define ImpactArena_h
+
+#include "ImpactResult.h"
+#include "ImpactState.h"
+
+_Pragma("clang assume_nonnull begin")
+__BEGIN_DECLS
+
+// Maps the arena and touches every page, so allocating never faults in new memory. The size is rounded
+// up to a whole number of pages. Not async-signal-safe.
+ImpactResult ImpactArenaInitialize(ImpactArena* arena, size_t size);
+ImpactResult ImpactArenaDeinitialize(ImpactArena* arena);
+
+// Returns NULL when the arena is out of space, or was never initialized. Alignment must be a power of two.
+// Async-signal-safe, and safe to call from multiple threads.
+void* _Nullable ImpactArenaAllocate(ImpactArena* arena, size_t size, size_t alignment);
+
+// Gives back the end of the most recent allocation, so callers can allocate for the worst case and keep
+// only what they used. Has no effect on any other allocation.
+void ImpactArenaTrim(ImpactArena* arena, void* allocation, size_t size, size_t usedSize);
+
+// Frees everything allocated so far. The high-water mark and failure count are kept.
+void ImpactArenaReset(ImpactArena* arena);
+
+size_t ImpactArenaGetUsed(const ImpactArena* arena);
+size_t ImpactArenaGetAvailable(const ImpactArena* arena);
+
+ImpactResult ImpactArenaLogStatistics(ImpactState* state);
+
+__END_DECLS
+_Pragma("clang assume_nonnull end")
+
+#endif /* ImpactArena_h */
@@ -91,7 +91,7 @@ ImpactResult ImpactCPURegistersLog(ImpactState* state, const ImpactCPURegisters*
 
     ImpactLogger* log = ImpactStateGetLog(state);
 
-    ImpactLogWriteString(log, "[Thread:State] ");
+    ImpactLogBeginRecord(log, "Thread:State");
 
 #if defined(__x86_64__)
     ImpactLogWriteKeyInteger(log, "rax", registers->__ss.__rax, false);
@@ -159,7 +159,7 @@ ImpactResult ImpactCPURegistersLog(ImpactState* state, const ImpactCPURegisters*
 
 ImpactResult ImpactCPUGetRegister(const ImpactCPURegisters* registers, ImpactCPURegister num, uintptr_t* value) {
     if (ImpactInvalidPtr(registers) || ImpactInvalidPtr(value)) {
-        ImpactDebugLog("[Log:WARN] %s pointer argument invalid\n", __func__);
+        ImpactDebugLogWarn("[Log:WARN] %s pointer argument invalid\n", __func__);
         return ImpactResultPointerInvalid;
     }
     
@@ -183,7 +183,7 @@ ImpactResult ImpactCPUGetRegister(const ImpactCPURegisters* registers, ImpactCPU
         case ImpactCPURegister_X86_64_R15: *value = registers->__ss.__r15; break;
         case ImpactCPURegister_X86_64_RIP: *value = registers->__ss.__rip; break;
         default:
-            ImpactDebugLog("[Log:WARN] %s register number unsupported %d\n", __func__, num);
+            ImpactDebugLogWarn("[Log:WARN] %s register number unsupported %d\n", __func__, num);
             return ImpactResultArgumentInvalid;
     }
 #elif defined(__arm64__)
@@ -224,7 +224,7 @@ ImpactResult ImpactCPUGetRegister(const ImpactCPURegisters* registers, ImpactCPU
         case ImpactCPURegister_ARM64_X31:  *value = ImpactCPURegisterARM64GetSP(registers->__ss); break;
         case ImpactCPURegister_ARM64_RIP: *value = ImpactCPURegisterARM64GetPC(registers->__ss); break;
         default:
-            ImpactDebugLog("[Log:WARN] %s register number unsupported %30d\n", __func__, num);
+            ImpactDebugLogWarn("[Log:WARN] %s register number unsupported %30d\n", __func__, num);
             return ImpactResultArgumentInvalid;
     }
 #endif
@@ -234,7 +234,7 @@ ImpactResult ImpactCPUGetRegister(const ImpactCPURegisters* registers, ImpactCPU
 
 ImpactResult ImpactCPUSetRegister(ImpactCPURegisters* registers, ImpactCPURegister num, uintptr_t value) {
     if (ImpactInvalidPtr(registers)) {
-        ImpactDebugLog("[Log:WARN] %s pointer argument invalid\n", __func__);
+        ImpactDebugLogWarn("[Log:WARN] %s pointer argument invalid\n", __func__);
         return ImpactResultPointerInvalid;
     }
 
@@ -259,7 +259,7 @@ ImpactResult ImpactCPUSetRegister(ImpactCPURegisters* registers, ImpactCPURegist
         case ImpactCPURegister_X86_64_RIP: registers->__ss.__rip = value; break;
         case ImpactCPURegister_X86_64_RA:  registers->__ss.__rip = value; break;
         default:
-            ImpactDebugLog("[Log:WARN] %s register number unsupported %d\n", __func__, num);
+            ImpactDebugLogWarn("[Log:WARN] %s register number unsupported %d\n", __func__, num);
             return ImpactResultArgumentInvalid;
     }
 #elif defined(__arm64__)
@@ -300,7 +300,7 @@ ImpactResult ImpactCPUSetRegister(ImpactCPURegisters* registers, ImpactCPURegist
         case ImpactCPURegister_ARM64_X31: ImpactCPURegisterARM64SetSP(&registers->__ss, value); break;
         case ImpactCPURegister_ARM64_RIP: ImpactCPURegisterARM64SetPC(&registers->__ss, value); break;
         default:
-            ImpactDebugLog("[Log:WARN] %s register number unsupported %d\n", __func__, num);
+            ImpactDebugLogWarn("[Log:WARN] %s register number unsupported %d\n", __func__, num);
             return ImpactResultArgumentInvalid;
     }
 #endif
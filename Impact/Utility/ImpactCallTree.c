@@ -0,0 +1,85 @@
+//
+//  ImpactCallTree.c
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#include "ImpactCallTree.h"
+#include "ImpactUtility.h"
+
+void ImpactCallTreeInitialize(ImpactCallTree* tree, ImpactCallTreeNode* nodes, uint32_t capacity) {
+    if (ImpactInvalidPtr(tree)) {
+        return;
+    }
+
+    tree->nodes = nodes;
+    tree->capacity = capacity;
+
+    ImpactCallTreeReset(tree);
+}
+
+void ImpactCallTreeReset(ImpactCallTree* tree) {
+    if (ImpactInvalidPtr(tree)) {
+        return;
+    }
+
+    tree->nodeCount = 0;
+    tree->firstRoot = ImpactCallTreeNodeNone;
+}
+
+static uint32_t ImpactCallTreeFindOrAddChild(ImpactCallTree* tree, uint32_t parent, uintptr_t ip) {
+    uint32_t* link = parent == ImpactCallTreeNodeNone ? &tree->firstRoot : &tree->nodes[parent].firstChild;
+
+    for (uint32_t index = *link; index != ImpactCallTreeNodeNone; index = tree->nodes[index].nextSibling) {
+        if (tree->nodes[index].ip == ip) {
+            return index;
+        }
+    }
+
+    if (tree->nodeCount >= tree->capacity) {
+        return ImpactCallTreeNodeNone;
+    }
+
+    const uint32_t index = tree->nodeCount;
+    ImpactCallTreeNode* node = &tree->nodes[index];
+
+    node->ip = ip;
+    node->parent = parent;
+    node->firstChild = ImpactCallTreeNodeNone;
+    node->nextSibling = *link;
+    node->count = 0;
+    node->leafCount = 0;
+
+    *link = index;
+    tree->nodeCount += 1;
+
+    return index;
+}
+
+bool ImpactCallTreeAddSample(ImpactCallTree* tree, const uintptr_t* ips, uint32_t count) {
+    if (ImpactInvalidPtr(tree) || ImpactInvalidPtr(ips)) {
+        return false;
+    }
+
+    uint32_t parent = ImpactCallTreeNodeNone;
+    bool complete = true;
+
+    // the tree is rooted at the outermost frame, so samples share as much of it as possible
+    for (uint32_t i = count; i > 0; --i) {
+        const uint32_t index = ImpactCallTreeFindOrAddChild(tree, parent, ips[i - 1]);
+        if (index == ImpactCallTreeNodeNone) {
+            complete = false;
+            break;
+        }
+
+        tree->nodes[index].count += 1;
+        parent = index;
+    }
+
+    if (parent != ImpactCallTreeNodeNone) {
+        tree->nodes[parent].leafCount += 1;
+    }
+
+    return complete;
+}
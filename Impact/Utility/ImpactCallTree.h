@@ -0,0 +1,50 @@
+//
+//  ImpactCallTree.h
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#ifndef ImpactCallTree_h
+#define ImpactCallTree_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/cdefs.h>
+
+_Pragma("clang assume_nonnull begin")
+__BEGIN_DECLS
+
+static const uint32_t ImpactCallTreeNodeNone = UINT32_MAX;
+
+// One frame of a calling-context tree. Nodes are only ever added after their parent, so visiting them in
+// order always visits a parent first.
+typedef struct {
+    uintptr_t ip;
+    uint32_t parent;
+    uint32_t firstChild;
+    uint32_t nextSibling;
+    uint32_t count; // samples that passed through this frame
+    uint32_t leafCount; // samples that ended here
+} ImpactCallTreeNode;
+
+// Merges stacks by their common outer frames. Nodes come from storage the caller owns, so adding a
+// sample never allocates.
+typedef struct {
+    ImpactCallTreeNode* nodes;
+    uint32_t capacity;
+    uint32_t nodeCount;
+    uint32_t firstRoot;
+} ImpactCallTree;
+
+void ImpactCallTreeInitialize(ImpactCallTree* tree, ImpactCallTreeNode* nodes, uint32_t capacity);
+void ImpactCallTreeReset(ImpactCallTree* tree);
+
+// Adds one stack, innermost frame first. Returns false when the tree ran out of nodes, in which case
+// the sample ends at the deepest frame that fit.
+bool ImpactCallTreeAddSample(ImpactCallTree* tree, const uintptr_t* ips, uint32_t count);
+
+__END_DECLS
+_Pragma("clang assume_nonnull end")
+
+#endif /* ImpactCallTree_h */
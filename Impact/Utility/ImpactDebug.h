@@ -11,24 +11,48 @@
 
 #include "ImpactState.h"
 #include "ImpactPointer.h"
+#include "ImpactResult.h"
 
-#include <stdio.h>
+#include <sys/cdefs.h>
 
 #define VA_ARGS(...) , ##__VA_ARGS__
 
-#if 1
+#define IMPACT_LOG_LEVEL_NONE 0
+#define IMPACT_LOG_LEVEL_ERROR 1
+#define IMPACT_LOG_LEVEL_WARN 2
+#define IMPACT_LOG_LEVEL_INFO 3
+
+// Diagnostic output is written on the crash path, so it is far from free. Release builds
+// keep errors only. Define IMPACT_LOG_LEVEL to override. Once a crash is being handled, only
+// the thread handling it writes anything; calls from every other thread are dropped.
+#ifndef IMPACT_LOG_LEVEL
+#if DEBUG
+#define IMPACT_LOG_LEVEL IMPACT_LOG_LEVEL_INFO
+#else
+#define IMPACT_LOG_LEVEL IMPACT_LOG_LEVEL_ERROR
+#endif
+#endif
+
+__BEGIN_DECLS
+
+ImpactResult ImpactLog(const char * __restrict format, ...) __printflike(1, 2);
+
+__END_DECLS
 
-#define ImpactDebugLog(format, ...) do { \
+// The level check is a constant, so disabled calls generate no code. Keeping them in an
+// if statement, instead of removing them with the preprocessor, means they still get type-checked.
+#define ImpactDebugLogLevel(level, format, ...) do { \
+if ((level) > IMPACT_LOG_LEVEL) { \
+    break; \
+} \
 if (ImpactInvalidPtr(GlobalImpactState)) { \
     break; \
 } \
-dprintf(GlobalImpactState->mutableState.log.fd, format VA_ARGS(__VA_ARGS__)); \
+ImpactLog(format VA_ARGS(__VA_ARGS__)); \
 } while(0)
 
-#else
-
-#define ImpactDebugLog(format, ...) ImpactLog(format VA_ARGS(__VA_ARGS__))
-
-#endif
+#define ImpactDebugLogError(format, ...) ImpactDebugLogLevel(IMPACT_LOG_LEVEL_ERROR, format VA_ARGS(__VA_ARGS__))
+#define ImpactDebugLogWarn(format, ...) ImpactDebugLogLevel(IMPACT_LOG_LEVEL_WARN, format VA_ARGS(__VA_ARGS__))
+#define ImpactDebugLogInfo(format, ...) ImpactDebugLogLevel(IMPACT_LOG_LEVEL_INFO, format VA_ARGS(__VA_ARGS__))
 
 #endif /* ImpactDebug_h */
@@ -0,0 +1,187 @@
+//
+//  ImpactEncoding.c
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#include "ImpactEncoding.h"
+
+#if defined(__arm64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define IMPACT_ENCODING_NEON 1
+#elif defined(__x86_64__) && defined(__SSE2__)
+#include <emmintrin.h>
+#define IMPACT_ENCODING_SSE2 1
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#define IMPACT_ENCODING_SSSE3 1
+#endif
+#endif
+
+static const char ImpactEncodingHexDigits[16] = "0123456789abcdef";
+static const char ImpactEncodingBase64Alphabet[64] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+size_t ImpactEncodingHexScalar(const uint8_t* data, size_t length, char* output) {
+    for (size_t i = 0; i < length; ++i) {
+        output[i * 2] = ImpactEncodingHexDigits[data[i] >> 4];
+        output[i * 2 + 1] = ImpactEncodingHexDigits[data[i] & 0x0F];
+    }
+
+    return length * 2;
+}
+
+size_t ImpactEncodingBase64Scalar(const uint8_t* data, size_t length, char* output) {
+    size_t o = 0;
+    size_t i = 0;
+
+    for (; i + 3 <= length; i += 3) {
+        const uint32_t value = (uint32_t)data[i] << 16 | (uint32_t)data[i + 1] << 8 | data[i + 2];
+
+        output[o++] = ImpactEncodingBase64Alphabet[value >> 18];
+        output[o++] = ImpactEncodingBase64Alphabet[(value >> 12) & 0x3F];
+        output[o++] = ImpactEncodingBase64Alphabet[(value >> 6) & 0x3F];
+        output[o++] = ImpactEncodingBase64Alphabet[value & 0x3F];
+    }
+
+    const size_t remaining = length - i;
+
+    if (remaining > 0) {
+        const uint32_t value = (uint32_t)data[i] << 16 | (remaining > 1 ? (uint32_t)data[i + 1] << 8 : 0);
+
+        output[o++] = ImpactEncodingBase64Alphabet[value >> 18];
+        output[o++] = ImpactEncodingBase64Alphabet[(value >> 12) & 0x3F];
+        output[o++] = remaining > 1 ? ImpactEncodingBase64Alphabet[(value >> 6) & 0x3F] : '=';
+        output[o++] = '=';
+    }
+
+    return o;
+}
+
+#if IMPACT_ENCODING_NEON
+
+size_t ImpactEncodingHex(const uint8_t* data, size_t length, char* output) {
+    const uint8x16_t digits = vld1q_u8((const uint8_t*)ImpactEncodingHexDigits);
+    const uint8x16_t mask = vdupq_n_u8(0x0F);
+    size_t i = 0;
+
+    for (; i + 16 <= length; i += 16) {
+        const uint8x16_t bytes = vld1q_u8(data + i);
+        uint8x16x2_t chars;
+
+        chars.val[0] = vqtbl1q_u8(digits, vshrq_n_u8(bytes, 4));
+        chars.val[1] = vqtbl1q_u8(digits, vandq_u8(bytes, mask));
+
+        // interleaves the high and low digits
+        vst2q_u8((uint8_t*)output + i * 2, chars);
+    }
+
+    return i * 2 + ImpactEncodingHexScalar(data + i, length - i, output + i * 2);
+}
+
+size_t ImpactEncodingBase64(const uint8_t* data, size_t length, char* output) {
+    const uint8_t* alphabet = (const uint8_t*)ImpactEncodingBase64Alphabet;
+    const uint8x16x4_t table = {{ vld1q_u8(alphabet), vld1q_u8(alphabet + 16), vld1q_u8(alphabet + 32), vld1q_u8(alphabet + 48) }};
+    const uint8x16_t mask = vdupq_n_u8(0x3F);
+    size_t i = 0;
+    size_t o = 0;
+
+    // 48 bytes become 64 characters. The loads split the input into first, second and third bytes
+    // of each group, and the stores put the four resulting characters back together.
+    for (; i + 48 <= length; i += 48, o += 64) {
+        const uint8x16x3_t bytes = vld3q_u8(data + i);
+        uint8x16x4_t chars;
+
+        chars.val[0] = vshrq_n_u8(bytes.val[0], 2);
+        chars.val[1] = vandq_u8(vorrq_u8(vshrq_n_u8(bytes.val[1], 4), vshlq_n_u8(bytes.val[0], 4)), mask);
+        chars.val[2] = vandq_u8(vorrq_u8(vshrq_n_u8(bytes.val[2], 6), vshlq_n_u8(bytes.val[1], 2)), mask);
+        chars.val[3] = vandq_u8(bytes.val[2], mask);
+
+        for (uint32_t j = 0; j < 4; ++j) {
+            chars.val[j] = vqtbl4q_u8(table, chars.val[j]);
+        }
+
+        vst4q_u8((uint8_t*)output + o, chars);
+    }
+
+    return o + ImpactEncodingBase64Scalar(data + i, length - i, output + o);
+}
+
+#elif IMPACT_ENCODING_SSE2
+
+static inline __m128i ImpactEncodingHexDigitsSSE2(__m128i nibbles) {
+    const __m128i letters = _mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9));
+    const __m128i offset = _mm_add_epi8(_mm_set1_epi8('0'), _mm_and_si128(letters, _mm_set1_epi8('a' - '0' - 10)));
+
+    return _mm_add_epi8(nibbles, offset);
+}
+
+size_t ImpactEncodingHex(const uint8_t* data, size_t length, char* output) {
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    size_t i = 0;
+
+    for (; i + 16 <= length; i += 16) {
+        const __m128i bytes = _mm_loadu_si128((const __m128i*)(data + i));
+        const __m128i high = ImpactEncodingHexDigitsSSE2(_mm_and_si128(_mm_srli_epi16(bytes, 4), mask));
+        const __m128i low = ImpactEncodingHexDigitsSSE2(_mm_and_si128(bytes, mask));
+
+        _mm_storeu_si128((__m128i*)(output + i * 2), _mm_unpacklo_epi8(high, low));
+        _mm_storeu_si128((__m128i*)(output + i * 2 + 16), _mm_unpackhi_epi8(high, low));
+    }
+
+    return i * 2 + ImpactEncodingHexScalar(data + i, length - i, output + i * 2);
+}
+
+#if IMPACT_ENCODING_SSSE3
+
+size_t ImpactEncodingBase64(const uint8_t* data, size_t length, char* output) {
+    // Gathers each group of three bytes into a 32-bit lane as bytes 1, 0, 2, 1, so the four 6-bit
+    // indices can be moved into place with multiplies.
+    const __m128i gather = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+
+    // Indices are mapped to characters by adding an offset that depends on which range they are in.
+    // The ranges are A-Z, a-z, 0-9, + and /, and the offsets are looked up by a reduced index.
+    const __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                          '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                          '/' - 63, 'A', 0, 0);
+    size_t i = 0;
+    size_t o = 0;
+
+    // 12 bytes become 16 characters, but each load reads 16 bytes
+    for (; i + 16 <= length; i += 12, o += 16) {
+        const __m128i bytes = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + i)), gather);
+
+        const __m128i high = _mm_mulhi_epu16(_mm_and_si128(bytes, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+        const __m128i low = _mm_mullo_epi16(_mm_and_si128(bytes, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+        const __m128i indices = _mm_or_si128(high, low);
+
+        __m128i reduced = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+        const __m128i uppercase = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+
+        reduced = _mm_or_si128(reduced, _mm_and_si128(uppercase, _mm_set1_epi8(13)));
+
+        _mm_storeu_si128((__m128i*)(output + o), _mm_add_epi8(indices, _mm_shuffle_epi8(offsets, reduced)));
+    }
+
+    return o + ImpactEncodingBase64Scalar(data + i, length - i, output + o);
+}
+
+#else
+
+size_t ImpactEncodingBase64(const uint8_t* data, size_t length, char* output) {
+    return ImpactEncodingBase64Scalar(data, length, output);
+}
+
+#endif
+
+#else
+
+size_t ImpactEncodingHex(const uint8_t* data, size_t length, char* output) {
+    return ImpactEncodingHexScalar(data, length, output);
+}
+
+size_t ImpactEncodingBase64(const uint8_t* data, size_t length, char* output) {
+    return ImpactEncodingBase64Scalar(data, length, output);
+}
+
+#endif
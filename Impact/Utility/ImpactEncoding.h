@@ -0,0 +1,45 @@
+//
+//  ImpactEncoding.h
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#ifndef ImpactEncoding_h
+#define ImpactEncoding_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/cdefs.h>
+
+// Lowercase hex and standard, padded base64. These write into caller-provided memory, never NUL-terminate,
+// and are async-signal-safe. Vector kernels are used on arm64 (NEON) and x86_64 (SSE2 for hex, SSSE3 for
+// base64), and produce exactly the same output as the scalar code.
+
+_Pragma("clang assume_nonnull begin")
+__BEGIN_DECLS
+
+static inline size_t ImpactEncodingHexLength(size_t length) {
+    return length * 2;
+}
+
+static inline size_t ImpactEncodingBase64Length(size_t length) {
+    return (length + 2) / 3 * 4;
+}
+
+// Returns the number of characters written, which is ImpactEncodingHexLength(length).
+size_t ImpactEncodingHex(const uint8_t* data, size_t length, char* output);
+
+// Returns the number of characters written, which is ImpactEncodingBase64Length(length). Only the
+// final group is padded, so input can be encoded in pieces as long as all but the last are a multiple
+// of three bytes long.
+size_t ImpactEncodingBase64(const uint8_t* data, size_t length, char* output);
+
+// The scalar implementations, for comparison.
+size_t ImpactEncodingHexScalar(const uint8_t* data, size_t length, char* output);
+size_t ImpactEncodingBase64Scalar(const uint8_t* data, size_t length, char* output);
+
+__END_DECLS
+_Pragma("clang assume_nonnull end")
+
+#endif /* ImpactEncoding_h */
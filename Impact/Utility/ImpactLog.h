@@ -13,6 +13,7 @@
 #include "ImpactState.h"
 
 #include <sys/types.h>
+#include <stdarg.h>
 #include <stdbool.h>
 
 #if __OBJC__
@@ -22,20 +23,48 @@
 _Pragma("clang assume_nonnull begin")
 __BEGIN_DECLS
 
+// Mapped reports start with this header. Only the committed number of bytes that follow it are part of the report.
+typedef struct {
+    char magic[4];
+    uint32_t headerSize;
+    _Atomic uint64_t committed;
+} ImpactLogMappedHeader;
+
+static const char ImpactLogMappedMagic[4] = { 'I', 'M', 'P', 'M' };
+
 ImpactResult ImpactLogInitialize(ImpactState* state, const char* path);
+ImpactResult ImpactLogInitializeWithEncoding(ImpactState* state, const char* path, ImpactLogEncoding encoding);
+// Preallocates and maps the file, so writing never needs a system call unless the report outgrows it.
+ImpactResult ImpactLogInitializeMapped(ImpactState* state, const char* path, ImpactLogEncoding encoding, size_t size);
+// Compresses the report in blocks, one per flush. Read these with ImpactLogCompressionDecode.
+ImpactResult ImpactLogInitializeCompressed(ImpactState* state, const char* path, ImpactLogEncoding encoding, ImpactLogCompressor* compressor);
 ImpactResult ImpactLogDeinitialize(ImpactLogger* log);
+
+// Resets a logger whose sink was just opened, and writes any encoding preamble.
+ImpactResult ImpactLogStart(ImpactLogger* log, ImpactLogEncoding encoding);
+
+// Finds the report within a file, which is everything unless it was written with a mapping.
+ImpactResult ImpactLogGetReportContents(const uint8_t* data, size_t length, const uint8_t* _Nullable * _Nonnull contents, size_t* contentLength);
 bool ImpactLogIsValid(const ImpactLogger* log);
 
-ImpactResult ImpactLog(const char * __restrict format, ...) __printflike(1, 2);
+// Async-signal-safe subset of printf: %d %i %u %x %X %p %s %c %%, with optional zero-padded
+// width and the hh, h, l, ll, z, j and t length modifiers. Always NUL-terminates.
+size_t ImpactLogFormat(char* buffer, size_t size, const char* format, va_list args) __printflike(3, 0);
 
 ImpactResult ImpactLogFlush(ImpactLogger* log);
 ImpactResult ImpactLogWriteData(ImpactLogger* log, const char* data, size_t length);
 ImpactResult ImpactLogWriteString(ImpactLogger* log, const char* string);
 ImpactResult ImpactLogWriteInteger(ImpactLogger* log, uintptr_t number);
 
+// Records are a name followed by key-value fields. The last field ends the record, and records without any fields must be ended explicitly.
+ImpactResult ImpactLogBeginRecord(ImpactLogger* log, const char* name);
+ImpactResult ImpactLogEndRecord(ImpactLogger* log);
+
 ImpactResult ImpactLogWriteKeyInteger(ImpactLogger* log, const char* key, uintptr_t number, bool last);
+ImpactResult ImpactLogWriteKeySignedInteger(ImpactLogger* log, const char* key, intptr_t number, bool last);
 ImpactResult ImpactLogWriteKeyPointer(ImpactLogger* log, const char* key, const void* _Nullable ptr, bool last);
 ImpactResult ImpactLogWriteKeyString(ImpactLogger* log, const char* key, const char* string, bool last);
+ImpactResult ImpactLogWriteKeyData(ImpactLogger* log, const char* key, const char* data, size_t length, bool last);
 
 #if __OBJC__
 ImpactResult ImpactLogWriteKeyStringObject(ImpactLogger* log, const char* key, NSString* string, bool last);
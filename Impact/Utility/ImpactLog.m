@@ -8,28 +8,120 @@
 
 #include "ImpactLog.h"
 #include "ImpactPointer.h"
+#include "ImpactTime.h"
+#include "ImpactLogBinary.h"
+#include "ImpactLogSink.h"
+#include "ImpactEncoding.h"
 
+#include <pthread.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <string.h>
 #include <time.h>
 
 ImpactResult ImpactLogInitialize(ImpactState* state, const char* _Nonnull path) {
+    return ImpactLogInitializeWithEncoding(state, path, ImpactLogEncodingText);
+}
+
+ImpactResult ImpactLogStart(ImpactLogger* log, ImpactLogEncoding encoding) {
+    if (ImpactInvalidPtr(log) || ImpactInvalidPtr(log->sink)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    log->bufferCount = 0;
+    log->flushDuration = 0;
+    log->flushCount = 0;
+
+    log->encoding = encoding;
+    log->recordSeparatorPending = false;
+    log->recordContinuation = false;
+    log->recordCount = 0;
+
+    if (encoding != ImpactLogEncodingBinary) {
+        return ImpactResultSuccess;
+    }
+
+    ImpactLogBinaryInitializeNames();
+
+    const uint8_t version = ImpactLogBinaryVersion;
+
+    ImpactLogWriteData(log, (const char*)ImpactLogBinaryMagic, sizeof(ImpactLogBinaryMagic));
+    ImpactLogWriteData(log, (const char*)&version, 1);
+
+    return ImpactLogFlush(log);
+}
+
+ImpactResult ImpactLogInitializeWithEncoding(ImpactState* state, const char* _Nonnull path, ImpactLogEncoding encoding) {
     if (ImpactInvalidPtr(state) || ImpactInvalidPtr(path)) {
         return ImpactResultPointerInvalid;
     }
 
+    ImpactLogger* log = &state->mutableState.log;
+
+    log->sink = NULL;
+
     int fd = open(path, O_WRONLY | O_APPEND | O_CREAT | O_TRUNC, 0666);
     if (fd == -1) {
         return ImpactResultFailure;
     }
 
-    state->mutableState.log.fd = fd;
+    const ImpactResult result = ImpactLogSinkOpenDescriptor(log, fd);
+    if (result != ImpactResultSuccess) {
+        close(fd);
+        return result;
+    }
 
-    state->mutableState.log.bufferCount = 0;
-    memset(state->mutableState.log.buffer, 0, ImpactLogBufferSize);
+    return ImpactLogStart(log, encoding);
+}
 
-    return ImpactResultSuccess;
+ImpactResult ImpactLogInitializeMapped(ImpactState* state, const char* _Nonnull path, ImpactLogEncoding encoding, size_t size) {
+    if (ImpactInvalidPtr(state) || ImpactInvalidPtr(path)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    ImpactLogger* log = &state->mutableState.log;
+
+    log->sink = NULL;
+
+    if (size == 0) {
+        return ImpactResultArgumentInvalid;
+    }
+
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0666);
+    if (fd == -1) {
+        return ImpactResultFailure;
+    }
+
+    const ImpactResult result = ImpactLogSinkOpenMapped(log, fd, size);
+    if (result != ImpactResultSuccess) {
+        close(fd);
+        return result;
+    }
+
+    return ImpactLogStart(log, encoding);
+}
+
+ImpactResult ImpactLogInitializeCompressed(ImpactState* state, const char* _Nonnull path, ImpactLogEncoding encoding, ImpactLogCompressor* _Nonnull compressor) {
+    if (ImpactInvalidPtr(state) || ImpactInvalidPtr(path)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    ImpactLogger* log = &state->mutableState.log;
+
+    log->sink = NULL;
+
+    int fd = open(path, O_WRONLY | O_APPEND | O_CREAT | O_TRUNC, 0666);
+    if (fd == -1) {
+        return ImpactResultFailure;
+    }
+
+    const ImpactResult result = ImpactLogSinkOpenCompressed(log, fd, compressor);
+    if (result != ImpactResultSuccess) {
+        close(fd);
+        return result;
+    }
+
+    return ImpactLogStart(log, encoding);
 }
 
 ImpactResult ImpactLogDeinitialize(ImpactLogger* _Nonnull log) {
@@ -37,7 +129,45 @@ ImpactResult ImpactLogDeinitialize(ImpactLogger* _Nonnull log) {
         return ImpactResultPointerInvalid;
     }
 
-    return ImpactResultFailure;
+    if (ImpactInvalidPtr(log->sink)) {
+        return ImpactResultArgumentInvalid;
+    }
+
+    const ImpactResult result = ImpactLogFlush(log);
+
+    log->sink->close(log);
+    log->sink = NULL;
+    log->fd = -1;
+
+    return result;
+}
+
+ImpactResult ImpactLogGetReportContents(const uint8_t* data, size_t length, const uint8_t* _Nullable * _Nonnull contents, size_t* contentLength) {
+    if (ImpactInvalidPtr(data) || ImpactInvalidPtr(contents) || ImpactInvalidPtr(contentLength)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    *contents = data;
+    *contentLength = length;
+
+    if (length < sizeof(ImpactLogMappedHeader) || memcmp(data, ImpactLogMappedMagic, sizeof(ImpactLogMappedMagic)) != 0) {
+        return ImpactResultSuccess;
+    }
+
+    ImpactLogMappedHeader header;
+
+    memcpy(&header, data, sizeof(ImpactLogMappedHeader));
+
+    const uint64_t committed = atomic_load_explicit(&header.committed, memory_order_relaxed);
+
+    if (header.headerSize > length || committed > length - header.headerSize) {
+        return ImpactResultInconsistentData;
+    }
+
+    *contents = data + header.headerSize;
+    *contentLength = (size_t)committed;
+
+    return ImpactResultSuccess;
 }
 
 bool ImpactLogIsValid(const ImpactLogger* log) {
@@ -45,7 +175,7 @@ bool ImpactLogIsValid(const ImpactLogger* log) {
         return false;
     }
 
-    if (log->fd <= 0) {
+    if (ImpactInvalidPtr(log->sink)) {
         return false;
     }
 
@@ -53,55 +183,46 @@ bool ImpactLogIsValid(const ImpactLogger* log) {
 }
 
 ImpactResult ImpactLogWriteData(ImpactLogger* log, const char* data, size_t length) {
-    if (length == 0) {
-        return ImpactResultSuccess;
-    }
-
     for(uint32_t i = 0; i < 100; ++i) {
-        const ssize_t spaceRemaining = ImpactLogBufferSize - log->bufferCount;
-        ssize_t chunkSize = MIN(length, spaceRemaining);
-        if (chunkSize <= 0) {
+        if (length == 0) {
+            return ImpactResultSuccess;
+        }
+
+        size_t chunkSize = length;
+        char* buffer = log->sink->reserve(log, &chunkSize);
+        if (buffer == NULL) {
             const ImpactResult result = ImpactLogFlush(log);
             if (result != ImpactResultSuccess) {
                 return result;
             }
 
-            chunkSize = MIN(length, ImpactLogBufferSize);
+            chunkSize = length;
+            buffer = log->sink->reserve(log, &chunkSize);
+            if (buffer == NULL) {
+                return ImpactResultFailure;
+            }
         }
 
-        void* buffer = log->buffer + log->bufferCount;
-
         memcpy(buffer, data, chunkSize);
 
-        log->bufferCount += chunkSize;
+        log->sink->commit(log, chunkSize);
         length -= chunkSize;
         data += chunkSize;
-
-        if (length == 0) {
-            return ImpactResultSuccess;
-        }
     }
 
     return ImpactResultTooManyIterations;
 }
 
 ImpactResult ImpactLogFlush(ImpactLogger* log) {
-    size_t writeCount = log->bufferCount;
-    const void* data = log->buffer;
+    const uint64_t start = ImpactTimeGetMonotonicNanoseconds();
 
-    while (writeCount > 0) {
-        const ssize_t count = write(log->fd, data, writeCount);
-
-        if (count == -1) {
-            return ImpactResultCallFailed;
-        }
-
-        // this accounts for a partial write
-        writeCount -= count;
-        data = log->buffer + count;
+    const ImpactResult result = log->sink->flush(log);
+    if (result != ImpactResultSuccess) {
+        return result;
     }
 
-    log->bufferCount = 0;
+    log->flushDuration += ImpactTimeGetMonotonicNanoseconds() - start;
+    log->flushCount += 1;
 
     return ImpactResultSuccess;
 }
@@ -133,38 +254,105 @@ ImpactResult ImpactLogWriteInteger(ImpactLogger* log, uintptr_t number) {
         return ImpactResultArgumentInvalid;
     }
 
-    char buffer[16];
-    char *ptr = buffer + sizeof(buffer) - 1;
-
-    memset(buffer, '0', sizeof(buffer));
+    uint32_t digits = 1;
 
-    while (number > 0) {
-        int modResult = number % 16;
+    for (uintptr_t value = number >> 4; value > 0; value >>= 4) {
+        digits += 1;
+    }
 
-        *ptr = ImpactLogValueToHexChar(modResult);
+    // Formatting straight into the sink saves a copy. This only works when the whole value fits
+    // in one span, which is nearly always.
+    const size_t length = 2 + digits;
+    size_t available = length;
+    char* ptr = log->sink->reserve(log, &available);
 
-        number = number / 16;
+    char buffer[2 + sizeof(uintptr_t) * 2];
 
-        if (number > 0) {
-            ptr -= 1;
-        }
+    if (ptr == NULL || available < length) {
+        ptr = buffer;
     }
 
-    ImpactLogWriteString(log, "0x");
+    ptr[0] = '0';
+    ptr[1] = 'x';
 
-    const size_t length = sizeof(buffer) - (ptr - buffer);
+    for (uint32_t i = 0; i < digits; ++i) {
+        ptr[length - 1 - i] = ImpactLogValueToHexChar(number >> (i * 4));
+    }
+
+    if (ptr != buffer) {
+        return log->sink->commit(log, length);
+    }
 
-    return ImpactLogWriteData(log, ptr, length);
+    return ImpactLogWriteData(log, buffer, length);
 }
 
 ImpactResult ImpactLogWriteHexData(ImpactLogger* log, const uint8_t* data, size_t length) {
-    char buffer[2] = {0};
+    if (ImpactInvalidPtr(data)) {
+        return ImpactResultSuccess;
+    }
+
+    while (length > 0) {
+        size_t available = ImpactEncodingHexLength(length);
+        char* ptr = log->sink->reserve(log, &available);
+        size_t count = available / 2;
+
+        // a span too small for even one byte means the sink has to be flushed first
+        if (ptr == NULL || count == 0) {
+            char buffer[2];
+
+            ImpactEncodingHex(data, 1, buffer);
+
+            const ImpactResult result = ImpactLogWriteData(log, buffer, 2);
+            if (result != ImpactResultSuccess) {
+                return result;
+            }
+
+            data += 1;
+            length -= 1;
+            continue;
+        }
+
+        log->sink->commit(log, ImpactEncodingHex(data, count, ptr));
+        data += count;
+        length -= count;
+    }
+
+    return ImpactResultSuccess;
+}
+
+ImpactResult ImpactLogWriteBase64Data(ImpactLogger* log, const uint8_t* data, size_t length) {
+    if (ImpactInvalidPtr(data)) {
+        return ImpactResultSuccess;
+    }
+
+    while (length > 0) {
+        size_t available = ImpactEncodingBase64Length(length);
+        char* ptr = log->sink->reserve(log, &available);
 
-    for (size_t i = 0; i < length; ++i) {
-        buffer[1] = ImpactLogValueToHexChar(data[i]);
-        buffer[0] = ImpactLogValueToHexChar(data[i] >> 4);
+        // Only the end of the data can be a partial group, so a span that can't take all of it
+        // gets whole groups.
+        size_t count = available >= ImpactEncodingBase64Length(length) ? length : available / 4 * 3;
 
-        ImpactLogWriteData(log, buffer, 2);
+        if (ptr == NULL || count == 0) {
+            char buffer[4];
+
+            count = length < 3 ? length : 3;
+
+            ImpactEncodingBase64(data, count, buffer);
+
+            const ImpactResult result = ImpactLogWriteData(log, buffer, 4);
+            if (result != ImpactResultSuccess) {
+                return result;
+            }
+
+            data += count;
+            length -= count;
+            continue;
+        }
+
+        log->sink->commit(log, ImpactEncodingBase64(data, count, ptr));
+        data += count;
+        length -= count;
     }
 
     return ImpactResultSuccess;
@@ -183,46 +371,546 @@ ImpactResult ImpactLogWriteSeparator(ImpactLogger* log, bool ending) {
     return ImpactResultSuccess;
 }
 
-ImpactResult ImpactLogWriteKeyInteger(ImpactLogger* log, const char* key, uintptr_t number, bool last) {
+#pragma mark - Binary Records
+
+static ImpactResult ImpactLogBinaryEmitRecord(ImpactLogger* log, uint8_t flags, const uint8_t* payload, size_t length) {
+    uint8_t header[1 + ImpactLogBinaryMaxVarintSize];
+
+    header[0] = ImpactLogBinaryRecordKind | flags;
+
+    const size_t headerLength = 1 + ImpactLogBinaryEncodeVarint(header + 1, length);
+
+    uint32_t crc = ImpactLogBinaryCRC32(0, header, headerLength);
+    crc = ImpactLogBinaryCRC32(crc, payload, length);
+
+    const uint8_t trailer[ImpactLogBinaryTrailerSize] = {
+        crc & 0xFF, (crc >> 8) & 0xFF, (crc >> 16) & 0xFF, (crc >> 24) & 0xFF
+    };
+
+    ImpactLogWriteData(log, (const char*)header, headerLength);
+    ImpactLogWriteData(log, (const char*)payload, length);
+
+    return ImpactLogWriteData(log, (const char*)trailer, sizeof(trailer));
+}
+
+static size_t ImpactLogBinaryEncodeName(uint8_t* buffer, const char* name) {
+    const uint32_t index = ImpactLogBinaryLookupName(name);
+    if (index != 0) {
+        return ImpactLogBinaryEncodeVarint(buffer, index);
+    }
+
+    // names are short, so a cap keeps the worst-case size of a field predictable
+    const size_t length = strnlen(name, 127);
+
+    size_t offset = ImpactLogBinaryEncodeVarint(buffer, 0);
+
+    offset += ImpactLogBinaryEncodeVarint(buffer + offset, length);
+    memcpy(buffer + offset, name, length);
+
+    return offset + length;
+}
+
+static ImpactResult ImpactLogBinaryFinishRecord(ImpactLogger* log, bool more) {
+    uint8_t flags = 0;
+
+    if (more) {
+        flags |= ImpactLogBinaryRecordFlagMore;
+    }
+
+    if (log->recordContinuation) {
+        flags |= ImpactLogBinaryRecordFlagContinuation;
+    }
+
+    ImpactResult result = ImpactLogBinaryEmitRecord(log, flags, log->record, log->recordCount);
+
+    log->recordCount = 0;
+    log->recordContinuation = more;
+
+    if (more) {
+        return result;
+    }
+
+    return ImpactLogFlush(log);
+}
+
+static ImpactResult ImpactLogBinaryAppendField(ImpactLogger* log, const char* key, ImpactLogBinaryFieldType type, uint64_t integer, const uint8_t* data, size_t length, bool last) {
+    // header, inline key length, inline key, and value length
+    const size_t overhead = ImpactLogBinaryMaxVarintSize * 3 + 127;
+    const size_t capacity = ImpactLogRecordBufferSize - overhead;
+
+    // a single value can never span records, so anything larger is truncated
+    if (length > capacity) {
+        length = capacity;
+    }
+
+    if (log->recordCount + overhead + length > ImpactLogRecordBufferSize) {
+        const ImpactResult result = ImpactLogBinaryFinishRecord(log, true);
+        if (result != ImpactResultSuccess) {
+            return result;
+        }
+    }
+
+    uint8_t* buffer = log->record + log->recordCount;
+    const uint32_t keyIndex = ImpactLogBinaryLookupName(key);
+    size_t offset = ImpactLogBinaryEncodeVarint(buffer, (uint64_t)keyIndex << ImpactLogBinaryFieldTypeBits | type);
+
+    if (keyIndex == 0) {
+        const size_t keyLength = strnlen(key, 127);
+
+        offset += ImpactLogBinaryEncodeVarint(buffer + offset, keyLength);
+        memcpy(buffer + offset, key, keyLength);
+        offset += keyLength;
+    }
+
+    if (type == ImpactLogBinaryFieldUnsigned || type == ImpactLogBinaryFieldSigned) {
+        offset += ImpactLogBinaryEncodeVarint(buffer + offset, integer);
+    } else {
+        offset += ImpactLogBinaryEncodeVarint(buffer + offset, length);
+
+        if (length > 0) {
+            memcpy(buffer + offset, data, length);
+        }
+
+        offset += length;
+    }
+
+    log->recordCount += offset;
+
+    if (last) {
+        return ImpactLogBinaryFinishRecord(log, false);
+    }
+
+    return ImpactResultSuccess;
+}
+
+static bool ImpactLogIsBinary(const ImpactLogger* log) {
+    return log->encoding == ImpactLogEncodingBinary;
+}
+
+ImpactResult ImpactLogBeginRecord(ImpactLogger* log, const char* name) {
+    if (!ImpactLogIsValid(log) || ImpactInvalidPtr(name)) {
+        return ImpactResultArgumentInvalid;
+    }
+
+    if (ImpactLogIsBinary(log)) {
+        log->recordContinuation = false;
+        log->recordCount = (uint32_t)ImpactLogBinaryEncodeName(log->record, name);
+
+        return ImpactResultSuccess;
+    }
+
+    ImpactLogWriteString(log, "[");
+    ImpactLogWriteString(log, name);
+    ImpactLogWriteString(log, "]");
+
+    log->recordSeparatorPending = true;
+
+    return ImpactResultSuccess;
+}
+
+ImpactResult ImpactLogEndRecord(ImpactLogger* log) {
+    if (!ImpactLogIsValid(log)) {
+        return ImpactResultArgumentInvalid;
+    }
+
+    if (ImpactLogIsBinary(log)) {
+        return ImpactLogBinaryFinishRecord(log, false);
+    }
+
+    log->recordSeparatorPending = false;
+
+    return ImpactLogWriteSeparator(log, true);
+}
+
+static ImpactResult ImpactLogWriteKey(ImpactLogger* log, const char* key) {
+    if (log->recordSeparatorPending) {
+        log->recordSeparatorPending = false;
+
+        ImpactLogWriteString(log, " ");
+    }
+
     ImpactLogWriteString(log, key);
-    ImpactLogWriteString(log, ": ");
+
+    return ImpactLogWriteString(log, ": ");
+}
+
+#pragma mark - Formatting
+
+typedef struct {
+    char* buffer;
+    size_t size;
+    size_t length;
+} ImpactLogFormatter;
+
+static void ImpactLogFormatterAppend(ImpactLogFormatter* formatter, char c) {
+    // reserve space for the terminator
+    if (formatter->length + 1 >= formatter->size) {
+        return;
+    }
+
+    formatter->buffer[formatter->length] = c;
+    formatter->length += 1;
+}
+
+static void ImpactLogFormatterAppendString(ImpactLogFormatter* formatter, const char* string) {
+    if (ImpactInvalidPtr(string)) {
+        string = "(null)";
+    }
+
+    for (; *string != 0; ++string) {
+        ImpactLogFormatterAppend(formatter, *string);
+    }
+}
+
+static void ImpactLogFormatterAppendNumber(ImpactLogFormatter* formatter, uint64_t value, uint32_t base, bool negative, uint32_t width, char padding, bool uppercase) {
+    const char* digits = uppercase ? "0123456789ABCDEF" : "0123456789abcdef";
+    char buffer[24];
+    uint32_t count = 0;
+
+    do {
+        buffer[count] = digits[value % base];
+        value /= base;
+        count += 1;
+    } while (value > 0 && count < sizeof(buffer));
+
+    const uint32_t length = count + (negative ? 1 : 0);
+
+    if (negative && padding == '0') {
+        ImpactLogFormatterAppend(formatter, '-');
+    }
+
+    for (uint32_t i = length; i < width; ++i) {
+        ImpactLogFormatterAppend(formatter, padding);
+    }
+
+    if (negative && padding != '0') {
+        ImpactLogFormatterAppend(formatter, '-');
+    }
+
+    while (count > 0) {
+        count -= 1;
+        ImpactLogFormatterAppend(formatter, buffer[count]);
+    }
+}
+
+typedef enum {
+    ImpactLogFormatLengthDefault,
+    ImpactLogFormatLengthChar,
+    ImpactLogFormatLengthShort,
+    ImpactLogFormatLengthLong,
+    ImpactLogFormatLengthLongLong,
+    ImpactLogFormatLengthSize
+} ImpactLogFormatLength;
+
+static int64_t ImpactLogFormatReadSigned(va_list* args, ImpactLogFormatLength length) {
+    switch (length) {
+        case ImpactLogFormatLengthChar:
+            return (signed char)va_arg(*args, int);
+        case ImpactLogFormatLengthShort:
+            return (short)va_arg(*args, int);
+        case ImpactLogFormatLengthLong:
+            return va_arg(*args, long);
+        case ImpactLogFormatLengthLongLong:
+            return va_arg(*args, long long);
+        case ImpactLogFormatLengthSize:
+            return va_arg(*args, ssize_t);
+        case ImpactLogFormatLengthDefault:
+            break;
+    }
+
+    return va_arg(*args, int);
+}
+
+static uint64_t ImpactLogFormatReadUnsigned(va_list* args, ImpactLogFormatLength length) {
+    switch (length) {
+        case ImpactLogFormatLengthChar:
+            return (unsigned char)va_arg(*args, unsigned int);
+        case ImpactLogFormatLengthShort:
+            return (unsigned short)va_arg(*args, unsigned int);
+        case ImpactLogFormatLengthLong:
+            return va_arg(*args, unsigned long);
+        case ImpactLogFormatLengthLongLong:
+            return va_arg(*args, unsigned long long);
+        case ImpactLogFormatLengthSize:
+            return va_arg(*args, size_t);
+        case ImpactLogFormatLengthDefault:
+            break;
+    }
+
+    return va_arg(*args, unsigned int);
+}
+
+size_t ImpactLogFormat(char* buffer, size_t size, const char* format, va_list args) {
+    if (ImpactInvalidPtr(buffer) || size == 0) {
+        return 0;
+    }
+
+    ImpactLogFormatter formatter = {
+        .buffer = buffer,
+        .size = size,
+        .length = 0
+    };
+
+    // va_list may be an array type, so work on a copy that can be passed by pointer
+    va_list argsCopy;
+    va_copy(argsCopy, args);
+
+    for (const char* ptr = format; ptr != NULL && *ptr != 0; ++ptr) {
+        if (*ptr != '%') {
+            ImpactLogFormatterAppend(&formatter, *ptr);
+            continue;
+        }
+
+        ptr += 1;
+
+        char padding = ' ';
+        uint32_t width = 0;
+        ImpactLogFormatLength length = ImpactLogFormatLengthDefault;
+
+        if (*ptr == '0') {
+            padding = '0';
+            ptr += 1;
+        }
+
+        while (*ptr >= '0' && *ptr <= '9') {
+            width = width * 10 + (*ptr - '0');
+            ptr += 1;
+        }
+
+        switch (*ptr) {
+            case 'h':
+                ptr += 1;
+                length = ImpactLogFormatLengthShort;
+
+                if (*ptr == 'h') {
+                    ptr += 1;
+                    length = ImpactLogFormatLengthChar;
+                }
+                break;
+            case 'l':
+                ptr += 1;
+                length = ImpactLogFormatLengthLong;
+
+                if (*ptr == 'l') {
+                    ptr += 1;
+                    length = ImpactLogFormatLengthLongLong;
+                }
+                break;
+            case 'z':
+            case 'j':
+            case 't':
+                ptr += 1;
+                length = ImpactLogFormatLengthSize;
+                break;
+            default:
+                break;
+        }
+
+        switch (*ptr) {
+            case 'd':
+            case 'i': {
+                const int64_t value = ImpactLogFormatReadSigned(&argsCopy, length);
+                const uint64_t magnitude = value < 0 ? (uint64_t)0 - (uint64_t)value : (uint64_t)value;
+
+                ImpactLogFormatterAppendNumber(&formatter, magnitude, 10, value < 0, width, padding, false);
+                break;
+            }
+            case 'u':
+                ImpactLogFormatterAppendNumber(&formatter, ImpactLogFormatReadUnsigned(&argsCopy, length), 10, false, width, padding, false);
+                break;
+            case 'x':
+            case 'X':
+                ImpactLogFormatterAppendNumber(&formatter, ImpactLogFormatReadUnsigned(&argsCopy, length), 16, false, width, padding, *ptr == 'X');
+                break;
+            case 'p':
+                ImpactLogFormatterAppendString(&formatter, "0x");
+                ImpactLogFormatterAppendNumber(&formatter, (uintptr_t)va_arg(argsCopy, void*), 16, false, width, padding, false);
+                break;
+            case 's':
+                ImpactLogFormatterAppendString(&formatter, va_arg(argsCopy, const char*));
+                break;
+            case 'c':
+                ImpactLogFormatterAppend(&formatter, (char)va_arg(argsCopy, int));
+                break;
+            case '%':
+                ImpactLogFormatterAppend(&formatter, '%');
+                break;
+            case 0:
+                // a trailing '%' - stop rather than read past the end
+                ptr -= 1;
+                break;
+            default:
+                ImpactLogFormatterAppend(&formatter, '%');
+                ImpactLogFormatterAppend(&formatter, *ptr);
+                break;
+        }
+    }
+
+    va_end(argsCopy);
+
+    formatter.buffer[formatter.length] = 0;
+
+    return formatter.length;
+}
+
+ImpactResult ImpactLog(const char * __restrict format, ...) {
+    ImpactState* state = GlobalImpactState;
+
+    if (ImpactInvalidPtr(state)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    // The logger has no lock. While a crash is handled, monitors running on other threads would
+    // otherwise write into the middle of the report.
+    const ImpactCrashState crashState = atomic_load(&state->mutableState.crashState);
+    const bool crashing = crashState != ImpactCrashStateUninitialized && crashState != ImpactCrashStateInitialized;
+
+    if (crashing && atomic_load(&state->mutableState.crashHandlerThread) != pthread_mach_thread_np(pthread_self())) {
+        return ImpactResultStateInvalid;
+    }
+
+    ImpactLogger* log = ImpactStateGetLog(state);
+
+    if (!ImpactLogIsValid(log)) {
+        return ImpactResultArgumentInvalid;
+    }
+
+    char buffer[ImpactLogBufferSize];
+    va_list args;
+
+    va_start(args, format);
+    const size_t length = ImpactLogFormat(buffer, sizeof(buffer), format, args);
+    va_end(args);
+
+    if (ImpactLogIsBinary(log)) {
+        // These become records of their own. A record being staged is not affected, as it has its own buffer.
+        uint8_t payload[ImpactLogBufferSize + ImpactLogBinaryMaxVarintSize * 3];
+
+        size_t offset = ImpactLogBinaryEncodeName(payload, "Log");
+
+        offset += ImpactLogBinaryEncodeVarint(payload + offset, (uint64_t)ImpactLogBinaryLookupName("message") << ImpactLogBinaryFieldTypeBits | ImpactLogBinaryFieldString);
+        offset += ImpactLogBinaryEncodeVarint(payload + offset, length);
+
+        memcpy(payload + offset, buffer, length);
+
+        return ImpactLogBinaryEmitRecord(log, 0, payload, offset + length);
+    }
+
+    // Messages are whole lines. Appending one in the middle of a record would split it, so
+    // sinks that can put it ahead of the partial record do so.
+    if (log->sink->writeAhead) {
+        return log->sink->writeAhead(log, buffer, length);
+    }
+
+    return ImpactLogWriteData(log, buffer, length);
+}
+
+ImpactResult ImpactLogWriteKeyInteger(ImpactLogger* log, const char* key, uintptr_t number, bool last) {
+    if (ImpactLogIsBinary(log)) {
+        return ImpactLogBinaryAppendField(log, key, ImpactLogBinaryFieldUnsigned, number, NULL, 0, last);
+    }
+
+    ImpactLogWriteKey(log, key);
     ImpactLogWriteInteger(log, number);
 
     return ImpactLogWriteSeparator(log, last);
 }
 
+ImpactResult ImpactLogWriteKeySignedInteger(ImpactLogger* log, const char* key, intptr_t number, bool last) {
+    if (ImpactLogIsBinary(log)) {
+        return ImpactLogBinaryAppendField(log, key, ImpactLogBinaryFieldSigned, ImpactLogBinaryZigZagEncode(number), NULL, 0, last);
+    }
+
+    ImpactLogWriteKey(log, key);
+
+    if (number < 0) {
+        ImpactLogWriteString(log, "-");
+    }
+
+    ImpactLogWriteInteger(log, number < 0 ? (uintptr_t)0 - (uintptr_t)number : (uintptr_t)number);
+
+    return ImpactLogWriteSeparator(log, last);
+}
+
 ImpactResult ImpactLogWriteKeyPointer(ImpactLogger* log, const char* key, const void* ptr, bool last) {
     return ImpactLogWriteKeyInteger(log, key, (uintptr_t)ptr, last);
 }
 
 ImpactResult ImpactLogWriteKeyString(ImpactLogger* log, const char* key, const char* string, bool last) {
-    ImpactLogWriteString(log, key);
-    ImpactLogWriteString(log, ": ");
-    ImpactLogWriteString(log, string);
+    if (ImpactInvalidPtr(string)) {
+        string = "";
+    }
+
+    return ImpactLogWriteKeyData(log, key, string, strlen(string), last);
+}
+
+ImpactResult ImpactLogWriteKeyData(ImpactLogger* log, const char* key, const char* data, size_t length, bool last) {
+    if (ImpactLogIsBinary(log)) {
+        return ImpactLogBinaryAppendField(log, key, ImpactLogBinaryFieldString, 0, (const uint8_t*)data, length, last);
+    }
+
+    ImpactLogWriteKey(log, key);
+    ImpactLogWriteData(log, data, length);
 
     return ImpactLogWriteSeparator(log, last);
 }
 
 ImpactResult ImpactLogWriteKeyStringObject(ImpactLogger* log, const char* key, NSString* string, bool last) {
+    if (ImpactLogIsBinary(log)) {
+        // the binary encoding has no trouble with arbitrary bytes, so there's no need for base64
+        const char* utf8String = string.length > 0 ? string.UTF8String : NULL;
+        const size_t length = utf8String ? strlen(utf8String) : 0;
+
+        return ImpactLogBinaryAppendField(log, key, ImpactLogBinaryFieldStringObject, 0, (const uint8_t*)utf8String, length, last);
+    }
+
     if (string.length == 0) {
         return ImpactLogWriteKeyString(log, key, "<none>", last);
     }
 
-    NSString* encodedString = [[string dataUsingEncoding:NSUTF8StringEncoding] base64EncodedStringWithOptions:0];
+    ImpactLogWriteKey(log, key);
+
+    // Copying the UTF-8 out in pieces avoids allocating the whole thing, and encoding it. Pieces can end
+    // on any character, so leftover bytes are carried over to keep all but the last a multiple of three.
+    uint8_t buffer[768];
+    size_t pending = 0;
+    NSRange remaining = NSMakeRange(0, string.length);
+
+    while (remaining.length > 0) {
+        NSUInteger used = 0;
+
+        if (![string getBytes:buffer + pending maxLength:sizeof(buffer) - pending usedLength:&used encoding:NSUTF8StringEncoding options:0 range:remaining remainingRange:&remaining] || used == 0) {
+            break;
+        }
+
+        pending += used;
+
+        const size_t whole = pending - pending % 3;
+
+        ImpactLogWriteBase64Data(log, buffer, whole);
+
+        memmove(buffer, buffer + whole, pending - whole);
+        pending -= whole;
+    }
+
+    ImpactLogWriteBase64Data(log, buffer, pending);
 
-    return ImpactLogWriteKeyString(log, key, encodedString.UTF8String, last);
+    return ImpactLogWriteSeparator(log, last);
 }
 
 ImpactResult ImpactLogWriteKeyHexData(ImpactLogger* log, const char* key, const uint8_t* _Nullable data, size_t length, bool last) {
-    ImpactLogWriteString(log, key);
-    ImpactLogWriteString(log, ": ");
+    if (ImpactLogIsBinary(log)) {
+        return ImpactLogBinaryAppendField(log, key, ImpactLogBinaryFieldHexData, 0, data, data ? length : 0, last);
+    }
+
+    ImpactLogWriteKey(log, key);
     ImpactLogWriteHexData(log, data, length);
 
     return ImpactLogWriteSeparator(log, last);
 }
 
 ImpactResult ImpactLogWriteTime(ImpactLogger* log, const char* key, bool last) {
-    const uint64_t epochTimeMS = time(NULL) * 1000;
+    const uint64_t epochTimeMS = ImpactTimeGetEpochMilliseconds();
 
     return ImpactLogWriteKeyInteger(log, key, epochTimeMS, last);
 }
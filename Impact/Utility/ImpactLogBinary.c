@@ -0,0 +1,480 @@
+//
+//  ImpactLogBinary.c
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#include "ImpactLogBinary.h"
+#include "ImpactLog.h"
+#include "ImpactUtility.h"
+#include "ImpactEncoding.h"
+
+#include <string.h>
+#include <pthread.h>
+
+const uint8_t ImpactLogBinaryMagic[4] = { 'I', 'M', 'P', 'B' };
+
+// Index 0 is reserved for inline names. These indexes are part of the format, so entries may only be appended.
+// The most frequently written names come first, so they fit in a single byte.
+static const char* const ImpactLogBinaryNames[] = {
+    NULL,
+    "ip", "sp", "fp", "unwind", "Thread:Frame", "Thread:State", "Thread:Crashed", "pc", "lr", "path",
+    "address", "size", "uuid", "Binary:Found", "Exception:Frame", "Log", "message", "Application",
+    "Environment", "Signal", "MachException", "Exception", "Truncated", "Timing", "Unwind", "id", "org_id",
+    "version", "short_version", "platform", "arch", "report_id", "install_id", "os_build", "model",
+    "simulated_model", "os_version", "translated", "region", "pid", "ppid", "time", "impact_version",
+    "signal", "code", "errno", "number", "subcode", "type", "name", "section", "reason", "remaining",
+    "transition", "uninstall", "enumerate", "suspend", "unwind_max", "images", "resume", "flush", "flushes",
+    "total", "threads", "lookups", "lookup_misses", "cache_hits", "thread_state", "compact_unwind", "dwarf",
+    "frame_pointer", "frame_pointer_fallback", "frames", "rax", "rbx", "rcx", "rdx", "rdi", "rsi", "rbp",
+    "rsp", "r8", "r9", "r10", "r11", "r12", "r13", "r14", "r15", "rip", "rflags", "cs", "fs", "gs", "x0",
+    "x1", "x2", "x3", "x4", "x5", "x6", "x7", "x8", "x9", "x10", "x11", "x12", "x13", "x14", "x15", "x16",
+    "x17", "x18", "x19", "x20", "x21", "x22", "x23", "x24", "x25", "x26", "x27", "x28",
+    "image", "offset", "sp_delta", "index", "Binary:Summary", "count", "referenced", "hash",
+    "catalog", "Binary:Catalog", "Hang:Node", "parent", "leaf", "Allocation", "Allocation:Stack",
+    "Allocation:Frame", "stack", "bytes", "live_bytes", "Breadcrumbs", "Breadcrumb", "recorded", "thread",
+    "age", "category", "arg0", "arg1", "arg2", "arg3", "Watchdog", "crash_state", "complete",
+};
+
+enum {
+    ImpactLogBinaryNameCount = sizeof(ImpactLogBinaryNames) / sizeof(const char*),
+    ImpactLogBinaryNameTableSize = 512
+};
+
+_Static_assert(ImpactLogBinaryNameCount < ImpactLogBinaryNameTableSize / 2, "Name table must stay sparse");
+
+static uint16_t ImpactLogBinaryNameTable[ImpactLogBinaryNameTableSize];
+static pthread_once_t ImpactLogBinaryNamesOnce = PTHREAD_ONCE_INIT;
+
+static const uint32_t ImpactLogBinaryCRCTable[256] = {
+    0x00000000, 0x77073096, 0xee0e612c, 0x990951ba, 0x076dc419, 0x706af48f,
+    0xe963a535, 0x9e6495a3, 0x0edb8832, 0x79dcb8a4, 0xe0d5e91e, 0x97d2d988,
+    0x09b64c2b, 0x7eb17cbd, 0xe7b82d07, 0x90bf1d91, 0x1db71064, 0x6ab020f2,
+    0xf3b97148, 0x84be41de, 0x1adad47d, 0x6ddde4eb, 0xf4d4b551, 0x83d385c7,
+    0x136c9856, 0x646ba8c0, 0xfd62f97a, 0x8a65c9ec, 0x14015c4f, 0x63066cd9,
+    0xfa0f3d63, 0x8d080df5, 0x3b6e20c8, 0x4c69105e, 0xd56041e4, 0xa2677172,
+    0x3c03e4d1, 0x4b04d447, 0xd20d85fd, 0xa50ab56b, 0x35b5a8fa, 0x42b2986c,
+    0xdbbbc9d6, 0xacbcf940, 0x32d86ce3, 0x45df5c75, 0xdcd60dcf, 0xabd13d59,
+    0x26d930ac, 0x51de003a, 0xc8d75180, 0xbfd06116, 0x21b4f4b5, 0x56b3c423,
+    0xcfba9599, 0xb8bda50f, 0x2802b89e, 0x5f058808, 0xc60cd9b2, 0xb10be924,
+    0x2f6f7c87, 0x58684c11, 0xc1611dab, 0xb6662d3d, 0x76dc4190, 0x01db7106,
+    0x98d220bc, 0xefd5102a, 0x71b18589, 0x06b6b51f, 0x9fbfe4a5, 0xe8b8d433,
+    0x7807c9a2, 0x0f00f934, 0x9609a88e, 0xe10e9818, 0x7f6a0dbb, 0x086d3d2d,
+    0x91646c97, 0xe6635c01, 0x6b6b51f4, 0x1c6c6162, 0x856530d8, 0xf262004e,
+    0x6c0695ed, 0x1b01a57b, 0x8208f4c1, 0xf50fc457, 0x65b0d9c6, 0x12b7e950,
+    0x8bbeb8ea, 0xfcb9887c, 0x62dd1ddf, 0x15da2d49, 0x8cd37cf3, 0xfbd44c65,
+    0x4db26158, 0x3ab551ce, 0xa3bc0074, 0xd4bb30e2, 0x4adfa541, 0x3dd895d7,
+    0xa4d1c46d, 0xd3d6f4fb, 0x4369e96a, 0x346ed9fc, 0xad678846, 0xda60b8d0,
+    0x44042d73, 0x33031de5, 0xaa0a4c5f, 0xdd0d7cc9, 0x5005713c, 0x270241aa,
+    0xbe0b1010, 0xc90c2086, 0x5768b525, 0x206f85b3, 0xb966d409, 0xce61e49f,
+    0x5edef90e, 0x29d9c998, 0xb0d09822, 0xc7d7a8b4, 0x59b33d17, 0x2eb40d81,
+    0xb7bd5c3b, 0xc0ba6cad, 0xedb88320, 0x9abfb3b6, 0x03b6e20c, 0x74b1d29a,
+    0xead54739, 0x9dd277af, 0x04db2615, 0x73dc1683, 0xe3630b12, 0x94643b84,
+    0x0d6d6a3e, 0x7a6a5aa8, 0xe40ecf0b, 0x9309ff9d, 0x0a00ae27, 0x7d079eb1,
+    0xf00f9344, 0x8708a3d2, 0x1e01f268, 0x6906c2fe, 0xf762575d, 0x806567cb,
+    0x196c3671, 0x6e6b06e7, 0xfed41b76, 0x89d32be0, 0x10da7a5a, 0x67dd4acc,
+    0xf9b9df6f, 0x8ebeeff9, 0x17b7be43, 0x60b08ed5, 0xd6d6a3e8, 0xa1d1937e,
+    0x38d8c2c4, 0x4fdff252, 0xd1bb67f1, 0xa6bc5767, 0x3fb506dd, 0x48b2364b,
+    0xd80d2bda, 0xaf0a1b4c, 0x36034af6, 0x41047a60, 0xdf60efc3, 0xa867df55,
+    0x316e8eef, 0x4669be79, 0xcb61b38c, 0xbc66831a, 0x256fd2a0, 0x5268e236,
+    0xcc0c7795, 0xbb0b4703, 0x220216b9, 0x5505262f, 0xc5ba3bbe, 0xb2bd0b28,
+    0x2bb45a92, 0x5cb36a04, 0xc2d7ffa7, 0xb5d0cf31, 0x2cd99e8b, 0x5bdeae1d,
+    0x9b64c2b0, 0xec63f226, 0x756aa39c, 0x026d930a, 0x9c0906a9, 0xeb0e363f,
+    0x72076785, 0x05005713, 0x95bf4a82, 0xe2b87a14, 0x7bb12bae, 0x0cb61b38,
+    0x92d28e9b, 0xe5d5be0d, 0x7cdcefb7, 0x0bdbdf21, 0x86d3d2d4, 0xf1d4e242,
+    0x68ddb3f8, 0x1fda836e, 0x81be16cd, 0xf6b9265b, 0x6fb077e1, 0x18b74777,
+    0x88085ae6, 0xff0f6a70, 0x66063bca, 0x11010b5c, 0x8f659eff, 0xf862ae69,
+    0x616bffd3, 0x166ccf45, 0xa00ae278, 0xd70dd2ee, 0x4e048354, 0x3903b3c2,
+    0xa7672661, 0xd06016f7, 0x4969474d, 0x3e6e77db, 0xaed16a4a, 0xd9d65adc,
+    0x40df0b66, 0x37d83bf0, 0xa9bcae53, 0xdebb9ec5, 0x47b2cf7f, 0x30b5ffe9,
+    0xbdbdf21c, 0xcabac28a, 0x53b39330, 0x24b4a3a6, 0xbad03605, 0xcdd70693,
+    0x54de5729, 0x23d967bf, 0xb3667a2e, 0xc4614ab8, 0x5d681b02, 0x2a6f2b94,
+    0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d,
+};
+
+size_t ImpactLogBinaryEncodeVarint(uint8_t* buffer, uint64_t value) {
+    size_t length = 0;
+
+    while (value >= 0x80) {
+        buffer[length] = (uint8_t)(value | 0x80);
+        value >>= 7;
+        length += 1;
+    }
+
+    buffer[length] = (uint8_t)value;
+
+    return length + 1;
+}
+
+ImpactResult ImpactLogBinaryDecodeVarint(const uint8_t** ptr, const uint8_t* end, uint64_t* value) {
+    uint64_t result = 0;
+
+    for (uint32_t shift = 0; shift < 64; shift += 7) {
+        if (*ptr >= end) {
+            return ImpactResultEndOfData;
+        }
+
+        const uint8_t byte = **ptr;
+
+        *ptr += 1;
+        result |= (uint64_t)(byte & 0x7F) << shift;
+
+        if ((byte & 0x80) == 0) {
+            *value = result;
+            return ImpactResultSuccess;
+        }
+    }
+
+    return ImpactResultInconsistentData;
+}
+
+uint32_t ImpactLogBinaryCRC32(uint32_t crc, const uint8_t* data, size_t length) {
+    crc = ~crc;
+
+    for (size_t i = 0; i < length; ++i) {
+        crc = ImpactLogBinaryCRCTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+
+    return ~crc;
+}
+
+static uint32_t ImpactLogBinaryHashName(const char* name) {
+    uint32_t hash = 2166136261u;
+
+    for (; *name != 0; ++name) {
+        hash = (hash ^ (uint8_t)*name) * 16777619u;
+    }
+
+    return hash;
+}
+
+static void ImpactLogBinaryBuildNameTable(void) {
+    for (uint32_t i = 1; i < ImpactLogBinaryNameCount; ++i) {
+        uint32_t slot = ImpactLogBinaryHashName(ImpactLogBinaryNames[i]) % ImpactLogBinaryNameTableSize;
+
+        while (ImpactLogBinaryNameTable[slot] != 0) {
+            slot = (slot + 1) % ImpactLogBinaryNameTableSize;
+        }
+
+        ImpactLogBinaryNameTable[slot] = i;
+    }
+}
+
+void ImpactLogBinaryInitializeNames(void) {
+    pthread_once(&ImpactLogBinaryNamesOnce, ImpactLogBinaryBuildNameTable);
+}
+
+uint32_t ImpactLogBinaryLookupName(const char* name) {
+    if (ImpactInvalidPtr(name)) {
+        return 0;
+    }
+
+    uint32_t slot = ImpactLogBinaryHashName(name) % ImpactLogBinaryNameTableSize;
+
+    // the table is never full, so this always terminates
+    while (ImpactLogBinaryNameTable[slot] != 0) {
+        const uint16_t index = ImpactLogBinaryNameTable[slot];
+
+        if (strcmp(ImpactLogBinaryNames[index], name) == 0) {
+            return index;
+        }
+
+        slot = (slot + 1) % ImpactLogBinaryNameTableSize;
+    }
+
+    return 0;
+}
+
+const char* ImpactLogBinaryGetName(uint32_t index) {
+    if (index == 0 || index >= ImpactLogBinaryNameCount) {
+        return NULL;
+    }
+
+    return ImpactLogBinaryNames[index];
+}
+
+#pragma mark - Decoding
+
+enum { ImpactLogBinaryMaxNameLength = 128 };
+
+typedef struct {
+    const uint8_t* key;
+    size_t keyLength;
+    uint32_t type;
+    uint64_t integer;
+    const uint8_t* data;
+    size_t length;
+} ImpactLogBinaryField;
+
+typedef struct {
+    ImpactLogger* output;
+    bool recordOpen;
+    bool isLogRecord;
+    bool hasPendingField;
+    ImpactLogBinaryField pendingField;
+} ImpactLogBinaryDecoder;
+
+static ImpactResult ImpactLogBinaryDecodeName(const uint8_t** ptr, const uint8_t* end, const uint8_t** name, size_t* length) {
+    uint64_t index = 0;
+
+    ImpactResult result = ImpactLogBinaryDecodeVarint(ptr, end, &index);
+    if (result != ImpactResultSuccess) {
+        return result;
+    }
+
+    if (index != 0) {
+        const char* internedName = ImpactLogBinaryGetName((uint32_t)index);
+        if (internedName == NULL) {
+            return ImpactResultUnexpectedData;
+        }
+
+        *name = (const uint8_t*)internedName;
+        *length = strlen(internedName);
+
+        return ImpactResultSuccess;
+    }
+
+    uint64_t nameLength = 0;
+
+    result = ImpactLogBinaryDecodeVarint(ptr, end, &nameLength);
+    if (result != ImpactResultSuccess) {
+        return result;
+    }
+
+    if (nameLength >= ImpactLogBinaryMaxNameLength || nameLength > (uint64_t)(end - *ptr)) {
+        return ImpactResultInconsistentData;
+    }
+
+    *name = *ptr;
+    *length = nameLength;
+    *ptr += nameLength;
+
+    return ImpactResultSuccess;
+}
+
+static ImpactResult ImpactLogBinaryWriteField(ImpactLogBinaryDecoder* decoder, const ImpactLogBinaryField* field, bool last) {
+    ImpactLogger* log = decoder->output;
+
+    if (decoder->isLogRecord) {
+        // diagnostic messages are written verbatim, just as the text encoding does
+        return ImpactLogWriteData(log, (const char*)field->data, field->length);
+    }
+
+    char key[ImpactLogBinaryMaxNameLength];
+
+    memcpy(key, field->key, field->keyLength);
+    key[field->keyLength] = 0;
+
+    switch (field->type) {
+        case ImpactLogBinaryFieldUnsigned:
+            return ImpactLogWriteKeyInteger(log, key, (uintptr_t)field->integer, last);
+        case ImpactLogBinaryFieldSigned:
+            return ImpactLogWriteKeySignedInteger(log, key, (intptr_t)ImpactLogBinaryZigZagDecode(field->integer), last);
+        case ImpactLogBinaryFieldString:
+            return ImpactLogWriteKeyData(log, key, (const char*)field->data, field->length, last);
+        case ImpactLogBinaryFieldHexData:
+            return ImpactLogWriteKeyHexData(log, key, field->data, field->length, last);
+        case ImpactLogBinaryFieldStringObject: {
+            if (field->length == 0) {
+                return ImpactLogWriteKeyString(log, key, "<none>", last);
+            }
+
+            if (field->length > ImpactLogRecordBufferSize) {
+                return ImpactResultInconsistentData;
+            }
+
+            char encoded[(ImpactLogRecordBufferSize + 2) / 3 * 4];
+
+            const size_t length = ImpactEncodingBase64(field->data, field->length, encoded);
+
+            return ImpactLogWriteKeyData(log, key, encoded, length, last);
+        }
+        default:
+            break;
+    }
+
+    return ImpactResultUnexpectedData;
+}
+
+static ImpactResult ImpactLogBinaryFinishRecord(ImpactLogBinaryDecoder* decoder) {
+    ImpactResult result = ImpactResultSuccess;
+
+    if (decoder->hasPendingField) {
+        result = ImpactLogBinaryWriteField(decoder, &decoder->pendingField, true);
+    } else if (decoder->isLogRecord == false) {
+        result = ImpactLogEndRecord(decoder->output);
+    }
+
+    decoder->recordOpen = false;
+    decoder->hasPendingField = false;
+
+    return result;
+}
+
+static ImpactResult ImpactLogBinaryDecodePayload(ImpactLogBinaryDecoder* decoder, const uint8_t* ptr, const uint8_t* end, uint8_t flags) {
+    ImpactResult result;
+
+    if ((flags & ImpactLogBinaryRecordFlagContinuation) == 0) {
+        if (decoder->recordOpen) {
+            return ImpactResultInconsistentData;
+        }
+
+        const uint8_t* name = NULL;
+        size_t nameLength = 0;
+
+        result = ImpactLogBinaryDecodeName(&ptr, end, &name, &nameLength);
+        if (result != ImpactResultSuccess) {
+            return result;
+        }
+
+        char recordName[ImpactLogBinaryMaxNameLength];
+
+        memcpy(recordName, name, nameLength);
+        recordName[nameLength] = 0;
+
+        decoder->recordOpen = true;
+        decoder->isLogRecord = strcmp(recordName, "Log") == 0;
+
+        if (decoder->isLogRecord == false) {
+            ImpactLogBeginRecord(decoder->output, recordName);
+        }
+    } else if (decoder->recordOpen == false) {
+        return ImpactResultInconsistentData;
+    }
+
+    // Fields are written one behind, because the text encoding needs to know which is last.
+    while (ptr < end) {
+        uint64_t header = 0;
+
+        result = ImpactLogBinaryDecodeVarint(&ptr, end, &header);
+        if (result != ImpactResultSuccess) {
+            return result;
+        }
+
+        ImpactLogBinaryField field = {0};
+
+        field.type = header & ((1 << ImpactLogBinaryFieldTypeBits) - 1);
+
+        const uint64_t keyIndex = header >> ImpactLogBinaryFieldTypeBits;
+
+        if (keyIndex == 0) {
+            uint64_t keyLength = 0;
+
+            result = ImpactLogBinaryDecodeVarint(&ptr, end, &keyLength);
+            if (result != ImpactResultSuccess) {
+                return result;
+            }
+
+            if (keyLength >= ImpactLogBinaryMaxNameLength || keyLength > (uint64_t)(end - ptr)) {
+                return ImpactResultInconsistentData;
+            }
+
+            field.key = ptr;
+            field.keyLength = keyLength;
+            ptr += keyLength;
+        } else {
+            const char* key = ImpactLogBinaryGetName((uint32_t)keyIndex);
+            if (key == NULL) {
+                return ImpactResultUnexpectedData;
+            }
+
+            field.key = (const uint8_t*)key;
+            field.keyLength = strlen(key);
+        }
+
+        result = ImpactLogBinaryDecodeVarint(&ptr, end, &field.integer);
+        if (result != ImpactResultSuccess) {
+            return result;
+        }
+
+        if (field.type != ImpactLogBinaryFieldUnsigned && field.type != ImpactLogBinaryFieldSigned) {
+            if (field.integer > (uint64_t)(end - ptr)) {
+                return ImpactResultInconsistentData;
+            }
+
+            field.data = ptr;
+            field.length = (size_t)field.integer;
+            ptr += field.length;
+        }
+
+        if (decoder->hasPendingField) {
+            result = ImpactLogBinaryWriteField(decoder, &decoder->pendingField, false);
+            if (result != ImpactResultSuccess) {
+                return result;
+            }
+        }
+
+        decoder->pendingField = field;
+        decoder->hasPendingField = true;
+    }
+
+    if (flags & ImpactLogBinaryRecordFlagMore) {
+        return ImpactResultSuccess;
+    }
+
+    return ImpactLogBinaryFinishRecord(decoder);
+}
+
+ImpactResult ImpactLogBinaryDecode(const uint8_t* data, size_t length, ImpactLogger* output) {
+    if (ImpactInvalidPtr(data) || ImpactInvalidPtr(output)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    if (length < ImpactLogBinaryHeaderSize || memcmp(data, ImpactLogBinaryMagic, sizeof(ImpactLogBinaryMagic)) != 0) {
+        return ImpactResultUnexpectedData;
+    }
+
+    if (data[4] != ImpactLogBinaryVersion) {
+        return ImpactResultUnimplemented;
+    }
+
+    const uint8_t* ptr = data + ImpactLogBinaryHeaderSize;
+    const uint8_t* end = data + length;
+
+    ImpactLogBinaryDecoder decoder = {
+        .output = output
+    };
+
+    while (ptr < end) {
+        const uint8_t* recordStart = ptr;
+        const uint8_t kind = *ptr;
+
+        if ((kind & ~ImpactLogBinaryRecordFlagMask) != ImpactLogBinaryRecordKind) {
+            return ImpactResultUnexpectedData;
+        }
+
+        ptr += 1;
+
+        uint64_t payloadLength = 0;
+
+        ImpactResult result = ImpactLogBinaryDecodeVarint(&ptr, end, &payloadLength);
+        if (result != ImpactResultSuccess) {
+            // a torn write, most likely from the process being killed mid-record
+            return ImpactResultEndOfData;
+        }
+
+        if (payloadLength + ImpactLogBinaryTrailerSize > (uint64_t)(end - ptr)) {
+            return ImpactResultEndOfData;
+        }
+
+        const uint8_t* payload = ptr;
+        const uint8_t* trailer = payload + payloadLength;
+
+        const uint32_t expectedCRC = (uint32_t)trailer[0] | (uint32_t)trailer[1] << 8 | (uint32_t)trailer[2] << 16 | (uint32_t)trailer[3] << 24;
+        const uint32_t crc = ImpactLogBinaryCRC32(0, recordStart, trailer - recordStart);
+
+        if (crc != expectedCRC) {
+            return ImpactResultInconsistentData;
+        }
+
+        result = ImpactLogBinaryDecodePayload(&decoder, payload, trailer, kind & ImpactLogBinaryRecordFlagMask);
+        if (result != ImpactResultSuccess) {
+            return result;
+        }
+
+        ptr = trailer + ImpactLogBinaryTrailerSize;
+    }
+
+    return decoder.recordOpen ? ImpactResultEndOfData : ImpactResultSuccess;
+}
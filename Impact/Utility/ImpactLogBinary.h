@@ -0,0 +1,83 @@
+//
+//  ImpactLogBinary.h
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#ifndef ImpactLogBinary_h
+#define ImpactLogBinary_h
+
+#include "ImpactResult.h"
+#include "ImpactState.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+// File layout: magic, version byte, then a sequence of records.
+//
+// record:  kind (1 byte), payload length (varint), payload, CRC32 of kind + length + payload (4 bytes, little-endian)
+// payload: name (only on the first fragment), fields...
+// name:    varint interned index, or 0 followed by a varint length and the bytes
+// field:   varint (key index << 3 | type), inline key if the index is 0, value
+//
+// Integers are varints, with signed values zigzag-encoded. All other values are a varint length followed by bytes.
+
+_Pragma("clang assume_nonnull begin")
+__BEGIN_DECLS
+
+enum {
+    ImpactLogBinaryVersion = 1,
+    ImpactLogBinaryHeaderSize = 5,
+    ImpactLogBinaryMaxVarintSize = 10,
+    ImpactLogBinaryTrailerSize = 4
+};
+
+extern const uint8_t ImpactLogBinaryMagic[4];
+
+typedef enum {
+    ImpactLogBinaryRecordKind = 0xA0,
+
+    // the record is continued by the next one
+    ImpactLogBinaryRecordFlagMore = 1 << 0,
+    // the record continues the previous one, and has no name
+    ImpactLogBinaryRecordFlagContinuation = 1 << 1,
+
+    ImpactLogBinaryRecordFlagMask = 0x0F
+} ImpactLogBinaryRecord;
+
+typedef enum {
+    ImpactLogBinaryFieldUnsigned = 0,
+    ImpactLogBinaryFieldSigned = 1,
+    ImpactLogBinaryFieldString = 2,
+    ImpactLogBinaryFieldHexData = 3,
+    ImpactLogBinaryFieldStringObject = 4,
+
+    ImpactLogBinaryFieldTypeBits = 3
+} ImpactLogBinaryFieldType;
+
+size_t ImpactLogBinaryEncodeVarint(uint8_t* buffer, uint64_t value);
+ImpactResult ImpactLogBinaryDecodeVarint(const uint8_t* _Nonnull * _Nonnull ptr, const uint8_t* end, uint64_t* value);
+
+static inline uint64_t ImpactLogBinaryZigZagEncode(int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static inline int64_t ImpactLogBinaryZigZagDecode(uint64_t value) {
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+uint32_t ImpactLogBinaryCRC32(uint32_t crc, const uint8_t* data, size_t length);
+
+// Builds the name lookup table. Not async-signal-safe, so this must be called ahead of time.
+void ImpactLogBinaryInitializeNames(void);
+uint32_t ImpactLogBinaryLookupName(const char* name);
+const char* _Nullable ImpactLogBinaryGetName(uint32_t index);
+
+// Replays a binary report into a logger, producing the same output the text encoding would have.
+ImpactResult ImpactLogBinaryDecode(const uint8_t* data, size_t length, ImpactLogger* output);
+
+__END_DECLS
+_Pragma("clang assume_nonnull end")
+
+#endif /* ImpactLogBinary_h */
@@ -0,0 +1,373 @@
+//
+//  ImpactLogCompression.c
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#include "ImpactLogCompression.h"
+#include "ImpactLogBinary.h"
+#include "ImpactUtility.h"
+
+#include <string.h>
+
+const uint8_t ImpactLogCompressionMagic[4] = { 'I', 'M', 'P', 'Z' };
+
+enum {
+    ImpactLogCompressionMinMatch = 4,
+    ImpactLogCompressionMaxOffset = 0xFFFF,
+    ImpactLogCompressionTokenMask = 0x0F
+};
+
+void ImpactLogCompressorReset(ImpactLogCompressor* compressor) {
+    if (ImpactInvalidPtr(compressor)) {
+        return;
+    }
+
+    compressor->historyCount = 0;
+    memset(compressor->table, 0, sizeof(compressor->table));
+}
+
+static uint32_t ImpactLogCompressionRead32(const uint8_t* ptr) {
+    uint32_t value;
+
+    memcpy(&value, ptr, sizeof(uint32_t));
+
+    return value;
+}
+
+static uint32_t ImpactLogCompressionHash(uint32_t value) {
+    return (value * 2654435761u) >> (32 - ImpactLogCompressionHashBits);
+}
+
+// Keeps the most recent window of history, and moves the table along with it.
+static void ImpactLogCompressorSlide(ImpactLogCompressor* compressor) {
+    const uint32_t delta = compressor->historyCount - ImpactLogCompressionWindowSize;
+
+    memmove(compressor->history, compressor->history + delta, ImpactLogCompressionWindowSize);
+    compressor->historyCount = ImpactLogCompressionWindowSize;
+
+    for (uint32_t i = 0; i < (1 << ImpactLogCompressionHashBits); ++i) {
+        const uint32_t entry = compressor->table[i];
+
+        compressor->table[i] = entry > delta ? entry - delta : 0;
+    }
+}
+
+static uint8_t* ImpactLogCompressionEncodeLength(uint8_t* ptr, size_t length) {
+    for (; length >= 255; length -= 255) {
+        *ptr++ = 255;
+    }
+
+    *ptr++ = (uint8_t)length;
+
+    return ptr;
+}
+
+static uint8_t* ImpactLogCompressionEncodeSequence(uint8_t* ptr, const uint8_t* literals, size_t literalLength, uint32_t offset, size_t matchLength) {
+    const size_t matchExtra = matchLength > 0 ? matchLength - ImpactLogCompressionMinMatch : 0;
+    uint8_t* token = ptr++;
+
+    *token = (uint8_t)((literalLength < 15 ? literalLength : 15) << 4);
+
+    if (literalLength >= 15) {
+        ptr = ImpactLogCompressionEncodeLength(ptr, literalLength - 15);
+    }
+
+    memcpy(ptr, literals, literalLength);
+    ptr += literalLength;
+
+    if (matchLength == 0) {
+        return ptr;
+    }
+
+    *token |= (uint8_t)(matchExtra < 15 ? matchExtra : 15);
+
+    *ptr++ = offset & 0xFF;
+    *ptr++ = (offset >> 8) & 0xFF;
+
+    if (matchExtra >= 15) {
+        ptr = ImpactLogCompressionEncodeLength(ptr, matchExtra - 15);
+    }
+
+    return ptr;
+}
+
+static size_t ImpactLogCompressorCompress(ImpactLogCompressor* compressor, uint32_t start, uint32_t end, uint8_t* output) {
+    const uint8_t* history = compressor->history;
+    uint8_t* ptr = output;
+    uint32_t anchor = start;
+    uint32_t position = start;
+
+    while (position + ImpactLogCompressionMinMatch <= end) {
+        const uint32_t value = ImpactLogCompressionRead32(history + position);
+        const uint32_t hash = ImpactLogCompressionHash(value);
+        const uint32_t entry = compressor->table[hash];
+
+        compressor->table[hash] = position + 1;
+
+        // entries can be stale or collide, so the bytes themselves always have to be checked
+        if (entry == 0 || position - (entry - 1) > ImpactLogCompressionMaxOffset || ImpactLogCompressionRead32(history + entry - 1) != value) {
+            position += 1;
+            continue;
+        }
+
+        const uint32_t candidate = entry - 1;
+        uint32_t matchLength = ImpactLogCompressionMinMatch;
+
+        while (position + matchLength < end && history[candidate + matchLength] == history[position + matchLength]) {
+            matchLength += 1;
+        }
+
+        ptr = ImpactLogCompressionEncodeSequence(ptr, history + anchor, position - anchor, position - candidate, matchLength);
+
+        position += matchLength;
+        anchor = position;
+    }
+
+    ptr = ImpactLogCompressionEncodeSequence(ptr, history + anchor, end - anchor, 0, 0);
+
+    return ptr - output;
+}
+
+ImpactResult ImpactLogCompressorEncodeBlock(ImpactLogCompressor* compressor, const uint8_t* data, size_t length, size_t* outputLength) {
+    if (ImpactInvalidPtr(compressor) || ImpactInvalidPtr(data) || ImpactInvalidPtr(outputLength)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    if (length > ImpactLogCompressionMaxBlockSize) {
+        return ImpactResultArgumentInvalid;
+    }
+
+    if (compressor->historyCount + length > sizeof(compressor->history)) {
+        ImpactLogCompressorSlide(compressor);
+    }
+
+    const uint32_t start = compressor->historyCount;
+
+    memcpy(compressor->history + start, data, length);
+    compressor->historyCount += (uint32_t)length;
+
+    // The compressed length isn't known until the end, so the payload is written after the largest
+    // possible header, and the header is then placed right in front of it.
+    uint8_t* payload = compressor->output + ImpactLogBinaryMaxVarintSize * 2;
+    const size_t payloadLength = ImpactLogCompressorCompress(compressor, start, compressor->historyCount, payload);
+
+    uint8_t header[ImpactLogBinaryMaxVarintSize * 2];
+    size_t headerLength = ImpactLogBinaryEncodeVarint(header, length);
+
+    headerLength += ImpactLogBinaryEncodeVarint(header + headerLength, payloadLength);
+
+    uint8_t* block = payload - headerLength;
+
+    memcpy(block, header, headerLength);
+
+    const uint32_t crc = ImpactLogBinaryCRC32(0, data, length);
+    uint8_t* trailer = payload + payloadLength;
+
+    trailer[0] = crc & 0xFF;
+    trailer[1] = (crc >> 8) & 0xFF;
+    trailer[2] = (crc >> 16) & 0xFF;
+    trailer[3] = (crc >> 24) & 0xFF;
+
+    // callers find the block at the start of the output buffer
+    *outputLength = headerLength + payloadLength + ImpactLogBinaryTrailerSize;
+    memmove(compressor->output, block, *outputLength);
+
+    return ImpactResultSuccess;
+}
+
+#pragma mark - Decoding
+
+bool ImpactLogCompressionIsCompressed(const uint8_t* data, size_t length) {
+    if (ImpactInvalidPtr(data)) {
+        return false;
+    }
+
+    return length >= ImpactLogCompressionHeaderSize && memcmp(data, ImpactLogCompressionMagic, sizeof(ImpactLogCompressionMagic)) == 0;
+}
+
+static ImpactResult ImpactLogCompressionCheckHeader(const uint8_t* data, size_t length) {
+    if (!ImpactLogCompressionIsCompressed(data, length)) {
+        return ImpactResultUnexpectedData;
+    }
+
+    if (data[4] != ImpactLogCompressionVersion) {
+        return ImpactResultUnimplemented;
+    }
+
+    return ImpactResultSuccess;
+}
+
+// Finds the bounds of the next block, returning ImpactResultEndOfData when it is incomplete.
+static ImpactResult ImpactLogCompressionReadBlock(const uint8_t** ptr, const uint8_t* end, uint64_t* rawLength, uint64_t* payloadLength) {
+    if (ImpactLogBinaryDecodeVarint(ptr, end, rawLength) != ImpactResultSuccess) {
+        return ImpactResultEndOfData;
+    }
+
+    if (ImpactLogBinaryDecodeVarint(ptr, end, payloadLength) != ImpactResultSuccess) {
+        return ImpactResultEndOfData;
+    }
+
+    if (*payloadLength + ImpactLogBinaryTrailerSize > (uint64_t)(end - *ptr)) {
+        return ImpactResultEndOfData;
+    }
+
+    if (*rawLength > ImpactLogCompressionMaxBlockSize) {
+        return ImpactResultInconsistentData;
+    }
+
+    return ImpactResultSuccess;
+}
+
+ImpactResult ImpactLogCompressionGetDecodedLength(const uint8_t* data, size_t length, size_t* decodedLength) {
+    if (ImpactInvalidPtr(data) || ImpactInvalidPtr(decodedLength)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    *decodedLength = 0;
+
+    ImpactResult result = ImpactLogCompressionCheckHeader(data, length);
+    if (result != ImpactResultSuccess) {
+        return result;
+    }
+
+    const uint8_t* ptr = data + ImpactLogCompressionHeaderSize;
+    const uint8_t* end = data + length;
+
+    while (ptr < end) {
+        uint64_t rawLength = 0;
+        uint64_t payloadLength = 0;
+
+        result = ImpactLogCompressionReadBlock(&ptr, end, &rawLength, &payloadLength);
+        if (result != ImpactResultSuccess) {
+            return result;
+        }
+
+        *decodedLength += (size_t)rawLength;
+        ptr += payloadLength + ImpactLogBinaryTrailerSize;
+    }
+
+    return ImpactResultSuccess;
+}
+
+static ImpactResult ImpactLogCompressionDecodeLength(const uint8_t** ptr, const uint8_t* end, size_t* length) {
+    for (;;) {
+        if (*ptr >= end) {
+            return ImpactResultInconsistentData;
+        }
+
+        const uint8_t byte = **ptr;
+
+        *ptr += 1;
+        *length += byte;
+
+        if (byte != 255) {
+            return ImpactResultSuccess;
+        }
+    }
+}
+
+static ImpactResult ImpactLogCompressionDecodeBlock(const uint8_t* ptr, const uint8_t* end, uint8_t* output, size_t position, size_t blockEnd) {
+    // the final sequence is always literals only, even if there are no literals left
+    for (;;) {
+        if (ptr >= end) {
+            return ImpactResultInconsistentData;
+        }
+
+        const uint8_t token = *ptr++;
+        size_t literalLength = token >> 4;
+
+        if (literalLength == 15 && ImpactLogCompressionDecodeLength(&ptr, end, &literalLength) != ImpactResultSuccess) {
+            return ImpactResultInconsistentData;
+        }
+
+        if (literalLength > (size_t)(end - ptr) || literalLength > blockEnd - position) {
+            return ImpactResultInconsistentData;
+        }
+
+        memcpy(output + position, ptr, literalLength);
+        ptr += literalLength;
+        position += literalLength;
+
+        if (position == blockEnd) {
+            break;
+        }
+
+        if (end - ptr < 2) {
+            return ImpactResultInconsistentData;
+        }
+
+        const size_t offset = ptr[0] | (size_t)ptr[1] << 8;
+        size_t matchLength = token & ImpactLogCompressionTokenMask;
+
+        ptr += 2;
+
+        if (matchLength == 15 && ImpactLogCompressionDecodeLength(&ptr, end, &matchLength) != ImpactResultSuccess) {
+            return ImpactResultInconsistentData;
+        }
+
+        matchLength += ImpactLogCompressionMinMatch;
+
+        if (offset == 0 || offset > position || matchLength > blockEnd - position) {
+            return ImpactResultInconsistentData;
+        }
+
+        // matches may overlap the bytes they produce, so this has to go one at a time
+        for (size_t i = 0; i < matchLength; ++i) {
+            output[position + i] = output[position - offset + i];
+        }
+
+        position += matchLength;
+    }
+
+    return ptr == end ? ImpactResultSuccess : ImpactResultInconsistentData;
+}
+
+ImpactResult ImpactLogCompressionDecode(const uint8_t* data, size_t length, uint8_t* output, size_t capacity, size_t* outputLength) {
+    if (ImpactInvalidPtr(data) || ImpactInvalidPtr(output) || ImpactInvalidPtr(outputLength)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    *outputLength = 0;
+
+    ImpactResult result = ImpactLogCompressionCheckHeader(data, length);
+    if (result != ImpactResultSuccess) {
+        return result;
+    }
+
+    const uint8_t* ptr = data + ImpactLogCompressionHeaderSize;
+    const uint8_t* end = data + length;
+
+    while (ptr < end) {
+        uint64_t rawLength = 0;
+        uint64_t payloadLength = 0;
+
+        result = ImpactLogCompressionReadBlock(&ptr, end, &rawLength, &payloadLength);
+        if (result != ImpactResultSuccess) {
+            return result;
+        }
+
+        if (rawLength > capacity - *outputLength) {
+            return ImpactResultArgumentInvalid;
+        }
+
+        const uint8_t* payloadEnd = ptr + payloadLength;
+
+        result = ImpactLogCompressionDecodeBlock(ptr, payloadEnd, output, *outputLength, *outputLength + (size_t)rawLength);
+        if (result != ImpactResultSuccess) {
+            return result;
+        }
+
+        const uint32_t crc = payloadEnd[0] | (uint32_t)payloadEnd[1] << 8 | (uint32_t)payloadEnd[2] << 16 | (uint32_t)payloadEnd[3] << 24;
+
+        if (ImpactLogBinaryCRC32(0, output + *outputLength, (size_t)rawLength) != crc) {
+            return ImpactResultInconsistentData;
+        }
+
+        *outputLength += (size_t)rawLength;
+        ptr = payloadEnd + ImpactLogBinaryTrailerSize;
+    }
+
+    return ImpactResultSuccess;
+}
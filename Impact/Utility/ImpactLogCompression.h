@@ -0,0 +1,68 @@
+//
+//  ImpactLogCompression.h
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#ifndef ImpactLogCompression_h
+#define ImpactLogCompression_h
+
+#include "ImpactResult.h"
+#include "ImpactState.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+// File layout: magic, version byte, then a sequence of blocks, one per flush.
+//
+// block:    raw length (varint), compressed length (varint), compressed bytes, CRC32 of the raw bytes (4 bytes, little-endian)
+// sequence: token (literal length << 4 | match length - 4), literal length extension, literals, match offset (2 bytes,
+//           little-endian), match length extension
+//
+// Lengths of 15 in the token continue in following bytes, each adding up to 255. A block ends with a
+// sequence that has only literals. Matches can reach back into earlier blocks, up to the window size,
+// which is why blocks are only decodable in order. But, a torn block never affects the ones before it.
+
+_Pragma("clang assume_nonnull begin")
+__BEGIN_DECLS
+
+enum {
+    ImpactLogCompressionVersion = 1,
+    ImpactLogCompressionHeaderSize = 5,
+    ImpactLogCompressionWindowSize = 64 * 1024,
+    ImpactLogCompressionHashBits = 13,
+    ImpactLogCompressionMaxBlockSize = 4096,
+    ImpactLogCompressionMaxBlockOverhead = 48
+};
+
+extern const uint8_t ImpactLogCompressionMagic[4];
+
+// All of the compressor's memory is allocated up front, so compressing needs no allocation and only a
+// small, fixed amount of stack.
+struct ImpactLogCompressor {
+    uint32_t historyCount;
+    uint8_t history[ImpactLogCompressionWindowSize * 2];
+    // positions in history, plus one so that zero means empty
+    uint32_t table[1 << ImpactLogCompressionHashBits];
+    uint8_t output[ImpactLogCompressionMaxBlockSize + ImpactLogCompressionMaxBlockSize / 255 + ImpactLogCompressionMaxBlockOverhead];
+};
+
+void ImpactLogCompressorReset(ImpactLogCompressor* compressor);
+
+// Compresses one block into the compressor's output buffer, including the framing. Async-signal-safe.
+ImpactResult ImpactLogCompressorEncodeBlock(ImpactLogCompressor* compressor, const uint8_t* data, size_t length, size_t* outputLength);
+
+bool ImpactLogCompressionIsCompressed(const uint8_t* data, size_t length);
+
+// The total size of every complete block, for sizing the buffer passed to decode.
+ImpactResult ImpactLogCompressionGetDecodedLength(const uint8_t* data, size_t length, size_t* decodedLength);
+
+// Decodes as many blocks as possible. A torn final block returns ImpactResultEndOfData, with everything
+// before it still decoded.
+ImpactResult ImpactLogCompressionDecode(const uint8_t* data, size_t length, uint8_t* output, size_t capacity, size_t* outputLength);
+
+__END_DECLS
+_Pragma("clang assume_nonnull end")
+
+#endif /* ImpactLogCompression_h */
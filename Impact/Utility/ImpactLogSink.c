@@ -0,0 +1,464 @@
+//
+//  ImpactLogSink.c
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#include "ImpactLogSink.h"
+#include "ImpactLog.h"
+#include "ImpactLogCompression.h"
+#include "ImpactUtility.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static void ImpactLogSinkReset(ImpactLogger* log) {
+    log->sink = NULL;
+    log->fd = -1;
+    log->bufferCount = 0;
+
+    memset(&log->mapping, 0, sizeof(ImpactLogMapping));
+    memset(&log->ring, 0, sizeof(ImpactLogRing));
+    log->compressor = NULL;
+}
+
+static ImpactResult ImpactLogSinkWriteFully(int fd, const char* data, size_t length, off_t offset, bool positioned) {
+    while (length > 0) {
+        const ssize_t count = positioned ? pwrite(fd, data, length, offset) : write(fd, data, length);
+
+        if (count == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            return ImpactResultCallFailed;
+        }
+
+        // this accounts for a partial write
+        length -= count;
+        data += count;
+        offset += count;
+    }
+
+    return ImpactResultSuccess;
+}
+
+#pragma mark - Descriptor
+
+static char* ImpactLogDescriptorReserve(ImpactLogger* log, size_t* length) {
+    const size_t available = ImpactLogBufferSize - log->bufferCount;
+
+    if (available == 0) {
+        return NULL;
+    }
+
+    if (*length > available) {
+        *length = available;
+    }
+
+    return log->buffer + log->bufferCount;
+}
+
+static ImpactResult ImpactLogDescriptorCommit(ImpactLogger* log, size_t length) {
+    log->bufferCount += length;
+
+    return ImpactResultSuccess;
+}
+
+static ImpactResult ImpactLogDescriptorFlush(ImpactLogger* log) {
+    const ImpactResult result = ImpactLogSinkWriteFully(log->fd, log->buffer, log->bufferCount, 0, false);
+    if (result != ImpactResultSuccess) {
+        return result;
+    }
+
+    log->bufferCount = 0;
+
+    return ImpactResultSuccess;
+}
+
+static ImpactResult ImpactLogDescriptorWriteAhead(ImpactLogger* log, const char* data, size_t length) {
+    // with nothing buffered, the message can just ride along with the next flush
+    if (log->bufferCount == 0) {
+        return ImpactLogWriteData(log, data, length);
+    }
+
+    return ImpactLogSinkWriteFully(log->fd, data, length, 0, false);
+}
+
+static void ImpactLogDescriptorClose(ImpactLogger* log) {
+    close(log->fd);
+}
+
+static const ImpactLogSink ImpactLogDescriptorSink = {
+    .reserve = ImpactLogDescriptorReserve,
+    .commit = ImpactLogDescriptorCommit,
+    .flush = ImpactLogDescriptorFlush,
+    .writeAhead = ImpactLogDescriptorWriteAhead,
+    .close = ImpactLogDescriptorClose
+};
+
+ImpactResult ImpactLogSinkOpenDescriptor(ImpactLogger* log, int fd) {
+    if (ImpactInvalidPtr(log)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    if (fd < 0) {
+        return ImpactResultArgumentInvalid;
+    }
+
+    ImpactLogSinkReset(log);
+
+    log->fd = fd;
+    log->sink = &ImpactLogDescriptorSink;
+
+    return ImpactResultSuccess;
+}
+
+#pragma mark - Stream
+
+static void ImpactLogStreamClose(ImpactLogger* log) {
+    // the descriptor belongs to the caller
+}
+
+static const ImpactLogSink ImpactLogStreamSink = {
+    .reserve = ImpactLogDescriptorReserve,
+    .commit = ImpactLogDescriptorCommit,
+    .flush = ImpactLogDescriptorFlush,
+    .writeAhead = ImpactLogDescriptorWriteAhead,
+    .close = ImpactLogStreamClose
+};
+
+ImpactResult ImpactLogSinkOpenStream(ImpactLogger* log, int fd) {
+    if (ImpactInvalidPtr(log)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    if (fd < 0) {
+        return ImpactResultArgumentInvalid;
+    }
+
+    // A reader that goes away must produce an error, not a signal in the middle of a crash.
+    if (fcntl(fd, F_SETNOSIGPIPE, 1) != 0) {
+        return ImpactResultCallFailed;
+    }
+
+    ImpactLogSinkReset(log);
+
+    log->fd = fd;
+    log->sink = &ImpactLogStreamSink;
+
+    return ImpactResultSuccess;
+}
+
+#pragma mark - Mapped
+
+static ImpactLogMappedHeader* ImpactLogMappedGetHeader(const ImpactLogger* log) {
+    return (ImpactLogMappedHeader*)log->mapping.base;
+}
+
+static size_t ImpactLogMappedCapacity(const ImpactLogger* log) {
+    return log->mapping.size - sizeof(ImpactLogMappedHeader);
+}
+
+static uint64_t ImpactLogMappedPosition(const ImpactLogger* log) {
+    const uint64_t committed = atomic_load_explicit(&ImpactLogMappedGetHeader(log)->committed, memory_order_relaxed);
+
+    return committed + log->mapping.pending;
+}
+
+// Writes go directly into the mapping. Once it's full, they are staged in the buffer, and written to the
+// file beyond the mapped region on flush.
+static char* ImpactLogMappedReserve(ImpactLogger* log, size_t* length) {
+    const uint64_t position = ImpactLogMappedPosition(log);
+    const size_t capacity = ImpactLogMappedCapacity(log);
+
+    if (position >= capacity) {
+        return ImpactLogDescriptorReserve(log, length);
+    }
+
+    const size_t available = capacity - (size_t)position;
+
+    if (*length > available) {
+        *length = available;
+    }
+
+    return (char*)log->mapping.base + sizeof(ImpactLogMappedHeader) + position;
+}
+
+static ImpactResult ImpactLogMappedCommit(ImpactLogger* log, size_t length) {
+    if (ImpactLogMappedPosition(log) >= ImpactLogMappedCapacity(log)) {
+        return ImpactLogDescriptorCommit(log, length);
+    }
+
+    log->mapping.pending += length;
+
+    return ImpactResultSuccess;
+}
+
+// The committed length only advances once the bytes it covers are completely written, so a reader
+// never sees a partial write.
+static ImpactResult ImpactLogMappedFlush(ImpactLogger* log) {
+    ImpactLogMappedHeader* header = ImpactLogMappedGetHeader(log);
+    uint64_t committed = atomic_load_explicit(&header->committed, memory_order_relaxed);
+
+    committed += log->mapping.pending;
+    log->mapping.pending = 0;
+
+    atomic_store_explicit(&header->committed, committed, memory_order_release);
+
+    if (log->bufferCount == 0) {
+        return ImpactResultSuccess;
+    }
+
+    const off_t offset = (off_t)(sizeof(ImpactLogMappedHeader) + committed);
+    const ImpactResult result = ImpactLogSinkWriteFully(log->fd, log->buffer, log->bufferCount, offset, true);
+    if (result != ImpactResultSuccess) {
+        return result;
+    }
+
+    atomic_store_explicit(&header->committed, committed + log->bufferCount, memory_order_release);
+    log->bufferCount = 0;
+
+    return ImpactResultSuccess;
+}
+
+static ImpactResult ImpactLogMappedWriteAhead(ImpactLogger* log, const char* data, size_t length) {
+    const uint64_t position = ImpactLogMappedPosition(log);
+
+    // Slide the uncommitted part of the record over to make room. After overflowing, appending
+    // is the only option left, even though it splits the record.
+    if (log->mapping.pending == 0 || log->bufferCount > 0 || position + length > ImpactLogMappedCapacity(log)) {
+        return ImpactLogWriteData(log, data, length);
+    }
+
+    ImpactLogMappedHeader* header = ImpactLogMappedGetHeader(log);
+    const uint64_t committed = atomic_load_explicit(&header->committed, memory_order_relaxed);
+    uint8_t* start = log->mapping.base + sizeof(ImpactLogMappedHeader) + committed;
+
+    memmove(start + length, start, log->mapping.pending);
+    memcpy(start, data, length);
+
+    atomic_store_explicit(&header->committed, committed + length, memory_order_release);
+
+    return ImpactResultSuccess;
+}
+
+static void ImpactLogMappedClose(ImpactLogger* log) {
+    munmap(log->mapping.base, log->mapping.size);
+    close(log->fd);
+}
+
+static const ImpactLogSink ImpactLogMappedSink = {
+    .reserve = ImpactLogMappedReserve,
+    .commit = ImpactLogMappedCommit,
+    .flush = ImpactLogMappedFlush,
+    .writeAhead = ImpactLogMappedWriteAhead,
+    .close = ImpactLogMappedClose
+};
+
+ImpactResult ImpactLogSinkOpenMapped(ImpactLogger* log, int fd, size_t size) {
+    if (ImpactInvalidPtr(log)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    const size_t pageSize = (size_t)getpagesize();
+
+    size = (size + pageSize - 1) & ~(pageSize - 1);
+    if (fd < 0 || size < pageSize) {
+        return ImpactResultArgumentInvalid;
+    }
+
+    // Reserving the blocks up front means running out of disk space shows up now, not as a SIGBUS
+    // while writing a crash. This is best-effort, as not every file system supports it.
+    fstore_t store = {
+        .fst_flags = F_ALLOCATEALL,
+        .fst_posmode = F_PEOFPOSMODE,
+        .fst_offset = 0,
+        .fst_length = (off_t)size
+    };
+
+    fcntl(fd, F_PREALLOCATE, &store);
+
+    if (ftruncate(fd, (off_t)size) != 0) {
+        return ImpactResultCallFailed;
+    }
+
+    uint8_t* mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        return ImpactResultCallFailed;
+    }
+
+    // Touch every page now, so writing at crash time never has to fault one in.
+    for (size_t offset = 0; offset < size; offset += pageSize) {
+        ((volatile uint8_t*)mapping)[offset] = 0;
+    }
+
+    ImpactLogMappedHeader* header = (ImpactLogMappedHeader*)mapping;
+
+    memcpy(header->magic, ImpactLogMappedMagic, sizeof(header->magic));
+    header->headerSize = sizeof(ImpactLogMappedHeader);
+    atomic_store_explicit(&header->committed, 0, memory_order_release);
+
+    ImpactLogSinkReset(log);
+
+    log->fd = fd;
+    log->mapping.base = mapping;
+    log->mapping.size = size;
+    log->sink = &ImpactLogMappedSink;
+
+    return ImpactResultSuccess;
+}
+
+#pragma mark - Compressed
+
+static ImpactResult ImpactLogCompressedWriteBlock(ImpactLogger* log, const char* data, size_t length) {
+    size_t blockLength = 0;
+
+    const ImpactResult result = ImpactLogCompressorEncodeBlock(log->compressor, (const uint8_t*)data, length, &blockLength);
+    if (result != ImpactResultSuccess) {
+        return result;
+    }
+
+    return ImpactLogSinkWriteFully(log->fd, (const char*)log->compressor->output, blockLength, 0, false);
+}
+
+// Every flush becomes a complete block, so a report that is cut off still decodes up to the last one.
+static ImpactResult ImpactLogCompressedFlush(ImpactLogger* log) {
+    if (log->bufferCount == 0) {
+        return ImpactResultSuccess;
+    }
+
+    const ImpactResult result = ImpactLogCompressedWriteBlock(log, log->buffer, log->bufferCount);
+    if (result != ImpactResultSuccess) {
+        return result;
+    }
+
+    log->bufferCount = 0;
+
+    return ImpactResultSuccess;
+}
+
+static ImpactResult ImpactLogCompressedWriteAhead(ImpactLogger* log, const char* data, size_t length) {
+    if (log->bufferCount == 0 || length > ImpactLogCompressionMaxBlockSize) {
+        return ImpactLogWriteData(log, data, length);
+    }
+
+    return ImpactLogCompressedWriteBlock(log, data, length);
+}
+
+static const ImpactLogSink ImpactLogCompressedSink = {
+    .reserve = ImpactLogDescriptorReserve,
+    .commit = ImpactLogDescriptorCommit,
+    .flush = ImpactLogCompressedFlush,
+    .writeAhead = ImpactLogCompressedWriteAhead,
+    .close = ImpactLogDescriptorClose
+};
+
+ImpactResult ImpactLogSinkOpenCompressed(ImpactLogger* log, int fd, ImpactLogCompressor* compressor) {
+    if (ImpactInvalidPtr(log) || ImpactInvalidPtr(compressor)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    if (fd < 0) {
+        return ImpactResultArgumentInvalid;
+    }
+
+    ImpactLogCompressorReset(compressor);
+
+    const uint8_t header[ImpactLogCompressionHeaderSize] = {
+        ImpactLogCompressionMagic[0], ImpactLogCompressionMagic[1], ImpactLogCompressionMagic[2], ImpactLogCompressionMagic[3],
+        ImpactLogCompressionVersion
+    };
+
+    const ImpactResult result = ImpactLogSinkWriteFully(fd, (const char*)header, sizeof(header), 0, false);
+    if (result != ImpactResultSuccess) {
+        return result;
+    }
+
+    ImpactLogSinkReset(log);
+
+    log->fd = fd;
+    log->compressor = compressor;
+    log->sink = &ImpactLogCompressedSink;
+
+    return ImpactResultSuccess;
+}
+
+#pragma mark - Ring
+
+static char* ImpactLogRingReserve(ImpactLogger* log, size_t* length) {
+    const size_t head = (size_t)(log->ring.written % log->ring.size);
+    const size_t available = log->ring.size - head;
+
+    if (*length > available) {
+        *length = available;
+    }
+
+    return (char*)log->ring.base + head;
+}
+
+static ImpactResult ImpactLogRingCommit(ImpactLogger* log, size_t length) {
+    log->ring.written += length;
+
+    return ImpactResultSuccess;
+}
+
+static ImpactResult ImpactLogRingFlush(ImpactLogger* log) {
+    return ImpactResultSuccess;
+}
+
+static void ImpactLogRingClose(ImpactLogger* log) {
+    // the memory belongs to the caller
+}
+
+static const ImpactLogSink ImpactLogRingSink = {
+    .reserve = ImpactLogRingReserve,
+    .commit = ImpactLogRingCommit,
+    .flush = ImpactLogRingFlush,
+    .writeAhead = NULL,
+    .close = ImpactLogRingClose
+};
+
+ImpactResult ImpactLogSinkOpenRing(ImpactLogger* log, uint8_t* buffer, size_t size) {
+    if (ImpactInvalidPtr(log) || ImpactInvalidPtr(buffer)) {
+        return ImpactResultPointerInvalid;
+    }
+
+    if (size == 0) {
+        return ImpactResultArgumentInvalid;
+    }
+
+    ImpactLogSinkReset(log);
+
+    log->ring.base = buffer;
+    log->ring.size = size;
+    log->sink = &ImpactLogRingSink;
+
+    return ImpactResultSuccess;
+}
+
+size_t ImpactLogSinkCopyRing(const ImpactLogger* log, uint8_t* buffer, size_t size) {
+    if (ImpactInvalidPtr(log) || ImpactInvalidPtr(buffer) || log->sink != &ImpactLogRingSink) {
+        return 0;
+    }
+
+    const ImpactLogRing* ring = &log->ring;
+
+    size_t count = ring->written < ring->size ? (size_t)ring->written : ring->size;
+
+    if (count > size) {
+        count = size;
+    }
+
+    const size_t start = (size_t)((ring->written - count) % ring->size);
+    const size_t first = count < ring->size - start ? count : ring->size - start;
+
+    memcpy(buffer, ring->base + start, first);
+    memcpy(buffer + first, ring->base, count - first);
+
+    return count;
+}
@@ -0,0 +1,44 @@
+//
+//  ImpactLogSink.h
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#ifndef ImpactLogSink_h
+#define ImpactLogSink_h
+
+#include "ImpactState.h"
+#include "ImpactResult.h"
+
+// Each of these points a logger at a destination, and must be followed by ImpactLogStart. None
+// of them are async-signal-safe, but all writing afterwards is.
+
+_Pragma("clang assume_nonnull begin")
+__BEGIN_DECLS
+
+// Buffers writes and hands them to write(2). The logger takes ownership of the descriptor.
+ImpactResult ImpactLogSinkOpenDescriptor(ImpactLogger* log, int fd);
+
+// Preallocates the file and writes through a shared mapping of it. The logger takes ownership of the descriptor.
+ImpactResult ImpactLogSinkOpenMapped(ImpactLogger* log, int fd, size_t size);
+
+// Keeps only the most recent bytes in memory owned by the caller. Wrapping cuts records apart, so this is
+// most useful with the text encoding.
+ImpactResult ImpactLogSinkOpenRing(ImpactLogger* log, uint8_t* buffer, size_t size);
+
+// Like the descriptor sink, but for a pipe or socket to another process. SIGPIPE is suppressed, and the
+// caller keeps ownership of the descriptor.
+ImpactResult ImpactLogSinkOpenStream(ImpactLogger* log, int fd);
+
+// Compresses each flush into a block of its own. The compressor must stay alive as long as the logger,
+// and is usually allocated up front along with the state. The logger takes ownership of the descriptor.
+ImpactResult ImpactLogSinkOpenCompressed(ImpactLogger* log, int fd, ImpactLogCompressor* compressor);
+
+// Copies out the newest bytes held by a ring sink, oldest first. Returns the number of bytes copied.
+size_t ImpactLogSinkCopyRing(const ImpactLogger* log, uint8_t* buffer, size_t size);
+
+__END_DECLS
+_Pragma("clang assume_nonnull end")
+
+#endif /* ImpactLogSink_h */
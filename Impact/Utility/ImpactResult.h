@@ -24,6 +24,10 @@ typedef enum {
     ImpactResultEndOfStack,
     ImpactResultMissingUnwindInfo,
     ImpactResultTooManyIterations,
+    ImpactResultDeadlineExceeded,
+    ImpactResultRateLimited,
+
+    ImpactResultCount
 } ImpactResult;
 
 #endif /* ImpactResult_h */
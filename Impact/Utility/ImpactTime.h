@@ -0,0 +1,25 @@
+//
+//  ImpactTime.h
+//  Impact
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#ifndef ImpactTime_h
+#define ImpactTime_h
+
+#include <stdint.h>
+#include <time.h>
+#include <dispatch/time.h>
+
+// CLOCK_UPTIME_RAW is backed by mach_absolute_time, which just reads the commpage. It takes no locks
+// and makes no syscalls, so it is safe to use from within the crash handler.
+static inline uint64_t ImpactTimeGetMonotonicNanoseconds(void) {
+    return clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+}
+
+static inline uint64_t ImpactTimeGetEpochMilliseconds(void) {
+    return clock_gettime_nsec_np(CLOCK_REALTIME) / NSEC_PER_MSEC;
+}
+
+#endif /* ImpactTime_h */
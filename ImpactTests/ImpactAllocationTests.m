@@ -0,0 +1,160 @@
+//
+//  ImpactAllocationTests.m
+//  ImpactTests
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "ImpactAllocation.h"
+#import "ImpactTime.h"
+
+#include <stdlib.h>
+
+static const char* ImpactAllocationTestsOutputPath = "/tmp/allocation_test.log";
+
+@interface ImpactAllocationTests : XCTestCase
+
+@end
+
+@implementation ImpactAllocationTests {
+    ImpactAllocationSampler* _sampler;
+}
+
+- (void)setUp {
+    _sampler = malloc(sizeof(ImpactAllocationSampler));
+}
+
+- (void)tearDown {
+    // an installed sampler can never be deinitialized or freed
+    if (_sampler->installed == false) {
+        ImpactAllocationSamplerDeinitialize(_sampler);
+        free(_sampler);
+    }
+}
+
+- (void)testEstimateIsCloseToTheTrueLiveBytes {
+    const uint64_t interval = 4096;
+    const uintptr_t base = 0x100000000;
+    const uint32_t count = 20000;
+
+    XCTAssertEqual(ImpactAllocationSamplerInitialize(_sampler, NULL, interval, ImpactUnwindStrategyFramePointer), ImpactResultSuccess);
+
+    // a mix of sizes, both well below and well above the interval
+    uint64_t trueBytes = 0;
+
+    for (uint32_t i = 0; i < count; ++i) {
+        const size_t size = (i % 10 == 0) ? 16384 : 16 * (i % 64 + 1);
+
+        ImpactAllocationSamplerRecordAllocation(_sampler, base + i * 32768, size, 0);
+        trueBytes += size;
+    }
+
+    const int64_t estimate = ImpactAllocationSamplerGetLiveBytes(_sampler);
+
+    XCTAssertGreaterThan(atomic_load(&_sampler->sampled), 1000);
+    XCTAssertEqual(atomic_load(&_sampler->dropped), 0);
+    XCTAssertEqualWithAccuracy((double)estimate, (double)trueBytes, (double)trueBytes * 0.1);
+
+    // every sample came from this one call site
+    XCTAssertEqual(atomic_load(&_sampler->stackCount), 1);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        ImpactAllocationSamplerRecordFree(_sampler, base + i * 32768);
+    }
+
+    XCTAssertEqual(ImpactAllocationSamplerGetLiveBytes(_sampler), 0);
+
+    // unsampled addresses are ignored
+    ImpactAllocationSamplerRecordFree(_sampler, base - 32768);
+    XCTAssertEqual(ImpactAllocationSamplerGetLiveBytes(_sampler), 0);
+}
+
+- (void)testDisabledSamplerOnlyRecordsFrees {
+    XCTAssertEqual(ImpactAllocationSamplerInitialize(_sampler, NULL, 1, ImpactUnwindStrategyFramePointer), ImpactResultSuccess);
+
+    ImpactAllocationSamplerRecordAllocation(_sampler, 0x10000, 64, 0);
+    XCTAssertEqual(ImpactAllocationSamplerGetLiveBytes(_sampler), 64);
+
+    atomic_store(&_sampler->enabled, false);
+
+    ImpactAllocationSamplerRecordAllocation(_sampler, 0x20000, 64, 0);
+    ImpactAllocationSamplerRecordFree(_sampler, 0x10000);
+
+    XCTAssertEqual(atomic_load(&_sampler->sampled), 1);
+    XCTAssertEqual(ImpactAllocationSamplerGetLiveBytes(_sampler), 0);
+}
+
+- (void)testInstalledSamplerSeesMallocAndWritesSnapshot {
+    XCTAssertEqual(ImpactAllocationSamplerInitialize(_sampler, NULL, 1024, ImpactUnwindStrategyFramePointer), ImpactResultSuccess);
+    XCTAssertEqual(ImpactAllocationSamplerInstall(_sampler), ImpactResultSuccess);
+
+    // only one at a time
+    XCTAssertEqual(ImpactAllocationSamplerInstall(_sampler), ImpactResultStateInvalid);
+    XCTAssertEqual(ImpactAllocationSamplerDeinitialize(_sampler), ImpactResultStateInvalid);
+
+    const size_t count = 256;
+    void* allocations[count];
+
+    for (size_t i = 0; i < count; ++i) {
+        allocations[i] = malloc(4096);
+    }
+
+    XCTAssertGreaterThan(atomic_load(&_sampler->sampled), 0);
+    XCTAssertGreaterThan(ImpactAllocationSamplerGetLiveBytes(_sampler), 0);
+
+    XCTAssertEqual(ImpactAllocationSamplerWriteSnapshot(_sampler, ImpactAllocationTestsOutputPath, ImpactLogEncodingText), ImpactResultSuccess);
+
+    for (size_t i = 0; i < count; ++i) {
+        free(allocations[i]);
+    }
+
+    XCTAssertEqual(ImpactAllocationSamplerUninstall(_sampler), ImpactResultSuccess);
+    XCTAssertEqual(ImpactAllocationSamplerUninstall(_sampler), ImpactResultStateInvalid);
+
+    NSString *path = [NSString stringWithUTF8String:ImpactAllocationTestsOutputPath];
+    NSString *contents = [NSString stringWithContentsOfFile:path encoding:NSUTF8StringEncoding error:nil];
+
+    XCTAssertTrue([contents containsString:@"[Allocation] interval: 0x400"]);
+    XCTAssertTrue([contents containsString:@"[Allocation:Stack] id: "]);
+    XCTAssertTrue([contents containsString:@"[Allocation:Frame] stack: "]);
+    XCTAssertTrue([contents containsString:@"[Binary:Found]"]);
+}
+
+static double ImpactAllocationTestsTimeMallocFree(uint32_t count, size_t size) {
+    const uint64_t start = ImpactTimeGetMonotonicNanoseconds();
+
+    for (uint32_t i = 0; i < count; ++i) {
+        void* volatile allocation = malloc(size);
+
+        free(allocation);
+    }
+
+    return (double)(ImpactTimeGetMonotonicNanoseconds() - start) / count;
+}
+
+- (void)testSamplingOverhead {
+    const uint32_t count = 1000000;
+    const size_t size = 64;
+
+    // the interval the monitor would typically be configured with
+    XCTAssertEqual(ImpactAllocationSamplerInitialize(_sampler, NULL, 512 * 1024, ImpactUnwindStrategyFramePointer), ImpactResultSuccess);
+
+    const double baseline = ImpactAllocationTestsTimeMallocFree(count, size);
+
+    XCTAssertEqual(ImpactAllocationSamplerInstall(_sampler), ImpactResultSuccess);
+
+    const double sampled = ImpactAllocationTestsTimeMallocFree(count, size);
+
+    XCTAssertEqual(ImpactAllocationSamplerUninstall(_sampler), ImpactResultSuccess);
+
+    const double throughput = (double)size / sampled * 1e9 / (1024 * 1024);
+
+    NSLog(@"allocation sampling: %.1f ns/pair, %.1f ns/pair sampled, %.0f MiB/s through malloc", baseline, sampled, throughput);
+
+    XCTAssertGreaterThan(atomic_load(&_sampler->sampled), 0);
+    XCTAssertLessThan(sampled - baseline, 1000.0);
+}
+
+@end
@@ -0,0 +1,83 @@
+//
+//  ImpactArenaTests.m
+//  ImpactTests
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "ImpactArena.h"
+
+@interface ImpactArenaTests : XCTestCase
+
+@end
+
+@implementation ImpactArenaTests {
+    ImpactArena _arena;
+}
+
+- (void)setUp {
+    XCTAssertEqual(ImpactArenaInitialize(&_arena, 1000), ImpactResultSuccess);
+}
+
+- (void)tearDown {
+    ImpactArenaDeinitialize(&_arena);
+}
+
+- (void)testSizeIsRoundedToPages {
+    XCTAssertEqual(_arena.size, (size_t)getpagesize());
+}
+
+- (void)testAllocationsAreAligned {
+    uint8_t* a = ImpactArenaAllocate(&_arena, 1, 1);
+    uint8_t* b = ImpactArenaAllocate(&_arena, 8, 16);
+
+    XCTAssertNotEqual(a, NULL);
+    XCTAssertEqual((uintptr_t)b % 16, 0);
+    XCTAssertEqual(b - a, 16);
+    XCTAssertEqual(ImpactArenaGetUsed(&_arena), 24);
+
+    XCTAssertEqual(ImpactArenaAllocate(&_arena, 8, 3), NULL);
+}
+
+- (void)testExhaustionAndReset {
+    XCTAssertNotEqual(ImpactArenaAllocate(&_arena, _arena.size, 1), NULL);
+    XCTAssertEqual(ImpactArenaAllocate(&_arena, 1, 1), NULL);
+    XCTAssertEqual(_arena.failures, 1);
+
+    ImpactArenaReset(&_arena);
+
+    XCTAssertEqual(ImpactArenaGetUsed(&_arena), 0);
+    XCTAssertEqual(_arena.highWater, _arena.size);
+    XCTAssertNotEqual(ImpactArenaAllocate(&_arena, 64, 8), NULL);
+}
+
+- (void)testUninitializedArenaFails {
+    ImpactArena arena = {0};
+
+    XCTAssertEqual(ImpactArenaAllocate(&arena, 1, 1), NULL);
+}
+
+- (void)testConcurrentAllocationsDoNotOverlap {
+    const size_t count = _arena.size / 16;
+    uintptr_t* allocations = calloc(count, sizeof(uintptr_t));
+
+    dispatch_apply(count, DISPATCH_APPLY_AUTO, ^(size_t i) {
+        allocations[i] = (uintptr_t)ImpactArenaAllocate(&self->_arena, 16, 16);
+    });
+
+    NSMutableSet<NSNumber *> *seen = [NSMutableSet set];
+
+    for (size_t i = 0; i < count; ++i) {
+        XCTAssertNotEqual(allocations[i], 0);
+        [seen addObject:@(allocations[i])];
+    }
+
+    XCTAssertEqual(seen.count, count);
+    XCTAssertEqual(ImpactArenaGetUsed(&_arena), _arena.size);
+
+    free(allocations);
+}
+
+@end
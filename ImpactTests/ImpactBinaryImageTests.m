@@ -0,0 +1,225 @@
+//
+//  ImpactBinaryImageTests.m
+//  ImpactTests
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "ImpactBinaryImage.h"
+#import "ImpactBinaryImageCatalog.h"
+#import "ImpactLog.h"
+
+#include <ptrauth.h>
+#include <string.h>
+#include <unistd.h>
+
+@interface ImpactBinaryImageTests : XCTestCase
+
+@end
+
+@implementation ImpactBinaryImageTests {
+    ImpactState _state;
+}
+
+- (void)setUp {
+    memset(&_state, 0, sizeof(ImpactState));
+
+    XCTAssertEqual(ImpactLogInitialize(&_state, "/tmp/binary_image_test.log"), ImpactResultSuccess);
+    XCTAssertEqual(ImpactBinaryImageInitialize(&_state), ImpactResultSuccess);
+}
+
+- (void)tearDown {
+    close(_state.mutableState.log.fd);
+}
+
+static uintptr_t ImpactTestFunctionAddress(const void* fn) {
+    return (uintptr_t)ptrauth_strip(fn, ptrauth_key_function_pointer);
+}
+
+- (void)testResolveAddressesMatchesFind {
+    const uintptr_t inputs[] = {
+        ImpactTestFunctionAddress(strlen) + 1,
+        ImpactTestFunctionAddress(ImpactBinaryImageFind) + 1,
+        ImpactTestFunctionAddress(malloc) + 1,
+        ImpactTestFunctionAddress(ImpactLogWriteString) + 1,
+    };
+    const uint32_t count = sizeof(inputs) / sizeof(uintptr_t);
+
+    ImpactBinaryImageAddress addresses[count];
+
+    for (uint32_t i = 0; i < count; ++i) {
+        addresses[i].address = inputs[i];
+    }
+
+    ImpactResult result = ImpactBinaryImageResolveAddresses(&_state, addresses, count, ImpactBinaryImageResolveOptionNone);
+    XCTAssertEqual(result, ImpactResultSuccess);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        // the resolved addresses must come back sorted
+        if (i > 0) {
+            XCTAssertLessThanOrEqual(addresses[i - 1].address, addresses[i].address);
+        }
+
+        ImpactMachOData data = {0};
+
+        result = ImpactBinaryImageFind(&_state, addresses[i].address, &data);
+        XCTAssertEqual(result, ImpactResultSuccess);
+
+        XCTAssertNotEqual(addresses[i].imageIndex, ImpactBinaryImageNotFoundFlag);
+        XCTAssertEqual(addresses[i].imageOffset, addresses[i].address - data.loadAddress);
+
+        // resolving alone must agree, so nothing leaks over from the images before it
+        ImpactBinaryImageAddress single = { .address = addresses[i].address };
+
+        XCTAssertEqual(ImpactBinaryImageResolveAddresses(&_state, &single, 1, ImpactBinaryImageResolveOptionNone), ImpactResultSuccess);
+        XCTAssertEqual(single.imageIndex, addresses[i].imageIndex);
+        XCTAssertEqual(single.unwindEncoding, addresses[i].unwindEncoding);
+    }
+}
+
+- (void)testResolveAddressOutsideOfAllImages {
+    ImpactBinaryImageAddress addresses[] = {
+        { .address = 0x10 },
+        { .address = ImpactTestFunctionAddress(strlen) + 1 },
+    };
+
+    ImpactResult result = ImpactBinaryImageResolveAddresses(&_state, addresses, 2, ImpactBinaryImageResolveOptionPresorted);
+    XCTAssertEqual(result, ImpactResultSuccess);
+
+    XCTAssertEqual(addresses[0].imageIndex, ImpactBinaryImageNotFoundFlag);
+    XCTAssertNotEqual(addresses[1].imageIndex, ImpactBinaryImageNotFoundFlag);
+}
+
+- (NSArray<NSString *> *)loggedLines {
+    ImpactLogFlush(&_state.mutableState.log);
+
+    NSString *contents = [NSString stringWithContentsOfFile:@"/tmp/binary_image_test.log" encoding:NSUTF8StringEncoding error:nil];
+
+    return [contents componentsSeparatedByString:@"\n"];
+}
+
+- (void)testOnlyReferencedImagesAreLogged {
+    _state.constantState.imageLogging = ImpactBinaryImageLoggingReferenced;
+
+    ImpactMachOData first = {0};
+    ImpactMachOData second = {0};
+
+    XCTAssertEqual(ImpactBinaryImageFind(&_state, ImpactTestFunctionAddress(strlen), &first), ImpactResultSuccess);
+    XCTAssertEqual(ImpactBinaryImageFind(&_state, ImpactTestFunctionAddress(ImpactLogWriteString), &second), ImpactResultSuccess);
+    XCTAssertNotEqual(first.index, second.index);
+
+    // nothing is written until the end
+    NSPredicate *imagePredicate = [NSPredicate predicateWithFormat:@"SELF BEGINSWITH '[Binary:Found]'"];
+
+    XCTAssertEqual([[self loggedLines] filteredArrayUsingPredicate:imagePredicate].count, 0);
+
+    XCTAssertEqual(ImpactBinaryImageLogRemainingImages(&_state), ImpactResultSuccess);
+
+    NSArray<NSString *> *lines = [self loggedLines];
+    NSArray<NSString *> *images = [lines filteredArrayUsingPredicate:imagePredicate];
+
+    XCTAssertEqual(images.count, 2);
+    XCTAssertTrue([images[0] hasPrefix:[NSString stringWithFormat:@"[Binary:Found] index: 0x%x,", MIN(first.index, second.index)]]);
+
+    const struct dyld_all_image_infos* imagesInfo = (void *)_state.mutableState.images.dyldInfo.all_image_info_addr;
+    NSString *summary = [NSString stringWithFormat:@"[Binary:Summary] count: 0x%x, referenced: 0x2, hash: 0x", imagesInfo->infoArrayCount];
+
+    XCTAssertEqual([lines filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"SELF BEGINSWITH %@", summary]].count, 1);
+}
+
+// Images past the bitmap only exist in processes with thousands of them, so the list is filled in
+// directly here. Each index in it is written once, and counted in the summary.
+- (void)testOverflowImagesAreLoggedOnce {
+    _state.constantState.imageLogging = ImpactBinaryImageLoggingReferenced;
+
+    ImpactMachOData data = {0};
+
+    XCTAssertEqual(ImpactBinaryImageFind(&_state, ImpactTestFunctionAddress(strlen), &data), ImpactResultSuccess);
+
+    memset(_state.mutableState.images.referenced, 0, sizeof(_state.mutableState.images.referenced));
+    _state.mutableState.images.overflowIndexes[0] = data.index;
+    _state.mutableState.images.overflowCount = 1;
+
+    XCTAssertEqual(ImpactBinaryImageLogRemainingImages(&_state), ImpactResultSuccess);
+
+    NSArray<NSString *> *lines = [self loggedLines];
+    NSString *found = [NSString stringWithFormat:@"[Binary:Found] index: 0x%x,", data.index];
+
+    XCTAssertEqual([lines filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"SELF BEGINSWITH %@", found]].count, 1);
+    XCTAssertEqual([lines filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"SELF CONTAINS %@", @"referenced: 0x1,"]].count, 1);
+}
+
+- (void)testCatalogIdsSurviveReopening {
+    const char* path = "/tmp/binary_image_catalog_test.log";
+
+    unlink(path);
+
+    ImpactBinaryImageCatalog* catalog = calloc(1, sizeof(ImpactBinaryImageCatalog));
+    ImpactMachOData data = {0};
+
+    XCTAssertEqual(ImpactBinaryImageCatalogOpen(catalog, path), ImpactResultSuccess);
+    XCTAssertEqual(ImpactBinaryImageFind(&_state, ImpactTestFunctionAddress(strlen), &data), ImpactResultSuccess);
+    XCTAssertEqual(ImpactBinaryImageCatalogAdd(catalog, &data), ImpactResultSuccess);
+
+    const uint32_t id = ImpactBinaryImageCatalogLookup(catalog, data.uuid);
+    const uint64_t identifier = catalog->identifier;
+
+    XCTAssertNotEqual(id, 0);
+    close(catalog->log.fd);
+
+    XCTAssertEqual(ImpactBinaryImageCatalogOpen(catalog, path), ImpactResultSuccess);
+    XCTAssertEqual(catalog->identifier, identifier);
+    XCTAssertEqual(ImpactBinaryImageCatalogLookup(catalog, data.uuid), id);
+    close(catalog->log.fd);
+
+    // reports then only need the catalog id and load address
+    _state.constantState.imageCatalog = catalog;
+    _state.constantState.imageLogging = ImpactBinaryImageLoggingReferenced;
+
+    XCTAssertEqual(ImpactBinaryImageFind(&_state, ImpactTestFunctionAddress(strlen), &data), ImpactResultSuccess);
+    XCTAssertEqual(ImpactBinaryImageLogReferencedImages(&_state), ImpactResultSuccess);
+
+    NSString *expected = [NSString stringWithFormat:@"[Binary:Found] index: 0x%x, catalog: 0x%x, address: 0x", data.index, id];
+
+    XCTAssertTrue([[self loggedLines] containsObject:[expected stringByAppendingFormat:@"%lx", data.loadAddress]]);
+
+    free(catalog);
+}
+
+- (void)testDerivedStatesDoNotUseTheCatalog {
+    ImpactBinaryImageCatalog catalog = {0};
+    ImpactState derived;
+
+    _state.constantState.imageCatalog = &catalog;
+
+    ImpactStateInitializeDerived(&derived, &_state, ImpactStateDerivedOptionReferencedImages);
+
+    XCTAssertTrue(derived.constantState.imageCatalog == NULL);
+    XCTAssertEqual(derived.constantState.imageLogging, ImpactBinaryImageLoggingReferenced);
+
+    _state.constantState.imageCatalog = NULL;
+}
+
+- (void)testResolveManyAddressesPerformance {
+    enum { count = 4096 };
+    static ImpactBinaryImageAddress addresses[count];
+
+    const uintptr_t bases[] = {
+        ImpactTestFunctionAddress(strlen),
+        ImpactTestFunctionAddress(malloc),
+        ImpactTestFunctionAddress(ImpactBinaryImageFind),
+        ImpactTestFunctionAddress(ImpactLogWriteString),
+    };
+
+    [self measureBlock:^{
+        for (uint32_t i = 0; i < count; ++i) {
+            addresses[i].address = bases[i % 4] + (i % 64);
+        }
+
+        ImpactBinaryImageResolveAddresses(&self->_state, addresses, count, ImpactBinaryImageResolveOptionNone);
+    }];
+}
+
+@end
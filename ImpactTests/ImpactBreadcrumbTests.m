@@ -0,0 +1,200 @@
+//
+//  ImpactBreadcrumbTests.m
+//  ImpactTests
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "ImpactBreadcrumb.h"
+#import "ImpactLog.h"
+#import "ImpactTime.h"
+
+#include <pthread.h>
+#include <unistd.h>
+
+static const char* ImpactBreadcrumbTestsLogPath = "/tmp/breadcrumb_test.log";
+
+static void* ImpactBreadcrumbTestsRecordOne(void* context) {
+    const uintptr_t argument = 2;
+
+    ImpactBreadcrumbRecord(context, 1, &argument, 1, "second");
+
+    return NULL;
+}
+
+typedef struct {
+    ImpactBreadcrumbPool* pool;
+    uint64_t duration;
+    uint64_t events;
+    uint64_t elapsed;
+} ImpactBreadcrumbTestsLoad;
+
+static void* ImpactBreadcrumbTestsRecordUntilDeadline(void* context) {
+    ImpactBreadcrumbTestsLoad* load = context;
+    const uint64_t start = ImpactTimeGetMonotonicNanoseconds();
+    uint64_t now = start;
+
+    // the clock is only read every so often, so that it is not most of what gets measured
+    while (now - start < load->duration) {
+        for (uint32_t i = 0; i < 1024; ++i) {
+            const uintptr_t arguments[2] = { (uintptr_t)load, i };
+
+            ImpactBreadcrumbRecord(load->pool, 3, arguments, 2, "load");
+        }
+
+        load->events += 1024;
+        now = ImpactTimeGetMonotonicNanoseconds();
+    }
+
+    load->elapsed = now - start;
+
+    return NULL;
+}
+
+@interface ImpactBreadcrumbTests : XCTestCase
+
+@end
+
+@implementation ImpactBreadcrumbTests {
+    ImpactBreadcrumbPool _pool;
+}
+
+- (void)tearDown {
+    XCTAssertEqual(ImpactBreadcrumbPoolDeinitialize(&_pool), ImpactResultSuccess);
+}
+
+- (void)recordOnOtherThread {
+    pthread_t thread;
+
+    XCTAssertEqual(pthread_create(&thread, NULL, ImpactBreadcrumbTestsRecordOne, &_pool), 0);
+    XCTAssertEqual(pthread_join(thread, NULL), 0);
+}
+
+- (void)testRingKeepsTheMostRecentEvents {
+    XCTAssertEqual(ImpactBreadcrumbPoolInitialize(&_pool, 4), ImpactResultSuccess);
+
+    for (uintptr_t i = 0; i < 100; ++i) {
+        const uintptr_t arguments[6] = { i, i + 1, i + 2, i + 3, i + 4, i + 5 };
+
+        ImpactBreadcrumbRecord(&_pool, 7, arguments, 6, "a message that is much too long to keep");
+    }
+
+    const ImpactBreadcrumbRing* ring = ImpactBreadcrumbPoolGetRing(&_pool, pthread_mach_thread_np(pthread_self()));
+
+    XCTAssertTrue(ring != NULL);
+    XCTAssertEqual(atomic_load(&ring->head), 100);
+
+    const ImpactBreadcrumb* newest = &ring->events[99 % ImpactBreadcrumbRingCapacity];
+    const ImpactBreadcrumb* oldest = &ring->events[100 % ImpactBreadcrumbRingCapacity];
+
+    XCTAssertEqual(newest->category, 7);
+    XCTAssertEqual(newest->argumentCount, ImpactBreadcrumbArgumentLimit);
+    XCTAssertEqual(newest->arguments[0], 99);
+    XCTAssertEqual(newest->arguments[3], 102);
+    XCTAssertEqual(strlen(newest->message), ImpactBreadcrumbMessageSize - 1);
+    XCTAssertEqual(oldest->arguments[0], 100 - ImpactBreadcrumbRingCapacity);
+    XCTAssertLessThanOrEqual(oldest->time, newest->time);
+}
+
+- (void)testThreadsWithoutARingAreDropped {
+    XCTAssertEqual(ImpactBreadcrumbPoolInitialize(&_pool, 1), ImpactResultSuccess);
+
+    // the ring goes back to the pool when its thread exits
+    [self recordOnOtherThread];
+    [self recordOnOtherThread];
+
+    XCTAssertEqual(atomic_load(&_pool.dropped), 0);
+
+    ImpactBreadcrumbRecord(&_pool, 1, NULL, 0, NULL);
+    [self recordOnOtherThread];
+
+    XCTAssertEqual(atomic_load(&_pool.dropped), 1);
+}
+
+- (void)testLogMergesThreadsOldestFirst {
+    XCTAssertEqual(ImpactBreadcrumbPoolInitialize(&_pool, 4), ImpactResultSuccess);
+
+    ImpactBreadcrumbRecord(&_pool, 1, NULL, 0, "first");
+    [self recordOnOtherThread];
+    ImpactBreadcrumbRecord(&_pool, 1, NULL, 0, "third");
+
+    ImpactState* state = calloc(1, sizeof(ImpactState));
+
+    state->mutableState.reportIndex.fd = -1;
+    state->mutableState.log.fd = -1;
+
+    XCTAssertEqual(ImpactLogInitialize(state, ImpactBreadcrumbTestsLogPath), ImpactResultSuccess);
+    XCTAssertEqual(ImpactBreadcrumbPoolLog(state, &_pool), ImpactResultSuccess);
+
+    ImpactLogDeinitialize(ImpactStateGetLog(state));
+    free(state);
+
+    NSString *path = [NSString stringWithUTF8String:ImpactBreadcrumbTestsLogPath];
+    NSString *contents = [NSString stringWithContentsOfFile:path encoding:NSUTF8StringEncoding error:nil];
+
+    XCTAssertTrue([contents containsString:@"[Breadcrumbs] threads: 0x2, recorded: 0x3, dropped: 0x0"]);
+    XCTAssertTrue([contents containsString:@"category: 0x1, arg0: 0x2, message: second"]);
+
+    const NSUInteger first = [contents rangeOfString:@"message: first"].location;
+    const NSUInteger second = [contents rangeOfString:@"message: second"].location;
+    const NSUInteger third = [contents rangeOfString:@"message: third"].location;
+
+    XCTAssertNotEqual(third, NSNotFound);
+    XCTAssertLessThan(first, second);
+    XCTAssertLessThan(second, third);
+}
+
+- (void)testRecordingCostUnderLoad {
+    const uint32_t threadCount = (uint32_t)sysconf(_SC_NPROCESSORS_ONLN);
+    const uint64_t duration = 1000000000;
+    pthread_t threads[threadCount];
+    ImpactBreadcrumbTestsLoad loads[threadCount];
+
+    // this thread needs a ring of its own, on top of one for every worker
+    XCTAssertEqual(ImpactBreadcrumbPoolInitialize(&_pool, threadCount + 1), ImpactResultSuccess);
+
+    ImpactBreadcrumbTestsLoad alone = { .pool = &_pool, .duration = duration };
+
+    ImpactBreadcrumbTestsRecordUntilDeadline(&alone);
+
+    // every worker records for the same length of time, so all of them overlap for nearly all of it
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        loads[i] = (ImpactBreadcrumbTestsLoad){ .pool = &_pool, .duration = duration };
+
+        XCTAssertEqual(pthread_create(&threads[i], NULL, ImpactBreadcrumbTestsRecordUntilDeadline, &loads[i]), 0);
+    }
+
+    uint64_t events = 0;
+    uint64_t elapsed = 0;
+
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        XCTAssertEqual(pthread_join(threads[i], NULL), 0);
+
+        events += loads[i].events;
+        elapsed += loads[i].elapsed;
+    }
+
+    NSLog(@"breadcrumbs: %.1f ns/event alone, %.1f ns/event with %u threads, %.1fM events/s in total",
+          (double)alone.elapsed / alone.events, (double)elapsed / events, threadCount, events / (duration / 1e9) / 1e6);
+
+    XCTAssertEqual(atomic_load(&_pool.dropped), 0);
+}
+
+- (void)testRecordPerformance {
+    XCTAssertEqual(ImpactBreadcrumbPoolInitialize(&_pool, 1), ImpactResultSuccess);
+
+    ImpactBreadcrumbPool* pool = &_pool;
+
+    // a million events, so each millisecond is a nanosecond per event
+    [self measureBlock:^{
+        for (uint32_t i = 0; i < 1000000; ++i) {
+            const uintptr_t arguments[2] = { 1, i };
+
+            ImpactBreadcrumbRecord(pool, 3, arguments, 2, "measured");
+        }
+    }];
+}
+
+@end
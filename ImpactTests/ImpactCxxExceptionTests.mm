@@ -0,0 +1,228 @@
+//
+//  ImpactCxxExceptionTests.mm
+//  ImpactTests
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "ImpactCxxException.h"
+#import "ImpactLog.h"
+#import "ImpactBinaryImage.h"
+
+#include <dlfcn.h>
+#include <pthread.h>
+#include <stdexcept>
+
+static const char* ImpactCxxExceptionTestsLogPath = "/tmp/cxx_exception_test.log";
+
+// What a thread in a host app runs into before recording starts, or once it has been turned off.
+static void* ImpactCxxExceptionTestsCatchWhileDisabled(void* context) {
+    ImpactCxxExceptionRecordBeginCatch();
+    ImpactCxxExceptionRecordRethrow();
+    ImpactCxxExceptionRecordEndCatch();
+    ImpactCxxExceptionRecordThrow(&typeid(std::runtime_error), 0);
+
+    const bool claimed = ImpactCxxExceptionGetThrowSite(pthread_mach_thread_np(pthread_self())) != NULL;
+
+    return (void*)(uintptr_t)claimed;
+}
+
+@interface ImpactCxxExceptionTests : XCTestCase
+
+@end
+
+@implementation ImpactCxxExceptionTests
+
+- (void)setUp {
+    XCTAssertEqual(ImpactCxxExceptionInitialize(), ImpactResultSuccess);
+}
+
+- (ImpactCxxExceptionThrowSite *)currentThrowSite {
+    return ImpactCxxExceptionGetThrowSite(pthread_mach_thread_np(pthread_self()));
+}
+
+- (void)testThrowSiteIsPendingUntilCaught {
+    ImpactCxxExceptionRecordThrow(&typeid(std::runtime_error), 0);
+
+    ImpactCxxExceptionThrowSite* site = [self currentThrowSite];
+
+    XCTAssertTrue(site != NULL);
+    XCTAssertTrue(atomic_load(&site->pending));
+    XCTAssertEqual(site->type, &typeid(std::runtime_error));
+    XCTAssertGreaterThan(site->frameCount, 1);
+
+    // the first frame is the throw site itself
+    Dl_info info = {0};
+
+    XCTAssertNotEqual(dladdr((const void*)site->frames[0], &info), 0);
+    XCTAssertTrue(strstr(info.dli_sname, "testThrowSiteIsPendingUntilCaught") != NULL);
+
+    // still pending until the catch block is done with it
+    ImpactCxxExceptionRecordBeginCatch();
+    XCTAssertTrue(atomic_load(&site->pending));
+
+    ImpactCxxExceptionRecordEndCatch();
+    XCTAssertFalse(atomic_load(&site->pending));
+
+    ImpactCxxExceptionRecordRethrow();
+    XCTAssertTrue(atomic_load(&site->pending));
+
+    ImpactCxxExceptionRecordBeginCatch();
+    ImpactCxxExceptionRecordEndCatch();
+}
+
+- (void)testHooksDoNothingWhileDisabled {
+    ImpactCxxExceptionRecordThrow(&typeid(std::runtime_error), 0);
+    ImpactCxxExceptionRecordBeginCatch();
+    ImpactCxxExceptionRecordEndCatch();
+
+    ImpactCxxExceptionThrowSite* site = [self currentThrowSite];
+    const uint64_t throwCount = site->throwCount;
+
+    ImpactCxxExceptionDeinitialize();
+
+    pthread_t thread;
+    void* claimed = NULL;
+
+    XCTAssertEqual(pthread_create(&thread, NULL, ImpactCxxExceptionTestsCatchWhileDisabled, NULL), 0);
+    XCTAssertEqual(pthread_join(thread, &claimed), 0);
+    XCTAssertEqual(claimed, NULL);
+
+    // a thread with a site leaves it alone too
+    ImpactCxxExceptionRecordBeginCatch();
+    ImpactCxxExceptionRecordRethrow();
+    ImpactCxxExceptionRecordThrow(&typeid(std::out_of_range), 0);
+
+    XCTAssertEqual(site->catchDepth, 0);
+    XCTAssertEqual(site->throwCount, throwCount);
+    XCTAssertFalse(atomic_load(&site->pending));
+
+    XCTAssertEqual(ImpactCxxExceptionInitialize(), ImpactResultSuccess);
+}
+
+// Throwing out of a noexcept function begins a catch, and then calls std::terminate.
+- (void)testThrowThroughNoexceptStaysPending {
+    ImpactCxxExceptionRecordThrow(&typeid(std::runtime_error), 0);
+    ImpactCxxExceptionRecordBeginCatch();
+
+    ImpactCxxExceptionThrowSite* site = [self currentThrowSite];
+
+    XCTAssertTrue(atomic_load(&site->pending));
+
+    ImpactCxxExceptionRecordEndCatch();
+}
+
+- (void)testThrowOutOfCatchBlockStaysPending {
+    ImpactCxxExceptionRecordThrow(&typeid(std::runtime_error), 0);
+    ImpactCxxExceptionRecordBeginCatch();
+
+    // a second exception leaves the first catch block, and is then caught by a noexcept boundary
+    ImpactCxxExceptionRecordThrow(&typeid(std::out_of_range), 0);
+    ImpactCxxExceptionRecordEndCatch();
+    ImpactCxxExceptionRecordBeginCatch();
+
+    ImpactCxxExceptionThrowSite* site = [self currentThrowSite];
+
+    XCTAssertTrue(atomic_load(&site->pending));
+    XCTAssertEqual(site->type, &typeid(std::out_of_range));
+
+    ImpactCxxExceptionRecordEndCatch();
+    XCTAssertFalse(atomic_load(&site->pending));
+    XCTAssertEqual(site->catchDepth, 0);
+}
+
+- (void)testNestedCatchLeavesOuterClear {
+    ImpactCxxExceptionRecordThrow(&typeid(std::runtime_error), 0);
+    ImpactCxxExceptionRecordBeginCatch();
+
+    ImpactCxxExceptionRecordThrow(&typeid(std::out_of_range), 0);
+    ImpactCxxExceptionRecordBeginCatch();
+    ImpactCxxExceptionRecordEndCatch();
+
+    ImpactCxxExceptionThrowSite* site = [self currentThrowSite];
+
+    XCTAssertFalse(atomic_load(&site->pending));
+
+    ImpactCxxExceptionRecordEndCatch();
+    XCTAssertFalse(atomic_load(&site->pending));
+    XCTAssertEqual(site->catchDepth, 0);
+}
+
+// Interposing only applies to images loaded at launch, and test bundles usually are not.
+- (BOOL)isInterposed {
+    ImpactCxxExceptionThrowSite* site = [self currentThrowSite];
+    const uint64_t before = site ? site->throwCount : 0;
+
+    try {
+        throw std::runtime_error("probe");
+    } catch (const std::exception&) {
+    }
+
+    site = [self currentThrowSite];
+
+    return site != NULL && site->throwCount == before + 1;
+}
+
+- (void)testCaughtThrowIsRecordedWhenInterposed {
+    XCTSkipUnless([self isInterposed], @"__cxa_throw is not interposed in this test bundle");
+
+    ImpactCxxExceptionThrowSite* site = [self currentThrowSite];
+    const uint64_t before = site->throwCount;
+
+    try {
+        throw std::runtime_error("test");
+    } catch (const std::exception&) {
+        XCTAssertTrue(atomic_load(&site->pending));
+    }
+
+    XCTAssertEqual(site->throwCount, before + 1);
+    XCTAssertFalse(atomic_load(&site->pending));
+}
+
+- (void)testThrowAndCatchPerformance {
+    // a million throws, so each millisecond is a nanosecond per throw
+    [self measureBlock:^{
+        for (uint32_t i = 0; i < 1000000; ++i) {
+            ImpactCxxExceptionRecordThrow(&typeid(std::runtime_error), 0);
+            ImpactCxxExceptionRecordBeginCatch();
+            ImpactCxxExceptionRecordEndCatch();
+        }
+    }];
+}
+
+- (void)testPendingExceptionIsLogged {
+    ImpactState* state = (ImpactState*)calloc(1, sizeof(ImpactState));
+
+    state->mutableState.reportIndex.fd = -1;
+    state->mutableState.log.fd = -1;
+
+    XCTAssertEqual(ImpactLogInitialize(state, ImpactCxxExceptionTestsLogPath), ImpactResultSuccess);
+    XCTAssertEqual(ImpactBinaryImageInitialize(state), ImpactResultSuccess);
+
+    const thread_act_t thread = pthread_mach_thread_np(pthread_self());
+
+    ImpactCxxExceptionRecordThrow(&typeid(std::out_of_range), 0);
+    XCTAssertEqual(ImpactCxxExceptionLogPending(state, thread), ImpactResultSuccess);
+
+    // once caught, there is nothing to log
+    ImpactCxxExceptionRecordBeginCatch();
+    ImpactCxxExceptionRecordEndCatch();
+    XCTAssertEqual(ImpactCxxExceptionLogPending(state, thread), ImpactResultSuccess);
+
+    ImpactLogDeinitialize(ImpactStateGetLog(state));
+    free(state);
+
+    NSString *path = [NSString stringWithUTF8String:ImpactCxxExceptionTestsLogPath];
+    NSString *contents = [NSString stringWithContentsOfFile:path encoding:NSUTF8StringEncoding error:nil];
+    NSString *name = [NSString stringWithUTF8String:typeid(std::out_of_range).name()];
+
+    XCTAssertTrue([contents containsString:[NSString stringWithFormat:@"[Exception] type: c++, name: %@", name]]);
+    // every frame here is in a loaded image, so none are written as a bare ip
+    XCTAssertTrue([contents containsString:@"[Exception:Frame] image: "]);
+    XCTAssertFalse([contents containsString:@"[Exception:Frame] ip: "]);
+    XCTAssertEqual([contents componentsSeparatedByString:@"[Exception] "].count, 2);
+}
+
+@end
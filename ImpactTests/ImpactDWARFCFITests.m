@@ -11,6 +11,8 @@
 #import "ImpactDWARF.h"
 #import "ImpactDWARFParser.h"
 #import "ImpactState.h"
+#import "ImpactLog.h"
+#import "ImpactLogSink.h"
 #import "ImpactCrashHelper.h"
 
 #import <stdio.h>
@@ -24,7 +26,10 @@
 - (void)setUp {
     GlobalImpactState = malloc(sizeof(ImpactState));
 
-    GlobalImpactState->mutableState.log.fd = STDERR_FILENO;
+    ImpactLogger* log = &GlobalImpactState->mutableState.log;
+
+    ImpactLogSinkOpenStream(log, STDERR_FILENO);
+    ImpactLogStart(log, ImpactLogEncodingText);
 }
 
 - (void)tearDown {
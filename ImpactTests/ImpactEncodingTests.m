@@ -0,0 +1,119 @@
+//
+//  ImpactEncodingTests.m
+//  ImpactTests
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "ImpactEncoding.h"
+
+@interface ImpactEncodingTests : XCTestCase
+
+@end
+
+@implementation ImpactEncodingTests
+
+- (NSString *)base64:(NSData *)data {
+    NSMutableData *output = [NSMutableData dataWithLength:ImpactEncodingBase64Length(data.length)];
+    const size_t length = ImpactEncodingBase64(data.bytes, data.length, output.mutableBytes);
+
+    XCTAssertEqual(length, output.length);
+
+    return [[NSString alloc] initWithData:output encoding:NSUTF8StringEncoding];
+}
+
+- (NSString *)hex:(NSData *)data {
+    NSMutableData *output = [NSMutableData dataWithLength:ImpactEncodingHexLength(data.length)];
+    const size_t length = ImpactEncodingHex(data.bytes, data.length, output.mutableBytes);
+
+    XCTAssertEqual(length, output.length);
+
+    return [[NSString alloc] initWithData:output encoding:NSUTF8StringEncoding];
+}
+
+- (NSData *)randomDataOfLength:(NSUInteger)length {
+    NSMutableData *data = [NSMutableData dataWithLength:length];
+
+    arc4random_buf(data.mutableBytes, length);
+
+    return data;
+}
+
+- (void)testBase64MatchesFoundation {
+    // every length up to a few vector iterations, so each tail length is covered
+    for (NSUInteger length = 0; length < 200; ++length) {
+        NSData *data = [self randomDataOfLength:length];
+
+        XCTAssertEqualObjects([self base64:data], [data base64EncodedStringWithOptions:0]);
+    }
+}
+
+- (void)testBase64MatchesScalar {
+    NSData *data = [self randomDataOfLength:4096];
+    NSMutableData *vector = [NSMutableData dataWithLength:ImpactEncodingBase64Length(data.length)];
+    NSMutableData *scalar = [NSMutableData dataWithLength:ImpactEncodingBase64Length(data.length)];
+
+    ImpactEncodingBase64(data.bytes, data.length, vector.mutableBytes);
+    ImpactEncodingBase64Scalar(data.bytes, data.length, scalar.mutableBytes);
+
+    XCTAssertEqualObjects(vector, scalar);
+}
+
+- (void)testBase64InPieces {
+    NSData *data = [self randomDataOfLength:100];
+    NSMutableString *pieces = [NSMutableString string];
+
+    for (NSUInteger offset = 0; offset < data.length; offset += 48) {
+        [pieces appendString:[self base64:[data subdataWithRange:NSMakeRange(offset, MIN(48, data.length - offset))]]];
+    }
+
+    XCTAssertEqualObjects(pieces, [data base64EncodedStringWithOptions:0]);
+}
+
+- (void)testHex {
+    const uint8_t bytes[] = { 0x00, 0x01, 0x7f, 0x80, 0xab, 0xcd, 0xef, 0xff };
+
+    XCTAssertEqualObjects([self hex:[NSData dataWithBytes:bytes length:sizeof(bytes)]], @"00017f80abcdefff");
+
+    for (NSUInteger length = 0; length < 100; ++length) {
+        NSData *data = [self randomDataOfLength:length];
+        NSMutableString *expected = [NSMutableString string];
+
+        for (NSUInteger i = 0; i < length; ++i) {
+            [expected appendFormat:@"%02x", ((const uint8_t *)data.bytes)[i]];
+        }
+
+        XCTAssertEqualObjects([self hex:data], expected);
+    }
+}
+
+- (void)measureEncoder:(size_t (*)(const uint8_t*, size_t, char*))encoder {
+    NSData *data = [self randomDataOfLength:1024 * 1024];
+    NSMutableData *output = [NSMutableData dataWithLength:ImpactEncodingHexLength(data.length)];
+
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 50; ++i) {
+            encoder(data.bytes, data.length, output.mutableBytes);
+        }
+    }];
+}
+
+- (void)testBase64Performance {
+    [self measureEncoder:ImpactEncodingBase64];
+}
+
+- (void)testBase64ScalarPerformance {
+    [self measureEncoder:ImpactEncodingBase64Scalar];
+}
+
+- (void)testHexPerformance {
+    [self measureEncoder:ImpactEncodingHex];
+}
+
+- (void)testHexScalarPerformance {
+    [self measureEncoder:ImpactEncodingHexScalar];
+}
+
+@end
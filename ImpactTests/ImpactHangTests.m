@@ -0,0 +1,204 @@
+//
+//  ImpactHangTests.m
+//  ImpactTests
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "ImpactHang.h"
+#import "ImpactTime.h"
+
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+static _Atomic bool ImpactHangTestsRunning = false;
+static ImpactHangWatch* _Atomic ImpactHangTestsWatch = NULL;
+
+static __attribute__((noinline)) void ImpactHangTestsBusyWait(uint64_t duration) {
+    const uint64_t end = ImpactTimeGetMonotonicNanoseconds() + duration;
+
+    while (ImpactTimeGetMonotonicNanoseconds() < end) {
+    }
+}
+
+static void* ImpactHangTestsHangingThread(void* context) {
+    // the watch is registered once the thread exists
+    while (atomic_load(&ImpactHangTestsWatch) == NULL) {
+        usleep(1000);
+    }
+
+    ImpactHangWatch* watch = atomic_load(&ImpactHangTestsWatch);
+
+    ImpactHangWatchBeat(watch);
+    ImpactHangTestsBusyWait(400 * NSEC_PER_MSEC);
+    ImpactHangWatchBeat(watch);
+    ImpactHangWatchIdle(watch);
+
+    while (atomic_load(&ImpactHangTestsRunning)) {
+        usleep(1000);
+    }
+
+    return NULL;
+}
+
+static void* ImpactHangTestsSpinningThread(void* context) {
+    while (atomic_load(&ImpactHangTestsWatch) == NULL) {
+        usleep(1000);
+    }
+
+    ImpactHangWatchBeat(atomic_load(&ImpactHangTestsWatch));
+
+    // busy until told otherwise, so it hangs for as long as the test needs
+    while (atomic_load(&ImpactHangTestsRunning)) {
+    }
+
+    return NULL;
+}
+
+@interface ImpactHangTests : XCTestCase
+
+@end
+
+@implementation ImpactHangTests {
+    ImpactState _source;
+    ImpactHangMonitor* _monitor;
+    NSURL *_directoryURL;
+}
+
+- (void)setUp {
+    memset(&_source, 0, sizeof(ImpactState));
+
+    _source.mutableState.reportIndex.fd = -1;
+
+    _source.constantState.threadPolicies.mainThread = ImpactThreadUnwindPolicyDefault;
+    _source.constantState.threadPolicies.otherThreads = ImpactThreadUnwindPolicyDefault;
+
+    _directoryURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:NSUUID.UUID.UUIDString]];
+    [NSFileManager.defaultManager createDirectoryAtURL:_directoryURL withIntermediateDirectories:YES attributes:nil error:nil];
+
+    _monitor = malloc(sizeof(ImpactHangMonitor));
+
+    XCTAssertEqual(ImpactHangMonitorInitialize(_monitor, &_source, _directoryURL.fileSystemRepresentation, ImpactLogEncodingText, 10 * NSEC_PER_MSEC, 10 * NSEC_PER_SEC), ImpactResultSuccess);
+}
+
+- (void)tearDown {
+    ImpactHangMonitorDeinitialize(_monitor);
+    free(_monitor);
+
+    [NSFileManager.defaultManager removeItemAtURL:_directoryURL error:nil];
+}
+
+- (void)testSamplesShareCommonFrames {
+    ImpactHang* hang = &_monitor->hang;
+
+    ImpactCallTreeInitialize(&hang->tree, hang->nodes, ImpactHangNodeCapacity);
+    hang->samples = 0;
+
+    const uintptr_t first[] = { 0x30, 0x20, 0x10 };
+    const uintptr_t second[] = { 0x40, 0x20, 0x10 };
+
+    ImpactHangRecordSample(hang, first, 3);
+    ImpactHangRecordSample(hang, first, 3);
+    ImpactHangRecordSample(hang, second, 3);
+
+    XCTAssertEqual(hang->samples, 3);
+    XCTAssertEqual(hang->tree.nodeCount, 4);
+
+    // the outermost frame is the root, and every sample went through it
+    XCTAssertEqual(hang->nodes[0].ip, 0x10);
+    XCTAssertEqual(hang->nodes[0].parent, ImpactCallTreeNodeNone);
+    XCTAssertEqual(hang->nodes[0].count, 3);
+    XCTAssertEqual(hang->nodes[0].leafCount, 0);
+
+    XCTAssertEqual(hang->nodes[1].ip, 0x20);
+    XCTAssertEqual(hang->nodes[1].parent, 0);
+    XCTAssertEqual(hang->nodes[1].count, 3);
+
+    XCTAssertEqual(hang->nodes[2].ip, 0x30);
+    XCTAssertEqual(hang->nodes[2].parent, 1);
+    XCTAssertEqual(hang->nodes[2].count, 2);
+    XCTAssertEqual(hang->nodes[2].leafCount, 2);
+
+    XCTAssertEqual(hang->nodes[3].ip, 0x40);
+    XCTAssertEqual(hang->nodes[3].parent, 1);
+    XCTAssertEqual(hang->nodes[3].leafCount, 1);
+}
+
+- (void)testHangIsSampledAndReportedWhenItEnds {
+    pthread_t thread;
+
+    XCTAssertEqual(ImpactHangMonitorStart(_monitor), ImpactResultSuccess);
+
+    atomic_store(&ImpactHangTestsRunning, true);
+    atomic_store(&ImpactHangTestsWatch, NULL);
+
+    XCTAssertEqual(pthread_create(&thread, NULL, ImpactHangTestsHangingThread, NULL), 0);
+
+    ImpactHangWatch* watch = ImpactHangMonitorRegisterThread(_monitor, pthread_mach_thread_np(thread), 100 * NSEC_PER_MSEC);
+    XCTAssertTrue(watch != NULL);
+
+    atomic_store(&ImpactHangTestsWatch, watch);
+
+    // give the hang time to be detected, sampled and then end
+    usleep(800 * 1000);
+
+    atomic_store(&ImpactHangTestsRunning, false);
+    pthread_join(thread, NULL);
+
+    ImpactHangMonitorUnregisterThread(_monitor, watch);
+    XCTAssertEqual(ImpactHangMonitorStop(_monitor), ImpactResultSuccess);
+
+    XCTAssertEqual(_monitor->reportCount, 1);
+
+    NSArray<NSURL *> *reports = [NSFileManager.defaultManager contentsOfDirectoryAtURL:_directoryURL includingPropertiesForKeys:nil options:0 error:nil];
+
+    XCTAssertEqual(reports.count, 1);
+
+    NSString *report = [NSString stringWithContentsOfURL:reports.firstObject encoding:NSUTF8StringEncoding error:nil];
+
+    XCTAssertTrue([report hasPrefix:@"[Hang] main: 0x0, duration: 0x"]);
+    XCTAssertTrue([report containsString:@"ongoing: 0x0"]);
+    XCTAssertTrue([report containsString:@"[Hang:Node] "]);
+    XCTAssertTrue([report containsString:@"[Binary:Found] "]);
+    XCTAssertGreaterThan(_monitor->hang.samples, 5);
+}
+
+- (void)testUnregisteringStopsSamplingOfAnOngoingHang {
+    pthread_t thread;
+
+    XCTAssertEqual(ImpactHangMonitorStart(_monitor), ImpactResultSuccess);
+
+    atomic_store(&ImpactHangTestsRunning, true);
+    atomic_store(&ImpactHangTestsWatch, NULL);
+
+    XCTAssertEqual(pthread_create(&thread, NULL, ImpactHangTestsSpinningThread, NULL), 0);
+
+    ImpactHangWatch* watch = ImpactHangMonitorRegisterThread(_monitor, pthread_mach_thread_np(thread), 50 * NSEC_PER_MSEC);
+    XCTAssertTrue(watch != NULL);
+
+    atomic_store(&ImpactHangTestsWatch, watch);
+
+    usleep(300 * 1000);
+
+    // sampling happens outside the lock, but this must still wait for the thread to be let go
+    ImpactHangMonitorUnregisterThread(_monitor, watch);
+
+    XCTAssertEqual(atomic_load(&watch->thread), MACH_PORT_NULL);
+
+    // the hang ends along with the watch, and is reported as such
+    usleep(100 * 1000);
+
+    atomic_store(&ImpactHangTestsRunning, false);
+    pthread_join(thread, NULL);
+
+    XCTAssertEqual(ImpactHangMonitorStop(_monitor), ImpactResultSuccess);
+
+    XCTAssertEqual(_monitor->reportCount, 1);
+    XCTAssertGreaterThan(_monitor->hang.samples, 0);
+    XCTAssertTrue(_monitor->sampling == NULL);
+}
+
+@end
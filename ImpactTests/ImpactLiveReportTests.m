@@ -0,0 +1,114 @@
+//
+//  ImpactLiveReportTests.m
+//  ImpactTests
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "ImpactLiveReport.h"
+#import "ImpactLog.h"
+
+#include <pthread.h>
+#include <string.h>
+
+static const char* ImpactLiveReportTestsLogPath = "/tmp/live_report_test.log";
+
+static _Atomic uint64_t ImpactLiveReportTestsCounter = 0;
+static _Atomic bool ImpactLiveReportTestsFinished = false;
+
+static void* ImpactLiveReportTestsSpinningThread(void* context) {
+    while (atomic_load(&ImpactLiveReportTestsFinished) == false) {
+        atomic_fetch_add(&ImpactLiveReportTestsCounter, 1);
+    }
+
+    return NULL;
+}
+
+@interface ImpactLiveReportTests : XCTestCase
+
+@end
+
+@implementation ImpactLiveReportTests {
+    ImpactState _source;
+    ImpactLiveReporter _reporter;
+}
+
+- (void)setUp {
+    GlobalImpactState = NULL;
+
+    memset(&_source, 0, sizeof(ImpactState));
+
+    _source.mutableState.reportIndex.fd = -1;
+
+    _source.constantState.threadPolicies.crashedThread = ImpactThreadUnwindPolicyDefault;
+    _source.constantState.threadPolicies.mainThread = ImpactThreadUnwindPolicyDefault;
+    _source.constantState.threadPolicies.otherThreads = ImpactThreadUnwindPolicyDefault;
+
+    XCTAssertEqual(ImpactLiveReporterInitialize(&_reporter, &_source, 256 * 1024, 0), ImpactResultSuccess);
+}
+
+- (void)tearDown {
+    ImpactLiveReporterDeinitialize(&_reporter);
+}
+
+- (NSString *)readReport {
+    NSString *path = [NSString stringWithUTF8String:ImpactLiveReportTestsLogPath];
+
+    return [NSString stringWithContentsOfFile:path encoding:NSUTF8StringEncoding error:nil];
+}
+
+- (void)testCaptureWritesEveryThreadAndResumesThem {
+    pthread_t thread;
+
+    atomic_store(&ImpactLiveReportTestsFinished, false);
+    XCTAssertEqual(pthread_create(&thread, NULL, ImpactLiveReportTestsSpinningThread, NULL), 0);
+
+    XCTAssertEqual(ImpactLiveReportCapture(&_reporter, ImpactLiveReportTestsLogPath, ImpactLogEncodingText), ImpactResultSuccess);
+
+    // the other thread has to be running again for this to ever finish
+    const uint64_t before = atomic_load(&ImpactLiveReportTestsCounter);
+
+    while (atomic_load(&ImpactLiveReportTestsCounter) == before) {
+    }
+
+    atomic_store(&ImpactLiveReportTestsFinished, true);
+    pthread_join(thread, NULL);
+
+    NSString *report = [self readReport];
+
+    XCTAssertTrue([report hasPrefix:@"[Live] pid: "]);
+    XCTAssertTrue([report containsString:@"[Thread:Frame] "]);
+    XCTAssertTrue([report containsString:@"[Binary:Found] "]);
+    XCTAssertTrue([report containsString:@"[Timing] "]);
+    XCTAssertFalse([report containsString:@"[Thread:Crashed]"]);
+    XCTAssertGreaterThan(_reporter.state.mutableState.metrics.threadCount, 1);
+}
+
+- (void)testCapturesWithinTheMinimumIntervalAreRateLimited {
+    _reporter.minimumInterval = 60 * NSEC_PER_SEC;
+
+    XCTAssertEqual(ImpactLiveReportCapture(&_reporter, ImpactLiveReportTestsLogPath, ImpactLogEncodingText), ImpactResultSuccess);
+    XCTAssertEqual(ImpactLiveReportCapture(&_reporter, ImpactLiveReportTestsLogPath, ImpactLogEncodingText), ImpactResultRateLimited);
+
+    XCTAssertEqual(_reporter.captureCount, 1);
+    XCTAssertEqual(_reporter.rateLimitedCount, 1);
+
+    // the rate-limited capture must leave the first report alone
+    XCTAssertTrue([[self readReport] containsString:@"[Timing] "]);
+}
+
+- (void)testCaptureIsRefusedWhileCrashing {
+    ImpactState crashing = {0};
+
+    atomic_store(&crashing.mutableState.crashState, ImpactCrashStateSignal);
+    GlobalImpactState = &crashing;
+
+    XCTAssertEqual(ImpactLiveReportCapture(&_reporter, ImpactLiveReportTestsLogPath, ImpactLogEncodingText), ImpactResultStateInvalid);
+    XCTAssertEqual(_reporter.captureCount, 0);
+
+    GlobalImpactState = NULL;
+}
+
+@end
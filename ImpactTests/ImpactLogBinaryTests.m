@@ -0,0 +1,178 @@
+//
+//  ImpactLogBinaryTests.m
+//  ImpactTests
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "ImpactLog.h"
+#import "ImpactLogBinary.h"
+
+#include <unistd.h>
+
+static const char* ImpactLogBinaryTestsTextPath = "/tmp/binary_log_test.txt";
+static const char* ImpactLogBinaryTestsBinaryPath = "/tmp/binary_log_test.bin";
+static const char* ImpactLogBinaryTestsConvertedPath = "/tmp/binary_log_test_converted.txt";
+
+enum {
+    ImpactLogBinaryTestsThreadCount = 200,
+    ImpactLogBinaryTestsFrameCount = 30
+};
+
+// Roughly the shape of a real report: environment, then a register dump and frames per thread, then images.
+static void ImpactLogBinaryTestsWriteSyntheticReport(ImpactLogger* log) {
+    ImpactLogBeginRecord(log, "Environment");
+    ImpactLogWriteKeyString(log, "platform", "macOS", false);
+    ImpactLogWriteKeyInteger(log, "pid", 1234, false);
+    ImpactLogWriteKeySignedInteger(log, "not_interned", -42, false);
+    ImpactLogWriteKeyInteger(log, "impact_version", 14, true);
+
+    for (uint32_t thread = 0; thread < ImpactLogBinaryTestsThreadCount; ++thread) {
+        ImpactLogBeginRecord(log, "Thread:State");
+
+        for (uint32_t reg = 0; reg < 29; ++reg) {
+            char key[8];
+
+            snprintf(key, sizeof(key), "x%d", reg);
+            ImpactLogWriteKeyInteger(log, key, 0x100000000ull * reg + thread, false);
+        }
+
+        ImpactLogWriteKeyInteger(log, "fp", 0x16fdff000 + thread, false);
+        ImpactLogWriteKeyInteger(log, "lr", 0x1a2b3c4d5, false);
+        ImpactLogWriteKeyInteger(log, "sp", 0x16fdfe000, false);
+        ImpactLogWriteKeyInteger(log, "pc", 0x1a2b3c4d5, true);
+
+        if (thread == 0) {
+            ImpactLogBeginRecord(log, "Thread:Crashed");
+            ImpactLogEndRecord(log);
+        }
+
+        for (uint32_t frame = 0; frame < ImpactLogBinaryTestsFrameCount; ++frame) {
+            ImpactLogBeginRecord(log, "Thread:Frame");
+            ImpactLogWriteKeyInteger(log, "image", frame % 4, false);
+            ImpactLogWriteKeyInteger(log, "offset", 0x20000 + frame * 0x1234, false);
+
+            if (frame == 0) {
+                ImpactLogWriteKeyInteger(log, "sp", 0x7ffee0000000ull, false);
+            } else {
+                ImpactLogWriteKeySignedInteger(log, "sp_delta", 0x40, false);
+            }
+
+            ImpactLogWriteKeyInteger(log, "fp", 0x7ffee0000010ull + frame * 0x40, false);
+            ImpactLogWriteKeyInteger(log, "unwind", 1, true);
+        }
+    }
+
+    const uint8_t uuid[16] = { 0xde, 0xad, 0xbe, 0xef };
+
+    ImpactLogBeginRecord(log, "Binary:Found");
+    ImpactLogWriteKeyInteger(log, "index", 0, false);
+    ImpactLogWriteKeyString(log, "path", "/usr/lib/libSystem.B.dylib", false);
+    ImpactLogWriteKeyInteger(log, "address", 0x180000000, false);
+    ImpactLogWriteKeyInteger(log, "size", 0x4000, false);
+    ImpactLogWriteKeyHexData(log, "uuid", uuid, sizeof(uuid), true);
+}
+
+@interface ImpactLogBinaryTests : XCTestCase
+
+@end
+
+@implementation ImpactLogBinaryTests {
+    ImpactState _state;
+}
+
+- (void)setUp {
+    GlobalImpactState = NULL;
+
+    memset(&_state, 0, sizeof(ImpactState));
+}
+
+- (NSData *)writeReportToPath:(const char *)path encoding:(ImpactLogEncoding)encoding {
+    ImpactResult result = ImpactLogInitializeWithEncoding(&_state, path, encoding);
+    if (result != ImpactResultSuccess) {
+        return nil;
+    }
+
+    ImpactLogBinaryTestsWriteSyntheticReport(ImpactStateGetLog(&_state));
+
+    close(_state.mutableState.log.fd);
+
+    return [NSData dataWithContentsOfFile:@(path)];
+}
+
+- (NSData *)convertReport:(NSData *)data result:(ImpactResult *)result {
+    ImpactLogInitialize(&_state, ImpactLogBinaryTestsConvertedPath);
+
+    ImpactLogger* log = ImpactStateGetLog(&_state);
+
+    *result = ImpactLogBinaryDecode(data.bytes, data.length, log);
+
+    ImpactLogFlush(log);
+    close(log->fd);
+
+    return [NSData dataWithContentsOfFile:@(ImpactLogBinaryTestsConvertedPath)];
+}
+
+- (void)testVarintRoundTrip {
+    const uint64_t values[] = { 0, 1, 127, 128, 300, UINT32_MAX, UINT64_MAX };
+
+    for (size_t i = 0; i < sizeof(values) / sizeof(uint64_t); ++i) {
+        uint8_t buffer[ImpactLogBinaryMaxVarintSize];
+        const size_t length = ImpactLogBinaryEncodeVarint(buffer, values[i]);
+
+        const uint8_t* ptr = buffer;
+        uint64_t value = 0;
+
+        XCTAssertEqual(ImpactLogBinaryDecodeVarint(&ptr, buffer + length, &value), ImpactResultSuccess);
+        XCTAssertEqual(value, values[i]);
+        XCTAssertEqual(ptr, buffer + length);
+    }
+
+    XCTAssertEqual(ImpactLogBinaryZigZagEncode(-1), 1);
+    XCTAssertEqual(ImpactLogBinaryZigZagDecode(ImpactLogBinaryZigZagEncode(INT64_MIN)), INT64_MIN);
+}
+
+- (void)testConvertedReportMatchesText {
+    NSData *text = [self writeReportToPath:ImpactLogBinaryTestsTextPath encoding:ImpactLogEncodingText];
+    NSData *binary = [self writeReportToPath:ImpactLogBinaryTestsBinaryPath encoding:ImpactLogEncodingBinary];
+
+    ImpactResult result = ImpactResultFailure;
+    NSData *converted = [self convertReport:binary result:&result];
+
+    XCTAssertEqual(result, ImpactResultSuccess);
+    XCTAssertEqualObjects(converted, text);
+
+    // varints and interned keys should make a big difference for this kind of data
+    XCTAssertLessThan(binary.length, text.length / 2);
+}
+
+- (void)testTornRecordIsDetected {
+    NSData *binary = [self writeReportToPath:ImpactLogBinaryTestsBinaryPath encoding:ImpactLogEncodingBinary];
+
+    ImpactResult result = ImpactResultSuccess;
+
+    [self convertReport:[binary subdataWithRange:NSMakeRange(0, binary.length - 2)] result:&result];
+    XCTAssertEqual(result, ImpactResultEndOfData);
+
+    NSMutableData *corrupted = [binary mutableCopy];
+    ((uint8_t *)corrupted.mutableBytes)[corrupted.length / 2] ^= 0x55;
+
+    [self convertReport:corrupted result:&result];
+    XCTAssertEqual(result, ImpactResultInconsistentData);
+}
+
+- (void)testWriteTextReportPerformance {
+    [self measureBlock:^{
+        [self writeReportToPath:ImpactLogBinaryTestsTextPath encoding:ImpactLogEncodingText];
+    }];
+}
+
+- (void)testWriteBinaryReportPerformance {
+    [self measureBlock:^{
+        [self writeReportToPath:ImpactLogBinaryTestsBinaryPath encoding:ImpactLogEncodingBinary];
+    }];
+}
+
+@end
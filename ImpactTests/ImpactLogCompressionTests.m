@@ -0,0 +1,184 @@
+//
+//  ImpactLogCompressionTests.m
+//  ImpactTests
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "ImpactLog.h"
+#import "ImpactLogCompression.h"
+
+@interface ImpactLogCompressionTests : XCTestCase
+
+@end
+
+@implementation ImpactLogCompressionTests {
+    ImpactState* _state;
+    ImpactLogCompressor* _compressor;
+}
+
+- (void)setUp {
+    _state = calloc(1, sizeof(ImpactState));
+    _compressor = malloc(sizeof(ImpactLogCompressor));
+}
+
+- (void)tearDown {
+    free(_compressor);
+    free(_state);
+}
+
+// Roughly the shape of a real report: register dumps, frames, and a long image list.
+static void ImpactLogCompressionTestsWriteReport(ImpactLogger* log) {
+    static const char* registers[] = { "x0", "x1", "x2", "x3", "x4", "x5", "x6", "x7", "x8", "x9", "fp", "lr", "sp", "pc" };
+    uint32_t seed = 1;
+
+    for (uint32_t thread = 0; thread < 20; ++thread) {
+        ImpactLogBeginRecord(log, "Thread:State");
+
+        for (uint32_t i = 0; i < 14; ++i) {
+            seed = seed * 1103515245 + 12345;
+            ImpactLogWriteKeyInteger(log, registers[i], i % 3 ? 0x16fdff000 + i * 0x1234 : seed, i == 13);
+        }
+
+        for (uint32_t frame = 0; frame < 30; ++frame) {
+            seed = seed * 1103515245 + 12345;
+
+            ImpactLogBeginRecord(log, "Thread:Frame");
+            ImpactLogWriteKeyInteger(log, "ip", 0x1a0000000 + (seed % 0x400000), false);
+            ImpactLogWriteKeyInteger(log, "sp", 0x16fdff000 + frame * 0x40 + thread * 0x100000, false);
+            ImpactLogWriteKeyInteger(log, "unwind", 1, true);
+        }
+    }
+
+    for (uint32_t i = 0; i < 400; ++i) {
+        char path[128];
+        uint8_t uuid[16];
+
+        snprintf(path, sizeof(path), "/System/Library/Frameworks/Framework%u.framework/Framework%u", i, i);
+
+        for (uint32_t j = 0; j < 16; ++j) {
+            seed = seed * 1103515245 + 12345;
+            uuid[j] = seed >> 16;
+        }
+
+        ImpactLogBeginRecord(log, "Binary:Found");
+        ImpactLogWriteKeyInteger(log, "address", 0x180000000 + i * 0x100000, false);
+        ImpactLogWriteKeyHexData(log, "uuid", uuid, sizeof(uuid), false);
+        ImpactLogWriteKeyString(log, "path", path, true);
+    }
+}
+
+- (NSData *)reportCompressed:(BOOL)compressed {
+    const char* path = compressed ? "/tmp/test_compressed.log" : "/tmp/test_uncompressed.log";
+    ImpactResult result;
+
+    if (compressed) {
+        result = ImpactLogInitializeCompressed(_state, path, ImpactLogEncodingText, _compressor);
+    } else {
+        result = ImpactLogInitialize(_state, path);
+    }
+
+    XCTAssertEqual(result, ImpactResultSuccess);
+
+    ImpactLogCompressionTestsWriteReport(ImpactStateGetLog(_state));
+    ImpactLogDeinitialize(ImpactStateGetLog(_state));
+
+    return [NSData dataWithContentsOfFile:@(path)];
+}
+
+- (NSData *)decode:(NSData *)data result:(ImpactResult *)result {
+    size_t length = 0;
+
+    ImpactLogCompressionGetDecodedLength(data.bytes, data.length, &length);
+
+    NSMutableData *decoded = [NSMutableData dataWithLength:length];
+
+    *result = ImpactLogCompressionDecode(data.bytes, data.length, decoded.mutableBytes, decoded.length, &length);
+    decoded.length = length;
+
+    return decoded;
+}
+
+- (void)testRoundTrip {
+    NSData *expected = [self reportCompressed:NO];
+    NSData *compressed = [self reportCompressed:YES];
+    ImpactResult result;
+
+    XCTAssertTrue(ImpactLogCompressionIsCompressed(compressed.bytes, compressed.length));
+    XCTAssertEqualObjects([self decode:compressed result:&result], expected);
+    XCTAssertEqual(result, ImpactResultSuccess);
+
+    // register values and image paths repeat a lot, even with some random content mixed in
+    XCTAssertLessThan(compressed.length, expected.length / 2);
+}
+
+- (void)testTornReportDecodesPrefix {
+    NSData *expected = [self reportCompressed:NO];
+    NSData *compressed = [self reportCompressed:YES];
+    NSUInteger previousLength = 0;
+
+    for (NSUInteger length = ImpactLogCompressionHeaderSize; length < compressed.length; length += 97) {
+        ImpactResult result;
+        NSData *decoded = [self decode:[compressed subdataWithRange:NSMakeRange(0, length)] result:&result];
+
+        XCTAssertTrue(result == ImpactResultSuccess || result == ImpactResultEndOfData);
+        XCTAssertEqualObjects(decoded, [expected subdataWithRange:NSMakeRange(0, decoded.length)]);
+        XCTAssertGreaterThanOrEqual(decoded.length, previousLength);
+
+        previousLength = decoded.length;
+    }
+}
+
+- (void)testCorruptionIsDetected {
+    NSMutableData *compressed = [[self reportCompressed:YES] mutableCopy];
+    uint8_t* bytes = compressed.mutableBytes;
+
+    for (NSUInteger offset = ImpactLogCompressionHeaderSize; offset < compressed.length; offset += 101) {
+        ImpactResult result;
+
+        bytes[offset] ^= 0x40;
+        [self decode:compressed result:&result];
+        bytes[offset] ^= 0x40;
+
+        XCTAssertNotEqual(result, ImpactResultSuccess);
+    }
+}
+
+- (void)measureWritingCompressed:(BOOL)compressed {
+    [self measureMetrics:@[XCTPerformanceMetric_WallClockTime] automaticallyStartMeasuring:NO forBlock:^{
+        if (compressed) {
+            ImpactLogInitializeCompressed(self->_state, "/tmp/test_compressed.log", ImpactLogEncodingText, self->_compressor);
+        } else {
+            ImpactLogInitialize(self->_state, "/tmp/test_uncompressed.log");
+        }
+
+        [self startMeasuring];
+        ImpactLogCompressionTestsWriteReport(ImpactStateGetLog(self->_state));
+        ImpactLogFlush(ImpactStateGetLog(self->_state));
+        [self stopMeasuring];
+
+        ImpactLogDeinitialize(ImpactStateGetLog(self->_state));
+    }];
+}
+
+- (void)testWriteUncompressedPerformance {
+    [self measureWritingCompressed:NO];
+}
+
+- (void)testWriteCompressedPerformance {
+    [self measureWritingCompressed:YES];
+}
+
+- (void)testDecodePerformance {
+    NSData *compressed = [self reportCompressed:YES];
+
+    [self measureBlock:^{
+        ImpactResult result;
+
+        [self decode:compressed result:&result];
+    }];
+}
+
+@end
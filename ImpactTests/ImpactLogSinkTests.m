@@ -0,0 +1,284 @@
+//
+//  ImpactLogSinkTests.m
+//  ImpactTests
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "ImpactLog.h"
+#import "ImpactLogSink.h"
+#import "ImpactTime.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+@interface ImpactLogSinkTests : XCTestCase
+
+@end
+
+@implementation ImpactLogSinkTests {
+    ImpactState _state;
+}
+
+- (void)setUp {
+    memset(&_state, 0, sizeof(ImpactState));
+}
+
+static void ImpactLogSinkTestsWriteFrames(ImpactLogger* log, uint32_t count) {
+    const uint8_t uuid[16] = { 0x0a, 0x1b, 0x2c, 0x3d, 0x4e, 0x5f, 0x60, 0x71, 0x82, 0x93, 0xa4, 0xb5, 0xc6, 0xd7, 0xe8, 0xf9 };
+
+    for (uint32_t i = 0; i < count; ++i) {
+        ImpactLogBeginRecord(log, "Thread:Frame");
+        ImpactLogWriteKeyInteger(log, "image", i % 8, false);
+        ImpactLogWriteKeyInteger(log, "offset", 0x20000 + i * 0x40, false);
+        ImpactLogWriteKeyHexData(log, "uuid", uuid, sizeof(uuid), false);
+        ImpactLogWriteKeyInteger(log, "fp", 0x16fdff000 + i * 0x30, true);
+    }
+}
+
+- (NSData *)descriptorReportWithFrames:(uint32_t)frames {
+    ImpactLogger* log = ImpactStateGetLog(&_state);
+
+    if (ImpactLogInitialize(&_state, "/tmp/test_sink.log") != ImpactResultSuccess) {
+        return nil;
+    }
+
+    ImpactLogSinkTestsWriteFrames(log, frames);
+    ImpactLogDeinitialize(log);
+
+    return [NSData dataWithContentsOfFile:@"/tmp/test_sink.log"];
+}
+
+- (void)testRingKeepsNewestBytes {
+    NSData *expected = [self descriptorReportWithFrames:1000];
+    ImpactLogger* log = ImpactStateGetLog(&_state);
+
+    // deliberately not a multiple of the record size, so the ring wraps mid-record
+    uint8_t ring[1000];
+    uint8_t copy[2000];
+
+    XCTAssertEqual(ImpactLogSinkOpenRing(log, ring, sizeof(ring)), ImpactResultSuccess);
+    XCTAssertEqual(ImpactLogStart(log, ImpactLogEncodingText), ImpactResultSuccess);
+
+    ImpactLogSinkTestsWriteFrames(log, 1000);
+
+    const size_t length = ImpactLogSinkCopyRing(log, copy, sizeof(copy));
+
+    XCTAssertEqual(length, sizeof(ring));
+    XCTAssertEqualObjects([NSData dataWithBytes:copy length:length], [expected subdataWithRange:NSMakeRange(expected.length - length, length)]);
+}
+
+- (void)testStreamMatchesDescriptor {
+    NSData *expected = [self descriptorReportWithFrames:1000];
+    ImpactLogger* log = ImpactStateGetLog(&_state);
+    int fds[2];
+
+    XCTAssertEqual(pipe(fds), 0);
+
+    // the reader has to drain the pipe concurrently, or writing would block once it fills
+    NSMutableData *received = [NSMutableData data];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"read"];
+
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0), ^{
+        uint8_t buffer[4096];
+        ssize_t count;
+
+        while ((count = read(fds[0], buffer, sizeof(buffer))) > 0) {
+            [received appendBytes:buffer length:count];
+        }
+
+        [expectation fulfill];
+    });
+
+    XCTAssertEqual(ImpactLogSinkOpenStream(log, fds[1]), ImpactResultSuccess);
+    XCTAssertEqual(ImpactLogStart(log, ImpactLogEncodingText), ImpactResultSuccess);
+
+    ImpactLogSinkTestsWriteFrames(log, 1000);
+    ImpactLogDeinitialize(log);
+
+    // the stream sink leaves the descriptor open
+    XCTAssertEqual(close(fds[1]), 0);
+
+    [self waitForExpectations:@[expectation] timeout:5.0];
+
+    close(fds[0]);
+
+    XCTAssertEqualObjects(received, expected);
+}
+
+- (void)testStreamWithoutReaderFails {
+    ImpactLogger* log = ImpactStateGetLog(&_state);
+    int fds[2];
+
+    XCTAssertEqual(pipe(fds), 0);
+    close(fds[0]);
+
+    XCTAssertEqual(ImpactLogSinkOpenStream(log, fds[1]), ImpactResultSuccess);
+    XCTAssertEqual(ImpactLogStart(log, ImpactLogEncodingText), ImpactResultSuccess);
+
+    // this must be an error, not SIGPIPE
+    ImpactLogWriteString(log, "hello");
+    XCTAssertEqual(ImpactLogFlush(log), ImpactResultCallFailed);
+
+    close(fds[1]);
+}
+
+- (void)testMappedMessageGoesAheadOfPartialRecord {
+    ImpactLogger* log = ImpactStateGetLog(&_state);
+
+    GlobalImpactState = &_state;
+
+    XCTAssertEqual(ImpactLogInitializeMapped(&_state, "/tmp/test_sink_mapped.log", ImpactLogEncodingText, 4096), ImpactResultSuccess);
+
+    ImpactLogBeginRecord(log, "Thread");
+    ImpactLogWriteKeyInteger(log, "id", 1, false);
+    ImpactLog("[Log:INFO] message\n");
+    ImpactLogWriteKeyInteger(log, "count", 2, true);
+
+    ImpactLogDeinitialize(log);
+    GlobalImpactState = NULL;
+
+    NSData *data = [NSData dataWithContentsOfFile:@"/tmp/test_sink_mapped.log"];
+    const uint8_t* contents = NULL;
+    size_t length = 0;
+
+    XCTAssertEqual(ImpactLogGetReportContents(data.bytes, data.length, &contents, &length), ImpactResultSuccess);
+
+    NSString *report = [[NSString alloc] initWithBytes:contents length:length encoding:NSUTF8StringEncoding];
+
+    XCTAssertEqualObjects(report, @"[Log:INFO] message\n[Thread] id: 0x1, count: 0x2\n");
+}
+
+- (void)testMessageFromOutsideTheCrashHandlerIsDropped {
+    ImpactLogger* log = ImpactStateGetLog(&_state);
+
+    GlobalImpactState = &_state;
+    atomic_store(&_state.mutableState.crashState, ImpactCrashStateSignal);
+
+    XCTAssertEqual(ImpactLogInitializeMapped(&_state, "/tmp/test_sink_dropped.log", ImpactLogEncodingText, 4096), ImpactResultSuccess);
+
+    ImpactLogBeginRecord(log, "Thread");
+    XCTAssertEqual(ImpactLog("[Log:INFO] message\n"), ImpactResultStateInvalid);
+    ImpactLogWriteKeyInteger(log, "id", 1, true);
+
+    ImpactLogDeinitialize(log);
+    GlobalImpactState = NULL;
+
+    NSData *data = [NSData dataWithContentsOfFile:@"/tmp/test_sink_dropped.log"];
+    const uint8_t* contents = NULL;
+    size_t length = 0;
+
+    XCTAssertEqual(ImpactLogGetReportContents(data.bytes, data.length, &contents, &length), ImpactResultSuccess);
+
+    NSString *report = [[NSString alloc] initWithBytes:contents length:length encoding:NSUTF8StringEncoding];
+
+    XCTAssertEqualObjects(report, @"[Thread] id: 0x1\n");
+}
+
+// Each iteration writes the same report, so the throughput of the sinks can be compared directly.
+- (void)measureSinkWithOpenBlock:(ImpactResult (^)(ImpactLogger* log))openBlock {
+    ImpactLogger* log = ImpactStateGetLog(&_state);
+
+    [self measureMetrics:@[XCTPerformanceMetric_WallClockTime] automaticallyStartMeasuring:NO forBlock:^{
+        XCTAssertEqual(openBlock(log), ImpactResultSuccess);
+        XCTAssertEqual(ImpactLogStart(log, ImpactLogEncodingText), ImpactResultSuccess);
+
+        [self startMeasuring];
+        ImpactLogSinkTestsWriteFrames(log, 10000);
+        ImpactLogFlush(log);
+        [self stopMeasuring];
+
+        ImpactLogDeinitialize(log);
+    }];
+}
+
+// The fastest of a few runs, as the first pays for faulting in the file and the page cache.
+- (double)bytesPerSecondWithOpenBlock:(ImpactResult (^)(ImpactLogger* log))openBlock reportLength:(NSUInteger)length {
+    ImpactLogger* log = ImpactStateGetLog(&_state);
+    uint64_t fastest = UINT64_MAX;
+
+    for (uint32_t i = 0; i < 5; ++i) {
+        XCTAssertEqual(openBlock(log), ImpactResultSuccess);
+        XCTAssertEqual(ImpactLogStart(log, ImpactLogEncodingText), ImpactResultSuccess);
+
+        const uint64_t start = ImpactTimeGetMonotonicNanoseconds();
+
+        ImpactLogSinkTestsWriteFrames(log, 10000);
+        ImpactLogFlush(log);
+
+        const uint64_t duration = ImpactTimeGetMonotonicNanoseconds() - start;
+
+        ImpactLogDeinitialize(log);
+
+        fastest = duration < fastest ? duration : fastest;
+    }
+
+    return (double)length / fastest * 1e9;
+}
+
+- (void)testSinkThroughput {
+    const NSUInteger length = [self descriptorReportWithFrames:10000].length;
+    static uint8_t ring[64 * 1024];
+    const int null = open("/dev/null", O_WRONLY);
+
+    XCTAssertGreaterThan(length, 0);
+    XCTAssertGreaterThanOrEqual(null, 0);
+
+    const double descriptor = [self bytesPerSecondWithOpenBlock:^ImpactResult(ImpactLogger* log) {
+        return ImpactLogSinkOpenDescriptor(log, open("/tmp/test_sink.log", O_WRONLY | O_CREAT | O_TRUNC, 0666));
+    } reportLength:length];
+
+    const double mapped = [self bytesPerSecondWithOpenBlock:^ImpactResult(ImpactLogger* log) {
+        return ImpactLogSinkOpenMapped(log, open("/tmp/test_sink_mapped.log", O_RDWR | O_CREAT | O_TRUNC, 0666), 4 * 1024 * 1024);
+    } reportLength:length];
+
+    const double ringRate = [self bytesPerSecondWithOpenBlock:^ImpactResult(ImpactLogger* log) {
+        return ImpactLogSinkOpenRing(log, ring, sizeof(ring));
+    } reportLength:length];
+
+    const double stream = [self bytesPerSecondWithOpenBlock:^ImpactResult(ImpactLogger* log) {
+        return ImpactLogSinkOpenStream(log, null);
+    } reportLength:length];
+
+    close(null);
+
+    const double mebibyte = 1024 * 1024;
+
+    NSLog(@"sinks, %lu byte report: descriptor %.0f MiB/s, mapped %.0f MiB/s, ring %.0f MiB/s, stream %.0f MiB/s", (unsigned long)length, descriptor / mebibyte, mapped / mebibyte, ringRate / mebibyte, stream / mebibyte);
+}
+
+- (void)testDescriptorSinkPerformance {
+    [self measureSinkWithOpenBlock:^ImpactResult(ImpactLogger* log) {
+        return ImpactLogSinkOpenDescriptor(log, open("/tmp/test_sink.log", O_WRONLY | O_CREAT | O_TRUNC, 0666));
+    }];
+}
+
+- (void)testMappedSinkPerformance {
+    [self measureSinkWithOpenBlock:^ImpactResult(ImpactLogger* log) {
+        return ImpactLogSinkOpenMapped(log, open("/tmp/test_sink_mapped.log", O_RDWR | O_CREAT | O_TRUNC, 0666), 4 * 1024 * 1024);
+    }];
+}
+
+- (void)testRingSinkPerformance {
+    static uint8_t ring[64 * 1024];
+
+    [self measureSinkWithOpenBlock:^ImpactResult(ImpactLogger* log) {
+        return ImpactLogSinkOpenRing(log, ring, sizeof(ring));
+    }];
+}
+
+- (void)testStreamSinkPerformance {
+    const int fd = open("/dev/null", O_WRONLY);
+
+    XCTAssertGreaterThanOrEqual(fd, 0);
+
+    [self measureSinkWithOpenBlock:^ImpactResult(ImpactLogger* log) {
+        return ImpactLogSinkOpenStream(log, fd);
+    }];
+
+    close(fd);
+}
+
+@end
@@ -67,6 +67,40 @@
     XCTAssertEqualObjects(contents, @"0xffffffffffffffff");
 }
 
+static size_t ImpactLogTestsFormatInto(char* buffer, size_t size, const char* format, ...) {
+    va_list args;
+
+    va_start(args, format);
+    const size_t length = ImpactLogFormat(buffer, size, format, args);
+    va_end(args);
+
+    return length;
+}
+
+static NSString* ImpactLogTestsFormat(const char* format, ...) {
+    char buffer[64];
+    va_list args;
+
+    va_start(args, format);
+    ImpactLogFormat(buffer, sizeof(buffer), format, args);
+    va_end(args);
+
+    return [NSString stringWithUTF8String:buffer];
+}
+
+- (void)testFormatMatchesPrintf {
+    XCTAssertEqualObjects(ImpactLogTestsFormat("[Log:%s] %d %u %x", "fn", -5, 42u, 0xbeef), @"[Log:fn] -5 42 beef");
+    XCTAssertEqualObjects(ImpactLogTestsFormat("%llx %zu %ld", 0xffffffffffffffffULL, (size_t)12, -7L), @"ffffffffffffffff 12 -7");
+    XCTAssertEqualObjects(ImpactLogTestsFormat("%08x %5d %p %c %%", 0x1f, 42, (void*)0x1234, 'q'), @"0000001f    42 0x1234 q %");
+}
+
+- (void)testFormatTruncates {
+    char buffer[8];
+
+    XCTAssertEqual(ImpactLogTestsFormatInto(buffer, sizeof(buffer), "hello %s", "world"), 7);
+    XCTAssertEqual(strcmp(buffer, "hello w"), 0);
+}
+
 - (void)testLogPastBufferSize {
     const size_t length = ImpactLogBufferSize + 1;
 
@@ -81,4 +115,80 @@
     XCTAssertEqualObjects(contents, matchingString);
 }
 
+static void ImpactLogTestsWriteFrames(ImpactLogger* log, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        ImpactLogBeginRecord(log, "Thread:Frame");
+        ImpactLogWriteKeyInteger(log, "image", i % 8, false);
+        ImpactLogWriteKeyInteger(log, "offset", 0x20000 + i * 0x40, false);
+        ImpactLogWriteKeySignedInteger(log, "sp_delta", 0x30, false);
+        ImpactLogWriteKeyInteger(log, "fp", 0x16fdff000 + i * 0x30, false);
+        ImpactLogWriteKeyInteger(log, "unwind", 1, true);
+    }
+}
+
+- (NSData *)mappedReportWithSize:(size_t)size frames:(uint32_t)frames {
+    ImpactState state = {0};
+
+    if (ImpactLogInitializeMapped(&state, "/tmp/test_mapped.log", ImpactLogEncodingText, size) != ImpactResultSuccess) {
+        return nil;
+    }
+
+    ImpactLogTestsWriteFrames(ImpactStateGetLog(&state), frames);
+    ImpactLogDeinitialize(ImpactStateGetLog(&state));
+
+    NSData *data = [NSData dataWithContentsOfFile:@"/tmp/test_mapped.log"];
+    const uint8_t* contents = NULL;
+    size_t length = 0;
+
+    if (ImpactLogGetReportContents(data.bytes, data.length, &contents, &length) != ImpactResultSuccess) {
+        return nil;
+    }
+
+    return [NSData dataWithBytes:contents length:length];
+}
+
+- (void)testMappedReportMatchesUnmapped {
+    NSString* expected = [self logContentsWithBlock:^(ImpactLogger* log) {
+        ImpactLogTestsWriteFrames(log, 1000);
+    }];
+
+    NSData *expectedData = [expected dataUsingEncoding:NSUTF8StringEncoding];
+
+    XCTAssertEqualObjects([self mappedReportWithSize:1024 * 1024 frames:1000], expectedData);
+
+    // too small to hold everything, so the rest has to go past the end of the mapping
+    XCTAssertEqualObjects([self mappedReportWithSize:4096 frames:1000], expectedData);
+}
+
+// Only the writing is measured, as setting up a mapping is done long before any crash.
+- (void)measureWritingWithMapping:(BOOL)mapped {
+    [self measureMetrics:@[XCTPerformanceMetric_WallClockTime] automaticallyStartMeasuring:NO forBlock:^{
+        ImpactState state = {0};
+        ImpactResult result;
+
+        if (mapped) {
+            result = ImpactLogInitializeMapped(&state, "/tmp/test_mapped.log", ImpactLogEncodingText, 4 * 1024 * 1024);
+        } else {
+            result = ImpactLogInitialize(&state, "/tmp/test.log");
+        }
+
+        XCTAssertEqual(result, ImpactResultSuccess);
+
+        [self startMeasuring];
+        ImpactLogTestsWriteFrames(ImpactStateGetLog(&state), 10000);
+        ImpactLogFlush(ImpactStateGetLog(&state));
+        [self stopMeasuring];
+
+        ImpactLogDeinitialize(ImpactStateGetLog(&state));
+    }];
+}
+
+- (void)testWriteReportPerformance {
+    [self measureWritingWithMapping:NO];
+}
+
+- (void)testWriteMappedReportPerformance {
+    [self measureWritingWithMapping:YES];
+}
+
 @end
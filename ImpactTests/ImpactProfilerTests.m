@@ -0,0 +1,171 @@
+//
+//  ImpactProfilerTests.m
+//  ImpactTests
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "ImpactProfiler.h"
+
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+static const char* ImpactProfilerTestsOutputPath = "/tmp/profiler_test.folded";
+
+static _Atomic bool ImpactProfilerTestsRunning = false;
+static _Atomic uint64_t ImpactProfilerTestsCounter = 0;
+
+void* ImpactProfilerTestsSpin(void* context) {
+    while (atomic_load(&ImpactProfilerTestsRunning)) {
+        atomic_fetch_add(&ImpactProfilerTestsCounter, 1);
+    }
+
+    return NULL;
+}
+
+@interface ImpactProfilerTests : XCTestCase
+
+@end
+
+@implementation ImpactProfilerTests {
+    ImpactProfiler* _profiler;
+}
+
+- (void)setUp {
+    _profiler = malloc(sizeof(ImpactProfiler));
+}
+
+- (void)tearDown {
+    ImpactProfilerDeinitialize(_profiler);
+    free(_profiler);
+}
+
+- (void)testIntervalIsClamped {
+    XCTAssertEqual(ImpactProfilerInitialize(_profiler, NULL, 1), ImpactResultSuccess);
+    XCTAssertEqual(_profiler->interval, ImpactProfilerMinimumInterval);
+
+    ImpactProfilerDeinitialize(_profiler);
+
+    XCTAssertEqual(ImpactProfilerInitialize(_profiler, NULL, 1000000000), ImpactResultSuccess);
+    XCTAssertEqual(_profiler->interval, ImpactProfilerMaximumInterval);
+}
+
+// How far a spinning thread gets in the given time, optionally while the profiler samples it.
+- (uint64_t)spinCountFor:(useconds_t)duration sampledEvery:(uint64_t)interval thread:(thread_act_t)port statistics:(ImpactProfilerStatistics *)statistics {
+    if (interval > 0) {
+        XCTAssertEqual(ImpactProfilerInitialize(_profiler, NULL, interval), ImpactResultSuccess);
+        XCTAssertEqual(ImpactProfilerSetThreads(_profiler, &port, 1), ImpactResultSuccess);
+        XCTAssertEqual(ImpactProfilerStart(_profiler), ImpactResultSuccess);
+    }
+
+    const uint64_t before = atomic_load(&ImpactProfilerTestsCounter);
+
+    usleep(duration);
+
+    const uint64_t count = atomic_load(&ImpactProfilerTestsCounter) - before;
+
+    if (interval > 0) {
+        XCTAssertEqual(ImpactProfilerStop(_profiler), ImpactResultSuccess);
+        XCTAssertEqual(ImpactProfilerGetStatistics(_profiler, statistics), ImpactResultSuccess);
+        ImpactProfilerDeinitialize(_profiler);
+    }
+
+    return count;
+}
+
+// Overhead shows up twice: as time the sampling thread spends, and as progress the sampled thread loses
+// while it is suspended. Both are logged for the slowest and fastest rates.
+- (void)testOverheadAtEachRate {
+    const useconds_t duration = 500 * 1000;
+    const uint64_t intervals[] = { ImpactProfilerMaximumInterval, ImpactProfilerMinimumInterval };
+    pthread_t thread;
+
+    atomic_store(&ImpactProfilerTestsRunning, true);
+    XCTAssertEqual(pthread_create(&thread, NULL, ImpactProfilerTestsSpin, NULL), 0);
+
+    const thread_act_t port = pthread_mach_thread_np(thread);
+    const uint64_t baseline = [self spinCountFor:duration sampledEvery:0 thread:port statistics:NULL];
+
+    for (size_t i = 0; i < sizeof(intervals) / sizeof(intervals[0]); ++i) {
+        ImpactProfilerStatistics statistics = {0};
+        const uint64_t count = [self spinCountFor:duration sampledEvery:intervals[i] thread:port statistics:&statistics];
+
+        XCTAssertGreaterThan(statistics.samples, 0);
+
+        NSLog(@"profiler at %llu Hz: %llu samples, %.1f us per sample, %.2f%% sampling time, %.2f%% lost by the sampled thread",
+              1000000000ull / intervals[i], statistics.samples,
+              statistics.samplingDuration / 1e3 / statistics.samples,
+              100.0 * statistics.samplingDuration / (duration * 1000.0),
+              100.0 * ((double)baseline - (double)count) / baseline);
+    }
+
+    atomic_store(&ImpactProfilerTestsRunning, false);
+    pthread_join(thread, NULL);
+
+    // tearDown deinitializes it again
+    XCTAssertEqual(ImpactProfilerInitialize(_profiler, NULL, ImpactProfilerMinimumInterval), ImpactResultSuccess);
+}
+
+- (void)testChosenThreadIsSampledAndWrittenAsFoldedStacks {
+    pthread_t thread;
+
+    atomic_store(&ImpactProfilerTestsRunning, true);
+    XCTAssertEqual(pthread_create(&thread, NULL, ImpactProfilerTestsSpin, NULL), 0);
+
+    const thread_act_t port = pthread_mach_thread_np(thread);
+
+    XCTAssertEqual(ImpactProfilerInitialize(_profiler, NULL, ImpactProfilerMinimumInterval), ImpactResultSuccess);
+    XCTAssertEqual(ImpactProfilerSetThreads(_profiler, &port, 1), ImpactResultSuccess);
+    XCTAssertEqual(ImpactProfilerStart(_profiler), ImpactResultSuccess);
+
+    usleep(200 * 1000);
+
+    XCTAssertEqual(ImpactProfilerStop(_profiler), ImpactResultSuccess);
+
+    // sampling has to resume the thread every time, or this would stall
+    const uint64_t before = atomic_load(&ImpactProfilerTestsCounter);
+
+    while (atomic_load(&ImpactProfilerTestsCounter) == before) {
+    }
+
+    atomic_store(&ImpactProfilerTestsRunning, false);
+    pthread_join(thread, NULL);
+
+    ImpactProfilerStatistics statistics = {0};
+
+    XCTAssertEqual(ImpactProfilerGetStatistics(_profiler, &statistics), ImpactResultSuccess);
+    XCTAssertGreaterThan(statistics.samples, 50);
+    XCTAssertEqual(statistics.samples, statistics.ticks - statistics.failed);
+    XCTAssertEqual(statistics.dropped, 0);
+    XCTAssertGreaterThan(statistics.samplingDuration, 0);
+
+    // everything has been aggregated
+    XCTAssertEqual(atomic_load(&_profiler->ring.head), atomic_load(&_profiler->ring.tail));
+
+    XCTAssertEqual(ImpactProfilerWriteFoldedStacks(_profiler, ImpactProfilerTestsOutputPath), ImpactResultSuccess);
+
+    NSString *path = [NSString stringWithUTF8String:ImpactProfilerTestsOutputPath];
+    NSString *folded = [NSString stringWithContentsOfFile:path encoding:NSUTF8StringEncoding error:nil];
+
+    XCTAssertTrue([folded containsString:@"ImpactProfilerTestsSpin"]);
+
+    uint64_t total = 0;
+
+    for (NSString *line in [folded componentsSeparatedByString:@"\n"]) {
+        if (line.length == 0) {
+            continue;
+        }
+
+        const NSRange space = [line rangeOfString:@" " options:NSBackwardsSearch];
+
+        XCTAssertNotEqual(space.location, NSNotFound);
+        total += [[line substringFromIndex:space.location + 1] longLongValue];
+    }
+
+    XCTAssertEqual(total, statistics.samples);
+}
+
+@end
@@ -0,0 +1,158 @@
+//
+//  ImpactReportStoreTests.m
+//  ImpactTests
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "ImpactReportStore.h"
+
+@interface ImpactReportStoreTests : XCTestCase
+
+@end
+
+@implementation ImpactReportStoreTests {
+    ImpactState* _state;
+    NSString* _directory;
+}
+
+- (void)setUp {
+    _state = calloc(1, sizeof(ImpactState));
+    _state->mutableState.reportIndex.fd = -1;
+    _directory = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtPath:_directory error:nil];
+    free(_state);
+}
+
+- (uint32_t)openReport:(uint8_t)identifier {
+    uint8_t reportId[16] = { identifier };
+    char path[PATH_MAX];
+
+    ImpactReportIndex* index = &_state->mutableState.reportIndex;
+
+    if (index->fd >= 0) {
+        close(index->fd);
+    }
+
+    XCTAssertEqual(ImpactReportStoreOpen(index, _directory.fileSystemRepresentation, 3, reportId, path, sizeof(path)), ImpactResultSuccess);
+
+    // launch times are in milliseconds, and ordering matters for rotation
+    usleep(2000);
+
+    return index->slot;
+}
+
+- (uint32_t)readIndex:(ImpactReportIndexEntry*)entries {
+    uint32_t count = 0;
+
+    XCTAssertEqual(ImpactReportStoreReadIndex(_directory.fileSystemRepresentation, entries, ImpactReportStoreMaxSlots, &count), ImpactResultSuccess);
+
+    return count;
+}
+
+- (void)testMissingIndexIsEmpty {
+    ImpactReportIndexEntry entries[ImpactReportStoreMaxSlots];
+
+    XCTAssertEqual([self readIndex:entries], 0);
+}
+
+- (void)testEmptySlotsAreFilledFirst {
+    XCTAssertEqual([self openReport:1], 0);
+    XCTAssertEqual([self openReport:2], 1);
+    XCTAssertEqual([self openReport:3], 2);
+
+    ImpactReportIndexEntry entries[ImpactReportStoreMaxSlots];
+
+    XCTAssertEqual([self readIndex:entries], 3);
+
+    for (uint32_t i = 0; i < 3; ++i) {
+        XCTAssertEqual(entries[i].reportId[0], i + 1);
+        XCTAssertNotEqual(entries[i].launchTime, 0);
+        XCTAssertEqual(entries[i].flags, 0);
+    }
+}
+
+- (void)testCrashesAreKeptOverNormalLaunches {
+    [self openReport:1];
+    ImpactReportStoreRecordSignal(_state, SIGSEGV);
+
+    [self openReport:2];
+    [self openReport:3];
+
+    // the oldest report crashed, so the oldest one that didn't is replaced
+    XCTAssertEqual([self openReport:4], 1);
+    XCTAssertEqual([self openReport:5], 2);
+
+    ImpactReportIndexEntry entries[ImpactReportStoreMaxSlots];
+
+    [self readIndex:entries];
+
+    XCTAssertEqual(entries[0].reportId[0], 1);
+    XCTAssertEqual(entries[0].signal, SIGSEGV);
+}
+
+- (void)testOldestCrashIsReplacedWhenAllCrashed {
+    for (uint8_t i = 1; i <= 3; ++i) {
+        [self openReport:i];
+        ImpactReportStoreRecordException(_state, 1);
+    }
+
+    XCTAssertEqual([self openReport:4], 0);
+}
+
+- (void)testCrashUpdatesAreVisibleInIndex {
+    const uint32_t slot = [self openReport:1];
+
+    ImpactReportStoreRecordException(_state, 1);
+    ImpactReportStoreRecordSignal(_state, SIGABRT);
+    ImpactReportStoreRecordStackHash(_state, 0x1234);
+    ImpactReportStoreRecordComplete(_state);
+
+    ImpactReportIndexEntry entries[ImpactReportStoreMaxSlots];
+
+    [self readIndex:entries];
+
+    const ImpactReportIndexEntry* entry = &entries[slot];
+
+    XCTAssertEqual(entry->flags, ImpactReportIndexFlagCrashed | ImpactReportIndexFlagComplete);
+    XCTAssertEqual(entry->exceptionType, 1);
+    XCTAssertEqual(entry->signal, SIGABRT);
+    XCTAssertEqual(entry->stackHash, 0x1234);
+    XCTAssertGreaterThanOrEqual(entry->crashTime, entry->launchTime);
+}
+
+- (void)testRemoveEmptiesSlot {
+    const uint32_t slot = [self openReport:1];
+    char path[PATH_MAX];
+
+    ImpactReportStoreGetReportPath(_directory.fileSystemRepresentation, slot, path, sizeof(path));
+    [@"report" writeToFile:@(path) atomically:NO encoding:NSUTF8StringEncoding error:nil];
+
+    XCTAssertEqual(ImpactReportStoreRemove(_directory.fileSystemRepresentation, slot), ImpactResultSuccess);
+
+    ImpactReportIndexEntry entries[ImpactReportStoreMaxSlots];
+
+    [self readIndex:entries];
+
+    XCTAssertEqual(entries[slot].launchTime, 0);
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:@(path)]);
+    XCTAssertEqual([self openReport:2], slot);
+}
+
+- (void)testStackHashDependsOnImageAndOffsetOnly {
+    const uint8_t uuid[16] = { 1, 2, 3 };
+    const uint8_t otherUUID[16] = { 1, 2, 4 };
+
+    const uint64_t hash = ImpactReportStoreStackHashAdd(ImpactReportStoreStackHashSeed, uuid, 0x100);
+
+    XCTAssertEqual(hash, ImpactReportStoreStackHashAdd(ImpactReportStoreStackHashSeed, uuid, 0x100));
+    XCTAssertNotEqual(hash, ImpactReportStoreStackHashAdd(ImpactReportStoreStackHashSeed, uuid, 0x104));
+    XCTAssertNotEqual(hash, ImpactReportStoreStackHashAdd(ImpactReportStoreStackHashSeed, otherUUID, 0x100));
+}
+
+@end
@@ -0,0 +1,527 @@
+//
+//  ImpactThreadTests.m
+//  ImpactTests
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "ImpactThread.h"
+#import "ImpactBinaryImage.h"
+#import "ImpactLog.h"
+#import "ImpactArena.h"
+#import "ImpactUnwind.h"
+#import "ImpactDebug.h"
+
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+static const char* ImpactThreadTestsLogPath = "/tmp/thread_test.log";
+
+enum {
+    ImpactThreadTestsThreadCount = 8,
+    ImpactThreadTestsManyThreadCount = 1000
+};
+
+static pthread_mutex_t ImpactThreadTestsMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t ImpactThreadTestsCondition = PTHREAD_COND_INITIALIZER;
+static bool ImpactThreadTestsFinished = false;
+
+static void* ImpactThreadTestsParkedThread(void* context);
+
+static __attribute__((noinline)) void* ImpactThreadTestsRecurse(uint32_t depth) {
+    if (depth == 0) {
+        return ImpactThreadTestsParkedThread(NULL);
+    }
+
+    void* result = ImpactThreadTestsRecurse(depth - 1);
+
+    // prevents tail-call optimization, so every level keeps its frame
+    __asm__ volatile("" ::: "memory");
+
+    return result;
+}
+
+// Returns the average nanoseconds per capture, made from depth frames down.
+static __attribute__((noinline)) uint64_t ImpactThreadTestsUnwindAtDepth(ImpactState* state, uint32_t strategies, uint32_t depth, uint32_t* frameCount) {
+    if (depth == 0) {
+        const uint32_t iterations = 100;
+        uintptr_t frames[512];
+        const uint64_t start = ImpactTimeGetMonotonicNanoseconds();
+
+        for (uint32_t i = 0; i < iterations; ++i) {
+            *frameCount = ImpactUnwindCaptureStack(state, strategies, frames, 512, 0);
+        }
+
+        return (ImpactTimeGetMonotonicNanoseconds() - start) / iterations;
+    }
+
+    const uint64_t result = ImpactThreadTestsUnwindAtDepth(state, strategies, depth - 1, frameCount);
+
+    __asm__ volatile("" ::: "memory");
+
+    return result;
+}
+
+static void* ImpactThreadTestsDeepThread(void* context) {
+    return ImpactThreadTestsRecurse((uint32_t)(uintptr_t)context);
+}
+
+static void* ImpactThreadTestsParkedThread(void* context) {
+    pthread_mutex_lock(&ImpactThreadTestsMutex);
+
+    while (ImpactThreadTestsFinished == false) {
+        pthread_cond_wait(&ImpactThreadTestsCondition, &ImpactThreadTestsMutex);
+    }
+
+    pthread_mutex_unlock(&ImpactThreadTestsMutex);
+
+    return NULL;
+}
+
+@interface ImpactThreadTests : XCTestCase
+
+@end
+
+@implementation ImpactThreadTests {
+    ImpactState _state;
+    pthread_t _threads[ImpactThreadTestsManyThreadCount];
+    uint32_t _threadCount;
+}
+
+- (void)setUp {
+    GlobalImpactState = NULL;
+
+    memset(&_state, 0, sizeof(ImpactState));
+
+    _state.mutableState.reportIndex.fd = -1;
+
+    _state.constantState.threadPolicies.crashedThread = ImpactThreadUnwindPolicyDefault;
+    _state.constantState.threadPolicies.mainThread = ImpactThreadUnwindPolicyDefault;
+    _state.constantState.threadPolicies.otherThreads = ImpactThreadUnwindPolicyDefault;
+
+    XCTAssertEqual(ImpactLogInitialize(&_state, ImpactThreadTestsLogPath), ImpactResultSuccess);
+    XCTAssertEqual(ImpactBinaryImageInitialize(&_state), ImpactResultSuccess);
+
+    ImpactThreadTestsFinished = false;
+    _threadCount = 0;
+
+    [self parkThreads:ImpactThreadTestsThreadCount];
+}
+
+// Tops up the parked threads to count. They all stay parked until tearDown.
+- (void)parkThreads:(uint32_t)count {
+    pthread_attr_t attr;
+
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, PTHREAD_STACK_MIN);
+
+    for (; _threadCount < count; ++_threadCount) {
+        XCTAssertEqual(pthread_create(&_threads[_threadCount], &attr, ImpactThreadTestsParkedThread, NULL), 0);
+    }
+
+    pthread_attr_destroy(&attr);
+}
+
+- (void)tearDown {
+    pthread_mutex_lock(&ImpactThreadTestsMutex);
+    ImpactThreadTestsFinished = true;
+    pthread_cond_broadcast(&ImpactThreadTestsCondition);
+    pthread_mutex_unlock(&ImpactThreadTestsMutex);
+
+    for (uint32_t i = 0; i < _threadCount; ++i) {
+        pthread_join(_threads[i], NULL);
+    }
+
+    close(_state.mutableState.log.fd);
+    ImpactArenaDeinitialize(&_state.mutableState.arena);
+}
+
+- (ImpactResult)logThreadsWithCrashedThread:(thread_act_t)crashedThread {
+    ImpactThreadList list = {0};
+
+    ImpactResult result = ImpactThreadListInitialize(&list, crashedThread, NULL);
+    if (result != ImpactResultSuccess) {
+        return result;
+    }
+
+    result = ImpactThreadListLog(&_state, &list);
+
+    ImpactThreadListDeinitialize(&list);
+
+    return result;
+}
+
+- (NSArray<NSString *> *)loggedLines {
+    ImpactLogFlush(&_state.mutableState.log);
+
+    NSString *contents = [NSString stringWithContentsOfFile:@(ImpactThreadTestsLogPath) encoding:NSUTF8StringEncoding error:nil];
+
+    return [contents componentsSeparatedByString:@"\n"];
+}
+
+- (NSString *)firstThreadStateLineFollowingLines:(NSArray<NSString *> *)lines {
+    for (NSUInteger i = 0; i + 1 < lines.count; ++i) {
+        if ([lines[i] hasPrefix:@"[Thread:State]"]) {
+            return lines[i + 1];
+        }
+    }
+
+    return nil;
+}
+
+- (void)testCrashedThreadIsLoggedFirst {
+    const thread_act_t crashedThread = pthread_mach_thread_np(_threads[ImpactThreadTestsThreadCount / 2]);
+
+    XCTAssertEqual([self logThreadsWithCrashedThread:crashedThread], ImpactResultSuccess);
+
+    NSArray<NSString *> *lines = [self loggedLines];
+
+    XCTAssertTrue([[self firstThreadStateLineFollowingLines:lines] hasPrefix:@"[Thread:Crashed]"]);
+}
+
+- (void)testDeadlineTruncatesAfterCrashedThread {
+    const thread_act_t crashedThread = pthread_mach_thread_np(_threads[0]);
+
+    _state.mutableState.crashDeadline = ImpactTimeGetMonotonicNanoseconds() + 1;
+
+    XCTAssertEqual([self logThreadsWithCrashedThread:crashedThread], ImpactResultDeadlineExceeded);
+
+    NSArray<NSString *> *lines = [self loggedLines];
+
+    XCTAssertTrue([[self firstThreadStateLineFollowingLines:lines] hasPrefix:@"[Thread:Crashed]"]);
+
+    NSUInteger truncated = [lines indexOfObjectPassingTest:^BOOL(NSString *line, NSUInteger idx, BOOL *stop) {
+        return [line hasPrefix:@"[Truncated] section: threads"];
+    }];
+
+    XCTAssertNotEqual(truncated, NSNotFound);
+}
+
+- (NSUInteger)loggedThreadCount {
+    NSPredicate *predicate = [NSPredicate predicateWithFormat:@"SELF BEGINSWITH %@", @"[Thread:State]"];
+
+    return [[self loggedLines] filteredArrayUsingPredicate:predicate].count;
+}
+
+// An expired deadline stops logging right after the crashed thread, so timing that shows how long a
+// crash with 1000 threads takes to get its most important trace written.
+- (void)testCrashedThreadLatencyWithManyThreads {
+    [self parkThreads:ImpactThreadTestsManyThreadCount];
+
+    const thread_act_t crashedThread = pthread_mach_thread_np(_threads[ImpactThreadTestsManyThreadCount - 1]);
+
+    uint64_t start = ImpactTimeGetMonotonicNanoseconds();
+
+    XCTAssertEqual([self logThreadsWithCrashedThread:crashedThread], ImpactResultSuccess);
+
+    const uint64_t everything = ImpactTimeGetMonotonicNanoseconds() - start;
+    const NSUInteger everyThread = [self loggedThreadCount];
+
+    _state.mutableState.crashDeadline = 1;
+    start = ImpactTimeGetMonotonicNanoseconds();
+
+    XCTAssertEqual([self logThreadsWithCrashedThread:crashedThread], ImpactResultDeadlineExceeded);
+
+    const uint64_t crashedOnly = ImpactTimeGetMonotonicNanoseconds() - start;
+
+    NSLog(@"crash path: %.2f ms until the crashed thread is written, %.2f ms for all %u threads", crashedOnly / 1e6, everything / 1e6, ImpactThreadTestsManyThreadCount);
+
+    // the second pass wrote the crashed thread, and nothing else
+    XCTAssertGreaterThan(everyThread, ImpactThreadTestsManyThreadCount);
+    XCTAssertEqual([self loggedThreadCount], everyThread + 1);
+}
+
+- (void)testLoggingRecordsPhaseMetrics {
+    const thread_act_t crashedThread = pthread_mach_thread_np(_threads[0]);
+
+    XCTAssertEqual([self logThreadsWithCrashedThread:crashedThread], ImpactResultSuccess);
+
+    const ImpactCrashMetrics* metrics = &_state.mutableState.metrics;
+
+    XCTAssertGreaterThan(metrics->threadCount, ImpactThreadTestsThreadCount);
+    XCTAssertGreaterThan(metrics->phaseDurations[ImpactCrashPhaseUnwind], 0);
+    XCTAssertGreaterThan(metrics->phaseDurations[ImpactCrashPhaseSuspend], 0);
+    XCTAssertLessThanOrEqual(metrics->slowestThreadDuration, metrics->phaseDurations[ImpactCrashPhaseUnwind]);
+    XCTAssertGreaterThan(metrics->imageLookups, 0);
+    XCTAssertGreaterThan(_state.mutableState.log.flushCount, 0);
+}
+
+- (void)testFramesCarryUnwindOutcome {
+    const thread_act_t crashedThread = pthread_mach_thread_np(_threads[0]);
+
+    XCTAssertEqual([self logThreadsWithCrashedThread:crashedThread], ImpactResultSuccess);
+
+    NSArray<NSString *> *lines = [self loggedLines];
+    NSUInteger frameCount = 0;
+
+    for (NSString *line in lines) {
+        if ([line hasPrefix:@"[Thread:Frame]"] == NO) {
+            continue;
+        }
+
+        XCTAssertTrue([line containsString:@", unwind: 0x"]);
+        frameCount += 1;
+    }
+
+    const uint32_t* outcomes = _state.mutableState.metrics.unwindOutcomes;
+    uint32_t outcomeTotal = 0;
+
+    for (uint32_t i = 0; i < ImpactUnwindOutcomeCount; ++i) {
+        outcomeTotal += outcomes[i];
+    }
+
+    XCTAssertEqual(outcomeTotal, frameCount);
+    XCTAssertEqual(outcomes[ImpactUnwindOutcomeThreadState], _state.mutableState.metrics.threadCount);
+
+    // every frame that fell back was preceded by a recovered failure, which isn't counted as terminal
+    uint32_t fallbackTotal = 0;
+
+    for (uint32_t i = 0; i < ImpactResultCount; ++i) {
+        fallbackTotal += _state.mutableState.metrics.unwindFallbacks[i];
+    }
+
+    XCTAssertGreaterThanOrEqual(fallbackTotal, outcomes[ImpactUnwindOutcomeFramePointerFallback]);
+}
+
+- (void)testFramesAreImageRelative {
+    const thread_act_t crashedThread = pthread_mach_thread_np(_threads[0]);
+
+    XCTAssertEqual([self logThreadsWithCrashedThread:crashedThread], ImpactResultSuccess);
+
+    NSArray<NSString *> *lines = [self loggedLines];
+    NSMutableSet<NSString *> *imageIndexes = [NSMutableSet set];
+    NSMutableSet<NSString *> *referencedIndexes = [NSMutableSet set];
+    BOOL previousWasFrame = NO;
+
+    for (NSString *line in lines) {
+        NSArray<NSString *> *fields = [line componentsSeparatedByString:@", "];
+
+        if ([line hasPrefix:@"[Binary:Found] index: "]) {
+            [imageIndexes addObject:[fields[0] substringFromIndex:@"[Binary:Found] index: ".length]];
+            continue;
+        }
+
+        if ([line hasPrefix:@"[Thread:Frame]"] == NO) {
+            previousWasFrame = previousWasFrame && [line hasPrefix:@"[Binary:Found]"];
+            continue;
+        }
+
+        if ([line hasPrefix:@"[Thread:Frame] image: "]) {
+            [referencedIndexes addObject:[fields[0] substringFromIndex:@"[Thread:Frame] image: ".length]];
+            XCTAssertTrue([fields[1] hasPrefix:@"offset: 0x"]);
+        } else {
+            XCTAssertTrue([line hasPrefix:@"[Thread:Frame] ip: 0x"]);
+        }
+
+        // only the first frame of each thread carries an absolute stack pointer
+        XCTAssertEqual([fields[2] hasPrefix:@"sp_delta: "], previousWasFrame);
+
+        previousWasFrame = YES;
+    }
+
+    XCTAssertGreaterThan(referencedIndexes.count, 0);
+    XCTAssertTrue([referencedIndexes isSubsetOfSet:imageIndexes]);
+}
+
+- (void)testCaptureWritesCrashedThreadStack {
+    const thread_act_t crashedThread = pthread_mach_thread_np(_threads[0]);
+
+    XCTAssertEqual(ImpactArenaInitialize(&_state.mutableState.arena, 1024 * 1024), ImpactResultSuccess);
+    XCTAssertEqual([self logThreadsWithCrashedThread:crashedThread], ImpactResultSuccess);
+
+    NSArray<NSString *> *lines = [self loggedLines];
+    NSUInteger crashed = [lines indexOfObjectPassingTest:^BOOL(NSString *line, NSUInteger idx, BOOL *stop) {
+        return [line hasPrefix:@"[Thread:Crashed]"];
+    }];
+
+    XCTAssertNotEqual(crashed, NSNotFound);
+    XCTAssertTrue([lines[crashed + 1] hasPrefix:@"[Thread:Stack] address: 0x"]);
+
+    XCTAssertGreaterThan(_state.mutableState.arena.highWater, 0);
+    XCTAssertEqual(_state.mutableState.metrics.threadCount, _state.mutableState.metrics.unwindOutcomes[ImpactUnwindOutcomeThreadState]);
+}
+
+- (void)testCaptureWithTooSmallArenaFallsBack {
+    const thread_act_t crashedThread = pthread_mach_thread_np(_threads[0]);
+
+    XCTAssertEqual(ImpactArenaInitialize(&_state.mutableState.arena, 1), ImpactResultSuccess);
+    XCTAssertEqual([self logThreadsWithCrashedThread:crashedThread], ImpactResultSuccess);
+
+    NSArray<NSString *> *lines = [self loggedLines];
+
+    XCTAssertTrue([[self firstThreadStateLineFollowingLines:lines] hasPrefix:@"[Thread:Crashed]"]);
+
+    NSUInteger stack = [lines indexOfObjectPassingTest:^BOOL(NSString *line, NSUInteger idx, BOOL *stop) {
+        return [line hasPrefix:@"[Thread:Stack]"];
+    }];
+
+    XCTAssertEqual(stack, NSNotFound);
+}
+
+- (void)testNothingIsWrittenWhileThreadsAreSuspended {
+    const thread_act_t crashedThread = pthread_mach_thread_np(_threads[0]);
+    ImpactCrashMetrics* metrics = &_state.mutableState.metrics;
+    const ImpactLogger* log = &_state.mutableState.log;
+
+    XCTAssertEqual(ImpactArenaInitialize(&_state.mutableState.arena, 1024 * 1024), ImpactResultSuccess);
+
+    ImpactThreadList list = {0};
+    ImpactThreadListSnapshot snapshot = {0};
+
+    XCTAssertEqual(ImpactThreadListInitialize(&list, crashedThread, NULL), ImpactResultSuccess);
+
+    const uint32_t flushCount = log->flushCount;
+    const uint32_t bufferCount = log->bufferCount;
+
+    XCTAssertEqual(ImpactThreadListCapture(&_state, &list, &snapshot), ImpactResultSuccess);
+    ImpactThreadListResume(&_state, &list);
+
+    // everything is formatted after the threads are running again
+    XCTAssertEqual(log->flushCount, flushCount);
+    XCTAssertEqual(log->bufferCount, bufferCount);
+
+    XCTAssertEqual(ImpactThreadListSnapshotLog(&_state, &list, &snapshot), ImpactResultSuccess);
+    ImpactThreadListDeinitialize(&list);
+
+    XCTAssertEqual(snapshot.count, list.count);
+    XCTAssertEqual([self loggedThreadCount], snapshot.count);
+    XCTAssertGreaterThan(metrics->phaseDurations[ImpactCrashPhaseFormat], 0);
+}
+
+- (void)testSnapshotFramesAreWrittenWithoutImageLookups {
+    const thread_act_t crashedThread = pthread_mach_thread_np(_threads[0]);
+    ImpactCrashMetrics* metrics = &_state.mutableState.metrics;
+
+    XCTAssertEqual(ImpactArenaInitialize(&_state.mutableState.arena, 1024 * 1024), ImpactResultSuccess);
+
+    ImpactThreadList list = {0};
+    ImpactThreadListSnapshot snapshot = {0};
+
+    XCTAssertEqual(ImpactThreadListInitialize(&list, crashedThread, NULL), ImpactResultSuccess);
+    XCTAssertEqual(ImpactThreadListCapture(&_state, &list, &snapshot), ImpactResultSuccess);
+    ImpactThreadListResume(&_state, &list);
+
+    const uint32_t lookups = metrics->imageLookups;
+
+    XCTAssertEqual(ImpactThreadListSnapshotLog(&_state, &list, &snapshot), ImpactResultSuccess);
+    ImpactThreadListDeinitialize(&list);
+
+    XCTAssertEqual(metrics->imageLookups, lookups);
+
+    const ImpactThreadFrame* frame = &snapshot.threads[0].frames[0];
+
+    XCTAssertNotEqual(frame->imageIndex, ImpactBinaryImageNotFoundFlag);
+    XCTAssertLessThan(frame->imageOffset, frame->ip);
+
+    NSString *expected = [NSString stringWithFormat:@"[Thread:Frame] image: 0x%x, offset: 0x%lx", frame->imageIndex, (unsigned long)frame->imageOffset];
+
+    XCTAssertTrue([[[self loggedLines] componentsJoinedByString:@"\n"] containsString:expected]);
+}
+
+- (void)testCaptureManyThreadsPerformance {
+    [self parkThreads:ImpactThreadTestsManyThreadCount];
+
+    const thread_act_t crashedThread = pthread_mach_thread_np(_threads[ImpactThreadTestsManyThreadCount - 1]);
+
+    XCTAssertEqual(ImpactArenaInitialize(&_state.mutableState.arena, 4 * 1024 * 1024), ImpactResultSuccess);
+
+    [self measureBlock:^{
+        ImpactThreadList list = {0};
+        ImpactThreadListSnapshot snapshot = {0};
+
+        ImpactThreadListInitialize(&list, crashedThread, NULL);
+        ImpactArenaReset(&self->_state.mutableState.arena);
+        ImpactThreadListCapture(&self->_state, &list, &snapshot);
+        ImpactThreadListResume(&self->_state, &list);
+        ImpactThreadListDeinitialize(&list);
+    }];
+}
+
+- (void)testLogManyThreadsPerformance {
+    [self parkThreads:ImpactThreadTestsManyThreadCount];
+
+    const thread_act_t crashedThread = pthread_mach_thread_np(_threads[ImpactThreadTestsManyThreadCount - 1]);
+
+    [self measureBlock:^{
+        [self logThreadsWithCrashedThread:crashedThread];
+    }];
+}
+
+- (void)testUnwindCostPerStrategy {
+    const struct {
+        const char* name;
+        uint32_t strategies;
+    } cases[] = {
+        { "frame pointer", ImpactUnwindStrategyFramePointer },
+        { "compact unwind", ImpactUnwindStrategyCompactUnwind | ImpactUnwindStrategyFramePointer },
+        { "dwarf", ImpactUnwindStrategyDWARF | ImpactUnwindStrategyFramePointer },
+        { "all", ImpactUnwindStrategyAll },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+        uint32_t frameCount = 0;
+
+        // the first pass pays for finding and logging each image once
+        ImpactThreadTestsUnwindAtDepth(&_state, cases[i].strategies, 400, &frameCount);
+
+        const uint64_t perStack = ImpactThreadTestsUnwindAtDepth(&_state, cases[i].strategies, 400, &frameCount);
+
+        NSLog(@"unwind %s: %.1f us/stack, %.1f ns/frame over %u frames", cases[i].name, perStack / 1e3, (double)perStack / frameCount, frameCount);
+
+        XCTAssertGreaterThan(frameCount, 400);
+    }
+}
+
+// Compact unwind makes two INFO calls for every frame. Without GlobalImpactState, each one stops at
+// a pointer check, which is as close to compiled out as a single build gets. In a build where
+// IMPACT_LOG_LEVEL is below INFO, both runs should come out the same.
+- (void)testDiagnosticsCostOnADeepStack {
+    const uint32_t strategies = ImpactUnwindStrategyCompactUnwind | ImpactUnwindStrategyFramePointer;
+    uint32_t frameCount = 0;
+
+    ImpactThreadTestsUnwindAtDepth(&_state, strategies, 400, &frameCount);
+
+    const uint64_t silent = ImpactThreadTestsUnwindAtDepth(&_state, strategies, 400, &frameCount);
+
+    GlobalImpactState = &_state;
+
+    const uint64_t logged = ImpactThreadTestsUnwindAtDepth(&_state, strategies, 400, &frameCount);
+
+    GlobalImpactState = NULL;
+
+    NSLog(@"diagnostics at level %d: %.1f us/stack, %.1f us/stack without, %.1f ns/frame added over %u frames",
+          IMPACT_LOG_LEVEL, logged / 1e3, silent / 1e3, ((double)logged - (double)silent) / frameCount, frameCount);
+
+    XCTAssertGreaterThan(frameCount, 400);
+}
+
+// With GlobalImpactState set, every diagnostic call that survives the IMPACT_LOG_LEVEL filter is
+// actually formatted and written. Comparing Debug and Release runs of this shows the crash-path cost.
+- (void)testLogDeepStackWithDiagnosticsPerformance {
+    pthread_t deepThread;
+
+    XCTAssertEqual(pthread_create(&deepThread, NULL, ImpactThreadTestsDeepThread, (void*)(uintptr_t)400), 0);
+
+    // give it a chance to reach the bottom
+    usleep(100 * 1000);
+
+    GlobalImpactState = &_state;
+
+    [self measureBlock:^{
+        [self logThreadsWithCrashedThread:pthread_mach_thread_np(deepThread)];
+    }];
+
+    GlobalImpactState = NULL;
+
+    pthread_mutex_lock(&ImpactThreadTestsMutex);
+    ImpactThreadTestsFinished = true;
+    pthread_cond_broadcast(&ImpactThreadTestsCondition);
+    pthread_mutex_unlock(&ImpactThreadTestsMutex);
+
+    pthread_join(deepThread, NULL);
+}
+
+@end
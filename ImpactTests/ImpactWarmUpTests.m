@@ -0,0 +1,128 @@
+//
+//  ImpactWarmUpTests.m
+//  ImpactTests
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "ImpactWarmUp.h"
+#import "ImpactArena.h"
+#import "ImpactLog.h"
+#import "ImpactTime.h"
+
+#include <sys/mman.h>
+
+@interface ImpactWarmUpTests : XCTestCase
+
+@end
+
+@implementation ImpactWarmUpTests {
+    ImpactState* _state;
+}
+
+- (void)setUp {
+    _state = calloc(1, sizeof(ImpactState));
+
+    XCTAssertEqual(ImpactArenaInitialize(&_state->mutableState.arena, 64 * 1024), ImpactResultSuccess);
+    XCTAssertEqual(ImpactLogInitializeMapped(_state, "/tmp/warm_up_test.log", ImpactLogEncodingText, 256 * 1024), ImpactResultSuccess);
+}
+
+- (void)tearDown {
+    ImpactLogDeinitialize(ImpactStateGetLog(_state));
+    ImpactArenaDeinitialize(&_state->mutableState.arena);
+    free(_state);
+}
+
+// Stands in for the crash handler, touching every page of the arena and part of the report mapping.
+- (uint64_t)handlerLatency {
+    ImpactArena* arena = &_state->mutableState.arena;
+    ImpactLogger* log = ImpactStateGetLog(_state);
+    const size_t pageSize = (size_t)getpagesize();
+    const uint64_t start = ImpactTimeGetMonotonicNanoseconds();
+
+    for (uint8_t* page = ImpactArenaAllocate(arena, pageSize, pageSize); page != NULL; page = ImpactArenaAllocate(arena, pageSize, pageSize)) {
+        page[0] = 1;
+    }
+
+    for (uint32_t i = 0; i < 1500; ++i) {
+        ImpactLogBeginRecord(log, "Thread:Frame");
+        ImpactLogWriteKeyInteger(log, "image", i % 8, false);
+        ImpactLogWriteKeyInteger(log, "offset", 0x1000 + i * 0x40, true);
+    }
+
+    const uint64_t latency = ImpactTimeGetMonotonicNanoseconds() - start;
+
+    ImpactArenaReset(arena);
+
+    return latency;
+}
+
+- (void)discardPages {
+    const ImpactArena* arena = &_state->mutableState.arena;
+    const ImpactLogMapping* mapping = &_state->mutableState.log.mapping;
+
+    madvise(arena->base, arena->size, MADV_DONTNEED);
+    madvise(mapping->base, mapping->size, MADV_DONTNEED);
+}
+
+- (void)testHandlerLatencyColdAndWarm {
+    [self discardPages];
+
+    const uint64_t cold = [self handlerLatency];
+
+    ImpactWarmUpStatistics statistics = {0};
+
+    [self discardPages];
+    XCTAssertEqual(ImpactWarmUp(_state, ImpactWarmUpOptionNone, &statistics), ImpactResultSuccess);
+
+    const uint64_t warm = [self handlerLatency];
+
+    NSLog(@"handler latency: %.1f us cold, %.1f us warm", cold / 1e3, warm / 1e3);
+}
+
+- (void)testRangeIsRoundedToPages {
+    ImpactWarmUpStatistics statistics = {0};
+    const uint8_t* base = _state->mutableState.arena.base;
+
+    XCTAssertEqual(ImpactWarmUpRange(base + 1, 1, true, &statistics), ImpactResultSuccess);
+
+    XCTAssertEqual(statistics.ranges, 1);
+    XCTAssertEqual(statistics.touchedBytes, (size_t)getpagesize());
+
+    // RLIMIT_MEMLOCK can be zero, which is not something this test can fix
+    XCTSkipIf(statistics.lockFailures > 0, @"mlock is not permitted here");
+
+    XCTAssertEqual(statistics.lockedBytes, (size_t)getpagesize());
+
+    munlock(base, getpagesize());
+}
+
+- (void)testWarmUpCoversCodeStateArenaAndMapping {
+    ImpactWarmUpStatistics statistics = {0};
+
+    XCTAssertEqual(ImpactWarmUp(_state, ImpactWarmUpOptionNone, &statistics), ImpactResultSuccess);
+
+    XCTAssertEqual(statistics.ranges, 4);
+    XCTAssertGreaterThan(statistics.touchedBytes, sizeof(ImpactState) + 64 * 1024 + 256 * 1024);
+    XCTAssertEqual(statistics.lockedBytes, 0);
+}
+
+- (void)testUnwindSectionsIncludeMainExecutable {
+    ImpactWarmUpStatistics statistics = {0};
+
+    XCTAssertEqual(ImpactWarmUp(_state, ImpactWarmUpOptionUnwindSections, &statistics), ImpactResultSuccess);
+
+    XCTAssertGreaterThan(statistics.ranges, 4);
+}
+
+- (void)testWarmUpPerformance {
+    [self measureBlock:^{
+        ImpactWarmUpStatistics statistics = {0};
+
+        ImpactWarmUp(self->_state, ImpactWarmUpOptionUnwindSections, &statistics);
+    }];
+}
+
+@end
@@ -0,0 +1,198 @@
+//
+//  ImpactWatchdogTests.m
+//  ImpactTests
+//
+//  Copyright © 2026 Chime Systems Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "ImpactWatchdog.h"
+#import "ImpactLog.h"
+
+#include <signal.h>
+#include <sys/wait.h>
+
+static const char* ImpactWatchdogTestsLogPath = "/tmp/watchdog_test.log";
+
+@interface ImpactWatchdogTests : XCTestCase
+
+@end
+
+@implementation ImpactWatchdogTests {
+    ImpactWatchdogRegion* _region;
+}
+
+- (void)setUp {
+    _region = ImpactWatchdogRegionCreate();
+
+    XCTAssertTrue(_region != NULL);
+
+    ImpactState* state = &_region->state;
+
+    state->mutableState.reportIndex.fd = -1;
+    state->mutableState.log.fd = -1;
+
+    XCTAssertEqual(ImpactLogInitialize(state, ImpactWatchdogTestsLogPath), ImpactResultSuccess);
+    XCTAssertEqual(ImpactBreadcrumbPoolInitialize(&_region->breadcrumbs, 4), ImpactResultSuccess);
+
+    state->constantState.breadcrumbs = &_region->breadcrumbs;
+
+    atomic_store(&state->mutableState.crashState, ImpactCrashStateInitialized);
+}
+
+- (void)tearDown {
+    XCTAssertEqual(ImpactBreadcrumbPoolDeinitialize(&_region->breadcrumbs), ImpactResultSuccess);
+    XCTAssertEqual(ImpactWatchdogRegionDestroy(_region), ImpactResultSuccess);
+}
+
+- (NSString *)reportContents {
+    ImpactLogDeinitialize(ImpactStateGetLog(&_region->state));
+
+    NSString *path = [NSString stringWithUTF8String:ImpactWatchdogTestsLogPath];
+
+    return [NSString stringWithContentsOfFile:path encoding:NSUTF8StringEncoding error:nil];
+}
+
+- (void)testNothingIsWrittenWithoutACrash {
+    ImpactBreadcrumbRecord(&_region->breadcrumbs, 1, NULL, 0, "unused");
+
+    XCTAssertEqual(ImpactWatchdogFinishReport(&_region->state), ImpactResultSuccess);
+
+    XCTAssertFalse([[self reportContents] containsString:@"[Watchdog]"]);
+}
+
+- (void)testUnfinishedCrashIsCompletedWithBreadcrumbs {
+    ImpactState* state = &_region->state;
+
+    ImpactBreadcrumbRecord(&_region->breadcrumbs, 1, NULL, 0, "before the crash");
+
+    atomic_store(&state->mutableState.crashState, ImpactCrashStateSignal);
+
+    // an expired deadline from the crash handler must not cut the watchdog short
+    state->mutableState.crashDeadline = 1;
+
+    XCTAssertEqual(ImpactWatchdogFinishReport(state), ImpactResultSuccess);
+
+    NSString *contents = [self reportContents];
+
+    XCTAssertTrue([contents containsString:@"[Watchdog] crash_state: 0x4, complete: 0x0"]);
+    XCTAssertTrue([contents containsString:@"message: before the crash"]);
+}
+
+- (void)testTornLineIsTerminatedFirst {
+    ImpactState* state = &_region->state;
+    ImpactLogger* log = ImpactStateGetLog(state);
+
+    // one part already made it to the file, and the rest is still buffered
+    ImpactLogBeginRecord(log, "Thread");
+    ImpactLogFlush(log);
+    ImpactLogWriteString(log, " partial");
+
+    atomic_store(&state->mutableState.crashState, ImpactCrashStateSignal);
+
+    XCTAssertEqual(ImpactWatchdogFinishReport(state), ImpactResultSuccess);
+    XCTAssertTrue([[self reportContents] containsString:@"[Thread] partial\n[Watchdog] crash_state: 0x4"]);
+}
+
+- (void)testCompleteLineIsNotTerminatedAgain {
+    ImpactState* state = &_region->state;
+    ImpactLogger* log = ImpactStateGetLog(state);
+
+    ImpactLogBeginRecord(log, "Thread");
+    ImpactLogWriteKeyInteger(log, "id", 1, true);
+
+    atomic_store(&state->mutableState.crashState, ImpactCrashStateSignal);
+
+    XCTAssertEqual(ImpactWatchdogFinishReport(state), ImpactResultSuccess);
+
+    NSString *contents = [self reportContents];
+
+    XCTAssertTrue([contents containsString:@"[Thread] id: 0x1\n[Watchdog]"]);
+    XCTAssertFalse([contents containsString:@"\n\n"]);
+}
+
+- (void)testNoWatchdogIsNotRunning {
+    XCTAssertFalse(ImpactWatchdogIsRunning(&_region->state));
+}
+
+- (void)testExitedWatchdogIsNotRunningBeforeItIsReaped {
+#if IMPACT_WATCHDOG_SUPPORTED
+    ImpactState* state = &_region->state;
+
+    XCTAssertEqual(ImpactWatchdogStart(_region), ImpactResultSuccess);
+
+    const pid_t watchdog = state->constantState.watchdogProcess;
+
+    XCTAssertGreaterThan(watchdog, 0);
+    XCTAssertTrue(ImpactWatchdogIsRunning(state));
+
+    // left unreaped, so it stays a zombie that kill(pid, 0) would still find
+    XCTAssertEqual(kill(watchdog, SIGKILL), 0);
+
+    bool running = true;
+
+    for (int i = 0; i < 100 && running; ++i) {
+        running = ImpactWatchdogIsRunning(state);
+
+        if (running) {
+            usleep(10000);
+        }
+    }
+
+    XCTAssertFalse(running);
+    XCTAssertEqual(kill(watchdog, 0), 0);
+
+    XCTAssertEqual(waitpid(watchdog, NULL, 0), watchdog);
+    close(state->constantState.watchdogPipe);
+#endif
+}
+
+- (void)testWatchdogFinishesAfterItsParentDies {
+#if IMPACT_WATCHDOG_SUPPORTED
+    ImpactWatchdogRegion* region = _region;
+
+    // Stands in for a process whose crash handler died part way through. Only async-signal-safe calls
+    // are made in the child.
+    const pid_t child = fork();
+
+    if (child == 0) {
+        if (ImpactWatchdogStart(region) != ImpactResultSuccess) {
+            _exit(1);
+        }
+
+        ImpactBreadcrumbRecord(&region->breadcrumbs, 2, NULL, 0, "from the child");
+        atomic_store(&region->state.mutableState.crashState, ImpactCrashStateSignal);
+
+        _exit(0);
+    }
+
+    XCTAssertGreaterThan(child, 0);
+
+    int status = 0;
+
+    XCTAssertEqual(waitpid(child, &status, 0), child);
+    XCTAssertEqual(WEXITSTATUS(status), 0);
+
+    // the watchdog is not a child of this process, so the report is all there is to wait on
+    NSString *path = [NSString stringWithUTF8String:ImpactWatchdogTestsLogPath];
+    NSString *contents = nil;
+
+    for (int i = 0; i < 100; ++i) {
+        contents = [NSString stringWithContentsOfFile:path encoding:NSUTF8StringEncoding error:nil];
+
+        if ([contents containsString:@"message: from the child"]) {
+            break;
+        }
+
+        usleep(50000);
+    }
+
+    XCTAssertTrue([contents containsString:@"[Watchdog] crash_state: 0x4"]);
+    XCTAssertTrue([contents containsString:@"message: from the child"]);
+
+    ImpactLogDeinitialize(ImpactStateGetLog(&_region->state));
+#endif
+}
+
+@end